@@ -54,6 +54,8 @@ EbBool is a 32 bit quantity and is aligned on a 32 bit word boundary.
 #define EB_FALSE 0
 #define EB_TRUE 1
 
+// Callers must zero-initialize the structure, the encoder reads the optional input fields
+// (roi_delta_qp, roi_static_hint) of every picture sent
 typedef struct EbBufferHeaderType {
     // EbBufferHeaderType size
     uint32_t size;
@@ -79,6 +81,11 @@ typedef struct EbBufferHeaderType {
     uint32_t cr_sse;
     uint32_t cb_sse;
 
+    // pic region of interest map (input, needs enable_roi_map): one entry per 64x64
+    // block in raster order, (width + 63) / 64 blocks per row, NULL: none
+    int8_t * roi_delta_qp; // added to the qp of the blocks, [-63, 63]
+    uint8_t *roi_static_hint; // non zero: static block, faster partitioning
+
     // pic flags
     uint32_t flags;
 } EbBufferHeaderType;
@@ -45,16 +45,42 @@ typedef struct PredictionStructureConfigEntry {
   int32_t ref_list1[REF_LIST_MAX_DEPTH];
 } PredictionStructureConfigEntry;
 
+/* Two pass statistics
+ * The first pass produces one record per picture: the referenced area of each
+ * 64x64 block of the picture (uint32_t, raster order). A stats file or buffer
+ * is the concatenation of the records in display order, so the record of a
+ * picture is at picture_number * EB_TWO_PASS_STAT_RECORD_SIZE(width, height). */
+#define EB_TWO_PASS_STAT_RECORD_SIZE(width, height) \
+    ((((width) + 63) / 64) * (((height) + 63) / 64) * sizeof(uint32_t))
+
+/* Callback function receiving the first pass statistics of a picture.
+ *
+ * Calls are serialized, but not in display order.
+ * Parameters:
+ * @  private_data    output_stat_private_data of the configuration
+ * @  picture_number  display order of the picture
+ * @  *record         statistics of the picture, valid during the call only
+ * @  record_size     size of the record in bytes*/
+typedef void (*EbOutputStatCallback)(void *private_data, uint64_t picture_number,
+                                     const uint8_t *record, uint32_t record_size);
+
 // super-res modes
 typedef enum {
     SUPERRES_NONE,     // No frame superres allowed.
     SUPERRES_FIXED,    // All frames are coded at the specified scale, and super-resolved.
     SUPERRES_RANDOM,   // All frames are coded at a random scale, and super-resolved.
     SUPERRES_QTHRESH,  // Superres scale for a frame is determined based on q_index.
-    SUPERRES_AUTO,     // Automatically select superres for appropriate frames.
+    SUPERRES_AUTO,     // Intra frames are coded at a reduced width when the speed control
+                       // cannot reach the target frame rate at the fastest preset.
     SUPERRES_MODES
 } SUPERRES_MODE;
 
+/* Rate control budget shared by the encoders of the chunks of a sequence
+ * (chunked parallel encoding, VBR only). The encoders attached to it steer
+ * their sliding window rate towards the deviation of all the chunks from the
+ * target rate, instead of their own deviation. */
+typedef struct EbSharedRateControl EbSharedRateControl;
+
 // Will contain the EbEncApi which will live in the EncHandle class
 // Only modifiable during config-time.
 typedef struct EbSvtAv1EncConfiguration {
@@ -95,6 +121,13 @@ typedef struct EbSvtAv1EncConfiguration {
      *
      * Default is 3. */
     uint32_t hierarchical_levels;
+    /* Adaptive mini GOP size: each mini GOP is sized between 4 pictures and
+     * 2^hierarchical_levels pictures from the temporal activity of its
+     * pictures (shorter for high motion, longer for static content). Random
+     * access only.
+     *
+     * Default is 0. */
+    EbBool adaptive_mini_gop;
 
     /* Prediction structure used to construct GOP. There are two main structures
      * supported, which are: Low Delay (P or B) and Random Access.
@@ -113,6 +146,14 @@ typedef struct EbSvtAv1EncConfiguration {
      *
      * Default is 2. */
     uint8_t pred_structure;
+    /* Real time (low latency) mode: flat prediction structure where each
+     * picture only references past pictures and is output as soon as it is
+     * coded, no look ahead, no temporal filtering, and a scene change detection
+     * on the past pictures only. Overrides hierarchical_levels,
+     * look_ahead_distance, enable_altrefs and enable_overlays.
+     *
+     * Default is 0. */
+    EbBool real_time_mode;
 
     // Input Info
     /* The width of input source in units of picture luma pixels.
@@ -198,6 +239,14 @@ typedef struct EbSvtAv1EncConfiguration {
      *
      * Default is 50. */
     uint32_t qp;
+    /* Constant quality level [0 - 63] of the constant rate factor (CRF) mode, a
+     * single pass mode of the constant qp rate control (overriding qp) where
+     * the qindex of each picture is modulated by the motion compensated
+     * complexity of the look ahead window, and the one of each SB by the look
+     * ahead statistics. -1 disables the mode.
+     *
+     * Default is -1. */
+    int32_t crf;
 
     /* force qp values for every picture that are passed in the header pointer
     *
@@ -207,6 +256,29 @@ typedef struct EbSvtAv1EncConfiguration {
     FILE *input_stat_file;
     /* output stats file */
     FILE *output_stat_file;
+    /* Input stats held in memory (e.g. a memory mapped stats file), used
+     * instead of input_stat_file when not NULL.
+     *
+     * Default is NULL. */
+    const uint8_t *input_stat_buffer;
+    uint64_t       input_stat_buffer_size;
+    /* Output stats delivered through a callback, used instead of
+     * output_stat_file when not NULL.
+     *
+     * Default is NULL. */
+    EbOutputStatCallback output_stat_callback;
+    void *               output_stat_private_data;
+    /* Rate control budget shared with the encoders of the other chunks of the
+     * sequence, created with eb_svt_enc_create_shared_rc().
+     *
+     * Default is NULL. */
+    EbSharedRateControl *shared_rc;
+    /* Derive the 2 pass statistics in process, from the motion estimation of
+     * the pictures of the look ahead window, instead of reading them from a
+     * first pass. Cannot be combined with the input / output stats.
+     *
+     * Default is 0. */
+    EbBool enable_lookahead_pass;
     /* Enable picture QP scaling between hierarchical levels
     *
     * Default is null.*/
@@ -230,6 +302,13 @@ typedef struct EbSvtAv1EncConfiguration {
     * Default is 0. */
     uint32_t film_grain_denoise_strength;
 
+    /* Fast film grain: the input picture is denoised per segment in the picture
+    * analysis, and the grain parameters are only estimated on key frames and
+    * scene cuts, the other pictures reuse them. Only used with 4:2:0 input.
+    *
+    * Default is 0. */
+    EbBool fast_film_grain;
+
     /* Warped motion
     *
     * Default is -1. */
@@ -436,9 +515,14 @@ typedef struct EbSvtAv1EncConfiguration {
      *
      * Default is 0. */
     uint32_t rate_control_mode;
-    /* Flag to enable the scene change detection algorithm.
+    /* Scene change detection algorithm.
      *
-     * Default is 1. */
+     * 0 = off.
+     * 1 = per region histogram detector.
+     * 2 = sliding window detector (histogram and SAD deltas over the past and
+     *     look ahead pictures, flash and fade detection).
+     *
+     * Default is 0. */
     uint32_t scene_change_detection;
     /* When RateControlMode is set to 1 it's best to set this parameter to be
      * equal to the Intra period value (such is the default set by the encoder).
@@ -446,6 +530,12 @@ typedef struct EbSvtAv1EncConfiguration {
      *
      * Default depends on rate control mode.*/
     uint32_t look_ahead_distance;
+    /* Temporal dependency model over the look ahead window: the intra / inter
+     * costs of the pictures are propagated to their references to derive the
+     * qindex boost of the base layer pictures and the QP offsets of their SBs.
+     *
+     * Default is 0. */
+    EbBool enable_tpl_la;
 
     /* Target bitrate in bits/second, only apllicable when rate control mode is
      * set to 2 or 3.
@@ -455,6 +545,29 @@ typedef struct EbSvtAv1EncConfiguration {
 
     /* VBV Buffer size */
     uint32_t vbv_bufsize;
+    /* Decoder buffer (VBV) model enforced in rate control mode 1 or 2, with a
+     * buffer of vbv_bufsize bits filled at vbv_maxrate.
+     *
+     * 0 = OFF.
+     * 1 = VBR: the buffer stops filling when full.
+     * 2 = CBR: the buffer keeps filling at vbv_maxrate, the temporal units are
+     *     padded to prevent a buffer overflow.
+     *
+     * Default is 0. */
+    uint32_t vbv_mode;
+    /* VBV buffer fill rate in bits/second, 0 = target_bit_rate.
+     *
+     * Default is 0. */
+    uint32_t vbv_maxrate;
+    /* Initial VBV buffer fullness in percent of vbv_bufsize.
+     *
+     * Default is 90. */
+    uint32_t vbv_init;
+    /* Maximum size of a temporal unit in bits when the VBV model is on,
+     * 0 = no cap.
+     *
+     * Default is 0. */
+    uint32_t max_frame_size;
 
     /* Maxium QP value allowed for rate control use, only applicable when rate
      * control mode is set to 1. It has to be greater or equal to minQpAllowed.
@@ -486,6 +599,14 @@ typedef struct EbSvtAv1EncConfiguration {
      * Default is FALSE. */
     EbBool enable_adaptive_quantization;
 
+    /* Allocate the region of interest maps of the input pictures: the delta qp
+     * and static hint maps of EbBufferHeaderType are copied and applied to the SBs
+     * (through the SB delta qp, not compatible with the segmentation mode 1 of
+     * enable_adaptive_quantization).
+     *
+     * Default is FALSE. */
+    EbBool enable_roi_map;
+
     // Tresholds
     /* Flag to signal that the input yuv is HDR10 BT2020 using SMPTE ST2048, requires
      *
@@ -624,6 +745,13 @@ typedef struct EbSvtAv1EncConfiguration {
     EbBool  enable_altrefs;
     uint8_t altref_strength;
     uint8_t altref_nframes;
+    /* Adaptive temporal filtering: the window is extended to the maximum
+     * number of frames, and each 32x32 block of the filtered picture only
+     * uses the neighbor frames its motion estimation error allows (a frame
+     * and the ones beyond it are dropped, e.g. across an occlusion).
+     *
+     * Default is 0. */
+    EbBool  adaptive_altref;
     EbBool  enable_overlays;
 
     // super-resolution parameters
@@ -747,6 +875,21 @@ EB_API EbErrorType eb_deinit_encoder(EbComponentType *svt_enc_component);
      * @ *svt_enc_component  Encoder handler. */
 EB_API EbErrorType eb_deinit_handle(EbComponentType *svt_enc_component);
 
+/* OPTIONAL: Create a rate control budget to share between the encoders of the
+ * chunks of a sequence. Set it as shared_rc of the configuration of each
+ * encoder before eb_init_encoder().
+     *
+     * Parameter:
+     * @ **shared_rc         Created shared rate control. */
+EB_API EbErrorType eb_svt_enc_create_shared_rc(EbSharedRateControl **shared_rc);
+
+/* OPTIONAL: Destroy a shared rate control, once all the encoders using it have
+ * been deinitialized.
+     *
+     * Parameter:
+     * @ *shared_rc          Shared rate control. */
+EB_API void eb_svt_enc_destroy_shared_rc(EbSharedRateControl *shared_rc);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -17,6 +17,7 @@
 #include <io.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 /**********************************
@@ -31,6 +32,7 @@
 #define OUTPUT_RECON_TOKEN "-o"
 #define ERROR_FILE_TOKEN "-errlog"
 #define QP_FILE_TOKEN "-qp-file"
+#define ROI_MAP_FILE_TOKEN "-roi-map-file"
 #define INPUT_STAT_FILE_TOKEN "-input-stat-file"
 #define OUTPUT_STAT_FILE_TOKEN "-output-stat-file"
 #define STAT_FILE_TOKEN "-stat-file"
@@ -41,6 +43,7 @@
 #define BUFFERED_INPUT_TOKEN "-nb"
 #define BASE_LAYER_SWITCH_MODE_TOKEN "-base-layer-switch-mode" // no Eval
 #define QP_TOKEN "-q"
+#define CRF_TOKEN "-crf"
 #define USE_QP_FILE_TOKEN "-use-q-file"
 #define STAT_REPORT_TOKEN "-stat-report"
 #define FRAME_RATE_TOKEN "-fps"
@@ -52,14 +55,18 @@
 #define INPUT_COMPRESSED_TEN_BIT_FORMAT "-compressed-ten-bit-format"
 #define ENCMODE_TOKEN "-enc-mode"
 #define ENCMODE2P_TOKEN "-enc-mode-2p"
+#define LOOKAHEAD_PASS_TOKEN "-lookahead-pass"
 #define HIERARCHICAL_LEVELS_TOKEN "-hierarchical-levels" // no Eval
 #define PRED_STRUCT_TOKEN "-pred-struct"
+#define REAL_TIME_TOKEN "-real-time"
+#define ADAPTIVE_MINI_GOP_TOKEN "-adaptive-mini-gop"
 #define INTRA_PERIOD_TOKEN "-intra-period"
 #define PROFILE_TOKEN "-profile"
 #define TIER_TOKEN "-tier"
 #define LEVEL_TOKEN "-level"
 #define LATENCY_MODE "-latency-mode" // no Eval
 #define FILM_GRAIN_TOKEN "-film-grain"
+#define FAST_FILM_GRAIN_TOKEN "-fast-film-grain"
 #define INTRA_REFRESH_TYPE_TOKEN "-irefresh-type" // no Eval
 #define LOOP_FILTER_DISABLE_TOKEN "-dlf"
 #define CDEF_MODE_TOKEN "-cdef-mode"
@@ -115,6 +122,7 @@
 #define ENABLE_ALTREFS "-enable-altrefs"
 #define ALTREF_STRENGTH "-altref-strength"
 #define ALTREF_NFRAMES "-altref-nframes"
+#define ADAPTIVE_ALTREF_TOKEN "-adaptive-altref"
 #define ENABLE_OVERLAYS "-enable-overlays"
 // --- end: ALTREF_FILTERING_SUPPORT
 // --- start: SUPER-RESOLUTION SUPPORT
@@ -131,9 +139,14 @@
 #define TARGET_BIT_RATE_TOKEN "-tbr"
 #define MAX_QP_TOKEN "-max-qp"
 #define VBV_BUFSIZE_TOKEN "-vbv-bufsize"
+#define VBV_MODE_TOKEN "-vbv-mode"
+#define VBV_MAXRATE_TOKEN "-vbv-maxrate"
+#define VBV_INIT_TOKEN "-vbv-init"
+#define MAX_FRAME_SIZE_TOKEN "-max-frame-size"
 #define MIN_QP_TOKEN "-min-qp"
 #define ADAPTIVE_QP_ENABLE_TOKEN "-adaptive-quantization"
 #define LOOK_AHEAD_DIST_TOKEN "-lad"
+#define ENABLE_TPL_LA_TOKEN "-enable-tpl-la"
 #define SUPER_BLOCK_SIZE_TOKEN "-sb-size"
 #define TILE_ROW_TOKEN "-tile-rows"
 #define TILE_COL_TOKEN "-tile-columns"
@@ -150,6 +163,7 @@
 #define THREAD_MGMNT "-lp"
 #define UNPIN_LP1_TOKEN "-unpin-lp1"
 #define TARGET_SOCKET "-ss"
+#define CHUNK_COUNT_TOKEN "-chunks"
 #define UNRESTRICTED_MOTION_VECTOR "-umv"
 #define CONFIG_FILE_COMMENT_CHAR '#'
 #define CONFIG_FILE_NEWLINE_CHAR '\n'
@@ -176,6 +190,8 @@
  **********************************/
 static void set_cfg_input_file(const char *filename, EbConfig *cfg) {
     if (cfg->input_file && !cfg->input_file_is_fifo) fclose(cfg->input_file);
+    free(cfg->input_file_name);
+    cfg->input_file_name = NULL;
 
     if (!filename) {
         cfg->input_file = NULL;
@@ -189,6 +205,11 @@ static void set_cfg_input_file(const char *filename, EbConfig *cfg) {
 
     if (cfg->input_file == NULL) { return; }
 
+    // kept to reopen the input for each chunk
+    const size_t name_size = EB_STRLEN(filename, RSIZE_MAX_STR) + 1;
+    cfg->input_file_name   = (char *)malloc(name_size);
+    if (cfg->input_file_name) EB_STRCPY(cfg->input_file_name, name_size, filename);
+
 #ifdef _WIN32
     HANDLE handle = (HANDLE)_get_osfhandle(_fileno(cfg->input_file));
     if (handle == INVALID_HANDLE_VALUE) return;
@@ -225,9 +246,59 @@ static void set_cfg_qp_file(const char *value, EbConfig *cfg) {
     if (cfg->qp_file) { fclose(cfg->qp_file); }
     FOPEN(cfg->qp_file, value, "r");
 };
+static void set_cfg_roi_map_file(const char *value, EbConfig *cfg) {
+    if (cfg->roi_map_file) { fclose(cfg->roi_map_file); }
+    FOPEN(cfg->roi_map_file, value, "r");
+};
+/* Unmaps the input stat file mapped by map_input_stat_file */
+static void unmap_input_stat_file(EbConfig *cfg) {
+    if (!cfg->input_stat_buffer) return;
+#ifdef _WIN32
+    UnmapViewOfFile(cfg->input_stat_buffer);
+    CloseHandle((HANDLE)cfg->input_stat_mapping);
+    cfg->input_stat_mapping = NULL;
+#else
+    munmap((void *)cfg->input_stat_buffer, (size_t)cfg->input_stat_buffer_size);
+#endif
+    cfg->input_stat_buffer      = NULL;
+    cfg->input_stat_buffer_size = 0;
+}
+
+/* Maps the input stat file in memory, so that the library reads the stats of
+ * each picture without any seek / read. The file is still read through
+ * input_stat_file when it cannot be mapped. */
+static void map_input_stat_file(EbConfig *cfg) {
+#ifdef _WIN32
+    HANDLE        handle = (HANDLE)_get_osfhandle(_fileno(cfg->input_stat_file));
+    LARGE_INTEGER file_size;
+    if (handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(handle, &file_size) ||
+        file_size.QuadPart == 0)
+        return;
+    HANDLE mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) return;
+    cfg->input_stat_buffer = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (cfg->input_stat_buffer == NULL) {
+        CloseHandle(mapping);
+        return;
+    }
+    cfg->input_stat_mapping     = (void *)mapping;
+    cfg->input_stat_buffer_size = (uint64_t)file_size.QuadPart;
+#else
+    int         fd = fileno(cfg->input_stat_file);
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) || !S_ISREG(statbuf.st_mode) || statbuf.st_size == 0) return;
+    void *buffer = mmap(NULL, (size_t)statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (buffer == MAP_FAILED) return;
+    cfg->input_stat_buffer      = (const uint8_t *)buffer;
+    cfg->input_stat_buffer_size = (uint64_t)statbuf.st_size;
+#endif
+}
+
 static void set_input_stat_file(const char *value, EbConfig *cfg) {
+    unmap_input_stat_file(cfg);
     if (cfg->input_stat_file) { fclose(cfg->input_stat_file); }
     FOPEN(cfg->input_stat_file, value, "rb");
+    if (cfg->input_stat_file) map_input_stat_file(cfg);
 };
 static void set_output_stat_file(const char *value, EbConfig *cfg) {
     if (cfg->output_stat_file) { fclose(cfg->output_stat_file); }
@@ -236,6 +307,9 @@ static void set_output_stat_file(const char *value, EbConfig *cfg) {
 static void set_snd_pass_enc_mode(const char *value, EbConfig *cfg) {
     cfg->snd_pass_enc_mode = (uint8_t)strtoul(value, NULL, 0);
 };
+static void set_lookahead_pass(const char *value, EbConfig *cfg) {
+    cfg->enable_lookahead_pass = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_cfg_stat_file(const char *value, EbConfig *cfg) {
     if (cfg->stat_file) { fclose(cfg->stat_file); }
     FOPEN(cfg->stat_file, value, "wb");
@@ -293,16 +367,26 @@ static void set_cfg_intra_refresh_type(const char *value, EbConfig *cfg) {
 static void set_hierarchical_levels(const char *value, EbConfig *cfg) {
     cfg->hierarchical_levels = strtol(value, NULL, 0);
 };
+static void set_adaptive_mini_gop(const char *value, EbConfig *cfg) {
+    cfg->adaptive_mini_gop = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_cfg_pred_structure(const char *value, EbConfig *cfg) {
     cfg->pred_structure = strtol(value, NULL, 0);
 };
+static void set_real_time_mode(const char *value, EbConfig *cfg) {
+    cfg->real_time_mode = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_cfg_qp(const char *value, EbConfig *cfg) { cfg->qp = strtoul(value, NULL, 0); };
+static void set_cfg_crf(const char *value, EbConfig *cfg) { cfg->crf = strtol(value, NULL, 0); };
 static void set_cfg_use_qp_file(const char *value, EbConfig *cfg) {
     cfg->use_qp_file = (EbBool)strtol(value, NULL, 0);
 };
 static void set_cfg_film_grain(const char *value, EbConfig *cfg) {
     cfg->film_grain_denoise_strength = strtol(value, NULL, 0);
 }; //not bool to enable possible algorithm extension in the future
+static void set_cfg_fast_film_grain(const char *value, EbConfig *cfg) {
+    cfg->fast_film_grain = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_disable_dlf_flag(const char *value, EbConfig *cfg) {
     cfg->disable_dlf_flag = (EbBool)strtoul(value, NULL, 0);
 };
@@ -418,6 +502,9 @@ static void set_scene_change_detection(const char *value, EbConfig *cfg) {
 static void set_look_ahead_distance(const char *value, EbConfig *cfg) {
     cfg->look_ahead_distance = strtoul(value, NULL, 0);
 };
+static void set_enable_tpl_la(const char *value, EbConfig *cfg) {
+    cfg->enable_tpl_la = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_rate_control_mode(const char *value, EbConfig *cfg) {
     cfg->rate_control_mode = strtoul(value, NULL, 0);
 };
@@ -427,6 +514,18 @@ static void set_target_bit_rate(const char *value, EbConfig *cfg) {
 static void set_vbv_buf_size(const char *value, EbConfig *cfg) {
     cfg->vbv_bufsize = 1000 * strtoul(value, NULL, 0);
 };
+static void set_vbv_mode(const char *value, EbConfig *cfg) {
+    cfg->vbv_mode = strtoul(value, NULL, 0);
+};
+static void set_vbv_maxrate(const char *value, EbConfig *cfg) {
+    cfg->vbv_maxrate = 1000 * strtoul(value, NULL, 0);
+};
+static void set_vbv_init(const char *value, EbConfig *cfg) {
+    cfg->vbv_init = strtoul(value, NULL, 0);
+};
+static void set_max_frame_size(const char *value, EbConfig *cfg) {
+    cfg->max_frame_size = 1000 * strtoul(value, NULL, 0);
+};
 static void set_max_qp_allowed(const char *value, EbConfig *cfg) {
     cfg->max_qp_allowed = strtoul(value, NULL, 0);
 };
@@ -506,6 +605,9 @@ static void set_altref_strength(const char *value, EbConfig *cfg) {
 static void set_altref_n_frames(const char *value, EbConfig *cfg) {
     cfg->altref_nframes = (uint8_t)strtoul(value, NULL, 0);
 };
+static void set_adaptive_altref(const char *value, EbConfig *cfg) {
+    cfg->adaptive_altref = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_enable_overlays(const char *value, EbConfig *cfg) {
     cfg->enable_overlays = (EbBool)strtoul(value, NULL, 0);
 };
@@ -613,6 +715,9 @@ static void set_unpin_single_core_execution(const char *value, EbConfig *cfg) {
 static void set_target_socket(const char *value, EbConfig *cfg) {
     cfg->target_socket = (int32_t)strtol(value, NULL, 0);
 };
+static void set_chunk_count(const char *value, EbConfig *cfg) {
+    cfg->chunk_count = strtoul(value, NULL, 0);
+};
 static void set_unrestricted_motion_vector(const char *value, EbConfig *cfg) {
     cfg->unrestricted_motion_vector = (EbBool)strtol(value, NULL, 0);
 };
@@ -696,10 +801,18 @@ ConfigEntry config_entry_global_options[] = {
     {SINGLE_INPUT, ENCODER_BIT_DEPTH, "Bit depth for codec(8 or 10)", set_encoder_bit_depth},
     //{SINGLE_INPUT, LEVEL_TOKEN, "Level", set_level},
     {SINGLE_INPUT, HIERARCHICAL_LEVELS_TOKEN, "Set hierarchical levels(3 or 4[default])", set_hierarchical_levels},
+    {SINGLE_INPUT,
+     ADAPTIVE_MINI_GOP_TOKEN,
+     "Adaptive mini GOP size, from 4 to 2^hierarchical levels pictures (0: OFF[default], 1: ON)",
+     set_adaptive_mini_gop},
     {SINGLE_INPUT,
      PRED_STRUCT_TOKEN,
      "Set prediction structure( 0: low delay P, 1: low delay B, 2: random access [default])",
      set_cfg_pred_structure},
+    {SINGLE_INPUT,
+     REAL_TIME_TOKEN,
+     "Real time mode: flat structure, no look ahead, each picture output once coded (0: OFF[default], 1: ON)",
+     set_real_time_mode},
     {SINGLE_INPUT, HDR_INPUT_TOKEN, "Enable high dynamic range(0: OFF[default], ON: 1)", set_high_dynamic_range_input},
     // Asm Type
     {SINGLE_INPUT,
@@ -714,6 +827,10 @@ ConfigEntry config_entry_global_options[] = {
      "specific mask( 0: OFF ,1: ON[default]) ",
      set_unpin_single_core_execution},
     {SINGLE_INPUT, TARGET_SOCKET, "Specify  which socket the encoder runs on", set_target_socket},
+    {SINGLE_INPUT,
+     CHUNK_COUNT_TOKEN,
+     "Split the input into n IDR aligned chunks encoded in parallel (VBR shares its budget)",
+     set_chunk_count},
     // Termination
     {SINGLE_INPUT, NULL, NULL, NULL}};
 
@@ -729,6 +846,16 @@ ConfigEntry config_entry_rc[] = {
      "Overwrite QP assignment using qp values in QP file",
      set_cfg_use_qp_file},
     {SINGLE_INPUT, QP_FILE_TOKEN, "Path to Qp file", set_cfg_qp_file},
+    {SINGLE_INPUT,
+     ROI_MAP_FILE_TOKEN,
+     "Path to the region of interest map file (one line per picture, one delta qp per 64x64 "
+     "block, suffixed by s for a static block)",
+     set_cfg_roi_map_file},
+    {SINGLE_INPUT,
+     SCENE_CHANGE_DETECTION_TOKEN,
+     "Scene change detection(0 = OFF, 1 = histogram, 2 = sliding window with flash/fade "
+     "detection)",
+     set_scene_change_detection},
     {SINGLE_INPUT, MAX_QP_TOKEN, "Maximum (worst) quantizer[0-63]", set_max_qp_allowed},
     {SINGLE_INPUT, MIN_QP_TOKEN, "Minimum (best) quantizer[0-63]", set_min_qp_allowed},
     {SINGLE_INPUT,
@@ -736,6 +863,13 @@ ConfigEntry config_entry_rc[] = {
      "Set adaptive QP level(0: OFF ,1: variance base using segments ,2: Deltaq pred efficiency)",
      set_adaptive_quantization},
     {SINGLE_INPUT, VBV_BUFSIZE_TOKEN, "VBV buffer size", set_vbv_buf_size},
+    {SINGLE_INPUT,
+     VBV_MODE_TOKEN,
+     "VBV decoder buffer model (0: OFF[default], 1: VBR, 2: CBR with padding)",
+     set_vbv_mode},
+    {SINGLE_INPUT, VBV_MAXRATE_TOKEN, "VBV buffer fill rate in kbps (0: TargetBitRate)", set_vbv_maxrate},
+    {SINGLE_INPUT, VBV_INIT_TOKEN, "VBV initial buffer fullness in percent", set_vbv_init},
+    {SINGLE_INPUT, MAX_FRAME_SIZE_TOKEN, "Maximum temporal unit size in kbits (0: no cap)", set_max_frame_size},
     // Termination
     {SINGLE_INPUT, NULL, NULL, NULL}};
 ConfigEntry config_entry_2p[] = {
@@ -749,6 +883,11 @@ ConfigEntry config_entry_2p[] = {
      ENCMODE2P_TOKEN,
      "Use Hme/Me settings of the second pass'encoder mode in the first pass",
      set_snd_pass_enc_mode},
+    {SINGLE_INPUT,
+     LOOKAHEAD_PASS_TOKEN,
+     "Derive the 2 pass statistics from the lookahead window instead of a first pass (0: OFF "
+     "[default], 1: ON)",
+     set_lookahead_pass},
     // Termination
     {SINGLE_INPUT, NULL, NULL, NULL}};
 ConfigEntry config_entry_intra_refresh[] = {
@@ -773,10 +912,18 @@ ConfigEntry config_entry_specific[] = {
     {SINGLE_INPUT, TILE_ROW_TOKEN, "Number of tile rows to use, log2[0-6]", set_tile_row},
     {SINGLE_INPUT, TILE_COL_TOKEN, "Number of tile columns to use, log2[0-6]", set_tile_col},
     {SINGLE_INPUT, QP_TOKEN, "Constant/Constrained Quality level", set_cfg_qp},
+    {SINGLE_INPUT,
+     CRF_TOKEN,
+     "Constant rate factor quality level[0-63], -1: OFF[default] (with -rc 0, overrides -q)",
+     set_cfg_crf},
     {SINGLE_INPUT,
      LOOK_AHEAD_DIST_TOKEN,
      "When RC is ON , it is best to set this parameter to be equal to the intra period value",
      set_look_ahead_distance},
+    {SINGLE_INPUT,
+     ENABLE_TPL_LA_TOKEN,
+     "Temporal dependency model over the look ahead window for the QP assignment (0: OFF[default], 1: ON)",
+     set_enable_tpl_la},
     // DLF
     {SINGLE_INPUT,
      LOOP_FILTER_DISABLE_TOKEN,
@@ -784,7 +931,9 @@ ConfigEntry config_entry_specific[] = {
      set_disable_dlf_flag},
     // CDEF
     {SINGLE_INPUT,
-        CDEF_MODE_TOKEN, "CDEF Mode (0: OFF, 1-5: ON with 2,4,8,16,64 step refinement, -1: DEFAULT)",
+        CDEF_MODE_TOKEN,
+        "CDEF Mode (0: OFF, 1-5: ON with 2,4,8,16,64 step refinement, 6: ON with fast search, -1: "
+        "DEFAULT)",
         set_cdef_mode},
     // RESTORATION
     {SINGLE_INPUT,
@@ -793,7 +942,8 @@ ConfigEntry config_entry_specific[] = {
      set_enable_restoration_filter_flag},
     {SINGLE_INPUT,
         SG_FILTER_MODE_TOKEN,
-        "Self-guided filter mode (0:OFF, 1: step 0, 2: step 1, 3: step 4, 4: step 16, -1: DEFAULT)",
+        "Self-guided filter mode (0:OFF, 1: step 0, 2: step 1, 3: step 4, 4: step 16, 5: step 16 "
+        "coarse to fine, -1: DEFAULT)",
         set_sg_filter_mode},
     {SINGLE_INPUT,
         WN_FILTER_MODE_TOKEN,
@@ -1006,11 +1156,20 @@ ConfigEntry config_entry_specific[] = {
      SPEED_CONTROL_TOKEN,
      "Enable speed control(0: OFF[default], 1: ON)",
      speed_control_flag},
+    {SINGLE_INPUT,
+     SUPERRES_MODE_INPUT,
+     "Set superres mode(0: OFF[default], 1: fixed, 2: random, 4: auto, intra frames are coded at "
+     "a reduced width when speed control cannot keep up at the fastest preset)",
+     set_superres_mode},
     // Annex A parameters
     {SINGLE_INPUT,
      FILM_GRAIN_TOKEN,
      "Enable film grain(0: OFF[default], 1: ON)",
      set_cfg_film_grain},
+    {SINGLE_INPUT,
+     FAST_FILM_GRAIN_TOKEN,
+     "Fast film grain, grain estimated on key frames and scene cuts only (0: OFF[default], 1: ON)",
+     set_cfg_fast_film_grain},
     // HME
     {ARRAY_INPUT,
      HME_LEVEL0_WIDTH,
@@ -1039,7 +1198,11 @@ ConfigEntry config_entry_specific[] = {
     // --- start: ALTREF_FILTERING_SUPPORT
     {SINGLE_INPUT, ENABLE_ALTREFS, "Enable automatic alt reference frames(0: OFF, 1: ON[default])", set_enable_altrefs},
     {SINGLE_INPUT, ALTREF_STRENGTH, "AltRef filter strength([0-6], default: 5)", set_altref_strength},
-    {SINGLE_INPUT, ALTREF_NFRAMES, "AltRef max frames([0-10], default: 7)", set_altref_n_frames},
+    {SINGLE_INPUT, ALTREF_NFRAMES, "AltRef max frames([0-15], default: 7)", set_altref_n_frames},
+    {SINGLE_INPUT,
+     ADAPTIVE_ALTREF_TOKEN,
+     "Adaptive AltRef window, neighbor frames selected per 32x32 block (0: OFF[default], 1: ON)",
+     set_adaptive_altref},
     {SINGLE_INPUT, ENABLE_OVERLAYS, "Enable the insertion of an extra picture called overlayer picture which will be used as an extra reference frame for the base-layer picture(0: OFF[default], 1: ON)", set_enable_overlays},
     // --- end: ALTREF_FILTERING_SUPPORT
     {SINGLE_INPUT, SQ_WEIGHT_TOKEN, "Determines if HA, HB, VA, VB, H4 and V4 shapes could be skipped based on the cost of SQ, H and V shapes([75-100], default: 100)", set_square_weight},
@@ -1069,6 +1232,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, ERROR_FILE_TOKEN, "ErrorFile", set_cfg_error_file},
     {SINGLE_INPUT, OUTPUT_RECON_TOKEN, "ReconFile", set_cfg_recon_file},
     {SINGLE_INPUT, QP_FILE_TOKEN, "QpFile", set_cfg_qp_file},
+    {SINGLE_INPUT, ROI_MAP_FILE_TOKEN, "RoiMapFile", set_cfg_roi_map_file},
     {SINGLE_INPUT, STAT_FILE_TOKEN, "StatFile", set_cfg_stat_file},
     {SINGLE_INPUT, INPUT_STAT_FILE_TOKEN, "input_stat_file", set_input_stat_file},
     {SINGLE_INPUT, OUTPUT_STAT_FILE_TOKEN, "output_stat_file", set_output_stat_file},
@@ -1081,6 +1245,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "BufferedInput", set_buffered_input},
     {SINGLE_INPUT, ENCMODE_TOKEN, "EncoderMode", set_enc_mode},
     {SINGLE_INPUT, ENCMODE2P_TOKEN, "EncoderMode2p", set_snd_pass_enc_mode},
+    {SINGLE_INPUT, LOOKAHEAD_PASS_TOKEN, "LookaheadPass", set_lookahead_pass},
     {SINGLE_INPUT, INTRA_PERIOD_TOKEN, "IntraPeriod", set_cfg_intra_period},
     {SINGLE_INPUT, INTRA_REFRESH_TYPE_TOKEN, "IntraRefreshType", set_cfg_intra_refresh_type},
     {SINGLE_INPUT, FRAME_RATE_TOKEN, "FrameRate", set_frame_rate},
@@ -1098,6 +1263,8 @@ ConfigEntry config_entry[] = {
      set_compressed_ten_bit_format},
     {SINGLE_INPUT, HIERARCHICAL_LEVELS_TOKEN, "HierarchicalLevels", set_hierarchical_levels},
     {SINGLE_INPUT, PRED_STRUCT_TOKEN, "PredStructure", set_cfg_pred_structure},
+    {SINGLE_INPUT, REAL_TIME_TOKEN, "RealTime", set_real_time_mode},
+    {SINGLE_INPUT, ADAPTIVE_MINI_GOP_TOKEN, "AdaptiveMiniGop", set_adaptive_mini_gop},
     {SINGLE_INPUT, TILE_ROW_TOKEN, "TileRow", set_tile_row},
     {SINGLE_INPUT, TILE_COL_TOKEN, "TileCol", set_tile_col},
     // Rate Control
@@ -1106,14 +1273,20 @@ ConfigEntry config_entry[] = {
      "SceneChangeDetection",
      set_scene_change_detection},
     {SINGLE_INPUT, QP_TOKEN, "QP", set_cfg_qp},
+    {SINGLE_INPUT, CRF_TOKEN, "CRF", set_cfg_crf},
     {SINGLE_INPUT, USE_QP_FILE_TOKEN, "UseQpFile", set_cfg_use_qp_file},
     {SINGLE_INPUT, STAT_REPORT_TOKEN, "StatReport", set_stat_report},
     {SINGLE_INPUT, RATE_CONTROL_ENABLE_TOKEN, "RateControlMode", set_rate_control_mode},
     {SINGLE_INPUT, LOOK_AHEAD_DIST_TOKEN, "LookAheadDistance", set_look_ahead_distance},
+    {SINGLE_INPUT, ENABLE_TPL_LA_TOKEN, "EnableTplLA", set_enable_tpl_la},
     {SINGLE_INPUT, TARGET_BIT_RATE_TOKEN, "TargetBitRate", set_target_bit_rate},
     {SINGLE_INPUT, MAX_QP_TOKEN, "MaxQpAllowed", set_max_qp_allowed},
     {SINGLE_INPUT, MIN_QP_TOKEN, "MinQpAllowed", set_min_qp_allowed},
     {SINGLE_INPUT, VBV_BUFSIZE_TOKEN, "VBVBufSize", set_vbv_buf_size},
+    {SINGLE_INPUT, VBV_MODE_TOKEN, "VBVMode", set_vbv_mode},
+    {SINGLE_INPUT, VBV_MAXRATE_TOKEN, "VBVMaxRate", set_vbv_maxrate},
+    {SINGLE_INPUT, VBV_INIT_TOKEN, "VBVInit", set_vbv_init},
+    {SINGLE_INPUT, MAX_FRAME_SIZE_TOKEN, "MaxFrameSize", set_max_frame_size},
     {SINGLE_INPUT, ADAPTIVE_QP_ENABLE_TOKEN, "AdaptiveQuantization", set_adaptive_quantization},
 
     // DLF
@@ -1224,6 +1397,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, THREAD_MGMNT, "LogicalProcessors", set_logical_processors},
     {SINGLE_INPUT, UNPIN_LP1_TOKEN, "UnpinSingleCoreExecution", set_unpin_single_core_execution},
     {SINGLE_INPUT, TARGET_SOCKET, "TargetSocket", set_target_socket},
+    {SINGLE_INPUT, CHUNK_COUNT_TOKEN, "ChunkCount", set_chunk_count},
     // Optional Features
     {SINGLE_INPUT,
      UNRESTRICTED_MOTION_VECTOR,
@@ -1242,6 +1416,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, LEVEL_TOKEN, "Level", set_level},
     {SINGLE_INPUT, LATENCY_MODE, "LatencyMode", set_latency_mode},
     {SINGLE_INPUT, FILM_GRAIN_TOKEN, "FilmGrain", set_cfg_film_grain},
+    {SINGLE_INPUT, FAST_FILM_GRAIN_TOKEN, "FastFilmGrain", set_cfg_fast_film_grain},
     // Asm Type
     {SINGLE_INPUT, ASM_TYPE_TOKEN, "Asm", set_asm_type},
     // HME
@@ -1273,6 +1448,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, ENABLE_ALTREFS, "EnableAltRefs", set_enable_altrefs},
     {SINGLE_INPUT, ALTREF_STRENGTH, "AltRefStrength", set_altref_strength},
     {SINGLE_INPUT, ALTREF_NFRAMES, "AltRefNframes", set_altref_n_frames},
+    {SINGLE_INPUT, ADAPTIVE_ALTREF_TOKEN, "AdaptiveAltRef", set_adaptive_altref},
     {SINGLE_INPUT, ENABLE_OVERLAYS, "EnableOverlays", set_enable_overlays},
     // --- end: ALTREF_FILTERING_SUPPORT
     // Super-resolution support
@@ -1303,9 +1479,12 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->buffered_input       = -1;
 
     config_ptr->qp                  = 50;
+    config_ptr->crf                 = -1;
     config_ptr->use_qp_file         = EB_FALSE;
     config_ptr->look_ahead_distance = (uint32_t)~0;
+    config_ptr->enable_tpl_la       = EB_FALSE;
     config_ptr->target_bit_rate     = 7000000;
+    config_ptr->vbv_init            = 90;
     config_ptr->max_qp_allowed      = 63;
     config_ptr->min_qp_allowed      = 10;
 
@@ -1316,6 +1495,8 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->intra_refresh_type                        = 1;
     config_ptr->hierarchical_levels                       = 4;
     config_ptr->pred_structure                            = 2;
+    config_ptr->real_time_mode                            = EB_FALSE;
+    config_ptr->adaptive_mini_gop                         = EB_FALSE;
     config_ptr->enable_global_motion                      = EB_TRUE;
     config_ptr->enable_warped_motion                      = DEFAULT;
     config_ptr->cdef_mode                                 = DEFAULT;
@@ -1387,6 +1568,7 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->enable_altrefs  = EB_TRUE;
     config_ptr->altref_strength = 5;
     config_ptr->altref_nframes  = 7;
+    config_ptr->adaptive_altref = EB_FALSE;
     // --- end: ALTREF_FILTERING_SUPPORT
 
     // start - super-resolution support
@@ -1420,6 +1602,8 @@ void eb_config_dtor(EbConfig *config_ptr) {
         if (!config_ptr->input_file_is_fifo) fclose(config_ptr->input_file);
         config_ptr->input_file = (FILE *)NULL;
     }
+    free(config_ptr->input_file_name);
+    config_ptr->input_file_name = NULL;
 
     if (config_ptr->bitstream_file) {
         fclose(config_ptr->bitstream_file);
@@ -1441,10 +1625,16 @@ void eb_config_dtor(EbConfig *config_ptr) {
         config_ptr->qp_file = (FILE *)NULL;
     }
 
+    if (config_ptr->roi_map_file) {
+        fclose(config_ptr->roi_map_file);
+        config_ptr->roi_map_file = (FILE *)NULL;
+    }
+
     if (config_ptr->stat_file) {
         fclose(config_ptr->stat_file);
         config_ptr->stat_file = (FILE *)NULL;
     }
+    unmap_input_stat_file(config_ptr);
     if (config_ptr->input_stat_file) {
         fclose(config_ptr->input_stat_file);
         config_ptr->input_stat_file = (FILE *)NULL;
@@ -1914,6 +2104,98 @@ int32_t compute_frames_to_be_encoded(EbConfig *config) {
     return frame_count;
 }
 
+/**********************************
+ * Split into Chunks
+ *   Splits the input of configs[0] into up to max_chunks chunks made of whole
+ *   GOPs (the chunks start with an IDR frame), configs[1..] being constructed
+ *   configs receiving a copy of the settings of configs[0]. Each chunk reads
+ *   its own part of the input and chunks k > 0 write to a temporary file to be
+ *   appended to the output of chunk 0 once encoded. Returns the number of
+ *   chunks, 0 on error.
+ **********************************/
+uint32_t split_into_chunks(EbConfig **configs, uint32_t max_chunks) {
+    EbConfig *config = configs[0];
+
+    if (!config->input_file || config->input_file == stdin || config->input_file_is_fifo ||
+        !config->input_file_name) {
+        fprintf(config->error_log_file, "Error: chunked encoding requires a seekable input file\n");
+        return 0;
+    }
+    if (config->intra_period < 0) {
+        fprintf(config->error_log_file, "Error: chunked encoding requires an explicit intra period\n");
+        return 0;
+    }
+    if (config->buffered_input != -1 || config->compressed_ten_bit_format ||
+        config->use_input_stat_file || config->use_output_stat_file ||
+        config->frames_to_be_encoded <= 0) {
+        fprintf(config->error_log_file,
+                "Error: chunked encoding does not support buffered, compressed 10 bit or "
+                "2 pass inputs\n");
+        return 0;
+    }
+    if (config->roi_map_file) {
+        fprintf(config->error_log_file,
+                "Error: chunked encoding does not support region of interest maps\n");
+        return 0;
+    }
+
+    const uint64_t gop_size     = (uint64_t)config->intra_period + 1;
+    const uint64_t gop_count    = (config->frames_to_be_encoded + gop_size - 1) / gop_size;
+    const uint64_t chunk_frames = (gop_count + max_chunks - 1) / max_chunks * gop_size;
+    const uint32_t chunk_count =
+        (uint32_t)((config->frames_to_be_encoded + chunk_frames - 1) / chunk_frames);
+
+    uint64_t frame_size = config->input_padded_width * config->input_padded_height; // Luma
+    frame_size += 2 * (frame_size >> (3 - config->encoder_color_format)); // Add Chroma
+    frame_size = frame_size << ((config->encoder_bit_depth == 10) ? 1 : 0);
+    if (config->y4m_input) frame_size += 6; // "FRAME\n" delimiter
+    // past the y4m header
+    const uint64_t data_offset  = ftello(config->input_file);
+    const int64_t  total_frames = config->frames_to_be_encoded;
+
+    if (config->rate_control_mode == 1 && chunk_count > 1 &&
+        eb_svt_enc_create_shared_rc(&config->shared_rc) != EB_ErrorNone)
+        return 0;
+    // every chunk starts with a frame that can be decoded on its own
+    config->intra_refresh_type = 2;
+
+    for (uint32_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+        EbConfig *     chunk       = configs[chunk_index];
+        const uint64_t first_frame = chunk_index * chunk_frames;
+
+        if (chunk_index) {
+            *chunk = *config;
+            // files owned by chunk 0
+            chunk->config_file            = NULL;
+            chunk->recon_file             = NULL;
+            chunk->stat_file              = NULL;
+            chunk->buffer_file            = NULL;
+            chunk->qp_file                = NULL;
+            chunk->input_stat_file        = NULL;
+            chunk->output_stat_file       = NULL;
+            chunk->input_stat_buffer      = NULL;
+            chunk->input_stat_mapping     = NULL;
+            chunk->input_pred_struct_file = NULL;
+            chunk->input_file_name        = NULL;
+            chunk->error_log_file         = stderr;
+            chunk->bitstream_file         = config->bitstream_file ? tmpfile() : NULL;
+            FOPEN(chunk->input_file, config->input_file_name, "rb");
+            if (!chunk->input_file || (config->bitstream_file && !chunk->bitstream_file)) {
+                fprintf(stderr, "Error: could not open the files of chunk %u\n", chunk_index + 1);
+                return 0;
+            }
+        }
+        chunk->chunk_index          = chunk_index;
+        chunk->chunk_count          = chunk_count;
+        chunk->ivf_count            = first_frame;
+        chunk->frames_to_be_encoded = total_frames - (int64_t)first_frame < (int64_t)chunk_frames
+                                          ? total_frames - (int64_t)first_frame
+                                          : (int64_t)chunk_frames;
+        fseeko(chunk->input_file, (int64_t)(data_offset + first_frame * frame_size), SEEK_SET);
+    }
+    return chunk_count;
+}
+
 /**********************************
 * Parse Pred Struct File
 **********************************/
@@ -150,6 +150,7 @@ typedef struct EbConfig {
      ****************************************/
     FILE *        config_file;
     FILE *        input_file;
+    char *        input_file_name;
     EbBool        input_file_is_fifo;
     FILE *        bitstream_file;
     FILE *        recon_file;
@@ -157,8 +158,14 @@ typedef struct EbConfig {
     FILE *        stat_file;
     FILE *        buffer_file;
     FILE *        qp_file;
+    FILE *        roi_map_file;
+    int8_t *      roi_delta_qp; // region of interest map of the next picture (roi_map_file)
+    uint8_t *     roi_static_hint;
     FILE *        input_stat_file;
     FILE *        output_stat_file;
+    const uint8_t *input_stat_buffer; // input_stat_file mapped in memory
+    uint64_t      input_stat_buffer_size;
+    void *        input_stat_mapping;
     FILE *        input_pred_struct_file;
     EbBool        use_input_stat_file;
     EbBool        use_output_stat_file;
@@ -194,20 +201,25 @@ typedef struct EbConfig {
      *****************************************/
     uint8_t  enc_mode;
     uint8_t  snd_pass_enc_mode;
+    EbBool   enable_lookahead_pass;
     int32_t  intra_period;
     uint32_t intra_refresh_type;
     uint32_t hierarchical_levels;
+    EbBool   adaptive_mini_gop;
     uint32_t pred_structure;
+    EbBool   real_time_mode;
 
     /****************************************
      * Quantization
      ****************************************/
     uint32_t qp;
+    int32_t  crf;
 
     /****************************************
      * Film Grain
      ****************************************/
     uint32_t film_grain_denoise_strength;
+    EbBool   fast_film_grain;
     /****************************************
      * DLF
      ****************************************/
@@ -406,10 +418,15 @@ typedef struct EbConfig {
     uint32_t scene_change_detection;
     uint32_t rate_control_mode;
     uint32_t look_ahead_distance;
+    EbBool   enable_tpl_la;
     uint32_t target_bit_rate;
     uint32_t max_qp_allowed;
     uint32_t min_qp_allowed;
     uint32_t vbv_bufsize;
+    uint32_t vbv_mode;
+    uint32_t vbv_maxrate;
+    uint32_t vbv_init;
+    uint32_t max_frame_size;
 
     EbBool enable_adaptive_quantization;
 
@@ -460,6 +477,13 @@ typedef struct EbConfig {
     uint64_t byte_count_since_ivf;
     uint64_t ivf_count;
 
+    /****************************************
+     * Chunked encoding
+     ****************************************/
+    uint32_t             chunk_count; // number of IDR aligned chunks encoded in parallel
+    uint32_t             chunk_index;
+    EbSharedRateControl *shared_rc;
+
     // --- start: ALTREF_FILTERING_SUPPORT
     /****************************************
      * ALT-REF related Parameters
@@ -467,6 +491,7 @@ typedef struct EbConfig {
     EbBool  enable_altrefs;
     uint8_t altref_strength;
     uint8_t altref_nframes;
+    EbBool  adaptive_altref;
     EbBool  enable_overlays;
     // --- end: ALTREF_FILTERING_SUPPORT
 
@@ -500,5 +525,6 @@ extern EbErrorType read_command_line(int32_t argc, char *const argv[], EbConfig
                                      uint32_t num_channels, EbErrorType *return_errors);
 extern uint32_t    get_help(int32_t argc, char *const argv[]);
 extern uint32_t    get_number_of_channels(int32_t argc, char *const argv[]);
+extern uint32_t    split_into_chunks(EbConfig **configs, uint32_t max_chunks);
 
 #endif //EbAppConfig_h
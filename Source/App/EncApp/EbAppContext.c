@@ -95,27 +95,40 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.intra_refresh_type     = config->intra_refresh_type;
     callback_data->eb_enc_parameters.enc_mode               = (EbBool)config->enc_mode;
     callback_data->eb_enc_parameters.snd_pass_enc_mode      = (EbBool)config->snd_pass_enc_mode;
+    callback_data->eb_enc_parameters.enable_lookahead_pass  = config->enable_lookahead_pass;
     callback_data->eb_enc_parameters.frame_rate             = config->frame_rate;
     callback_data->eb_enc_parameters.frame_rate_denominator = config->frame_rate_denominator;
     callback_data->eb_enc_parameters.frame_rate_numerator   = config->frame_rate_numerator;
     callback_data->eb_enc_parameters.hierarchical_levels    = config->hierarchical_levels;
     callback_data->eb_enc_parameters.pred_structure         = (uint8_t)config->pred_structure;
+    callback_data->eb_enc_parameters.real_time_mode         = config->real_time_mode;
+    callback_data->eb_enc_parameters.adaptive_mini_gop      = config->adaptive_mini_gop;
     callback_data->eb_enc_parameters.ext_block_flag         = config->ext_block_flag;
     callback_data->eb_enc_parameters.tile_rows              = config->tile_rows;
     callback_data->eb_enc_parameters.tile_columns           = config->tile_columns;
     callback_data->eb_enc_parameters.scene_change_detection = config->scene_change_detection;
     callback_data->eb_enc_parameters.look_ahead_distance    = config->look_ahead_distance;
+    callback_data->eb_enc_parameters.enable_tpl_la          = config->enable_tpl_la;
     callback_data->eb_enc_parameters.rate_control_mode      = config->rate_control_mode;
     callback_data->eb_enc_parameters.target_bit_rate        = config->target_bit_rate;
     callback_data->eb_enc_parameters.max_qp_allowed         = config->max_qp_allowed;
     callback_data->eb_enc_parameters.min_qp_allowed         = config->min_qp_allowed;
     callback_data->eb_enc_parameters.vbv_bufsize            = config->vbv_bufsize;
+    callback_data->eb_enc_parameters.vbv_mode               = config->vbv_mode;
+    callback_data->eb_enc_parameters.vbv_maxrate            = config->vbv_maxrate;
+    callback_data->eb_enc_parameters.vbv_init               = config->vbv_init;
+    callback_data->eb_enc_parameters.max_frame_size         = config->max_frame_size;
     callback_data->eb_enc_parameters.enable_adaptive_quantization =
         (EbBool)config->enable_adaptive_quantization;
     callback_data->eb_enc_parameters.qp                   = config->qp;
+    callback_data->eb_enc_parameters.crf                  = config->crf;
     callback_data->eb_enc_parameters.use_qp_file          = (EbBool)config->use_qp_file;
+    callback_data->eb_enc_parameters.enable_roi_map       = config->roi_map_file != NULL;
     callback_data->eb_enc_parameters.input_stat_file      = config->input_stat_file;
     callback_data->eb_enc_parameters.output_stat_file     = config->output_stat_file;
+    callback_data->eb_enc_parameters.input_stat_buffer    = config->input_stat_buffer;
+    callback_data->eb_enc_parameters.input_stat_buffer_size = config->input_stat_buffer_size;
+    callback_data->eb_enc_parameters.shared_rc            = config->shared_rc;
     callback_data->eb_enc_parameters.stat_report          = (EbBool)config->stat_report;
     callback_data->eb_enc_parameters.disable_dlf_flag     = (EbBool)config->disable_dlf_flag;
     callback_data->eb_enc_parameters.enable_warped_motion = config->enable_warped_motion;
@@ -186,6 +199,9 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.level                     = config->level;
     callback_data->eb_enc_parameters.injector_frame_rate       = config->injector_frame_rate;
     callback_data->eb_enc_parameters.speed_control_flag        = config->speed_control_flag;
+    callback_data->eb_enc_parameters.film_grain_denoise_strength =
+        config->film_grain_denoise_strength;
+    callback_data->eb_enc_parameters.fast_film_grain           = config->fast_film_grain;
     callback_data->eb_enc_parameters.use_cpu_flags             = config->cpu_flags_limit;
     callback_data->eb_enc_parameters.logical_processors        = config->logical_processors;
     callback_data->eb_enc_parameters.unpin_lp1                 = config->unpin_lp1;
@@ -197,6 +213,7 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.enable_altrefs  = (EbBool)config->enable_altrefs;
     callback_data->eb_enc_parameters.altref_strength = config->altref_strength;
     callback_data->eb_enc_parameters.altref_nframes  = config->altref_nframes;
+    callback_data->eb_enc_parameters.adaptive_altref = config->adaptive_altref;
     callback_data->eb_enc_parameters.enable_overlays = (EbBool)config->enable_overlays;
     // --- end: ALTREF_FILTERING_SUPPORT
     // --- start: SUPER-RESOLUTION SUPPORT
@@ -345,6 +362,21 @@ EbErrorType allocate_input_buffers(EbConfig *config, EbAppContext *callback_data
     if (config->buffered_input == -1)
         allocate_frame_buffer(config, callback_data->input_buffer_pool->p_buffer);
 
+    // Region of interest map, one entry per 64x64 block
+    callback_data->input_buffer_pool->roi_delta_qp    = NULL;
+    callback_data->input_buffer_pool->roi_static_hint = NULL;
+    if (config->roi_map_file) {
+        const size_t roi_map_size =
+            ((config->source_width + 63) / 64) * ((config->source_height + 63) / 64);
+        EB_APP_MALLOC(
+            int8_t *, config->roi_delta_qp, roi_map_size, EB_N_PTR, EB_ErrorInsufficientResources);
+        EB_APP_MALLOC(uint8_t *,
+                      config->roi_static_hint,
+                      roi_map_size,
+                      EB_N_PTR,
+                      EB_ErrorInsufficientResources);
+    }
+
     // Assign the variables
     callback_data->input_buffer_pool->p_app_private = NULL;
     callback_data->input_buffer_pool->pic_type      = EB_AV1_INVALID_PICTURE;
@@ -71,6 +71,22 @@ void assign_app_thread_group(uint8_t target_socket) {
 
 double get_psnr(double sse, double max);
 
+/***************************************
+ * Append the bitstreams of the chunks k > 0 to the one of chunk 0
+ ***************************************/
+static void stitch_chunks(EbConfig **configs, uint32_t num_channels) {
+    uint8_t buffer[1 << 16];
+    if (!configs[0]->bitstream_file) return;
+    for (uint32_t inst_cnt = 1; inst_cnt < num_channels; ++inst_cnt) {
+        FILE *chunk_file = configs[inst_cnt]->bitstream_file;
+        size_t size;
+        if (!chunk_file) continue;
+        rewind(chunk_file);
+        while ((size = fread(buffer, 1, sizeof(buffer), chunk_file)) > 0)
+            fwrite(buffer, 1, size, configs[0]->bitstream_file);
+    }
+}
+
 /***************************************
  * Encoder App Main
  ***************************************/
@@ -134,6 +150,35 @@ int32_t main(int32_t argc, char *argv[]) {
         // Read all configuration files.
         return_error = read_command_line(argc, argv, configs, num_channels, return_errors);
 
+        // Chunked encoding: one channel per chunk of the input
+        if (return_error == EB_ErrorNone && num_channels == 1 && configs[0]->chunk_count > 1) {
+            const uint32_t max_chunks = configs[0]->chunk_count < MAX_CHANNEL_NUMBER
+                                            ? configs[0]->chunk_count
+                                            : MAX_CHANNEL_NUMBER;
+            uint32_t       chunk_count;
+            for (inst_cnt = 1; inst_cnt < max_chunks; ++inst_cnt) {
+                configs[inst_cnt]       = (EbConfig *)malloc(sizeof(EbConfig));
+                app_callbacks[inst_cnt] = (EbAppContext *)malloc(sizeof(EbAppContext));
+                if (!configs[inst_cnt] || !app_callbacks[inst_cnt]) {
+                    free(configs[inst_cnt]);
+                    free(app_callbacks[inst_cnt]);
+                    break;
+                }
+                eb_config_ctor(configs[inst_cnt]);
+                return_errors[inst_cnt] = EB_ErrorNone;
+            }
+            num_channels = inst_cnt;
+            chunk_count  = inst_cnt == max_chunks ? split_into_chunks(configs, max_chunks) : 0;
+            if (!chunk_count) return_error = EB_ErrorBadParameter;
+            // release the configs left unused by the split
+            while (chunk_count && num_channels > chunk_count) {
+                --num_channels;
+                eb_config_dtor(configs[num_channels]);
+                free(configs[num_channels]);
+                free(app_callbacks[num_channels]);
+            }
+        }
+
         // Process any command line options, including the configuration file
 
         if (return_error == EB_ErrorNone) {
@@ -398,11 +443,13 @@ int32_t main(int32_t argc, char *argv[]) {
                     return_errors[inst_cnt - 1] =
                         de_init_encoder(app_callbacks[inst_cnt - 1], inst_cnt - 1);
             }
+            if (configs[0]->chunk_count > 1) stitch_chunks(configs, num_channels);
         } else {
             fprintf(stderr, "Error in configuration, could not begin encoding! ... \n");
             fprintf(stderr, "Run %s -help for a list of options\n", argv[0]);
         }
         // Destruct the App memory variables
+        if (configs[0]->shared_rc) eb_svt_enc_destroy_shared_rc(configs[0]->shared_rc);
         for (inst_cnt = 0; inst_cnt < num_channels; ++inst_cnt) {
             eb_config_dtor(configs[inst_cnt]);
             if (configs[inst_cnt]) free(configs[inst_cnt]);
@@ -891,6 +891,48 @@ void send_qp_on_the_fly(EbConfig *config, EbBufferHeaderType *header_ptr) {
     return;
 }
 
+//************************************/
+// send_roi_map
+// Reads the region of interest map of the next picture
+// from the roi_map_file: one line per picture, one delta
+// qp per 64x64 block in raster order, suffixed by 's' for
+// a static block. The pictures past the end of the file
+// have no map
+/************************************/
+static void send_roi_map(EbConfig *config, EbBufferHeaderType *header_ptr) {
+    const uint32_t block_count =
+        ((config->source_width + 63) / 64) * ((config->source_height + 63) / 64);
+    int32_t c;
+
+    header_ptr->roi_delta_qp    = NULL;
+    header_ptr->roi_static_hint = NULL;
+    for (uint32_t block_index = 0; block_index < block_count; block_index++) {
+        int32_t delta_qp;
+        EbBool  has_entry = EB_FALSE;
+        // the map of a picture does not go past the end of its line
+        do { c = fgetc(config->roi_map_file); } while (c == ' ' || c == '\t' || c == '\r');
+        if (c != '\n' && c != EOF) {
+            ungetc(c, config->roi_map_file);
+            has_entry = fscanf(config->roi_map_file, "%d", &delta_qp) == 1;
+        }
+        if (!has_entry) {
+            if (block_index || (c != '\n' && c != EOF))
+                fprintf(stderr, "\nWarning: incomplete region of interest map, ignored");
+            // the rest of the line, the next picture reads the next line
+            while (c != '\n' && c != EOF) c = fgetc(config->roi_map_file);
+            return;
+        }
+        c = fgetc(config->roi_map_file);
+        config->roi_static_hint[block_index] = (c == 's' || c == 'S');
+        if (!config->roi_static_hint[block_index] && c != EOF) ungetc(c, config->roi_map_file);
+        config->roi_delta_qp[block_index] = (int8_t)CLIP3(-63, 63, delta_qp);
+    }
+    // the rest of the line
+    do { c = fgetc(config->roi_map_file); } while (c != '\n' && c != EOF);
+    header_ptr->roi_delta_qp    = config->roi_delta_qp;
+    header_ptr->roi_static_hint = config->roi_static_hint;
+}
+
 //************************************/
 // process_input_buffer
 // Reads yuv frames from file and copy
@@ -941,6 +983,7 @@ AppExitConditionType process_input_buffer(EbConfig *config, EbAppContext *app_ca
 
             // Configuration parameters changed on the fly
             if (config->use_qp_file && config->qp_file) send_qp_on_the_fly(config, header_ptr);
+            if (config->roi_map_file) send_roi_map(config, header_ptr);
 
             if (keep_running == 0 && !config->stop_encoder) config->stop_encoder = EB_TRUE;
             // Fill in Buffers Header control data
@@ -1096,7 +1139,7 @@ void process_output_statistics_buffer(EbBufferHeaderType *header_ptr, EbConfig *
     if (config->stat_file)
         fprintf(config->stat_file,
                 "Picture Number: %4d\t QP: %4d  [ PSNR-Y: %.2f dB,\tPSNR-U: %.2f dB,\tPSNR-V: %.2f "
-                "dB,\tMSE-Y: %.2f,\tMSE-U: %.2f,\tMSE-V: %.2f ]\t %6d bytes\n",
+                "dB,\tMSE-Y: %.2f,\tMSE-U: %.2f,\tMSE-V: %.2f ]\t %6d bytes\t %4u ms\n",
                 (int)picture_number,
                 (int)picture_qp,
                 luma_psnr,
@@ -1105,7 +1148,8 @@ void process_output_statistics_buffer(EbBufferHeaderType *header_ptr, EbConfig *
                 (double)luma_sse / (config->source_width * config->source_height),
                 (double)cb_sse / (config->source_width / 2 * config->source_height / 2),
                 (double)cr_sse / (config->source_width / 2 * config->source_height / 2),
-                (int)picture_stream_size);
+                (int)picture_stream_size,
+                header_ptr->n_tick_count);
 
     return;
 }
@@ -1165,7 +1209,8 @@ AppExitConditionType process_output_stream_buffer(EbConfig *config, EbAppContext
 
             // Write Stream Data to file
             if (stream_file) {
-                if (config->performance_context.frame_count == 1 &&
+                // the chunks k > 0 are appended to the stream of chunk 0
+                if (config->performance_context.frame_count == 1 && config->chunk_index == 0 &&
                     !(header_ptr->flags & EB_BUFFERFLAG_IS_ALT_REF)) {
                     write_ivf_stream_header(config);
                 }
@@ -935,7 +935,14 @@ void eb_copy_rect8_8bit_to_16bit_avx2(uint16_t *dst, int32_t dstride, const uint
                                       int32_t sstride, int32_t v, int32_t h) {
     int32_t i, j;
     for (i = 0; i < v; i++) {
-        for (j = 0; j < (h & ~0x7); j += 8) {
+        for (j = 0; j < (h & ~0x1f); j += 32) {
+            const __m256i row = _mm256_loadu_si256((__m256i *)&src[i * sstride + j]);
+            _mm256_storeu_si256((__m256i *)&dst[i * dstride + j],
+                                _mm256_cvtepu8_epi16(_mm256_castsi256_si128(row)));
+            _mm256_storeu_si256((__m256i *)&dst[i * dstride + j + 16],
+                                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(row, 1)));
+        }
+        for (; j < (h & ~0x7); j += 8) {
             __m128i row = _mm_loadl_epi64((__m128i *)&src[i * sstride + j]);
             _mm_storeu_si128((__m128i *)&dst[i * dstride + j],
                              _mm_unpacklo_epi8(row, _mm_setzero_si128()));
@@ -943,3 +950,26 @@ void eb_copy_rect8_8bit_to_16bit_avx2(uint16_t *dst, int32_t dstride, const uint
         for (; j < h; j++) dst[i * dstride + j] = src[i * sstride + j];
     }
 }
+
+void eb_copy_rect16_16bit_to_8bit_avx2(uint8_t *dst, int32_t dstride, const uint16_t *src,
+                                      int32_t sstride, int32_t v, int32_t h) {
+    // The low bytes only, as the C truncation
+    const __m256i mask = _mm256_set1_epi16(0xff);
+    int32_t       i, j;
+    for (i = 0; i < v; i++) {
+        for (j = 0; j < (h & ~0x1f); j += 32) {
+            const __m256i lo =
+                _mm256_and_si256(_mm256_loadu_si256((__m256i *)&src[i * sstride + j]), mask);
+            const __m256i hi =
+                _mm256_and_si256(_mm256_loadu_si256((__m256i *)&src[i * sstride + j + 16]), mask);
+            _mm256_storeu_si256((__m256i *)&dst[i * dstride + j],
+                                _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8));
+        }
+        for (; j < (h & ~0x7); j += 8) {
+            const __m128i row = _mm_and_si128(_mm_loadu_si128((__m128i *)&src[i * sstride + j]),
+                                              _mm256_castsi256_si128(mask));
+            _mm_storel_epi64((__m128i *)&dst[i * dstride + j], _mm_packus_epi16(row, row));
+        }
+        for (; j < h; j++) dst[i * dstride + j] = (uint8_t)src[i * sstride + j];
+    }
+}
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <smmintrin.h> /* SSE4.1 */
+
+#include "common_dsp_rtcd.h"
+#include "EbInterPrediction.h"
+#include "EbSuperRes.h"
+
+// Filters four output pixels whose 8 source pixels (already widened to 16 bits) are in
+// s0..s3 with the matching 8-tap kernels in f0..f3. Returns the four 32-bit sums.
+static INLINE __m128i convolve_8tap_x4(const __m128i s0, const __m128i s1, const __m128i s2,
+                                       const __m128i s3, const __m128i f0, const __m128i f1,
+                                       const __m128i f2, const __m128i f3) {
+    const __m128i c0  = _mm_madd_epi16(s0, f0);
+    const __m128i c1  = _mm_madd_epi16(s1, f1);
+    const __m128i c2  = _mm_madd_epi16(s2, f2);
+    const __m128i c3  = _mm_madd_epi16(s3, f3);
+    const __m128i c01 = _mm_hadd_epi32(c0, c1);
+    const __m128i c23 = _mm_hadd_epi32(c2, c3);
+    return _mm_hadd_epi32(c01, c23);
+}
+
+static INLINE __m128i load_8bit_8x1_to_16bit(const uint8_t *src) {
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)src));
+}
+
+void av1_convolve_horiz_rs_sse4_1(const uint8_t *src, int src_stride, uint8_t *dst,
+                                  int dst_stride, int w, int h, const int16_t *x_filters,
+                                  int x0_qn, int x_step_qn) {
+    const __m128i round = _mm_set1_epi32((1 << FILTER_BITS) >> 1);
+    const int     w4    = w & ~3;
+    int           x_qn  = x0_qn;
+    int           x;
+
+    assert(UPSCALE_NORMATIVE_TAPS == 8);
+    src -= UPSCALE_NORMATIVE_TAPS / 2 - 1;
+
+    // The filter phase only depends on the column, so the kernels of four columns are loaded once
+    // and applied to every row.
+    for (x = 0; x < w4; x += 4, x_qn += 4 * x_step_qn) {
+        const int     x_qn1 = x_qn + x_step_qn;
+        const int     x_qn2 = x_qn1 + x_step_qn;
+        const int     x_qn3 = x_qn2 + x_step_qn;
+        const __m128i f0    = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const __m128i f1 = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn1 & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const __m128i f2 = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn2 & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const __m128i f3 = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn3 & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const uint8_t *src_y = src;
+        uint8_t *      dst_y = dst + x;
+
+        for (int y = 0; y < h; ++y, src_y += src_stride, dst_y += dst_stride) {
+            const __m128i s0  = load_8bit_8x1_to_16bit(src_y + (x_qn >> RS_SCALE_SUBPEL_BITS));
+            const __m128i s1  = load_8bit_8x1_to_16bit(src_y + (x_qn1 >> RS_SCALE_SUBPEL_BITS));
+            const __m128i s2  = load_8bit_8x1_to_16bit(src_y + (x_qn2 >> RS_SCALE_SUBPEL_BITS));
+            const __m128i s3  = load_8bit_8x1_to_16bit(src_y + (x_qn3 >> RS_SCALE_SUBPEL_BITS));
+            const __m128i sum = convolve_8tap_x4(s0, s1, s2, s3, f0, f1, f2, f3);
+            const __m128i res = _mm_srai_epi32(_mm_add_epi32(sum, round), FILTER_BITS);
+            const __m128i res_16 = _mm_packs_epi32(res, res);
+            *(uint32_t *)dst_y   = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(res_16, res_16));
+        }
+    }
+
+    for (; x < w; ++x, x_qn += x_step_qn) {
+        const int16_t *const x_filter =
+            &x_filters[((x_qn & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                       UPSCALE_NORMATIVE_TAPS];
+        const uint8_t *src_x = src + (x_qn >> RS_SCALE_SUBPEL_BITS);
+        for (int y = 0; y < h; ++y, src_x += src_stride) {
+            int sum = 0;
+            for (int k = 0; k < UPSCALE_NORMATIVE_TAPS; ++k) sum += src_x[k] * x_filter[k];
+            dst[y * dst_stride + x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+        }
+    }
+}
+
+void av1_highbd_convolve_horiz_rs_sse4_1(const uint16_t *src, int src_stride, uint16_t *dst,
+                                         int dst_stride, int w, int h, const int16_t *x_filters,
+                                         int x0_qn, int x_step_qn, int bd) {
+    const __m128i round   = _mm_set1_epi32((1 << FILTER_BITS) >> 1);
+    const __m128i clip_hi = _mm_set1_epi32((1 << bd) - 1);
+    const __m128i zero    = _mm_setzero_si128();
+    const int     w4      = w & ~3;
+    int           x_qn    = x0_qn;
+    int           x;
+
+    assert(UPSCALE_NORMATIVE_TAPS == 8);
+    src -= UPSCALE_NORMATIVE_TAPS / 2 - 1;
+
+    for (x = 0; x < w4; x += 4, x_qn += 4 * x_step_qn) {
+        const int     x_qn1 = x_qn + x_step_qn;
+        const int     x_qn2 = x_qn1 + x_step_qn;
+        const int     x_qn3 = x_qn2 + x_step_qn;
+        const __m128i f0    = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const __m128i f1 = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn1 & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const __m128i f2 = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn2 & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const __m128i f3 = _mm_loadu_si128(
+            (const __m128i *)&x_filters[((x_qn3 & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                                        UPSCALE_NORMATIVE_TAPS]);
+        const uint16_t *src_y = src;
+        uint16_t *      dst_y = dst + x;
+
+        for (int y = 0; y < h; ++y, src_y += src_stride, dst_y += dst_stride) {
+            const __m128i s0 =
+                _mm_loadu_si128((const __m128i *)(src_y + (x_qn >> RS_SCALE_SUBPEL_BITS)));
+            const __m128i s1 =
+                _mm_loadu_si128((const __m128i *)(src_y + (x_qn1 >> RS_SCALE_SUBPEL_BITS)));
+            const __m128i s2 =
+                _mm_loadu_si128((const __m128i *)(src_y + (x_qn2 >> RS_SCALE_SUBPEL_BITS)));
+            const __m128i s3 =
+                _mm_loadu_si128((const __m128i *)(src_y + (x_qn3 >> RS_SCALE_SUBPEL_BITS)));
+            const __m128i sum = convolve_8tap_x4(s0, s1, s2, s3, f0, f1, f2, f3);
+            __m128i       res = _mm_srai_epi32(_mm_add_epi32(sum, round), FILTER_BITS);
+            res               = _mm_min_epi32(_mm_max_epi32(res, zero), clip_hi);
+            _mm_storel_epi64((__m128i *)dst_y, _mm_packus_epi32(res, res));
+        }
+    }
+
+    for (; x < w; ++x, x_qn += x_step_qn) {
+        const int16_t *const x_filter =
+            &x_filters[((x_qn & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS) *
+                       UPSCALE_NORMATIVE_TAPS];
+        const uint16_t *src_x = src + (x_qn >> RS_SCALE_SUBPEL_BITS);
+        for (int y = 0; y < h; ++y, src_x += src_stride) {
+            int sum = 0;
+            for (int k = 0; k < UPSCALE_NORMATIVE_TAPS; ++k) sum += src_x[k] * x_filter[k];
+            dst[y * dst_stride + x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
+        }
+    }
+}
+
+// Horizontal pass of the scaled convolution into the 16-bit intermediate block. Every output
+// column has its own filter phase; four columns are filtered per iteration.
+static INLINE void convolve_2d_scale_horiz(const uint8_t *src, const uint16_t *src16,
+                                           int src_stride, int16_t *im_block, int w, int im_h,
+                                           const InterpFilterParams *filter_params_x,
+                                           const int subpel_x_qn, const int x_step_qn,
+                                           const ConvolveParams *conv_params, int bd) {
+    const int     fo_horiz = filter_params_x->taps / 2 - 1;
+    const int     round_0  = conv_params->round_0;
+    const __m128i offset = _mm_set1_epi32((1 << (bd + FILTER_BITS - 1)) + ((1 << round_0) >> 1));
+    const __m128i round_0_shift = _mm_cvtsi32_si128(round_0);
+    const int     w4            = w & ~3;
+    int           x_qn          = subpel_x_qn;
+    int           x;
+
+    for (x = 0; x < w4; x += 4, x_qn += 4 * x_step_qn) {
+        const int     x_qn1 = x_qn + x_step_qn;
+        const int     x_qn2 = x_qn1 + x_step_qn;
+        const int     x_qn3 = x_qn2 + x_step_qn;
+        const __m128i f0    = _mm_loadu_si128((const __m128i *)av1_get_interp_filter_subpel_kernel(
+            *filter_params_x, (x_qn & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS));
+        const __m128i f1 = _mm_loadu_si128((const __m128i *)av1_get_interp_filter_subpel_kernel(
+            *filter_params_x, (x_qn1 & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS));
+        const __m128i f2 = _mm_loadu_si128((const __m128i *)av1_get_interp_filter_subpel_kernel(
+            *filter_params_x, (x_qn2 & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS));
+        const __m128i f3 = _mm_loadu_si128((const __m128i *)av1_get_interp_filter_subpel_kernel(
+            *filter_params_x, (x_qn3 & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS));
+        const int o0 = (x_qn >> SCALE_SUBPEL_BITS) - fo_horiz;
+        const int o1 = (x_qn1 >> SCALE_SUBPEL_BITS) - fo_horiz;
+        const int o2 = (x_qn2 >> SCALE_SUBPEL_BITS) - fo_horiz;
+        const int o3 = (x_qn3 >> SCALE_SUBPEL_BITS) - fo_horiz;
+
+        for (int y = 0; y < im_h; ++y) {
+            __m128i s0, s1, s2, s3;
+            if (src16) {
+                const uint16_t *const s = src16 + y * src_stride;
+                s0                      = _mm_loadu_si128((const __m128i *)(s + o0));
+                s1                      = _mm_loadu_si128((const __m128i *)(s + o1));
+                s2                      = _mm_loadu_si128((const __m128i *)(s + o2));
+                s3                      = _mm_loadu_si128((const __m128i *)(s + o3));
+            } else {
+                const uint8_t *const s = src + y * src_stride;
+                s0                     = load_8bit_8x1_to_16bit(s + o0);
+                s1                     = load_8bit_8x1_to_16bit(s + o1);
+                s2                     = load_8bit_8x1_to_16bit(s + o2);
+                s3                     = load_8bit_8x1_to_16bit(s + o3);
+            }
+            const __m128i sum = convolve_8tap_x4(s0, s1, s2, s3, f0, f1, f2, f3);
+            const __m128i res = _mm_sra_epi32(_mm_add_epi32(sum, offset), round_0_shift);
+            _mm_storel_epi64((__m128i *)&im_block[y * w + x], _mm_packs_epi32(res, res));
+        }
+    }
+
+    for (; x < w; ++x, x_qn += x_step_qn) {
+        const int16_t *x_filter = av1_get_interp_filter_subpel_kernel(
+            *filter_params_x, (x_qn & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS);
+        const int o = (x_qn >> SCALE_SUBPEL_BITS) - fo_horiz;
+        for (int y = 0; y < im_h; ++y) {
+            int32_t sum = (1 << (bd + FILTER_BITS - 1));
+            if (src16) {
+                for (int k = 0; k < SUBPEL_TAPS; ++k)
+                    sum += x_filter[k] * src16[y * src_stride + o + k];
+            } else {
+                for (int k = 0; k < SUBPEL_TAPS; ++k)
+                    sum += x_filter[k] * src[y * src_stride + o + k];
+            }
+            im_block[y * w + x] = (int16_t)ROUND_POWER_OF_TWO(sum, round_0);
+        }
+    }
+}
+
+// Vertical pass of the scaled convolution. The filter phase only depends on the output row, so
+// each row is filtered four columns at a time with interleaved tap pairs. The rounded results
+// are either stored to the compound buffer or converted to pixels, following the C reference.
+static INLINE void convolve_2d_scale_vert(const int16_t *im_block, uint8_t *dst8,
+                                          uint16_t *dst16_px, int dst_stride, int w, int h,
+                                          const InterpFilterParams *filter_params_y,
+                                          const int subpel_y_qn, const int y_step_qn,
+                                          ConvolveParams *conv_params, int bd) {
+    const int      fo_vert       = filter_params_y->taps / 2 - 1;
+    const int      round_1       = conv_params->round_1;
+    const int      offset_bits   = bd + 2 * FILTER_BITS - conv_params->round_0;
+    const int      bits          = FILTER_BITS * 2 - conv_params->round_0 - round_1;
+    CONV_BUF_TYPE *dst16         = conv_params->dst;
+    const int      dst16_stride  = conv_params->dst_stride;
+    const __m128i  offset        = _mm_set1_epi32((1 << offset_bits) + ((1 << round_1) >> 1));
+    // Subtract round offset and add the rounding of the convolve round in one go
+    const __m128i  sub_round     = _mm_set1_epi32(
+        ((1 << (offset_bits - round_1)) + (1 << (offset_bits - round_1 - 1))) -
+        ((1 << bits) >> 1));
+    const __m128i  round_1_shift = _mm_cvtsi32_si128(round_1);
+    const __m128i  bits_shift    = _mm_cvtsi32_si128(bits);
+    const __m128i  fwd           = _mm_set1_epi32(conv_params->fwd_offset);
+    const __m128i  bck           = _mm_set1_epi32(conv_params->bck_offset);
+    const __m128i  zero          = _mm_setzero_si128();
+    const __m128i  clip_hi       = _mm_set1_epi32((1 << bd) - 1);
+    const int      w4            = w & ~3;
+    const int16_t *src_vert      = im_block + fo_vert * w;
+    int            y_qn          = subpel_y_qn;
+
+    for (int y = 0; y < h; ++y, y_qn += y_step_qn) {
+        const int16_t *src_y    = &src_vert[((y_qn >> SCALE_SUBPEL_BITS) - fo_vert) * w];
+        const int16_t *y_filter = av1_get_interp_filter_subpel_kernel(
+            *filter_params_y, (y_qn & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS);
+        const __m128i f01 = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)y_filter[1] << 16) |
+                                                     (uint16_t)y_filter[0]));
+        const __m128i f23 = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)y_filter[3] << 16) |
+                                                     (uint16_t)y_filter[2]));
+        const __m128i f45 = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)y_filter[5] << 16) |
+                                                     (uint16_t)y_filter[4]));
+        const __m128i f67 = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)y_filter[7] << 16) |
+                                                     (uint16_t)y_filter[6]));
+        int x;
+
+        for (x = 0; x < w4; x += 4) {
+            const int16_t *s = src_y + x;
+#define LOAD_ROW(r) _mm_loadl_epi64((const __m128i *)(s + (r)*w))
+            const __m128i s01 = _mm_unpacklo_epi16(LOAD_ROW(0), LOAD_ROW(1));
+            const __m128i s23 = _mm_unpacklo_epi16(LOAD_ROW(2), LOAD_ROW(3));
+            const __m128i s45 = _mm_unpacklo_epi16(LOAD_ROW(4), LOAD_ROW(5));
+            const __m128i s67 = _mm_unpacklo_epi16(LOAD_ROW(6), LOAD_ROW(7));
+#undef LOAD_ROW
+            const __m128i sum0123 =
+                _mm_add_epi32(_mm_madd_epi16(s01, f01), _mm_madd_epi16(s23, f23));
+            const __m128i sum4567 =
+                _mm_add_epi32(_mm_madd_epi16(s45, f45), _mm_madd_epi16(s67, f67));
+            const __m128i sum = _mm_add_epi32(sum0123, sum4567);
+            const __m128i res = _mm_sra_epi32(_mm_add_epi32(sum, offset), round_1_shift);
+
+            if (conv_params->is_compound && !conv_params->do_average) {
+                _mm_storel_epi64((__m128i *)&dst16[y * dst16_stride + x],
+                                 _mm_packus_epi32(res, res));
+                continue;
+            }
+            __m128i tmp = res;
+            if (conv_params->is_compound) {
+                const __m128i ref = _mm_cvtepu16_epi32(
+                    _mm_loadl_epi64((const __m128i *)&dst16[y * dst16_stride + x]));
+                if (conv_params->use_dist_wtd_comp_avg)
+                    tmp = _mm_srai_epi32(
+                        _mm_add_epi32(_mm_mullo_epi32(ref, fwd), _mm_mullo_epi32(res, bck)),
+                        DIST_PRECISION_BITS);
+                else
+                    tmp = _mm_srai_epi32(_mm_add_epi32(ref, res), 1);
+            }
+            tmp = _mm_sra_epi32(_mm_sub_epi32(tmp, sub_round), bits_shift);
+            if (dst16_px) {
+                tmp = _mm_min_epi32(_mm_max_epi32(tmp, zero), clip_hi);
+                _mm_storel_epi64((__m128i *)&dst16_px[y * dst_stride + x],
+                                 _mm_packus_epi32(tmp, tmp));
+            } else {
+                const __m128i tmp_16 = _mm_packs_epi32(tmp, tmp);
+                *(uint32_t *)&dst8[y * dst_stride + x] =
+                    (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(tmp_16, tmp_16));
+            }
+        }
+
+        for (; x < w; ++x) {
+            int32_t sum = 1 << offset_bits;
+            for (int k = 0; k < SUBPEL_TAPS; ++k) sum += y_filter[k] * src_y[k * w + x];
+            const CONV_BUF_TYPE res = ROUND_POWER_OF_TWO(sum, round_1);
+            if (conv_params->is_compound && !conv_params->do_average) {
+                dst16[y * dst16_stride + x] = res;
+                continue;
+            }
+            int32_t tmp = res;
+            if (conv_params->is_compound) {
+                tmp = dst16[y * dst16_stride + x];
+                if (conv_params->use_dist_wtd_comp_avg) {
+                    tmp = tmp * conv_params->fwd_offset + res * conv_params->bck_offset;
+                    tmp = tmp >> DIST_PRECISION_BITS;
+                } else {
+                    tmp += res;
+                    tmp = tmp >> 1;
+                }
+            }
+            /* Subtract round offset and convolve round */
+            tmp = tmp - ((1 << (offset_bits - round_1)) + (1 << (offset_bits - round_1 - 1)));
+            if (dst16_px)
+                dst16_px[y * dst_stride + x] =
+                    clip_pixel_highbd(ROUND_POWER_OF_TWO(tmp, bits), bd);
+            else
+                dst8[y * dst_stride + x] = clip_pixel(ROUND_POWER_OF_TWO(tmp, bits));
+        }
+    }
+}
+
+void eb_av1_convolve_2d_scale_sse4_1(const uint8_t *src, int src_stride, uint8_t *dst8,
+                                     int dst8_stride, int w, int h,
+                                     const InterpFilterParams *filter_params_x,
+                                     const InterpFilterParams *filter_params_y,
+                                     const int subpel_x_qn, const int x_step_qn,
+                                     const int subpel_y_qn, const int y_step_qn,
+                                     ConvolveParams *conv_params) {
+    DECLARE_ALIGNED(16, int16_t, im_block[(2 * MAX_SB_SIZE + MAX_FILTER_TAP) * MAX_SB_SIZE]);
+    const int im_h =
+        (((h - 1) * y_step_qn + subpel_y_qn) >> SCALE_SUBPEL_BITS) + filter_params_y->taps;
+    const int fo_vert = filter_params_y->taps / 2 - 1;
+
+    if (filter_params_x->taps != SUBPEL_TAPS || filter_params_y->taps != SUBPEL_TAPS) {
+        eb_av1_convolve_2d_scale_c(src,
+                                   src_stride,
+                                   dst8,
+                                   dst8_stride,
+                                   w,
+                                   h,
+                                   filter_params_x,
+                                   filter_params_y,
+                                   subpel_x_qn,
+                                   x_step_qn,
+                                   subpel_y_qn,
+                                   y_step_qn,
+                                   conv_params);
+        return;
+    }
+    assert(FILTER_BITS * 2 - conv_params->round_0 - conv_params->round_1 >= 0);
+
+    convolve_2d_scale_horiz(src - fo_vert * src_stride,
+                            NULL,
+                            src_stride,
+                            im_block,
+                            w,
+                            im_h,
+                            filter_params_x,
+                            subpel_x_qn,
+                            x_step_qn,
+                            conv_params,
+                            8);
+    convolve_2d_scale_vert(im_block,
+                           dst8,
+                           NULL,
+                           dst8_stride,
+                           w,
+                           h,
+                           filter_params_y,
+                           subpel_y_qn,
+                           y_step_qn,
+                           conv_params,
+                           8);
+}
+
+void eb_av1_highbd_convolve_2d_scale_sse4_1(const uint16_t *src, int src_stride, uint16_t *dst,
+                                            int dst_stride, int w, int h,
+                                            const InterpFilterParams *filter_params_x,
+                                            const InterpFilterParams *filter_params_y,
+                                            const int subpel_x_qn, const int x_step_qn,
+                                            const int subpel_y_qn, const int y_step_qn,
+                                            ConvolveParams *conv_params, int bd) {
+    DECLARE_ALIGNED(16, int16_t, im_block[(2 * MAX_SB_SIZE + MAX_FILTER_TAP) * MAX_SB_SIZE]);
+    const int im_h =
+        (((h - 1) * y_step_qn + subpel_y_qn) >> SCALE_SUBPEL_BITS) + filter_params_y->taps;
+    const int fo_vert = filter_params_y->taps / 2 - 1;
+
+    if (filter_params_x->taps != SUBPEL_TAPS || filter_params_y->taps != SUBPEL_TAPS) {
+        eb_av1_highbd_convolve_2d_scale_c(src,
+                                          src_stride,
+                                          dst,
+                                          dst_stride,
+                                          w,
+                                          h,
+                                          filter_params_x,
+                                          filter_params_y,
+                                          subpel_x_qn,
+                                          x_step_qn,
+                                          subpel_y_qn,
+                                          y_step_qn,
+                                          conv_params,
+                                          bd);
+        return;
+    }
+    assert(FILTER_BITS * 2 - conv_params->round_0 - conv_params->round_1 >= 0);
+
+    convolve_2d_scale_horiz(NULL,
+                            src - fo_vert * src_stride,
+                            src_stride,
+                            im_block,
+                            w,
+                            im_h,
+                            filter_params_x,
+                            subpel_x_qn,
+                            x_step_qn,
+                            conv_params,
+                            bd);
+    convolve_2d_scale_vert(im_block,
+                           NULL,
+                           dst,
+                           dst_stride,
+                           w,
+                           h,
+                           filter_params_y,
+                           subpel_y_qn,
+                           y_step_qn,
+                           conv_params,
+                           bd);
+}
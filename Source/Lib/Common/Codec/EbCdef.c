@@ -117,6 +117,13 @@ void eb_copy_rect8_8bit_to_16bit_c(uint16_t *dst, int32_t dstride, const uint8_t
     }
 }
 
+void eb_copy_rect16_16bit_to_8bit_c(uint8_t *dst, int32_t dstride, const uint16_t *src,
+                                    int32_t sstride, int32_t v, int32_t h) {
+    for (int32_t i = 0; i < v; i++) {
+        for (int32_t j = 0; j < h; j++) dst[i * dstride + j] = (uint8_t)src[i * sstride + j];
+    }
+}
+
 /* Detect direction. 0 means 45-degree up-right, 2 is horizontal, and so on.
 The search minimizes the weighted variance along all the lines in a
 particular direction, i.e. the squared error between the input and a
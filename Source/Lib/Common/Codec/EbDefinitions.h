@@ -191,10 +191,10 @@ enum {
 /********************************************************/
 
 /* maximum number of frames allowed for the Alt-ref picture computation
- * this number can be increased by increasing the constant
+ * the number of future frames available is limited by the constant
  * FUTURE_WINDOW_WIDTH defined in EbPictureDecisionProcess.c
  */
-#define ALTREF_MAX_NFRAMES 10
+#define ALTREF_MAX_NFRAMES 15
 #define ALTREF_MAX_STRENGTH 6
 #define PAD_VALUE (128 + 32)
 #define PAD_VALUE_SCALED (128+128+32)
@@ -103,6 +103,73 @@ EbErrorType picture_copy(EbPictureBufferDesc *src, uint32_t src_luma_origin_inde
     return return_error;
 }
 
+// Offset and stride of a plane, at the luma row (the chroma row of 4:2:0 under it)
+static uint32_t picture_plane_offset(const EbPictureBufferDesc *pic, int32_t plane, uint32_t row,
+                                     int32_t *stride) {
+    if (plane == 0) {
+        *stride = pic->stride_y;
+        return pic->origin_x + (pic->origin_y + row) * pic->stride_y;
+    }
+    *stride = plane == 1 ? pic->stride_cb : pic->stride_cr;
+    return pic->origin_x / 2 + (pic->origin_y / 2 + row / 2) * *stride;
+}
+
+/*******************************************
+* picture_convert_8bit_to_16bit
+*  converts the luma rows [row_start, row_end) of an 8 bit
+*  picture, and the chroma rows under them, to a 16 bit
+*  picture of the same size
+*******************************************/
+void picture_convert_8bit_to_16bit(EbPictureBufferDesc *src, EbPictureBufferDesc *dst,
+                                   uint32_t row_start, uint32_t row_end) {
+    row_end = MIN(row_end, dst->height);
+    for (int32_t plane = 0; plane < 3 && row_start < row_end; plane++) {
+        const uint32_t shift = plane ? 1 : 0;
+        int32_t        src_stride, dst_stride;
+        const uint32_t src_offset = picture_plane_offset(src, plane, row_start, &src_stride);
+        const uint32_t dst_offset = picture_plane_offset(dst, plane, row_start, &dst_stride);
+        EbByte         src_buffer = plane == 0 ? src->buffer_y
+                                               : plane == 1 ? src->buffer_cb : src->buffer_cr;
+        EbByte         dst_buffer = plane == 0 ? dst->buffer_y
+                                               : plane == 1 ? dst->buffer_cb : dst->buffer_cr;
+
+        eb_copy_rect8_8bit_to_16bit((uint16_t *)dst_buffer + dst_offset,
+                                    dst_stride,
+                                    src_buffer + src_offset,
+                                    src_stride,
+                                    (row_end >> shift) - (row_start >> shift),
+                                    dst->width >> shift);
+    }
+}
+
+/*******************************************
+* picture_convert_16bit_to_8bit
+*  converts the luma rows [row_start, row_end) of a 16 bit
+*  picture of 8 bit samples, and the chroma rows under
+*  them, to an 8 bit picture of the same size
+*******************************************/
+void picture_convert_16bit_to_8bit(EbPictureBufferDesc *src, EbPictureBufferDesc *dst,
+                                   uint32_t row_start, uint32_t row_end) {
+    row_end = MIN(row_end, src->height);
+    for (int32_t plane = 0; plane < 3 && row_start < row_end; plane++) {
+        const uint32_t shift = plane ? 1 : 0;
+        int32_t        src_stride, dst_stride;
+        const uint32_t src_offset = picture_plane_offset(src, plane, row_start, &src_stride);
+        const uint32_t dst_offset = picture_plane_offset(dst, plane, row_start, &dst_stride);
+        EbByte         src_buffer = plane == 0 ? src->buffer_y
+                                               : plane == 1 ? src->buffer_cb : src->buffer_cr;
+        EbByte         dst_buffer = plane == 0 ? dst->buffer_y
+                                               : plane == 1 ? dst->buffer_cb : dst->buffer_cr;
+
+        eb_copy_rect16_16bit_to_8bit(dst_buffer + dst_offset,
+                                     dst_stride,
+                                     (uint16_t *)src_buffer + src_offset,
+                                     src_stride,
+                                     (row_end >> shift) - (row_start >> shift),
+                                     src->width >> shift);
+    }
+}
+
 /*******************************************
 * Residual Kernel 16bit
 Computes the residual data
@@ -91,6 +91,13 @@ EbErrorType picture_copy(EbPictureBufferDesc *src, uint32_t src_luma_origin_inde
                          uint32_t area_width, uint32_t area_height, uint32_t chroma_area_width,
                          uint32_t chroma_area_height, uint32_t component_mask, uint8_t hbd);
 
+// Conversions of the luma rows [row_start, row_end), and of the 4:2:0 chroma rows under them,
+// between the 8 bit and the 16 bit pictures of the 16 bit pipeline (8 bit input)
+void picture_convert_8bit_to_16bit(EbPictureBufferDesc *src, EbPictureBufferDesc *dst,
+                                   uint32_t row_start, uint32_t row_end);
+void picture_convert_16bit_to_8bit(EbPictureBufferDesc *src, EbPictureBufferDesc *dst,
+                                   uint32_t row_start, uint32_t row_end);
+
 #ifdef __cplusplus
 }
 #endif
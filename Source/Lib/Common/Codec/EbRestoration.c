@@ -740,50 +740,18 @@ const int32_t eb_one_by_x[MAX_NELEM] = {
     293,  273,  256,  241,  228, 216, 205, 195, 186, 178, 171, 164,
 };
 
-static void selfguided_restoration_fast_internal(int32_t *dgd, int32_t width, int32_t height,
-                                                 int32_t dgd_stride, int32_t *dst,
-                                                 int32_t dst_stride, int32_t bit_depth,
-                                                 int32_t sgr_params_idx, int32_t radius_idx) {
-    const SgrParamsType *const params     = &eb_sgr_params[sgr_params_idx];
-    const int32_t              r          = params->r[radius_idx];
-    const int32_t              width_ext  = width + 2 * SGRPROJ_BORDER_HORZ;
-    const int32_t              height_ext = height + 2 * SGRPROJ_BORDER_VERT;
-    // Adjusting the stride of A and B here appears to avoid bad cache effects,
-    // leading to a significant speed improvement.
-    // We also align the stride to a multiple of 16 bytes, for consistency
-    // with the SIMD version of this function.
-    int32_t  buf_stride = ((width_ext + 3) & ~3) + 16;
-    int32_t  a_[RESTORATION_PROC_UNIT_PELS];
-    int32_t  b_[RESTORATION_PROC_UNIT_PELS];
-    int32_t *A = a_;
-    int32_t *B = b_;
-    int32_t  i, j;
-
-    assert(r <= MAX_RADIUS && "Need MAX_RADIUS >= r");
-    assert(r <= SGRPROJ_BORDER_VERT - 1 && r <= SGRPROJ_BORDER_HORZ - 1 &&
-           "Need SGRPROJ_BORDER_* >= r+1");
+// Calculate the eventual A[] and B[] arrays of the filter of radius
+// params->r[radius_idx], from the box sums of the squares (in A[]) and of the
+// pixels (in B[]), on every row_step rows. Include a 1-pixel border - ie, for a
+// 64x64 processing unit, we calculate 66x66 pixels of A[] and B[].
+static void calc_ab(int32_t *A, int32_t *B, int32_t buf_stride, int32_t width, int32_t height,
+                    int32_t bit_depth, int32_t sgr_params_idx, int32_t radius_idx,
+                    int32_t row_step) {
+    const SgrParamsType *const params = &eb_sgr_params[sgr_params_idx];
+    const int32_t              r      = params->r[radius_idx];
+    int32_t                    i, j;
 
-    boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
-           width_ext,
-           height_ext,
-           dgd_stride,
-           r,
-           0,
-           B,
-           buf_stride);
-    boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
-           width_ext,
-           height_ext,
-           dgd_stride,
-           r,
-           1,
-           A,
-           buf_stride);
-    A += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
-    B += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
-    // Calculate the eventual A[] and B[] arrays. Include a 1-pixel border - ie,
-    // for a 64x64 processing unit, we calculate 66x66 pixels of A[] and B[].
-    for (i = -1; i < height + 1; i += 2) {
+    for (i = -1; i < height + 1; i += row_step) {
         for (j = -1; j < width + 1; ++j) {
             const int32_t k = i * buf_stride + j;
             const int32_t n = (2 * r + 1) * (2 * r + 1);
@@ -845,8 +813,19 @@ static void selfguided_restoration_fast_internal(int32_t *dgd, int32_t width, in
                 SGRPROJ_RECIP_BITS);
         }
     }
-    // Use the A[] and B[] arrays to calculate the filtered image
-    assert(r == 2);
+}
+
+static INLINE int32_t sgr_pixel(const uint8_t *dgd8, int32_t idx, int32_t highbd) {
+    return highbd ? CONVERT_TO_SHORTPTR(dgd8)[idx] : dgd8[idx];
+}
+
+// Use the A[] and B[] arrays of the filter of radius 2 (calculated on every
+// other row) to calculate the filtered image
+static void final_filter_fast(int32_t *dst, int32_t dst_stride, const int32_t *A,
+                              const int32_t *B, int32_t buf_stride, const uint8_t *dgd8,
+                              int32_t dgd_stride, int32_t width, int32_t height, int32_t highbd) {
+    int32_t i, j;
+
     for (i = 0; i < height; ++i) {
         if (!(i & 1)) { // even row
             for (j = 0; j < width; ++j) {
@@ -862,7 +841,7 @@ static void selfguided_restoration_fast_internal(int32_t *dgd, int32_t width, in
                                   (B[k - 1 - buf_stride] + B[k - 1 + buf_stride] +
                                    B[k + 1 - buf_stride] + B[k + 1 + buf_stride]) *
                                       5;
-                const int32_t v = a * dgd[l] + b;
+                const int32_t v = a * sgr_pixel(dgd8, l, highbd) + b;
                 dst[m]          = ROUND_POWER_OF_TWO(v, SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS);
             }
         } else { // odd row
@@ -873,17 +852,49 @@ static void selfguided_restoration_fast_internal(int32_t *dgd, int32_t width, in
                 const int32_t nb = 4;
                 const int32_t a  = A[k] * 6 + (A[k - 1] + A[k + 1]) * 5;
                 const int32_t b  = B[k] * 6 + (B[k - 1] + B[k + 1]) * 5;
-                const int32_t v  = a * dgd[l] + b;
+                const int32_t v  = a * sgr_pixel(dgd8, l, highbd) + b;
                 dst[m]           = ROUND_POWER_OF_TWO(v, SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS);
             }
         }
     }
 }
 
+// Use the A[] and B[] arrays of the filter of radius 1 to calculate the
+// filtered image
+static void final_filter(int32_t *dst, int32_t dst_stride, const int32_t *A, const int32_t *B,
+                         int32_t buf_stride, const uint8_t *dgd8, int32_t dgd_stride,
+                         int32_t width, int32_t height, int32_t highbd) {
+    int32_t i, j;
+
+    for (i = 0; i < height; ++i) {
+        for (j = 0; j < width; ++j) {
+            const int32_t k  = i * buf_stride + j;
+            const int32_t l  = i * dgd_stride + j;
+            const int32_t m  = i * dst_stride + j;
+            const int32_t nb = 5;
+            const int32_t a =
+                (A[k] + A[k - 1] + A[k + 1] + A[k - buf_stride] + A[k + buf_stride]) * 4 +
+                (A[k - 1 - buf_stride] + A[k - 1 + buf_stride] + A[k + 1 - buf_stride] +
+                 A[k + 1 + buf_stride]) *
+                    3;
+            const int32_t b =
+                (B[k] + B[k - 1] + B[k + 1] + B[k - buf_stride] + B[k + buf_stride]) * 4 +
+                (B[k - 1 - buf_stride] + B[k - 1 + buf_stride] + B[k + 1 - buf_stride] +
+                 B[k + 1 + buf_stride]) *
+                    3;
+            const int32_t v = a * sgr_pixel(dgd8, l, highbd) + b;
+            dst[m]          = ROUND_POWER_OF_TWO(v, SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS);
+        }
+    }
+}
+
+// Filter of radius params->r[radius_idx]: the fast filter of radius 2
+// (radius_idx 0), or the filter of radius 1 (radius_idx 1)
 static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t height,
-                                            int32_t dgd_stride, int32_t *dst, int32_t dst_stride,
-                                            int32_t bit_depth, int32_t sgr_params_idx,
-                                            int32_t radius_idx) {
+                                            int32_t dgd_stride, const uint8_t *dgd8,
+                                            int32_t dgd8_stride, int32_t *dst, int32_t dst_stride,
+                                            int32_t bit_depth, int32_t highbd,
+                                            int32_t sgr_params_idx, int32_t radius_idx) {
     const SgrParamsType *const params     = &eb_sgr_params[sgr_params_idx];
     const int32_t              r          = params->r[radius_idx];
     const int32_t              width_ext  = width + 2 * SGRPROJ_BORDER_HORZ;
@@ -897,11 +908,11 @@ static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t
     int32_t  b_[RESTORATION_PROC_UNIT_PELS];
     int32_t *A = a_;
     int32_t *B = b_;
-    int32_t  i, j;
 
     assert(r <= MAX_RADIUS && "Need MAX_RADIUS >= r");
     assert(r <= SGRPROJ_BORDER_VERT - 1 && r <= SGRPROJ_BORDER_HORZ - 1 &&
            "Need SGRPROJ_BORDER_* >= r+1");
+    assert(radius_idx || r == 2);
 
     boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
            width_ext,
@@ -921,91 +932,13 @@ static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t
            buf_stride);
     A += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
     B += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
-    // Calculate the eventual A[] and B[] arrays. Include a 1-pixel border - ie,
-    // for a 64x64 processing unit, we calculate 66x66 pixels of A[] and B[].
-    for (i = -1; i < height + 1; ++i) {
-        for (j = -1; j < width + 1; ++j) {
-            const int32_t k = i * buf_stride + j;
-            const int32_t n = (2 * r + 1) * (2 * r + 1);
-
-            // a < 2^16 * n < 2^22 regardless of bit depth
-            uint32_t a = ROUND_POWER_OF_TWO(A[k], 2 * (bit_depth - 8));
-            // b < 2^8 * n < 2^14 regardless of bit depth
-            uint32_t b = ROUND_POWER_OF_TWO(B[k], bit_depth - 8);
-
-            // Each term in calculating p = a * n - b * b is < 2^16 * n^2 < 2^28,
-            // and p itself satisfies p < 2^14 * n^2 < 2^26.
-            // This bound on p is due to:
-            // https://en.wikipedia.org/wiki/Popoviciu's_inequality_on_variances
-            //
-            // Note: Sometimes, in high bit depth, we can end up with a*n < b*b.
-            // This is an artefact of rounding, and can only happen if all pixels
-            // are (almost) identical, so in this case we saturate to p=0.
-            uint32_t p = (a * n < b * b) ? 0 : a * n - b * b;
-
-            const uint32_t s = params->s[radius_idx];
-
-            // p * s < (2^14 * n^2) * round(2^20 / n^2 eps) < 2^34 / eps < 2^32
-            // as long as eps >= 4. So p * s fits into a uint32_t, and z < 2^12
-            // (this holds even after accounting for the rounding in s)
-            const uint32_t z = ROUND_POWER_OF_TWO(p * s, SGRPROJ_MTABLE_BITS);
-
-            // Note: We have to be quite careful about the value of A[k].
-            // This is used as a blend factor between individual pixel values and the
-            // local mean. So it logically has a range of [0, 256], including both
-            // endpoints.
-            //
-            // This is a pain for hardware, as we'd like something which can be stored
-            // in exactly 8 bits.
-            // Further, in the calculation of B[k] below, if z == 0 and r == 2,
-            // then A[k] "should be" 0. But then we can end up setting B[k] to a value
-            // slightly above 2^(8 + bit depth), due to rounding in the value of
-            // eb_one_by_x[25-1].
-            //
-            // Thus we saturate so that, when z == 0, A[k] is set to 1 instead of 0.
-            // This fixes the above issues (256 - A[k] fits in a uint8, and we can't
-            // overflow), without significantly affecting the final result: z == 0
-            // implies that the image is essentially "flat", so the local mean and
-            // individual pixel values are very similar.
-            //
-            // Note that saturating on the other side, ie. requring A[k] <= 255,
-            // would be a bad idea, as that corresponds to the case where the image
-            // is very variable, when we want to preserve the local pixel value as
-            // much as possible.
-            A[k] = eb_x_by_xplus1[AOMMIN(z, 255)]; // in range [1, 256]
-
-            // SGRPROJ_SGR - A[k] < 2^8 (from above), B[k] < 2^(bit_depth) * n,
-            // eb_one_by_x[n - 1] = round(2^12 / n)
-            // => the product here is < 2^(20 + bit_depth) <= 2^32,
-            // and B[k] is set to a value < 2^(8 + bit depth)
-            // This holds even with the rounding in eb_one_by_x and in the overall
-            // result, as long as SGRPROJ_SGR - A[k] is strictly less than 2^8.
-            B[k] = (int32_t)ROUND_POWER_OF_TWO(
-                (uint32_t)(SGRPROJ_SGR - A[k]) * (uint32_t)B[k] * (uint32_t)eb_one_by_x[n - 1],
-                SGRPROJ_RECIP_BITS);
-        }
-    }
-    // Use the A[] and B[] arrays to calculate the filtered image
-    for (i = 0; i < height; ++i) {
-        for (j = 0; j < width; ++j) {
-            const int32_t k  = i * buf_stride + j;
-            const int32_t l  = i * dgd_stride + j;
-            const int32_t m  = i * dst_stride + j;
-            const int32_t nb = 5;
-            const int32_t a =
-                (A[k] + A[k - 1] + A[k + 1] + A[k - buf_stride] + A[k + buf_stride]) * 4 +
-                (A[k - 1 - buf_stride] + A[k - 1 + buf_stride] + A[k + 1 - buf_stride] +
-                 A[k + 1 + buf_stride]) *
-                    3;
-            const int32_t b =
-                (B[k] + B[k - 1] + B[k + 1] + B[k - buf_stride] + B[k + buf_stride]) * 4 +
-                (B[k - 1 - buf_stride] + B[k - 1 + buf_stride] + B[k + 1 - buf_stride] +
-                 B[k + 1 + buf_stride]) *
-                    3;
-            const int32_t v = a * dgd[l] + b;
-            dst[m]          = ROUND_POWER_OF_TWO(v, SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS);
-        }
-    }
+    calc_ab(A, B, buf_stride, width, height, bit_depth, sgr_params_idx, radius_idx, 2 - radius_idx);
+    if (radius_idx)
+        final_filter(
+            dst, dst_stride, A, B, buf_stride, dgd8, dgd8_stride, width, height, highbd);
+    else
+        final_filter_fast(
+            dst, dst_stride, A, B, buf_stride, dgd8, dgd8_stride, width, height, highbd);
 }
 
 void eb_av1_selfguided_restoration_c(const uint8_t *dgd8, int32_t width, int32_t height,
@@ -1016,17 +949,9 @@ void eb_av1_selfguided_restoration_c(const uint8_t *dgd8, int32_t width, int32_t
     const int32_t dgd32_stride = width + 2 * SGRPROJ_BORDER_HORZ;
     int32_t *     dgd32        = dgd32_ + dgd32_stride * SGRPROJ_BORDER_VERT + SGRPROJ_BORDER_HORZ;
 
-    if (highbd) {
-        const uint16_t *dgd16 = CONVERT_TO_SHORTPTR(dgd8);
-        for (int32_t i = -SGRPROJ_BORDER_VERT; i < height + SGRPROJ_BORDER_VERT; ++i) {
-            for (int32_t j = -SGRPROJ_BORDER_HORZ; j < width + SGRPROJ_BORDER_HORZ; ++j)
-                dgd32[i * dgd32_stride + j] = dgd16[i * dgd_stride + j];
-        }
-    } else {
-        for (int32_t i = -SGRPROJ_BORDER_VERT; i < height + SGRPROJ_BORDER_VERT; ++i) {
-            for (int32_t j = -SGRPROJ_BORDER_HORZ; j < width + SGRPROJ_BORDER_HORZ; ++j)
-                dgd32[i * dgd32_stride + j] = dgd8[i * dgd_stride + j];
-        }
+    for (int32_t i = -SGRPROJ_BORDER_VERT; i < height + SGRPROJ_BORDER_VERT; ++i) {
+        for (int32_t j = -SGRPROJ_BORDER_HORZ; j < width + SGRPROJ_BORDER_HORZ; ++j)
+            dgd32[i * dgd32_stride + j] = sgr_pixel(dgd8, i * dgd_stride + j, highbd);
     }
 
     const SgrParamsType *const params = &eb_sgr_params[sgr_params_idx];
@@ -1036,11 +961,101 @@ void eb_av1_selfguided_restoration_c(const uint8_t *dgd8, int32_t width, int32_t
     assert(!(params->r[0] == 0 && params->r[1] == 0));
 
     if (params->r[0] > 0)
-        selfguided_restoration_fast_internal(
-            dgd32, width, height, dgd32_stride, flt0, flt_stride, bit_depth, sgr_params_idx, 0);
+        selfguided_restoration_internal(dgd32,
+                                        width,
+                                        height,
+                                        dgd32_stride,
+                                        dgd8,
+                                        dgd_stride,
+                                        flt0,
+                                        flt_stride,
+                                        bit_depth,
+                                        highbd,
+                                        sgr_params_idx,
+                                        0);
     if (params->r[1] > 0)
-        selfguided_restoration_internal(
-            dgd32, width, height, dgd32_stride, flt1, flt_stride, bit_depth, sgr_params_idx, 1);
+        selfguided_restoration_internal(dgd32,
+                                        width,
+                                        height,
+                                        dgd32_stride,
+                                        dgd8,
+                                        dgd_stride,
+                                        flt1,
+                                        flt_stride,
+                                        bit_depth,
+                                        highbd,
+                                        sgr_params_idx,
+                                        1);
+}
+
+void eb_av1_selfguided_integral_images_c(const uint8_t *dgd8, int32_t width, int32_t height,
+                                         int32_t dgd_stride, int32_t *sgr_buf, int32_t highbd) {
+    const int32_t  width_ext  = width + 2 * SGRPROJ_BORDER_HORZ;
+    const int32_t  height_ext = height + 2 * SGRPROJ_BORDER_VERT;
+    const int32_t  buf_stride = sgrproj_ii_stride(width);
+    const uint8_t *dgd0 = dgd8 - SGRPROJ_BORDER_HORZ - dgd_stride * SGRPROJ_BORDER_VERT;
+    // The sums of squares of a whole unit overflow 32 bits: as in the SIMD
+    // version, the integral images wrap around, the box sums (differences of 4
+    // of their values) being exact
+    uint32_t *ctl = (uint32_t *)sgr_buf + 2 * SGRPROJ_II_PELS + 7;
+    uint32_t *dtl = (uint32_t *)sgr_buf + 3 * SGRPROJ_II_PELS + 7;
+
+    memset(ctl, 0, sizeof(*ctl) * (width_ext + 1));
+    memset(dtl, 0, sizeof(*dtl) * (width_ext + 1));
+    for (int32_t i = 0; i < height_ext; ++i) {
+        uint32_t *ct    = ctl + (i + 1) * buf_stride;
+        uint32_t *dt    = dtl + (i + 1) * buf_stride;
+        uint32_t  c_row = 0;
+        uint32_t  d_row = 0;
+
+        ct[0] = dt[0] = 0;
+        for (int32_t j = 0; j < width_ext; ++j) {
+            const uint32_t v = (uint32_t)sgr_pixel(dgd0, i * dgd_stride + j, highbd);
+            c_row += v * v;
+            d_row += v;
+            ct[j + 1] = ct[j + 1 - buf_stride] + c_row;
+            dt[j + 1] = dt[j + 1 - buf_stride] + d_row;
+        }
+    }
+}
+
+void eb_av1_selfguided_restoration_ii_c(const uint8_t *dgd8, int32_t width, int32_t height,
+                                        int32_t dgd_stride, int32_t *sgr_buf, int32_t *flt0,
+                                        int32_t *flt1, int32_t flt_stride, int32_t sgr_params_idx,
+                                        int32_t bit_depth, int32_t highbd) {
+    const SgrParamsType *const params     = &eb_sgr_params[sgr_params_idx];
+    const int32_t              buf_stride = sgrproj_ii_stride(width);
+    int32_t *                  A          = sgrproj_ii_origin(sgr_buf, 0, buf_stride);
+    int32_t *                  B          = sgrproj_ii_origin(sgr_buf, 1, buf_stride);
+    const uint32_t *           C = (const uint32_t *)sgrproj_ii_origin(sgr_buf, 2, buf_stride);
+    const uint32_t *           D = (const uint32_t *)sgrproj_ii_origin(sgr_buf, 3, buf_stride);
+
+    assert(!(params->r[0] == 0 && params->r[1] == 0));
+
+    for (int32_t radius_idx = 0; radius_idx < 2; ++radius_idx) {
+        const int32_t r        = params->r[radius_idx];
+        const int32_t row_step = 2 - radius_idx;
+
+        if (!r) continue;
+        // Box sums of the rows calculated by calc_ab()
+        for (int32_t i = -1; i < height + 1; i += row_step) {
+            for (int32_t j = -1; j < width + 1; ++j) {
+                const int32_t k  = i * buf_stride + j;
+                const int32_t tl = k - (r + 1) * buf_stride - (r + 1);
+                const int32_t tr = k - (r + 1) * buf_stride + r;
+                const int32_t bl = k + r * buf_stride - (r + 1);
+                const int32_t br = k + r * buf_stride + r;
+                A[k]             = (int32_t)(C[br] - C[bl] - C[tr] + C[tl]);
+                B[k]             = (int32_t)(D[br] - D[bl] - D[tr] + D[tl]);
+            }
+        }
+        calc_ab(A, B, buf_stride, width, height, bit_depth, sgr_params_idx, radius_idx, row_step);
+        if (radius_idx)
+            final_filter(flt1, flt_stride, A, B, buf_stride, dgd8, dgd_stride, width, height, highbd);
+        else
+            final_filter_fast(
+                flt0, flt_stride, A, B, buf_stride, dgd8, dgd_stride, width, height, highbd);
+    }
 }
 
 void eb_apply_selfguided_restoration_c(const uint8_t *dat8, int32_t width, int32_t height,
@@ -88,6 +88,25 @@ void eb_apply_selfguided_restoration_c(const uint8_t *dat8, int32_t width, int32
 // on the decoder side.
 #define SGRPROJ_TMPBUF_SIZE (RESTORATION_UNITPELS_MAX * 2 * sizeof(int32_t))
 
+// Self-guided filter buffers of a whole restoration unit, for the search: A, b,
+// and the integral images C (sums of squares) and D (sums) of the unit with its
+// borders, computed once and shared by all the parameter sets of the search
+#define SGRPROJ_II_STRIDE_MAX ALIGN_POWER_OF_TWO(RESTORATION_UNITPELS_HORZ_MAX, 3)
+#define SGRPROJ_II_PELS (SGRPROJ_II_STRIDE_MAX * (RESTORATION_UNITPELS_VERT_MAX + 8))
+#define SGRPROJ_II_BUF_SIZE (4 * SGRPROJ_II_PELS * sizeof(int32_t))
+
+static INLINE int32_t sgrproj_ii_stride(int32_t width) {
+    return ALIGN_POWER_OF_TWO(width + 2 * SGRPROJ_BORDER_HORZ + 16, 3);
+}
+
+// Position (0, 0) of the buffer idx (0: A, 1: b, 2: C, 3: D). Column 1 of each
+// buffer is 32-byte aligned, and the integral images have a zero top row and
+// left column.
+static INLINE int32_t *sgrproj_ii_origin(int32_t *sgr_buf, int32_t idx, int32_t buf_stride) {
+    return sgr_buf + idx * SGRPROJ_II_PELS + 8 + buf_stride * (SGRPROJ_BORDER_VERT + 1) +
+           SGRPROJ_BORDER_HORZ;
+}
+
 #define SGRPROJ_EXTBUF_SIZE (0)
 #define SGRPROJ_PARAMS_BITS 4
 #define SGRPROJ_PARAMS (1 << SGRPROJ_PARAMS_BITS)
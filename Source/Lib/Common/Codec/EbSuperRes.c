@@ -16,6 +16,7 @@
 #include "EbResize.h"
 #include "EbUtility.h"
 #include "EbSuperRes.h"
+#include "common_dsp_rtcd.h"
 
 #define FILTER_BITS 7
 
@@ -128,15 +129,15 @@ void upscale_normative_rect(const uint8_t *const input, int height, int width, i
         }
     }
 
-    av1_convolve_horiz_rs_c(input - 1,
-                            in_stride,
-                            output,
-                            out_stride,
-                            width2,
-                            height2,
-                            &av1_resize_filter_normative[0][0],
-                            x0_qn,
-                            x_step_qn);
+    av1_convolve_horiz_rs(input - 1,
+                          in_stride,
+                          output,
+                          out_stride,
+                          width2,
+                          height2,
+                          &av1_resize_filter_normative[0][0],
+                          x0_qn,
+                          x_step_qn);
 
     /* Restore the left/right border pixels */
     if (pad_left) {
@@ -190,16 +191,16 @@ void highbd_upscale_normative_rect(const uint8_t *const input, int height, int w
         }
     }
 
-    av1_highbd_convolve_horiz_rs_c(((uint16_t *)(input)-1),
-                                   in_stride,
-                                   (uint16_t *)(output),
-                                   out_stride,
-                                   width2,
-                                   height2,
-                                   &av1_resize_filter_normative[0][0],
-                                   x0_qn,
-                                   x_step_qn,
-                                   bd);
+    av1_highbd_convolve_horiz_rs(((uint16_t *)(input)-1),
+                                 in_stride,
+                                 (uint16_t *)(output),
+                                 out_stride,
+                                 width2,
+                                 height2,
+                                 &av1_resize_filter_normative[0][0],
+                                 x0_qn,
+                                 x_step_qn,
+                                 bd);
 
     /*Restore the left/right border pixels*/
     if (pad_left) {
@@ -277,6 +277,13 @@ void setup_common_rtcd_internal(CPU_FLAGS flags) {
     eb_av1_selfguided_restoration = eb_av1_selfguided_restoration_c;
     if (flags & HAS_AVX2) eb_av1_selfguided_restoration = eb_av1_selfguided_restoration_avx2;
 
+    eb_av1_selfguided_integral_images = eb_av1_selfguided_integral_images_c;
+    if (flags & HAS_AVX2)
+        eb_av1_selfguided_integral_images = eb_av1_selfguided_integral_images_avx2;
+
+    eb_av1_selfguided_restoration_ii = eb_av1_selfguided_restoration_ii_c;
+    if (flags & HAS_AVX2) eb_av1_selfguided_restoration_ii = eb_av1_selfguided_restoration_ii_avx2;
+
     eb_av1_inv_txfm2d_add_16x16 = eb_av1_inv_txfm2d_add_16x16_c;
     eb_av1_inv_txfm2d_add_32x32 = eb_av1_inv_txfm2d_add_32x32_c;
     eb_av1_inv_txfm2d_add_4x4   = eb_av1_inv_txfm2d_add_4x4_c;
@@ -387,6 +394,9 @@ void setup_common_rtcd_internal(CPU_FLAGS flags) {
     if (flags & HAS_AVX2) eb_av1_convolve_2d_copy_sr = eb_av1_convolve_2d_copy_sr_avx2;
 
     eb_av1_convolve_2d_scale = eb_av1_convolve_2d_scale_c;
+    if (flags & HAS_SSE4_1) eb_av1_convolve_2d_scale = eb_av1_convolve_2d_scale_sse4_1;
+    av1_convolve_horiz_rs = av1_convolve_horiz_rs_c;
+    if (flags & HAS_SSE4_1) av1_convolve_horiz_rs = av1_convolve_horiz_rs_sse4_1;
 
     eb_av1_highbd_convolve_2d_copy_sr = eb_av1_highbd_convolve_2d_copy_sr_c;
     if (flags & HAS_AVX2)
@@ -400,6 +410,10 @@ void setup_common_rtcd_internal(CPU_FLAGS flags) {
     if (flags & HAS_AVX2) eb_av1_highbd_convolve_2d_sr = eb_av1_highbd_convolve_2d_sr_avx2;
 
     eb_av1_highbd_convolve_2d_scale = eb_av1_highbd_convolve_2d_scale_c;
+    if (flags & HAS_SSE4_1)
+        eb_av1_highbd_convolve_2d_scale = eb_av1_highbd_convolve_2d_scale_sse4_1;
+    av1_highbd_convolve_horiz_rs = av1_highbd_convolve_horiz_rs_c;
+    if (flags & HAS_SSE4_1) av1_highbd_convolve_horiz_rs = av1_highbd_convolve_horiz_rs_sse4_1;
 
     eb_av1_highbd_jnt_convolve_2d = eb_av1_highbd_jnt_convolve_2d_c;
     if (flags & HAS_AVX2) eb_av1_highbd_jnt_convolve_2d = eb_av1_highbd_jnt_convolve_2d_avx2;
@@ -1020,6 +1034,8 @@ void setup_common_rtcd_internal(CPU_FLAGS flags) {
 
     eb_copy_rect8_8bit_to_16bit = eb_copy_rect8_8bit_to_16bit_c;
     if (flags & HAS_AVX2) eb_copy_rect8_8bit_to_16bit = eb_copy_rect8_8bit_to_16bit_avx2;
+    eb_copy_rect16_16bit_to_8bit = eb_copy_rect16_16bit_to_8bit_c;
+    if (flags & HAS_AVX2) eb_copy_rect16_16bit_to_8bit = eb_copy_rect16_16bit_to_8bit_avx2;
 
     eb_cdef_filter_block_8x8_16 =
             eb_cdef_filter_block_8x8_16_avx2; // It has no c version, and is only called in parent avx2 function, so it's safe to initialize to avx2 version.
@@ -158,6 +158,8 @@ uint32_t nxm_sad_kernel_helper_avx2(const uint8_t *src, uint32_t src_stride, con
 uint32_t sad_16bit_kernel_avx2(uint16_t *src, uint32_t src_stride, uint16_t *ref,
                                uint32_t ref_stride, uint32_t height, uint32_t width);
 
+uint32_t eb_hist_abs_diff_avx2(const uint32_t *hist_a, const uint32_t *hist_b, uint32_t n);
+
 #ifdef __cplusplus
 }
 #endif
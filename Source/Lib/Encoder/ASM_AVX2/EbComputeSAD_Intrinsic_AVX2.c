@@ -4,6 +4,7 @@
 */
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include "EbComputeSAD_AVX2.h"
 #include "EbDefinitions.h"
@@ -8851,3 +8852,26 @@ uint32_t sad_16bit_kernel_avx2(uint16_t *src, // input parameter, source samples
     }
     return sad;
 }
+
+uint32_t eb_hist_abs_diff_avx2(const uint32_t *hist_a, const uint32_t *hist_b, uint32_t n) {
+    __m256i  sum = _mm256_setzero_si256();
+    __m128i  sum_128;
+    uint32_t bin = 0;
+    uint32_t diff;
+
+    for (; bin + 8 <= n; bin += 8) {
+        const __m256i a = _mm256_loadu_si256((const __m256i *)(hist_a + bin));
+        const __m256i b = _mm256_loadu_si256((const __m256i *)(hist_b + bin));
+        sum = _mm256_add_epi32(sum, _mm256_abs_epi32(_mm256_sub_epi32(a, b)));
+    }
+
+    sum_128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    sum_128 = _mm_add_epi32(sum_128, _mm_srli_si128(sum_128, 8));
+    sum_128 = _mm_add_epi32(sum_128, _mm_srli_si128(sum_128, 4));
+    diff    = (uint32_t)_mm_cvtsi128_si32(sum_128);
+
+    for (; bin < n; bin++)
+        diff += (uint32_t)abs((int32_t)hist_a[bin] - (int32_t)hist_b[bin]);
+
+    return diff;
+}
@@ -10,10 +10,15 @@
  */
 
 #include <immintrin.h> /* AVX2 */
+#include <stdlib.h>
 
 #include "EbDefinitions.h"
+#include "EbCabacContextModel.h"
+#include "EbCommonUtils.h"
+#include "EbBitstreamUnit.h"
 #include "synonyms.h"
 #include "synonyms_avx2.h"
+#include "aom_dsp_rtcd.h"
 
 static INLINE __m256i txb_init_levels_avx2(const TranLow *const coeff) {
     const __m256i idx   = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
@@ -117,3 +122,301 @@ void eb_av1_txb_init_levels_avx2(const TranLow *const coeff, const int32_t width
         xx_storeu_128(ls + 4 * 32, x_zeros);
     }
 }
+
+static INLINE __m256i xx_to_yy(const __m128i lo, const __m128i hi) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Levels of 2 rows of 16 (width 16) or of 1 row of 32 (width 32)
+static INLINE void load_levels_32x5_avx2(const uint8_t *const src, const int32_t width,
+                                         const int32_t stride, const ptrdiff_t *const offsets,
+                                         __m256i *const level) {
+    if (width == 16) {
+        level[0] = yy_loadu2_128(src + stride + 1, src + 1);
+        level[1] = yy_loadu2_128(src + 2 * stride, src + stride);
+        level[2] = yy_loadu2_128(src + stride + offsets[0], src + offsets[0]);
+        level[3] = yy_loadu2_128(src + stride + offsets[1], src + offsets[1]);
+        level[4] = yy_loadu2_128(src + stride + offsets[2], src + offsets[2]);
+    } else {
+        level[0] = yy_loadu_256(src + 1);
+        level[1] = yy_loadu_256(src + stride);
+        level[2] = yy_loadu_256(src + offsets[0]);
+        level[3] = yy_loadu_256(src + offsets[1]);
+        level[4] = yy_loadu_256(src + offsets[2]);
+    }
+}
+
+static INLINE __m256i get_coeff_contexts_kernel_avx2(__m256i *const level) {
+    const __m256i const_3 = _mm256_set1_epi8(3);
+    const __m256i const_4 = _mm256_set1_epi8(4);
+    __m256i       count;
+
+    count    = _mm256_min_epu8(level[0], const_3);
+    level[1] = _mm256_min_epu8(level[1], const_3);
+    level[2] = _mm256_min_epu8(level[2], const_3);
+    level[3] = _mm256_min_epu8(level[3], const_3);
+    level[4] = _mm256_min_epu8(level[4], const_3);
+    count    = _mm256_add_epi8(count, level[1]);
+    count    = _mm256_add_epi8(count, level[2]);
+    count    = _mm256_add_epi8(count, level[3]);
+    count    = _mm256_add_epi8(count, level[4]);
+    count    = _mm256_avg_epu8(count, _mm256_setzero_si256());
+    count    = _mm256_min_epu8(count, const_4);
+    return count;
+}
+
+/*
+ * The 16n kernels below process 32 contexts per iteration: 2 rows when the
+ * (padded) width is 16, 1 row otherwise (width is at most 32). The position
+ * offsets of each 16-context half follow the sse2 row state machine.
+ */
+static INLINE void get_16n_coeff_contexts_2d_avx2(const uint8_t *levels, const int32_t real_width,
+                                                  const int32_t real_height, const int32_t width,
+                                                  const int32_t height,
+                                                  const ptrdiff_t *const offsets,
+                                                  int8_t *const          coeff_contexts) {
+    const int32_t stride = width + TX_PAD_HOR;
+    int8_t *      cc     = coeff_contexts;
+    int32_t       row    = height;
+    __m128i       pos_to_offset[5];
+    __m128i       pos_to_offset_large[3];
+    __m256i       count;
+    __m256i       level[5];
+
+    assert(width == 16 || width == 32);
+
+    pos_to_offset_large[2] = _mm_set1_epi8(21);
+    if (real_width == real_height) {
+        pos_to_offset[0] =
+            _mm_setr_epi8(0, 1, 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[1] =
+            _mm_setr_epi8(1, 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[2] =
+            _mm_setr_epi8(6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[3] =
+            _mm_setr_epi8(6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[4] = pos_to_offset_large[0] = pos_to_offset_large[1] = pos_to_offset_large[2];
+    } else if (real_width > real_height) {
+        pos_to_offset[0] =
+            _mm_setr_epi8(0, 16, 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[1] =
+            _mm_setr_epi8(16, 16, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[2] = pos_to_offset[3] = pos_to_offset[4] =
+            _mm_setr_epi8(16, 16, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset_large[0] = pos_to_offset_large[1] = pos_to_offset_large[2];
+    } else { // real_width < real_height
+        pos_to_offset[0] = pos_to_offset[1] = _mm_set1_epi8(11);
+        pos_to_offset[2] =
+            _mm_setr_epi8(6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[3] =
+            _mm_setr_epi8(6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21);
+        pos_to_offset[4]       = pos_to_offset_large[2];
+        pos_to_offset_large[0] = pos_to_offset_large[1] = _mm_set1_epi8(11);
+    }
+
+    do {
+        load_levels_32x5_avx2(levels, width, stride, offsets, level);
+        count = get_coeff_contexts_kernel_avx2(level);
+        if (width == 16) {
+            count = _mm256_add_epi8(count, xx_to_yy(pos_to_offset[0], pos_to_offset[1]));
+            pos_to_offset[0] = pos_to_offset[2];
+            pos_to_offset[1] = pos_to_offset[3];
+            pos_to_offset[2] = pos_to_offset[3] = pos_to_offset[4];
+            levels += 2 * stride;
+            row -= 2;
+        } else {
+            count = _mm256_add_epi8(count, xx_to_yy(pos_to_offset[0], pos_to_offset_large[0]));
+            pos_to_offset[0]       = pos_to_offset[1];
+            pos_to_offset[1]       = pos_to_offset[2];
+            pos_to_offset[2]       = pos_to_offset[3];
+            pos_to_offset[3]       = pos_to_offset[4];
+            pos_to_offset_large[0] = pos_to_offset_large[1];
+            pos_to_offset_large[1] = pos_to_offset_large[2];
+            levels += stride;
+            row--;
+        }
+        yy_storeu_256(cc, count);
+        cc += 32;
+    } while (row);
+
+    coeff_contexts[0] = 0;
+}
+
+static INLINE void get_16n_coeff_contexts_hor_avx2(const uint8_t *levels, const int32_t width,
+                                                   const int32_t height,
+                                                   const ptrdiff_t *const offsets,
+                                                   int8_t *               coeff_contexts) {
+    const int32_t stride              = width + TX_PAD_HOR;
+    const __m128i pos_to_offset_large = _mm_set1_epi8(SIG_COEF_CONTEXTS_2D + 10);
+    const __m128i pos_to_offset_first = _mm_setr_epi8(SIG_COEF_CONTEXTS_2D + 0,
+                                                      SIG_COEF_CONTEXTS_2D + 5,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10,
+                                                      SIG_COEF_CONTEXTS_2D + 10);
+    const __m256i pos_to_offset = (width == 16)
+        ? xx_to_yy(pos_to_offset_first, pos_to_offset_first)
+        : xx_to_yy(pos_to_offset_first, pos_to_offset_large);
+    const int32_t rows_per_iter = (width == 16) ? 2 : 1;
+    __m256i       count;
+    __m256i       level[5];
+    int32_t       row = height;
+
+    assert(width == 16 || width == 32);
+
+    do {
+        load_levels_32x5_avx2(levels, width, stride, offsets, level);
+        count = get_coeff_contexts_kernel_avx2(level);
+        count = _mm256_add_epi8(count, pos_to_offset);
+        yy_storeu_256(coeff_contexts, count);
+        levels += rows_per_iter * stride;
+        coeff_contexts += 32;
+        row -= rows_per_iter;
+    } while (row);
+}
+
+static INLINE void get_16n_coeff_contexts_ver_avx2(const uint8_t *levels, const int32_t width,
+                                                   const int32_t height,
+                                                   const ptrdiff_t *const offsets,
+                                                   int8_t *               coeff_contexts) {
+    const int32_t stride = width + TX_PAD_HOR;
+    __m128i       pos_to_offset[3];
+    __m256i       count;
+    __m256i       level[5];
+    int32_t       row = height;
+
+    assert(width == 16 || width == 32);
+
+    pos_to_offset[0] = _mm_set1_epi8(SIG_COEF_CONTEXTS_2D + 0);
+    pos_to_offset[1] = _mm_set1_epi8(SIG_COEF_CONTEXTS_2D + 5);
+    pos_to_offset[2] = _mm_set1_epi8(SIG_COEF_CONTEXTS_2D + 10);
+
+    do {
+        load_levels_32x5_avx2(levels, width, stride, offsets, level);
+        count = get_coeff_contexts_kernel_avx2(level);
+        if (width == 16) {
+            count = _mm256_add_epi8(count, xx_to_yy(pos_to_offset[0], pos_to_offset[1]));
+            pos_to_offset[0] = pos_to_offset[1] = pos_to_offset[2];
+            levels += 2 * stride;
+            row -= 2;
+        } else {
+            count = _mm256_add_epi8(count, xx_to_yy(pos_to_offset[0], pos_to_offset[0]));
+            pos_to_offset[0] = pos_to_offset[1];
+            pos_to_offset[1] = pos_to_offset[2];
+            levels += stride;
+            row--;
+        }
+        yy_storeu_256(coeff_contexts, count);
+        coeff_contexts += 32;
+    } while (row);
+}
+
+void eb_av1_get_nz_map_contexts_avx2(const uint8_t *const levels, const int16_t *const scan,
+                                     const uint16_t eob, TxSize tx_size, const TxClass tx_class,
+                                     int8_t *const coeff_contexts) {
+    const int32_t last_idx = eob - 1;
+    if (!last_idx) {
+        coeff_contexts[0] = 0;
+        return;
+    }
+
+    const int32_t width = get_txb_wide(tx_size);
+
+    // 4 and 8 wide blocks fit in a single sse2 register
+    if (width < 16) {
+        eb_av1_get_nz_map_contexts_sse2(levels, scan, eob, tx_size, tx_class, coeff_contexts);
+        return;
+    }
+
+    const int32_t real_width  = tx_size_wide[tx_size];
+    const int32_t real_height = tx_size_high[tx_size];
+    const int32_t height      = get_txb_high(tx_size);
+    const int32_t stride      = width + TX_PAD_HOR;
+    ptrdiff_t     offsets[3];
+
+    if (tx_class == TX_CLASS_2D) {
+        offsets[0] = 0 * stride + 2;
+        offsets[1] = 1 * stride + 1;
+        offsets[2] = 2 * stride + 0;
+        get_16n_coeff_contexts_2d_avx2(
+            levels, real_width, real_height, width, height, offsets, coeff_contexts);
+    } else if (tx_class == TX_CLASS_HORIZ) {
+        offsets[0] = 2;
+        offsets[1] = 3;
+        offsets[2] = 4;
+        get_16n_coeff_contexts_hor_avx2(levels, width, height, offsets, coeff_contexts);
+    } else { // TX_CLASS_VERT
+        offsets[0] = 2 * stride;
+        offsets[1] = 3 * stride;
+        offsets[2] = 4 * stride;
+        get_16n_coeff_contexts_ver_avx2(levels, width, height, offsets, coeff_contexts);
+    }
+
+    const int32_t bwl = get_txb_bwl(tx_size);
+    const int32_t pos = scan[last_idx];
+    if (last_idx <= (height << bwl) / 8)
+        coeff_contexts[pos] = 1;
+    else if (last_idx <= (height << bwl) / 4)
+        coeff_contexts[pos] = 2;
+    else
+        coeff_contexts[pos] = 3;
+}
+
+/*
+ * Fast RDOQ stage: scan positions are checked 8 at a time from the tail, the
+ * first one (backward) that can not be zeroed out ends the search. The dc
+ * position (scan index 0, the only one with rc == 0) is checked in C.
+ */
+void eb_av1_update_coeff_eob_fast_avx2(uint16_t *eob, int shift, const int16_t *dequant_ptr,
+                                       const int16_t *scan, const TranLow *coeff_ptr,
+                                       TranLow *qcoeff_ptr, TranLow *dqcoeff_ptr) {
+    const int     zbin_dc = dequant_ptr[0] + ROUND_POWER_OF_TWO(dequant_ptr[0] * 70, 7);
+    const int     zbin_ac = dequant_ptr[1] + ROUND_POWER_OF_TWO(dequant_ptr[1] * 70, 7);
+    const __m256i zbin_m1 = _mm256_set1_epi32(zbin_ac - 1);
+    const __m128i sh      = _mm_cvtsi32_si128(1 + shift);
+    const int     eob_in  = *eob;
+    int           i       = eob_in;
+    int           found   = 0;
+
+    while (i > 8) {
+        const __m256i rc     = _mm256_cvtepi16_epi32(xx_loadu_128(scan + i - 8));
+        const __m256i coeff  = _mm256_i32gather_epi32((const int *)coeff_ptr, rc, 4);
+        const __m256i qcoeff = _mm256_i32gather_epi32((const int *)qcoeff_ptr, rc, 4);
+        const __m256i abs    = _mm256_sll_epi32(_mm256_abs_epi32(coeff), sh);
+        // keep: (abs_coeff << (1 + shift)) >= zbin && qcoeff != 0
+        const __m256i keep = _mm256_andnot_si256(
+            _mm256_cmpeq_epi32(qcoeff, _mm256_setzero_si256()), _mm256_cmpgt_epi32(abs, zbin_m1));
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(keep));
+        if (mask) {
+            i     = i - 8 + get_msb((uint32_t)mask) + 1;
+            found = 1;
+            break;
+        }
+        i -= 8;
+    }
+
+    if (!found) {
+        for (; i > 0; i--) {
+            const int rc    = scan[i - 1];
+            const int coeff = abs(coeff_ptr[rc]);
+            if (((int64_t)coeff << (1 + shift)) >= (rc ? zbin_ac : zbin_dc) && qcoeff_ptr[rc])
+                break;
+        }
+    }
+
+    for (int c = i; c < eob_in; c++) {
+        qcoeff_ptr[scan[c]]  = 0;
+        dqcoeff_ptr[scan[c]] = 0;
+    }
+    *eob = (uint16_t)i;
+}
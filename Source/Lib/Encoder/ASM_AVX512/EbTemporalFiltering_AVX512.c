@@ -0,0 +1,376 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbDefinitions.h"
+
+#ifndef NON_AVX512_SUPPORT
+
+#include <assert.h>
+#include <immintrin.h>
+#include "EbTemporalFiltering.h"
+
+// Largest block handled by the kernels (the engine filters 32x32 blocks), larger or odd sized
+// blocks are sent to the C version
+#define TF_MAX_BW (BW >> 1)
+#define TF_MAX_BH (BH >> 1)
+// Squared errors are stored with a zero border of one pixel, so that the 3x3 sums of the pixels
+// on the block edges only add the pixels inside the block. The extra 16 entries cover the loads
+// of the chroma rows that are up-sampled to the luma width.
+#define TF_SE_BUF_SIZE ((TF_MAX_BW + 2) * (TF_MAX_BH + 2) + 16)
+
+// mod = (sum_dist / index) * 3, in Q16 and Q32
+static const uint32_t index_mult[14] = {
+    0, 0, 0, 0, 49152, 39322, 32768, 28087, 24576, 21846, 19661, 17874, 0, 15124};
+static const uint32_t index_mult_highbd[14] = {0U,
+                                               0U,
+                                               0U,
+                                               0U,
+                                               3221225472U,
+                                               2576980378U,
+                                               2147483648U,
+                                               1840700270U,
+                                               1610612736U,
+                                               1431655766U,
+                                               1288490189U,
+                                               1171354718U,
+                                               0U,
+                                               991146300U};
+
+static INLINE __m512i load_pels_16(const uint8_t *src, int offset, EbBool is_highbd) {
+    if (is_highbd)
+        return _mm512_cvtepu16_epi32(
+            _mm256_loadu_si256((const __m256i *)((const uint16_t *)src + offset)));
+    return _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *)(src + offset)));
+}
+
+// Store the squared errors of a width x height block in the center of se (stride width + 2)
+static INLINE void store_squared_errors(const uint8_t *s, int s_stride, const uint8_t *p,
+                                        int p_stride, uint32_t *se, int width, int height,
+                                        EbBool is_highbd) {
+    const int se_stride = width + 2;
+
+    memset(se, 0, se_stride * sizeof(*se));
+    se += se_stride;
+    for (int i = 0; i < height; i++) {
+        se[0]         = 0;
+        se[width + 1] = 0;
+        for (int j = 0; j < width; j += 16) {
+            const __m512i diff = _mm512_sub_epi32(load_pels_16(s, i * s_stride + j, is_highbd),
+                                                  load_pels_16(p, i * p_stride + j, is_highbd));
+            _mm512_storeu_si512((__m512i *)(se + 1 + j), _mm512_mullo_epi32(diff, diff));
+        }
+        se += se_stride;
+    }
+    memset(se, 0, se_stride * sizeof(*se));
+}
+
+// Sum of the 3x3 neighborhood of 16 pixels, se points to the padded row above the pixels
+static INLINE __m512i sum_3x3(const uint32_t *se, int se_stride) {
+    __m512i sum = _mm512_setzero_si512();
+    for (int k = 0; k < 3; k++) {
+        sum = _mm512_add_epi32(sum, _mm512_loadu_si512((const __m512i *)(se + 0)));
+        sum = _mm512_add_epi32(sum, _mm512_loadu_si512((const __m512i *)(se + 1)));
+        sum = _mm512_add_epi32(sum, _mm512_loadu_si512((const __m512i *)(se + 2)));
+        se += se_stride;
+    }
+    return sum;
+}
+
+// Number of pixels of the 3x3 neighborhood inside the block is row_cnt * 3, or row_cnt * 2 on
+// the first and last columns
+static INLINE __m512i get_index_mult(int row_cnt, int extra, int x, int width,
+                                     EbBool is_highbd) {
+    const uint32_t *mult      = is_highbd ? index_mult_highbd : index_mult;
+    __mmask16       edge_mask = 0;
+
+    if (x == 0) edge_mask |= 0x0001;
+    if (x + 16 == width) edge_mask |= 0x8000;
+    return _mm512_mask_mov_epi32(_mm512_set1_epi32((int32_t)mult[row_cnt * 3 + extra]),
+                                 edge_mask,
+                                 _mm512_set1_epi32((int32_t)mult[row_cnt * 2 + extra]));
+}
+
+// Vector version of adjust_modifier() / adjust_modifier_highbd()
+static INLINE __m512i adjust_modifier_avx512(__m512i sum_dist, __m512i mult, __m512i rounding,
+                                             __m128i strength, __m512i filter_weight,
+                                             EbBool is_highbd) {
+    __m512i mod;
+
+    if (!is_highbd) {
+        sum_dist = _mm512_min_epu32(sum_dist, _mm512_set1_epi32(UINT16_MAX));
+        mod      = _mm512_srli_epi32(_mm512_mullo_epi32(sum_dist, mult), 16);
+    } else {
+        // (sum_dist * mult) >> 32 on the even and odd lanes
+        sum_dist           = _mm512_min_epu32(sum_dist, _mm512_set1_epi32(INT32_MAX));
+        const __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(sum_dist, mult), 32);
+        const __m512i odd  = _mm512_mul_epu32(_mm512_srli_epi64(sum_dist, 32),
+                                             _mm512_srli_epi64(mult, 32));
+        mod                = _mm512_mask_blend_epi32(0xAAAA, even, odd);
+    }
+    mod = _mm512_srl_epi32(_mm512_add_epi32(mod, rounding), strength);
+    mod = _mm512_min_epi32(mod, _mm512_set1_epi32(16));
+    mod = _mm512_sub_epi32(_mm512_set1_epi32(16), mod);
+    return _mm512_mullo_epi32(mod, filter_weight);
+}
+
+static INLINE void accumulate_16(__m512i mod, const uint8_t *pre, int pre_offset,
+                                 uint32_t *accum, uint16_t *count, EbBool is_highbd) {
+    const __m512i pels = load_pels_16(pre, pre_offset, is_highbd);
+    const __m512i cnt  = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)count));
+    const __m512i acc  = _mm512_loadu_si512((const __m512i *)accum);
+
+    _mm256_storeu_si256((__m256i *)count, _mm512_cvtepi32_epi16(_mm512_add_epi32(cnt, mod)));
+    _mm512_storeu_si512((__m512i *)accum,
+                        _mm512_add_epi32(acc, _mm512_mullo_epi32(mod, pels)));
+}
+
+// Sum of the (1 + ss_y) x (1 + ss_x) luma squared errors of 16 chroma pixels
+static INLINE __m512i sum_luma_of_chroma(const uint32_t *y_se, int y_se_stride, int ss_x,
+                                         int ss_y) {
+    const __m512i idx_even =
+        _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i idx_odd =
+        _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    __m512i sum = _mm512_setzero_si512();
+
+    for (int k = 0; k <= ss_y; k++) {
+        if (ss_x) {
+            const __m512i a = _mm512_loadu_si512((const __m512i *)y_se);
+            const __m512i b = _mm512_loadu_si512((const __m512i *)(y_se + 16));
+            sum = _mm512_add_epi32(sum, _mm512_permutex2var_epi32(a, idx_even, b));
+            sum = _mm512_add_epi32(sum, _mm512_permutex2var_epi32(a, idx_odd, b));
+        } else
+            sum = _mm512_add_epi32(sum, _mm512_loadu_si512((const __m512i *)y_se));
+        y_se += y_se_stride;
+    }
+    return sum;
+}
+
+static INLINE void apply_temporal_filter_avx512(
+    const uint8_t *y_src, int y_src_stride, const uint8_t *y_pre, int y_pre_stride,
+    const uint8_t *u_src, const uint8_t *v_src, int uv_src_stride, const uint8_t *u_pre,
+    const uint8_t *v_pre, int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, uint32_t *y_accum, uint16_t *y_count,
+    uint32_t *u_accum, uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    EbBool is_highbd) {
+    DECLARE_ALIGNED(64, uint32_t, y_se[TF_SE_BUF_SIZE]);
+    DECLARE_ALIGNED(64, uint32_t, u_se[TF_SE_BUF_SIZE]);
+    DECLARE_ALIGNED(64, uint32_t, v_se[TF_SE_BUF_SIZE]);
+    int32_t       col_fw_idx[TF_MAX_BW];
+    int32_t       uv_col_fw_idx[TF_MAX_BW];
+    const int     width        = (int)block_width;
+    const int     height       = (int)block_height;
+    const int     uv_width     = width >> ss_x;
+    const int     uv_height    = height >> ss_y;
+    const int     y_se_stride  = width + 2;
+    const int     uv_se_stride = uv_width + 2;
+    const int     uv_extra     = (1 + ss_x) * (1 + ss_y);
+    const int     fw_cols      = (width == (BW >> 1)) ? 2 : 4;
+    const __m512i rounding     = _mm512_set1_epi32((1 << strength) >> 1);
+    const __m128i shift        = _mm_cvtsi32_si128(strength);
+    const __m512i uv_up_idx    = _mm512_srli_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), ss_x);
+
+    // Sub-block filter weight index of each column, see get_subblock_filter_weight_*subblocks()
+    for (int j = 0; j < width; j++)
+        col_fw_idx[j] = AOMMIN(fw_cols - 1, j / (width / fw_cols));
+    for (int j = 0; j < uv_width; j++) uv_col_fw_idx[j] = col_fw_idx[j << ss_x];
+
+    store_squared_errors(y_src, y_src_stride, y_pre, y_pre_stride, y_se, width, height, is_highbd);
+    store_squared_errors(
+        u_src, uv_src_stride, u_pre, uv_pre_stride, u_se, uv_width, uv_height, is_highbd);
+    store_squared_errors(
+        v_src, uv_src_stride, v_pre, uv_pre_stride, v_se, uv_width, uv_height, is_highbd);
+
+    for (int i = 0; i < height; i++) {
+        const int row_cnt = (i == 0 || i == height - 1) ? 2 : 3;
+        const int row_fw  = AOMMIN(fw_cols - 1, i / (height / fw_cols));
+        const int uv_r    = i >> ss_y;
+        // Filter weights of the 2 or 4 sub-blocks the row crosses
+        const __m512i fw_row = _mm512_castsi128_si512(
+            fw_cols == 2 ? _mm_loadl_epi64((const __m128i *)(blk_fw + row_fw * 2))
+                         : _mm_loadu_si128((const __m128i *)(blk_fw + row_fw * 4)));
+
+        for (int j = 0; j < width; j += 16) {
+            const __m512i fw = _mm512_permutexvar_epi32(
+                _mm512_loadu_si512((const __m512i *)(col_fw_idx + j)), fw_row);
+            const int uv_offset = (uv_r + 1) * uv_se_stride + 1 + (j >> ss_x);
+
+            // Luma: 3x3 neighborhood + co-located chroma
+            const __m512i uv =
+                _mm512_add_epi32(_mm512_loadu_si512((const __m512i *)(u_se + uv_offset)),
+                                 _mm512_loadu_si512((const __m512i *)(v_se + uv_offset)));
+            const __m512i sum = _mm512_add_epi32(sum_3x3(y_se + i * y_se_stride + j, y_se_stride),
+                                                 _mm512_permutexvar_epi32(uv_up_idx, uv));
+            const __m512i mult = get_index_mult(row_cnt, 2, j, width, is_highbd);
+            const __m512i mod  = adjust_modifier_avx512(sum, mult, rounding, shift, fw, is_highbd);
+            accumulate_16(mod,
+                          y_pre,
+                          i * y_pre_stride + j,
+                          y_accum + i * y_pre_stride + j,
+                          y_count + i * y_pre_stride + j,
+                          is_highbd);
+        }
+
+        if (i & ss_y) continue;
+
+        // Chroma: 3x3 neighborhood + co-located luma
+        const int uv_row_cnt = (uv_r == 0 || uv_r == uv_height - 1) ? 2 : 3;
+        for (int j = 0; j < uv_width; j += 16) {
+            const __m512i fw = _mm512_permutexvar_epi32(
+                _mm512_loadu_si512((const __m512i *)(uv_col_fw_idx + j)), fw_row);
+            const __m512i y_sum = sum_luma_of_chroma(
+                y_se + (i + 1) * y_se_stride + 1 + (j << ss_x), y_se_stride, ss_x, ss_y);
+            const __m512i mult  = get_index_mult(uv_row_cnt, uv_extra, j, uv_width, is_highbd);
+            const __m512i u_mod = adjust_modifier_avx512(
+                _mm512_add_epi32(sum_3x3(u_se + uv_r * uv_se_stride + j, uv_se_stride), y_sum),
+                mult,
+                rounding,
+                shift,
+                fw,
+                is_highbd);
+            const __m512i v_mod = adjust_modifier_avx512(
+                _mm512_add_epi32(sum_3x3(v_se + uv_r * uv_se_stride + j, uv_se_stride), y_sum),
+                mult,
+                rounding,
+                shift,
+                fw,
+                is_highbd);
+            const int m = uv_r * uv_pre_stride + j;
+
+            accumulate_16(u_mod, u_pre, m, u_accum + m, u_count + m, is_highbd);
+            accumulate_16(v_mod, v_pre, m, v_accum + m, v_count + m, is_highbd);
+        }
+    }
+}
+
+// Blocks the kernel handles: luma and chroma widths multiple of 16, up to 32x32
+static INLINE EbBool tf_avx512_block_supported(unsigned int block_width,
+                                               unsigned int block_height, int ss_x, int ss_y) {
+    return (block_width <= TF_MAX_BW && block_height <= TF_MAX_BH && !(block_width & 15) &&
+            !((block_width >> ss_x) & 15) && block_height >= 4 && (block_height >> ss_y) >= 2)
+               ? EB_TRUE
+               : EB_FALSE;
+}
+
+void svt_av1_apply_temporal_filter_avx512(
+    const uint8_t *y_src, int y_src_stride, const uint8_t *y_pre, int y_pre_stride,
+    const uint8_t *u_src, const uint8_t *v_src, int uv_src_stride, const uint8_t *u_pre,
+    const uint8_t *v_pre, int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, int use_whole_blk, uint32_t *y_accum,
+    uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count, uint32_t *v_accum,
+    uint16_t *v_count) {
+    assert(use_whole_blk == 0);
+    if (!tf_avx512_block_supported(block_width, block_height, ss_x, ss_y)) {
+        svt_av1_apply_filtering_c(y_src,
+                                  y_src_stride,
+                                  y_pre,
+                                  y_pre_stride,
+                                  u_src,
+                                  v_src,
+                                  uv_src_stride,
+                                  u_pre,
+                                  v_pre,
+                                  uv_pre_stride,
+                                  block_width,
+                                  block_height,
+                                  ss_x,
+                                  ss_y,
+                                  strength,
+                                  blk_fw,
+                                  use_whole_blk,
+                                  y_accum,
+                                  y_count,
+                                  u_accum,
+                                  u_count,
+                                  v_accum,
+                                  v_count);
+        return;
+    }
+    apply_temporal_filter_avx512(y_src,
+                                 y_src_stride,
+                                 y_pre,
+                                 y_pre_stride,
+                                 u_src,
+                                 v_src,
+                                 uv_src_stride,
+                                 u_pre,
+                                 v_pre,
+                                 uv_pre_stride,
+                                 block_width,
+                                 block_height,
+                                 ss_x,
+                                 ss_y,
+                                 strength,
+                                 blk_fw,
+                                 y_accum,
+                                 y_count,
+                                 u_accum,
+                                 u_count,
+                                 v_accum,
+                                 v_count,
+                                 EB_FALSE);
+}
+
+void svt_av1_highbd_apply_temporal_filter_avx512(
+    const uint16_t *y_src, int y_src_stride, const uint16_t *y_pre, int y_pre_stride,
+    const uint16_t *u_src, const uint16_t *v_src, int uv_src_stride, const uint16_t *u_pre,
+    const uint16_t *v_pre, int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, int use_whole_blk, uint32_t *y_accum,
+    uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count, uint32_t *v_accum,
+    uint16_t *v_count) {
+    assert(use_whole_blk == 0);
+    if (!tf_avx512_block_supported(block_width, block_height, ss_x, ss_y)) {
+        svt_av1_apply_filtering_highbd_c(y_src,
+                                         y_src_stride,
+                                         y_pre,
+                                         y_pre_stride,
+                                         u_src,
+                                         v_src,
+                                         uv_src_stride,
+                                         u_pre,
+                                         v_pre,
+                                         uv_pre_stride,
+                                         block_width,
+                                         block_height,
+                                         ss_x,
+                                         ss_y,
+                                         strength,
+                                         blk_fw,
+                                         use_whole_blk,
+                                         y_accum,
+                                         y_count,
+                                         u_accum,
+                                         u_count,
+                                         v_accum,
+                                         v_count);
+        return;
+    }
+    apply_temporal_filter_avx512((const uint8_t *)y_src,
+                                 y_src_stride,
+                                 (const uint8_t *)y_pre,
+                                 y_pre_stride,
+                                 (const uint8_t *)u_src,
+                                 (const uint8_t *)v_src,
+                                 uv_src_stride,
+                                 (const uint8_t *)u_pre,
+                                 (const uint8_t *)v_pre,
+                                 uv_pre_stride,
+                                 block_width,
+                                 block_height,
+                                 ss_x,
+                                 ss_y,
+                                 strength,
+                                 blk_fw,
+                                 y_accum,
+                                 y_count,
+                                 u_accum,
+                                 u_count,
+                                 v_accum,
+                                 v_count,
+                                 EB_TRUE);
+}
+
+#endif // !NON_AVX512_SUPPORT
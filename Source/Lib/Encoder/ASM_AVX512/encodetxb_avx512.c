@@ -7,6 +7,8 @@
 #ifndef NON_AVX512_SUPPORT
 
 #include <immintrin.h> /* AVX2 */
+#include <stdlib.h>
+#include "EbBitstreamUnit.h"
 #include "synonyms.h"
 #include "synonyms_avx2.h"
 
@@ -140,4 +142,48 @@ void eb_av1_txb_init_levels_avx512(const TranLow *const coeff, const int32_t wid
         xx_storeu_128(ls + 2 * 64, x_zeros);
     }
 }
+
+void eb_av1_update_coeff_eob_fast_avx512(uint16_t *eob, int shift, const int16_t *dequant_ptr,
+                                         const int16_t *scan, const TranLow *coeff_ptr,
+                                         TranLow *qcoeff_ptr, TranLow *dqcoeff_ptr) {
+    const int     zbin_dc = dequant_ptr[0] + ROUND_POWER_OF_TWO(dequant_ptr[0] * 70, 7);
+    const int     zbin_ac = dequant_ptr[1] + ROUND_POWER_OF_TWO(dequant_ptr[1] * 70, 7);
+    const __m512i zbin_m1 = _mm512_set1_epi32(zbin_ac - 1);
+    const __m128i sh      = _mm_cvtsi32_si128(1 + shift);
+    const int     eob_in  = *eob;
+    int           i       = eob_in;
+    int           found   = 0;
+
+    // 16 scan positions per iteration from the tail, the dc position is checked in C
+    while (i > 16) {
+        const __m512i rc =
+            _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *)(scan + i - 16)));
+        const __m512i coeff  = _mm512_i32gather_epi32(rc, (const int *)coeff_ptr, 4);
+        const __m512i qcoeff = _mm512_i32gather_epi32(rc, (const int *)qcoeff_ptr, 4);
+        const __m512i abs    = _mm512_sll_epi32(_mm512_abs_epi32(coeff), sh);
+        const __mmask16 keep =
+            _mm512_mask_cmpgt_epi32_mask(_mm512_test_epi32_mask(qcoeff, qcoeff), abs, zbin_m1);
+        if (keep) {
+            i     = i - 16 + get_msb((uint32_t)keep) + 1;
+            found = 1;
+            break;
+        }
+        i -= 16;
+    }
+
+    if (!found) {
+        for (; i > 0; i--) {
+            const int rc    = scan[i - 1];
+            const int coeff = abs(coeff_ptr[rc]);
+            if (((int64_t)coeff << (1 + shift)) >= (rc ? zbin_ac : zbin_dc) && qcoeff_ptr[rc])
+                break;
+        }
+    }
+
+    for (int c = i; c < eob_in; c++) {
+        qcoeff_ptr[scan[c]]  = 0;
+        dqcoeff_ptr[scan[c]] = 0;
+    }
+    *eob = (uint16_t)i;
+}
 #endif // !NON_AVX512_SUPPORT
@@ -357,3 +357,17 @@ uint32_t nxm_sad_avg_kernel_helper_c(uint8_t *src, uint32_t src_stride, uint8_t
 
     return nxm_sad_avg;
 }
+
+/*******************************************
+* eb_hist_abs_diff_c
+*   returns the sum of the absolute differences
+*   of 2 histograms of n bins
+*******************************************/
+uint32_t eb_hist_abs_diff_c(const uint32_t *hist_a, const uint32_t *hist_b, uint32_t n) {
+    uint32_t diff = 0;
+
+    for (uint32_t bin = 0; bin < n; bin++)
+        diff += (uint32_t)ABS((int32_t)hist_a[bin] - (int32_t)hist_b[bin]);
+
+    return diff;
+}
@@ -62,6 +62,8 @@ uint32_t nxm_sad_avg_kernel_helper_c(uint8_t *src, uint32_t src_stride, uint8_t
                                      uint32_t ref1_stride, uint8_t *ref2, uint32_t ref2_stride,
                                      uint32_t height, uint32_t width);
 
+uint32_t eb_hist_abs_diff_c(const uint32_t *hist_a, const uint32_t *hist_b, uint32_t n);
+
 #ifdef __cplusplus
 }
 #endif
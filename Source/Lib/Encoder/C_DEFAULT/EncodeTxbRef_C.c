@@ -428,3 +428,31 @@ void eb_av1_get_nz_map_contexts_c(const uint8_t* const levels, const int16_t* co
             get_nz_map_ctx(levels, pos, bwl, height, i, i == eob - 1, tx_size, tx_class);
     }
 }
+
+/*
+ * Reduce the number of non-zero quantized coefficients before getting to the main/complex RDOQ stage
+ * (it performs an early check of whether to zero out each of the non-zero quantized coefficients,
+ * and updates the quantized coeffs if it is determined it can be zeroed out).
+ */
+void eb_av1_update_coeff_eob_fast_c(uint16_t* eob, int shift, const int16_t* dequant_ptr,
+                                    const int16_t* scan, const TranLow* coeff_ptr,
+                                    TranLow* qcoeff_ptr, TranLow* dqcoeff_ptr) {
+    int eob_out = *eob;
+    int zbin[2] = {dequant_ptr[0] + ROUND_POWER_OF_TWO(dequant_ptr[0] * 70, 7),
+                   dequant_ptr[1] + ROUND_POWER_OF_TWO(dequant_ptr[1] * 70, 7)};
+    for (int i = *eob - 1; i >= 0; i--) {
+        const int rc         = scan[i];
+        const int qcoeff     = qcoeff_ptr[rc];
+        const int coeff      = coeff_ptr[rc];
+        const int coeff_sign = (coeff >> 31);
+        int64_t   abs_coeff  = (coeff ^ coeff_sign) - coeff_sign;
+        if (((abs_coeff << (1 + shift)) < zbin[rc != 0]) || (qcoeff == 0)) {
+            eob_out--;
+            qcoeff_ptr[rc]  = 0;
+            dqcoeff_ptr[rc] = 0;
+        } else {
+            break;
+        }
+    }
+    *eob = eob_out;
+}
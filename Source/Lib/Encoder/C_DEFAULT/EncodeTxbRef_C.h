@@ -21,6 +21,9 @@ extern "C" {
 void eb_av1_get_nz_map_contexts_c(const uint8_t* const levels, const int16_t* const scan,
                                   const uint16_t eob, const TxSize tx_size, const TxClass tx_class,
                                   int8_t* const coeff_contexts);
+void eb_av1_update_coeff_eob_fast_c(uint16_t* eob, int shift, const int16_t* dequant_ptr,
+                                    const int16_t* scan, const TranLow* coeff_ptr,
+                                    TranLow* qcoeff_ptr, TranLow* dqcoeff_ptr);
 #ifdef __cplusplus
 } // extern "C"
 #endif
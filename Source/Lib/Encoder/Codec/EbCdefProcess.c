@@ -22,6 +22,7 @@
 #include "EbEncDecResults.h"
 #include "EbThreads.h"
 #include "EbReferenceObject.h"
+#include "EbPictureOperators.h"
 #include "EbEncCdef.h"
 #include "EbEncDecProcess.h"
 #include "EbPictureBufferDesc.h"
@@ -129,15 +130,16 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
     int32_t  sec_damping = 3 + (frm_hdr->quantization_params.base_q_idx >> 6);
 
     const int32_t num_planes      = 3;
-    const int32_t total_strengths = fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
     DECLARE_ALIGNED(32, uint16_t, inbuf[CDEF_INBUF_SIZE]);
     uint16_t *in;
     DECLARE_ALIGNED(32, uint8_t, tmp_dst[1 << (MAX_SB_SIZE_LOG2 * 2)]);
-
-    int32_t gi_step;
-    int32_t mid_gi;
-    int32_t start_gi;
-    int32_t end_gi;
+    // Fast search: the mse of the 8x8 blocks evaluated are scaled to the filter block
+    const EbBool  fast_search = ppcs->cdef_filter_mode == CDEF_FAST_SEARCH_MODE;
+    CdefList      sub_dlist[MI_SIZE_128X128 * MI_SIZE_128X128];
+    CdefList *    search_list;
+    int32_t       search_count;
+    int32_t       gi_list[TOTAL_STRENGTHS];
+    const int32_t gi_count = get_cdef_search_candidates(ppcs, gi_list);
 
     EbPictureBufferDesc *input_picture_ptr =
         (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
@@ -174,7 +176,6 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
     for (fbr = y_b64_start_idx; fbr < y_b64_end_idx; ++fbr) {
         for (fbc = x_b64_start_idx; fbc < x_b64_end_idx; ++fbc) {
             int32_t nvb, nhb;
-            int32_t gi;
             int32_t dirinit    = 0;
             nhb                = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
             nvb                = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
@@ -208,6 +209,12 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
 
             cdef_count = eb_sb_compute_cdef_list(
                 pcs_ptr, cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, bs);
+            search_list  = dlist;
+            search_count = cdef_count;
+            if (fast_search) {
+                search_list  = sub_dlist;
+                search_count = cdef_subsample_list(sub_dlist, dlist, cdef_count);
+            }
 
             for (pli = 0; pli < num_planes; pli++) {
                 for (int i = 0; i < CDEF_INBUF_SIZE; i++) inbuf[i] = CDEF_VERY_LARGE;
@@ -227,16 +234,8 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                             stride_src[pli],
                             ysize,
                             xsize);
-                gi_step  = get_cdef_gi_step(ppcs->cdef_filter_mode);
-                mid_gi   = ppcs->cdf_ref_frame_strength;
-                start_gi = ppcs->use_ref_frame_cdef_strength && ppcs->cdef_filter_mode == 1
-                               ? (AOMMAX(0, mid_gi - gi_step))
-                               : 0;
-                end_gi = ppcs->use_ref_frame_cdef_strength
-                             ? AOMMIN(total_strengths, mid_gi + gi_step)
-                             : ppcs->cdef_filter_mode == 1 ? 8 : total_strengths;
-
-                for (gi = start_gi; gi < end_gi; gi++) {
+                for (int32_t gi_idx = 0; gi_idx < gi_count; gi_idx++) {
+                    const int32_t gi = gi_list[gi_idx];
                     int32_t  threshold;
                     uint64_t curr_mse;
                     int32_t  sec_strength;
@@ -256,8 +255,8 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                                       &dirinit,
                                       var,
                                       pli,
-                                      dlist,
-                                      cdef_count,
+                                      search_list,
+                                      search_count,
                                       threshold,
                                       sec_strength + (sec_strength == 3),
                                       pri_damping,
@@ -270,11 +269,13 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                             (fbc * MI_SIZE_64X64 << mi_wide_l2[pli]),
                         stride_ref[pli],
                         tmp_dst,
-                        dlist,
-                        cdef_count,
+                        search_list,
+                        search_count,
                         (BlockSize)bsize[pli],
                         coeff_shift,
                         pli);
+                    if (search_count < cdef_count)
+                        curr_mse = curr_mse * cdef_count / search_count;
 
                     if (pli < 2)
                         pcs_ptr->mse_seg[pli][fbr * nhfb + fbc][gi] = curr_mse;
@@ -342,14 +343,16 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
     int32_t   sec_damping = 3 + (frm_hdr->quantization_params.base_q_idx >> 6);
 
     const int32_t num_planes      = 3;
-    const int32_t total_strengths = fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
     DECLARE_ALIGNED(32, uint16_t, inbuf[CDEF_INBUF_SIZE]);
     uint16_t *in;
     DECLARE_ALIGNED(32, uint16_t, tmp_dst[1 << (MAX_SB_SIZE_LOG2 * 2)]);
-    int32_t gi_step;
-    int32_t mid_gi;
-    int32_t start_gi;
-    int32_t end_gi;
+    // Fast search: the mse of the 8x8 blocks evaluated are scaled to the filter block
+    const EbBool  fast_search = ppcs->cdef_filter_mode == CDEF_FAST_SEARCH_MODE;
+    CdefList      sub_dlist[MI_SIZE_128X128 * MI_SIZE_128X128];
+    CdefList *    search_list;
+    int32_t       search_count;
+    int32_t       gi_list[TOTAL_STRENGTHS];
+    const int32_t gi_count = get_cdef_search_candidates(ppcs, gi_list);
 
     for (pli = 0; pli < num_planes; pli++) {
         int32_t subsampling_x = (pli == 0) ? 0 : 1;
@@ -377,7 +380,6 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
     for (fbr = y_b64_start_idx; fbr < y_b64_end_idx; ++fbr) {
         for (fbc = x_b64_start_idx; fbc < x_b64_end_idx; ++fbc) {
             int32_t nvb, nhb;
-            int32_t gi;
             int32_t dirinit    = 0;
             nhb                = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
             nvb                = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
@@ -410,6 +412,12 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
 
             cdef_count = eb_sb_compute_cdef_list(
                 pcs_ptr, cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, bs);
+            search_list  = dlist;
+            search_count = cdef_count;
+            if (fast_search) {
+                search_list  = sub_dlist;
+                search_count = cdef_subsample_list(sub_dlist, dlist, cdef_count);
+            }
 
             for (pli = 0; pli < num_planes; pli++) {
                 for (int i = 0; i < CDEF_INBUF_SIZE; i++) inbuf[i] = CDEF_VERY_LARGE;
@@ -429,16 +437,8 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
                              stride_src[pli],
                              ysize,
                              xsize);
-                gi_step  = get_cdef_gi_step(ppcs->cdef_filter_mode);
-                mid_gi   = ppcs->cdf_ref_frame_strength;
-                start_gi = ppcs->use_ref_frame_cdef_strength && ppcs->cdef_filter_mode == 1
-                               ? (AOMMAX(0, mid_gi - gi_step))
-                               : 0;
-                end_gi = ppcs->use_ref_frame_cdef_strength
-                             ? AOMMIN(total_strengths, mid_gi + gi_step)
-                             : ppcs->cdef_filter_mode == 1 ? 8 : total_strengths;
-
-                for (gi = start_gi; gi < end_gi; gi++) {
+                for (int32_t gi_idx = 0; gi_idx < gi_count; gi_idx++) {
+                    const int32_t gi = gi_list[gi_idx];
                     int32_t  threshold;
                     uint64_t curr_mse;
                     int32_t  sec_strength;
@@ -458,8 +458,8 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
                                       &dirinit,
                                       var,
                                       pli,
-                                      dlist,
-                                      cdef_count,
+                                      search_list,
+                                      search_count,
                                       threshold,
                                       sec_strength + (sec_strength == 3),
                                       pri_damping,
@@ -472,11 +472,13 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
                             (fbc * MI_SIZE_64X64 << mi_wide_l2[pli]),
                         stride_ref[pli],
                         tmp_dst,
-                        dlist,
-                        cdef_count,
+                        search_list,
+                        search_count,
                         (BlockSize)bsize[pli],
                         coeff_shift,
                         pli);
+                    if (search_count < cdef_count)
+                        curr_mse = curr_mse * cdef_count / search_count;
 
                     if (pli < 2)
                         pcs_ptr->mse_seg[pli][fbr * nhfb + fbc][gi] = curr_mse;
@@ -522,6 +524,7 @@ void *cdef_kernel(void *input_ptr) {
         Av1Common *cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
         frm_hdr             = &pcs_ptr->parent_pcs_ptr->frm_hdr;
         int32_t selected_strength_cnt[64] = {0};
+        uint64_t cdef_strength_mask         = 0;
 
         if (scs_ptr->seq_header.enable_cdef && pcs_ptr->parent_pcs_ptr->cdef_filter_mode) {
             if (scs_ptr->static_config.encoder_16bit_pipeline || is_16bit)
@@ -538,6 +541,11 @@ void *cdef_kernel(void *input_ptr) {
             // SVT_LOG("    CDEF all seg here  %i\n", pcs_ptr->picture_number);
             if (scs_ptr->seq_header.enable_cdef && pcs_ptr->parent_pcs_ptr->cdef_filter_mode) {
                 finish_cdef_search(0, pcs_ptr, selected_strength_cnt);
+                cdef_strength_mask = 0;
+                for (int32_t i = 0; i < pcs_ptr->parent_pcs_ptr->nb_cdef_strengths; i++)
+                    cdef_strength_mask |=
+                        ((uint64_t)1 << frm_hdr->cdef_params.cdef_y_strength[i]) |
+                        ((uint64_t)1 << frm_hdr->cdef_params.cdef_uv_strength[i]);
 
                 if (scs_ptr->seq_header.enable_restoration != 0 ||
                     pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
@@ -554,15 +562,16 @@ void *cdef_kernel(void *input_ptr) {
                 frm_hdr->cdef_params.cdef_uv_strength[0]   = 0;
             }
 
+            // Statistics of the fast search of the next pictures of the layer
+            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag)
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->cdef_strength_mask = cdef_strength_mask;
+
             // TODO: remove the copy when entire 16bit pipeline is ready
             if (scs_ptr->static_config.encoder_16bit_pipeline &&
                 scs_ptr->static_config.encoder_bit_depth == EB_8BIT &&
                !scs_ptr->seq_header.enable_restoration) {
-                //copy recon from 16bit to 8bit
-                uint8_t*  recon_8bit;
-                int32_t   recon_stride_8bit;
-                uint16_t* recon_16bit;
-                int32_t   recon_stride_16bit;
                 EbPictureBufferDesc *recon_buffer, *recon_buffer_8bit;
                 if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
                     recon_buffer = ((EbReferenceObject *)
@@ -575,51 +584,7 @@ void *cdef_kernel(void *input_ptr) {
                     recon_buffer = pcs_ptr->recon_picture16bit_ptr;
                     recon_buffer_8bit = pcs_ptr->recon_picture_ptr;
                 }
-                // Y
-                recon_16bit = (uint16_t*)(recon_buffer->buffer_y)
-                            + recon_buffer->origin_x
-                            + recon_buffer->origin_y * recon_buffer->stride_y;
-                recon_stride_16bit = recon_buffer->stride_y;
-                recon_8bit  = recon_buffer_8bit->buffer_y
-                            + recon_buffer_8bit->origin_x
-                            + recon_buffer_8bit->origin_y * recon_buffer_8bit->stride_y;
-                recon_stride_8bit = recon_buffer_8bit->stride_y;
-                for (int j = 0; j < recon_buffer->height; j++) {
-                    for (int i = 0; i < recon_buffer->width; i++) {
-                        recon_8bit[i + j * recon_stride_8bit] =
-                            (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                    }
-                }
-                // Cb
-                recon_16bit = (uint16_t*)(recon_buffer->buffer_cb)
-                            + recon_buffer->origin_x / 2
-                            + recon_buffer->origin_y / 2 * recon_buffer->stride_cb;
-                recon_stride_16bit = recon_buffer->stride_cb;
-                recon_8bit  = recon_buffer_8bit->buffer_cb
-                            + recon_buffer_8bit->origin_x / 2
-                            + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cb;
-                recon_stride_8bit = recon_buffer_8bit->stride_cb;
-                for (int j = 0; j < recon_buffer->height / 2; j++) {
-                    for (int i = 0; i < recon_buffer->width / 2; i++) {
-                        recon_8bit[i + j * recon_stride_8bit] =
-                            (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                    }
-                }
-                // Cr
-                recon_16bit = (uint16_t*)(recon_buffer->buffer_cr)
-                            + recon_buffer->origin_x / 2
-                            + recon_buffer->origin_y / 2 * recon_buffer->stride_cr;
-                recon_stride_16bit = recon_buffer->stride_cr;
-                recon_8bit  = recon_buffer_8bit->buffer_cr
-                            + recon_buffer_8bit->origin_x / 2
-                            + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cr;
-                recon_stride_8bit = recon_buffer_8bit->stride_cr;
-                for (int j = 0; j < recon_buffer->height / 2; j++) {
-                    for (int i = 0; i < recon_buffer->width / 2; i++) {
-                        recon_8bit[i + j * recon_stride_8bit] =
-                            (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                    }
-                }
+                picture_convert_16bit_to_8bit(recon_buffer, recon_buffer_8bit, 0, recon_buffer->height);
             }
 
             //restoration prep
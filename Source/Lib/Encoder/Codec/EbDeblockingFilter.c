@@ -172,11 +172,11 @@ static TxSize get_transform_size(const MacroBlockD *const xd, const MbModeInfo *
 // awared
 static TxSize set_lpf_parameters(Av1DeblockingParameters *const params, const uint64_t mode_step,
                                  const PictureControlSet *const pcs_ptr,
+                                 const LoopFilterInfoN *const lfi_n,
                                  const MacroBlockD *const xd, const EdgeDir edge_dir,
                                  const uint32_t x, const uint32_t y, const int32_t plane,
                                  const struct MacroblockdPlane *const plane_ptr) {
     FrameHeader* frm_hdr = &pcs_ptr->parent_pcs_ptr->frm_hdr;
-    const LoopFilterInfoN *lfi_n = &pcs_ptr->parent_pcs_ptr->lf_info;
 
     // reset to initial values
     params->filter_length = 0;
@@ -303,8 +303,7 @@ static TxSize set_lpf_parameters(Av1DeblockingParameters *const params, const ui
             }
             // prepare common parameters
             if (params->filter_length) {
-                const LoopFilterThresh *const limits =
-                    pcs_ptr->parent_pcs_ptr->lf_info.lfthr + level;
+                const LoopFilterThresh *const limits = lfi_n->lfthr + level;
                 params->lim     = limits->lim;
                 params->mblim   = limits->mblim;
                 params->hev_thr = limits->hev_thr;
@@ -315,7 +314,8 @@ static TxSize set_lpf_parameters(Av1DeblockingParameters *const params, const ui
     return ts;
 }
 
-void eb_av1_filter_block_plane_vert(const PictureControlSet *const pcs_ptr,
+static void filter_block_plane_vert(const PictureControlSet *const pcs_ptr,
+                                    const LoopFilterInfoN *const lfi_n,
                                     const MacroBlockD *const xd, const int32_t plane,
                                     const MacroblockdPlane *const plane_ptr, const uint32_t mi_row,
                                     const uint32_t mi_col) {
@@ -356,6 +356,7 @@ void eb_av1_filter_block_plane_vert(const PictureControlSet *const pcs_ptr,
             tx_size = set_lpf_parameters(&params,
                                          ((uint64_t)1 << scale_horz),
                                          pcs_ptr,
+                                         lfi_n,
                                          xd,
                                          VERT_EDGE,
                                          curr_x,
@@ -428,7 +429,8 @@ void eb_av1_filter_block_plane_vert(const PictureControlSet *const pcs_ptr,
     }
 }
 
-void eb_av1_filter_block_plane_horz(const PictureControlSet *const pcs_ptr,
+static void filter_block_plane_horz(const PictureControlSet *const pcs_ptr,
+                                    const LoopFilterInfoN *const lfi_n,
                                     const MacroBlockD *const xd, const int32_t plane,
                                     const MacroblockdPlane *const plane_ptr, const uint32_t mi_row,
                                     const uint32_t mi_col) {
@@ -470,6 +472,7 @@ void eb_av1_filter_block_plane_horz(const PictureControlSet *const pcs_ptr,
                                          //(pcs_ptr->parent_pcs_ptr->av1_cm->mi_stride << scale_vert),
                                          (mi_stride << scale_vert),
                                          pcs_ptr,
+                                         lfi_n,
                                          xd,
                                          HORZ_EDGE,
                                          curr_x,
@@ -544,6 +547,22 @@ void eb_av1_filter_block_plane_horz(const PictureControlSet *const pcs_ptr,
     }
 }
 
+void eb_av1_filter_block_plane_vert(const PictureControlSet *const pcs_ptr,
+                                    const MacroBlockD *const xd, const int32_t plane,
+                                    const MacroblockdPlane *const plane_ptr, const uint32_t mi_row,
+                                    const uint32_t mi_col) {
+    filter_block_plane_vert(
+        pcs_ptr, &pcs_ptr->parent_pcs_ptr->lf_info, xd, plane, plane_ptr, mi_row, mi_col);
+}
+
+void eb_av1_filter_block_plane_horz(const PictureControlSet *const pcs_ptr,
+                                    const MacroBlockD *const xd, const int32_t plane,
+                                    const MacroblockdPlane *const plane_ptr, const uint32_t mi_row,
+                                    const uint32_t mi_col) {
+    filter_block_plane_horz(
+        pcs_ptr, &pcs_ptr->parent_pcs_ptr->lf_info, xd, plane, plane_ptr, mi_row, mi_col);
+}
+
 // New function to filter each sb (64x64)
 void loop_filter_sb(EbPictureBufferDesc *frame_buffer, //reconpicture,
                     //Yv12BufferConfig *frame_buffer,
@@ -687,6 +706,56 @@ void eb_av1_loop_filter_frame(EbPictureBufferDesc *frame_buffer, PictureControlS
         }
     }
 }
+
+void eb_av1_loop_filter_sb_rows(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                const FrameHeader *frm_hdr, const LoopFilterInfoN *lfi_n,
+                                int32_t plane_start, int32_t plane_end, uint32_t sb_row_start,
+                                uint32_t sb_row_end, EdgeDir edge_dir) {
+    SequenceControlSet *scs_ptr      = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const uint8_t       sb_size_log2 = (uint8_t)Log2f(scs_ptr->sb_size_pix);
+    const uint32_t      pic_width_in_sb =
+        (pcs_ptr->parent_pcs_ptr->aligned_width + scs_ptr->sb_size_pix - 1) / scs_ptr->sb_size_pix;
+    struct MacroblockdPlane pd[3];
+
+    for (int32_t plane = 0; plane < 3; plane++) {
+        pd[plane].subsampling_x = plane ? 1 : 0;
+        pd[plane].subsampling_y = plane ? 1 : 0;
+        pd[plane].plane_type    = plane ? PLANE_TYPE_UV : PLANE_TYPE_Y;
+        pd[plane].is_16bit      = frame_buffer->bit_depth > 8 ||
+                             (scs_ptr->static_config.encoder_16bit_pipeline &&
+                              pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2);
+    }
+
+    for (int32_t plane = plane_start; plane < plane_end; plane++) {
+        if (plane == 0 && !(frm_hdr->loop_filter_params.filter_level[0]) &&
+            !(frm_hdr->loop_filter_params.filter_level[1]))
+            break;
+        else if (plane == 1 && !(frm_hdr->loop_filter_params.filter_level_u))
+            continue;
+        else if (plane == 2 && !(frm_hdr->loop_filter_params.filter_level_v))
+            continue;
+
+        for (uint32_t y_sb_index = sb_row_start; y_sb_index < sb_row_end; ++y_sb_index) {
+            for (uint32_t x_sb_index = 0; x_sb_index < pic_width_in_sb; ++x_sb_index) {
+                const int32_t mi_row = (y_sb_index << sb_size_log2) >> MI_SIZE_LOG2;
+                const int32_t mi_col = (x_sb_index << sb_size_log2) >> MI_SIZE_LOG2;
+
+                eb_av1_setup_dst_planes(pd,
+                                        scs_ptr->seq_header.sb_size,
+                                        frame_buffer,
+                                        mi_row,
+                                        mi_col,
+                                        plane,
+                                        plane + 1);
+                if (edge_dir == VERT_EDGE)
+                    filter_block_plane_vert(pcs_ptr, lfi_n, NULL, plane, &pd[plane], mi_row, mi_col);
+                else
+                    filter_block_plane_horz(pcs_ptr, lfi_n, NULL, plane, &pd[plane], mi_row, mi_col);
+            }
+        }
+    }
+}
+
 extern int16_t eb_av1_ac_quant_q3(int32_t qindex, int32_t delta, AomBitDepth bit_depth);
 
 void eb_copy_buffer(EbPictureBufferDesc *srcBuffer, EbPictureBufferDesc *dstBuffer,
@@ -1273,3 +1342,299 @@ void eb_av1_pick_filter_level(DlfContext *         context_ptr,
         }
     }
 }
+
+EbPictureBufferDesc *get_lf_recon_picture(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *scs_ptr  = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const EbBool        is_16bit = scs_ptr->static_config.encoder_16bit_pipeline ||
+                            scs_ptr->static_config.encoder_bit_depth > EB_8BIT;
+
+    if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+        EbReferenceObject *ref_obj =
+            (EbReferenceObject *)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
+        return is_16bit ? ref_obj->reference_picture16bit : ref_obj->reference_picture;
+    }
+    return is_16bit ? pcs_ptr->recon_picture16bit_ptr : pcs_ptr->recon_picture_ptr;
+}
+
+static uint8_t *lf_plane_buffer(const EbPictureBufferDesc *pic, int32_t plane, uint32_t ss_x,
+                                uint32_t ss_y, EbBool is_16bit, int32_t *stride) {
+    uint8_t *buffer = plane == 0 ? pic->buffer_y : plane == 1 ? pic->buffer_cb : pic->buffer_cr;
+    *stride = plane == 0 ? pic->stride_y : plane == 1 ? pic->stride_cb : pic->stride_cr;
+    if (plane == 0) ss_x = ss_y = 0;
+    return buffer + (((pic->origin_x >> ss_x) + (pic->origin_y >> ss_y) * *stride) << is_16bit);
+}
+
+// Gives dst the layout of src, as eb_copy_buffer
+static void lf_copy_layout(const EbPictureBufferDesc *src, EbPictureBufferDesc *dst) {
+    dst->origin_x          = src->origin_x;
+    dst->origin_y          = src->origin_y;
+    dst->width             = src->width;
+    dst->height            = src->height;
+    dst->max_width         = src->max_width;
+    dst->max_height        = src->max_height;
+    dst->bit_depth         = src->bit_depth;
+    dst->luma_size         = src->luma_size;
+    dst->chroma_size       = src->chroma_size;
+    dst->packed_flag       = src->packed_flag;
+    dst->stride_y          = src->stride_y;
+    dst->stride_cb         = src->stride_cb;
+    dst->stride_cr         = src->stride_cr;
+    dst->stride_bit_inc_y  = src->stride_bit_inc_y;
+    dst->stride_bit_inc_cb = src->stride_bit_inc_cb;
+    dst->stride_bit_inc_cr = src->stride_bit_inc_cr;
+}
+
+/******************************************************
+ * lf_copy_rows
+ *  copies the rows [row_start, row_end) of a plane, the
+ *  buffers having the same layout (as eb_copy_buffer)
+ ******************************************************/
+static void lf_copy_rows(const EbPictureBufferDesc *src, EbPictureBufferDesc *dst, int32_t plane,
+                         uint32_t ss_x, uint32_t ss_y, EbBool is_16bit, uint32_t row_start,
+                         uint32_t row_end) {
+    int32_t        stride;
+    uint8_t *      src_buf = lf_plane_buffer(src, plane, ss_x, ss_y, is_16bit, &stride);
+    const size_t   offset  = src_buf - (plane == 0 ? src->buffer_y
+                                                 : plane == 1 ? src->buffer_cb : src->buffer_cr);
+    uint8_t *      dst_buf =
+        (plane == 0 ? dst->buffer_y : plane == 1 ? dst->buffer_cb : dst->buffer_cr) + offset;
+    const uint32_t width = (uint32_t)(plane ? src->width >> ss_x : src->width) << is_16bit;
+
+    for (uint32_t row = row_start; row < row_end; row++)
+        EB_MEMCPY(dst_buf + ((row * stride) << is_16bit),
+                  src_buf + ((row * stride) << is_16bit),
+                  width);
+}
+
+// Sum squared error of the rows [row_start, row_end) of a plane
+static uint64_t lf_rows_sse(PictureControlSet *pcs_ptr, EbPictureBufferDesc *recon_ptr,
+                            int32_t plane, uint32_t row_start, uint32_t row_end) {
+    SequenceControlSet *       scs_ptr  = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const EbBool               is_16bit = scs_ptr->static_config.encoder_16bit_pipeline ||
+                            scs_ptr->static_config.encoder_bit_depth > EB_8BIT;
+    const uint32_t             ss_x     = scs_ptr->subsampling_x;
+    const uint32_t             ss_y     = scs_ptr->subsampling_y;
+    const EbPictureBufferDesc *input_picture_ptr =
+        is_16bit ? pcs_ptr->input_frame16bit
+                 : (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+    const uint32_t width  = plane ? input_picture_ptr->width >> ss_x : input_picture_ptr->width;
+    const uint32_t height = plane ? input_picture_ptr->height >> ss_y : input_picture_ptr->height;
+    int32_t        input_stride, recon_stride;
+    const uint8_t *input_buffer =
+        lf_plane_buffer(input_picture_ptr, plane, ss_x, ss_y, is_16bit, &input_stride);
+    const uint8_t *recon_buffer =
+        lf_plane_buffer(recon_ptr, plane, ss_x, ss_y, is_16bit, &recon_stride);
+    uint64_t residual_distortion = 0;
+
+    row_end = MIN(row_end, height);
+    for (uint32_t row = row_start; row < row_end; row++) {
+        if (is_16bit) {
+            const uint16_t *input = (const uint16_t *)input_buffer + row * input_stride;
+            const uint16_t *recon = (const uint16_t *)recon_buffer + row * recon_stride;
+            for (uint32_t col = 0; col < width; col++)
+                residual_distortion += (int64_t)SQR((int64_t)input[col] - (int64_t)recon[col]);
+        } else {
+            const uint8_t *input = input_buffer + row * input_stride;
+            const uint8_t *recon = recon_buffer + row * recon_stride;
+            for (uint32_t col = 0; col < width; col++)
+                residual_distortion += (int64_t)SQR((int64_t)input[col] - (int64_t)recon[col]);
+        }
+    }
+    return residual_distortion;
+}
+
+// Adds the candidates of the next round: the levels search_filter_level evaluates next
+static void dlf_search_set_candidates(DlfLevelSearch *search) {
+    const int32_t filt_high = AOMMIN(search->filt_mid + search->filter_step, MAX_LOOP_FILTER);
+    const int32_t filt_low  = AOMMAX(search->filt_mid - search->filter_step, 0);
+
+    search->candidate_count = 0;
+    if (search->done) return;
+    if (search->ss_err[search->filt_mid] < 0)
+        search->candidates[search->candidate_count++] = search->filt_mid;
+    if (search->filt_direction <= 0 && filt_low != search->filt_mid && search->ss_err[filt_low] < 0)
+        search->candidates[search->candidate_count++] = filt_low;
+    if (search->filt_direction >= 0 && filt_high != search->filt_mid &&
+        search->ss_err[filt_high] < 0)
+        search->candidates[search->candidate_count++] = filt_high;
+    // summed by the segments
+    for (uint8_t i = 0; i < search->candidate_count; i++) search->ss_err[search->candidates[i]] = 0;
+}
+
+// One step of search_filter_level, once the errors of the low / mid / high levels are known
+static void dlf_search_step(DlfLevelSearch *search, const FrameHeader *frm_hdr,
+                            uint8_t loop_filter_mode) {
+    const int32_t filt_mid  = search->filt_mid;
+    const int32_t filt_high = AOMMIN(filt_mid + search->filter_step, MAX_LOOP_FILTER);
+    const int32_t filt_low  = AOMMAX(filt_mid - search->filter_step, 0);
+
+    if (search->filt_best < 0) {
+        search->best_err  = search->ss_err[filt_mid];
+        search->filt_best = filt_mid;
+    }
+    // Bias against raising loop filter in favor of lowering it.
+    int64_t bias = (search->best_err >> (15 - (filt_mid / 8))) * search->filter_step;
+    // yx, bias less for large block size
+    if (frm_hdr->tx_mode != ONLY_4X4) bias >>= 1;
+
+    if (search->filt_direction <= 0 && filt_low != filt_mid) {
+        // If value is close to the best so far then bias towards a lower loop
+        // filter value.
+        if (search->ss_err[filt_low] < (search->best_err + bias)) {
+            if (search->ss_err[filt_low] < search->best_err)
+                search->best_err = search->ss_err[filt_low];
+            search->filt_best = filt_low;
+        }
+    }
+    if (search->filt_direction >= 0 && filt_high != filt_mid) {
+        // If value is significantly better than previous best, bias added against
+        // raising filter value
+        if (search->ss_err[filt_high] < (search->best_err - bias)) {
+            search->best_err  = search->ss_err[filt_high];
+            search->filt_best = filt_high;
+        }
+    }
+
+    if (loop_filter_mode <= 2) {
+        search->done = EB_TRUE;
+        return;
+    }
+    // Half the step distance if the best filter value was the same as last time
+    if (search->filt_best == filt_mid) {
+        search->filter_step /= 2;
+        search->filt_direction = 0;
+    } else {
+        search->filt_direction = (search->filt_best < filt_mid) ? -1 : 1;
+        search->filt_mid       = search->filt_best;
+    }
+    if (search->filter_step == 0) search->done = EB_TRUE;
+}
+
+void eb_av1_dlf_search_init(PictureControlSet *pcs_ptr) {
+    const FrameHeader *frm_hdr = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    // Start levels of search_filter_level: the luma search (dir 2) starts at
+    // last_frame_filter_level[2]
+    const int32_t last_frame_filter_level[MAX_MB_PLANE] = {
+        frm_hdr->loop_filter_params.filter_level_u,
+        frm_hdr->loop_filter_params.filter_level_u,
+        frm_hdr->loop_filter_params.filter_level_v};
+
+    for (int32_t plane = 0; plane < MAX_MB_PLANE; plane++) {
+        DlfLevelSearch *search = &pcs_ptr->dlf_level_search[plane];
+        search->filt_mid       = clamp(last_frame_filter_level[plane], 0, MAX_LOOP_FILTER);
+        search->filter_step    = pcs_ptr->parent_pcs_ptr->loop_filter_mode <= 2
+                                  ? 2
+                                  : search->filt_mid < 16 ? 4 : search->filt_mid / 4;
+        search->filt_direction = 0;
+        search->filt_best      = -1;
+        search->best_err       = 0;
+        search->done           = EB_FALSE;
+        memset(search->ss_err, 0xFF, sizeof(search->ss_err));
+        dlf_search_set_candidates(search);
+    }
+}
+
+EbBool eb_av1_dlf_search_next_round(PictureControlSet *pcs_ptr) {
+    FrameHeader *frm_hdr   = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    EbBool       new_round = EB_FALSE;
+
+    for (int32_t plane = 0; plane < MAX_MB_PLANE; plane++) {
+        DlfLevelSearch *search = &pcs_ptr->dlf_level_search[plane];
+        // levels already evaluated are not evaluated again
+        while (!search->done) {
+            dlf_search_step(search, frm_hdr, pcs_ptr->parent_pcs_ptr->loop_filter_mode);
+            dlf_search_set_candidates(search);
+            if (search->candidate_count) break;
+        }
+        if (search->candidate_count) new_round = EB_TRUE;
+    }
+    if (!new_round) {
+        frm_hdr->loop_filter_params.filter_level[0] = pcs_ptr->dlf_level_search[0].filt_best;
+        frm_hdr->loop_filter_params.filter_level[1] = pcs_ptr->dlf_level_search[0].filt_best;
+        frm_hdr->loop_filter_params.filter_level_u  = pcs_ptr->dlf_level_search[1].filt_best;
+        frm_hdr->loop_filter_params.filter_level_v  = pcs_ptr->dlf_level_search[2].filt_best;
+    }
+    return new_round;
+}
+
+void eb_av1_dlf_search_segment(DlfContext *context_ptr, PictureControlSet *pcs_ptr,
+                               uint32_t segment_index, int64_t seg_err[MAX_MB_PLANE][3]) {
+    SequenceControlSet * scs_ptr  = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const EbBool         is_16bit = scs_ptr->static_config.encoder_16bit_pipeline ||
+                            scs_ptr->static_config.encoder_bit_depth > EB_8BIT;
+    EbPictureBufferDesc *recon_buffer = get_lf_recon_picture(pcs_ptr);
+    EbPictureBufferDesc *temp_lf_recon_buffer =
+        is_16bit ? context_ptr->temp_lf_recon_picture16bit_ptr
+                 : context_ptr->temp_lf_recon_picture_ptr;
+    FrameHeader *    frm_hdr  = &context_ptr->search_frm_hdr;
+    LoopFilterInfoN *lf_info  = &context_ptr->search_lf_info;
+    const uint32_t   sb_size  = scs_ptr->sb_size_pix;
+    const uint32_t   ss_x     = scs_ptr->subsampling_x;
+    const uint32_t   ss_y     = scs_ptr->subsampling_y;
+    const uint32_t   pic_height_in_sb =
+        (pcs_ptr->parent_pcs_ptr->aligned_height + sb_size - 1) / sb_size;
+    const uint32_t sb_row_start =
+        SEGMENT_START_IDX(segment_index, pic_height_in_sb, pcs_ptr->dlf_segments_total_count);
+    const uint32_t sb_row_end =
+        SEGMENT_END_IDX(segment_index, pic_height_in_sb, pcs_ptr->dlf_segments_total_count);
+
+    *frm_hdr = pcs_ptr->parent_pcs_ptr->frm_hdr;
+    *lf_info = pcs_ptr->parent_pcs_ptr->lf_info;
+    memset(seg_err, 0, sizeof(int64_t) * MAX_MB_PLANE * 3);
+    // The candidates filter a copy of the rows: EncDec may still read the recon (intra block
+    // copy) while the first round runs on the coded SB rows
+    lf_copy_layout(recon_buffer, temp_lf_recon_buffer);
+
+    for (uint32_t sb_row = sb_row_start; sb_row < sb_row_end; sb_row++) {
+        // Sampled SB rows: the rows filtered by the segments, and the rows above them read by
+        // the horizontal edges, never overlap
+        if (sb_row % DLF_SEARCH_SB_ROW_STEP) continue;
+        for (int32_t plane = 0; plane < MAX_MB_PLANE; plane++) {
+            const uint32_t shift     = plane ? ss_y : 0;
+            const uint32_t row_start = (sb_row ? sb_row * sb_size - 8 : 0) >> shift;
+            const uint32_t row_end =
+                MIN((sb_row + 1) * sb_size, (uint32_t)recon_buffer->height) >> shift;
+            if (!pcs_ptr->dlf_level_search[plane].candidate_count) continue;
+            for (uint8_t i = 0; i < pcs_ptr->dlf_level_search[plane].candidate_count; i++) {
+                const int32_t level = pcs_ptr->dlf_level_search[plane].candidates[i];
+                switch (plane) {
+                case 0:
+                    frm_hdr->loop_filter_params.filter_level[0] = level;
+                    frm_hdr->loop_filter_params.filter_level[1] = level;
+                    break;
+                case 1: frm_hdr->loop_filter_params.filter_level_u = level; break;
+                default: frm_hdr->loop_filter_params.filter_level_v = level; break;
+                }
+                eb_av1_loop_filter_frame_init(frm_hdr, lf_info, plane, plane + 1);
+                lf_copy_rows(recon_buffer,
+                             temp_lf_recon_buffer,
+                             plane,
+                             ss_x,
+                             ss_y,
+                             is_16bit,
+                             row_start,
+                             row_end);
+                eb_av1_loop_filter_sb_rows(temp_lf_recon_buffer,
+                                           pcs_ptr,
+                                           frm_hdr,
+                                           lf_info,
+                                           plane,
+                                           plane + 1,
+                                           sb_row,
+                                           sb_row + 1,
+                                           VERT_EDGE);
+                eb_av1_loop_filter_sb_rows(temp_lf_recon_buffer,
+                                           pcs_ptr,
+                                           frm_hdr,
+                                           lf_info,
+                                           plane,
+                                           plane + 1,
+                                           sb_row,
+                                           sb_row + 1,
+                                           HORZ_EDGE);
+                seg_err[plane][i] +=
+                    lf_rows_sse(pcs_ptr, temp_lf_recon_buffer, plane, row_start, row_end);
+            }
+        }
+    }
+}
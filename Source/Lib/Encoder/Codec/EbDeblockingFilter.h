@@ -72,6 +72,33 @@ void eb_av1_filter_block_plane_horz(const PictureControlSet *const pcs_ptr,
                                     const MacroblockdPlane *const plane_ptr, const uint32_t mi_row,
                                     const uint32_t mi_col);
 
+// Filters the vertical or the horizontal edges of the planes [plane_start, plane_end) in the SB
+// rows [sb_row_start, sb_row_end), at the filter levels of frm_hdr / lfi_n. The edges of a
+// direction are independent, so bands of SB rows are filtered in parallel once the vertical edges
+// of the band and of the band above (read by the horizontal edges at the top) are filtered.
+void eb_av1_loop_filter_sb_rows(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                const FrameHeader *frm_hdr, const LoopFilterInfoN *lfi_n,
+                                int32_t plane_start, int32_t plane_end, uint32_t sb_row_start,
+                                uint32_t sb_row_end, EdgeDir edge_dir);
+
+// Recon picture deblocked by the DLF
+EbPictureBufferDesc *get_lf_recon_picture(PictureControlSet *pcs_ptr);
+
+// Segment parallel filter level search: search_filter_level is run in rounds, each round
+// evaluates the low / mid / high candidates of the 3 planes on the sampled SB rows of every
+// segment, once the errors are summed the search steps and posts the next round.
+#define DLF_SEARCH_SB_ROW_STEP 2
+
+void eb_av1_dlf_search_init(PictureControlSet *pcs_ptr);
+
+// Sum squared errors of the round candidates (dlf_level_search) on the sampled SB rows of a segment
+void eb_av1_dlf_search_segment(DlfContext *context_ptr, PictureControlSet *pcs_ptr,
+                               uint32_t segment_index, int64_t seg_err[MAX_MB_PLANE][3]);
+
+// Steps the searches once a round is evaluated. Returns EB_TRUE when a new round has candidates,
+// else sets the searched filter levels in the frame header.
+EbBool eb_av1_dlf_search_next_round(PictureControlSet *pcs_ptr);
+
 typedef struct LoopFilterWorkerData {
     EbPictureBufferDesc *   frame_buffer; //reconpicture,
     PictureControlSet *     pcs_ptr;
@@ -15,6 +15,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include "EbEncHandle.h"
 #include "EbDlfProcess.h"
 #include "EbEncDecResults.h"
@@ -23,6 +24,8 @@
 #include "EbDefinitions.h"
 #include "EbSequenceControlSet.h"
 #include "EbPictureControlSet.h"
+#include "EbCdef.h"
+#include "EbPictureOperators.h"
 
 void eb_av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame, Av1Common *cm,
                                                  int32_t after_cdef);
@@ -38,7 +41,7 @@ static void dlf_context_dctor(EbPtr p) {
  * Dlf Context Constructor
  ******************************************************/
 EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHandle *enc_handle_ptr,
-                             int index) {
+                             int index, int feedback_index) {
     const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
     EbBool        is_16bit     = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
     EbColorFormat color_format = scs_ptr->static_config.encoder_color_format;
@@ -53,6 +56,8 @@ EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHan
         eb_system_resource_get_consumer_fifo(enc_handle_ptr->enc_dec_results_resource_ptr, index);
     context_ptr->dlf_output_fifo_ptr =
         eb_system_resource_get_producer_fifo(enc_handle_ptr->dlf_results_resource_ptr, index);
+    context_ptr->dlf_feedback_fifo_ptr = eb_system_resource_get_producer_fifo(
+        enc_handle_ptr->enc_dec_results_resource_ptr, feedback_index);
 
     context_ptr->temp_lf_recon_picture16bit_ptr = (EbPictureBufferDesc *)EB_NULL;
     context_ptr->temp_lf_recon_picture_ptr      = (EbPictureBufferDesc *)EB_NULL;
@@ -84,6 +89,340 @@ EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHan
     return EB_ErrorNone;
 }
 
+/******************************************************
+ * dlf_cdef_init
+ *  links the recon of the picture for CDEF, and resets
+ *  its CDEF segments, before any of them is posted
+ ******************************************************/
+static void dlf_cdef_init(PictureControlSet *pcs_ptr) {
+    SequenceControlSet * scs_ptr  = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbBool               is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common *          cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+    EbPictureBufferDesc *recon_picture_ptr;
+
+    if (is_16bit) {
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+            recon_picture_ptr =
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->reference_picture16bit;
+        else
+            recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
+    } else {
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+            recon_picture_ptr =
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->reference_picture;
+        else
+            recon_picture_ptr = pcs_ptr->recon_picture_ptr;
+    }
+    if (scs_ptr->static_config.encoder_16bit_pipeline) {
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+            recon_picture_ptr = ((EbReferenceObject *)
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                ->reference_picture16bit;
+        } else {
+            recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
+        }
+        cm->use_highbitdepth = 1;
+    }
+    link_eb_to_aom_buffer_desc(recon_picture_ptr, cm->frame_to_show);
+    if (scs_ptr->seq_header.enable_cdef && pcs_ptr->parent_pcs_ptr->cdef_filter_mode) {
+        if (scs_ptr->static_config.encoder_16bit_pipeline || is_16bit) {
+            pcs_ptr->src[0] = (uint16_t *)recon_picture_ptr->buffer_y +
+                              (recon_picture_ptr->origin_x +
+                               recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
+            pcs_ptr->src[1] =
+                (uint16_t *)recon_picture_ptr->buffer_cb +
+                (recon_picture_ptr->origin_x / 2 +
+                 recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cb);
+            pcs_ptr->src[2] =
+                (uint16_t *)recon_picture_ptr->buffer_cr +
+                (recon_picture_ptr->origin_x / 2 +
+                 recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cr);
+
+            EbPictureBufferDesc *input_picture_ptr = pcs_ptr->input_frame16bit;
+            pcs_ptr->ref_coeff[0] =
+                (uint16_t *)input_picture_ptr->buffer_y +
+                (input_picture_ptr->origin_x +
+                 input_picture_ptr->origin_y * input_picture_ptr->stride_y);
+            pcs_ptr->ref_coeff[1] =
+                (uint16_t *)input_picture_ptr->buffer_cb +
+                (input_picture_ptr->origin_x / 2 +
+                 input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb);
+            pcs_ptr->ref_coeff[2] =
+                (uint16_t *)input_picture_ptr->buffer_cr +
+                (input_picture_ptr->origin_x / 2 +
+                 input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr);
+        } else {
+            EbByte rec_ptr =
+                &((recon_picture_ptr->buffer_y)[recon_picture_ptr->origin_x +
+                                                recon_picture_ptr->origin_y *
+                                                    recon_picture_ptr->stride_y]);
+            EbByte rec_ptr_cb =
+                &((recon_picture_ptr->buffer_cb)[recon_picture_ptr->origin_x / 2 +
+                                                 recon_picture_ptr->origin_y / 2 *
+                                                     recon_picture_ptr->stride_cb]);
+            EbByte rec_ptr_cr =
+                &((recon_picture_ptr->buffer_cr)[recon_picture_ptr->origin_x / 2 +
+                                                 recon_picture_ptr->origin_y / 2 *
+                                                     recon_picture_ptr->stride_cr]);
+
+            EbPictureBufferDesc *input_picture_ptr =
+                (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+            EbByte enh_ptr =
+                &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x +
+                                                input_picture_ptr->origin_y *
+                                                    input_picture_ptr->stride_y]);
+            EbByte enh_ptr_cb =
+                &((input_picture_ptr->buffer_cb)[input_picture_ptr->origin_x / 2 +
+                                                 input_picture_ptr->origin_y / 2 *
+                                                     input_picture_ptr->stride_cb]);
+            EbByte enh_ptr_cr =
+                &((input_picture_ptr->buffer_cr)[input_picture_ptr->origin_x / 2 +
+                                                 input_picture_ptr->origin_y / 2 *
+                                                     input_picture_ptr->stride_cr]);
+
+            pcs_ptr->src[0] = (uint16_t *)rec_ptr;
+            pcs_ptr->src[1] = (uint16_t *)rec_ptr_cb;
+            pcs_ptr->src[2] = (uint16_t *)rec_ptr_cr;
+
+            pcs_ptr->ref_coeff[0] = (uint16_t *)enh_ptr;
+            pcs_ptr->ref_coeff[1] = (uint16_t *)enh_ptr_cb;
+            pcs_ptr->ref_coeff[2] = (uint16_t *)enh_ptr_cr;
+        }
+    }
+
+    pcs_ptr->cdef_segments_column_count = scs_ptr->cdef_segment_column_count;
+    pcs_ptr->cdef_segments_row_count    = scs_ptr->cdef_segment_row_count;
+    pcs_ptr->cdef_segments_total_count =
+        (uint16_t)(pcs_ptr->cdef_segments_column_count * pcs_ptr->cdef_segments_row_count);
+    pcs_ptr->tot_seg_searched_cdef    = 0;
+    pcs_ptr->cdef_segment_rows_posted = 0;
+}
+
+// Posts the CDEF segments of the segment rows [row_start, row_end)
+static void dlf_post_cdef_segment_rows(DlfContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                                       uint32_t row_start, uint32_t row_end) {
+    PictureControlSet *pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    EbObjectWrapper *  dlf_results_wrapper_ptr;
+    struct DlfResults *dlf_results_ptr;
+
+    for (uint32_t segment_index = row_start * pcs_ptr->cdef_segments_column_count;
+         segment_index < row_end * pcs_ptr->cdef_segments_column_count;
+         ++segment_index) {
+        // Get Empty DLF Results to Cdef
+        eb_get_empty_object(context_ptr->dlf_output_fifo_ptr, &dlf_results_wrapper_ptr);
+        dlf_results_ptr = (struct DlfResults *)dlf_results_wrapper_ptr->object_ptr;
+        dlf_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+        dlf_results_ptr->segment_index   = segment_index;
+        // Post DLF Results
+        eb_post_full_object(dlf_results_wrapper_ptr);
+    }
+}
+
+/******************************************************
+ * dlf_post_cdef_segments
+ *  prepares the deblocked recon for CDEF and posts the
+ *  CDEF segments of the picture not posted yet
+ ******************************************************/
+static void dlf_post_cdef_segments(DlfContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr) {
+    PictureControlSet * pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+
+    // TODO: remove the copy when entire 16bit pipeline is ready
+    if (scs_ptr->static_config.encoder_16bit_pipeline &&
+        scs_ptr->static_config.encoder_bit_depth == EB_8BIT &&
+        !scs_ptr->seq_header.enable_restoration &&
+        !scs_ptr->seq_header.enable_cdef) {
+        EbPictureBufferDesc *recon_buffer, *recon_buffer_8bit;
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+            recon_buffer = ((EbReferenceObject *)
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                ->reference_picture16bit;
+            recon_buffer_8bit = ((EbReferenceObject *)
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                ->reference_picture;
+        } else {
+            recon_buffer = pcs_ptr->recon_picture16bit_ptr;
+            recon_buffer_8bit = pcs_ptr->recon_picture_ptr;
+        }
+        picture_convert_16bit_to_8bit(recon_buffer, recon_buffer_8bit, 0, recon_buffer->height);
+    }
+
+    if (scs_ptr->seq_header.enable_restoration)
+        eb_av1_loop_restoration_save_boundary_lines(
+            pcs_ptr->parent_pcs_ptr->av1_cm->frame_to_show, pcs_ptr->parent_pcs_ptr->av1_cm, 0);
+
+    dlf_post_cdef_segment_rows(context_ptr,
+                               pcs_wrapper_ptr,
+                               pcs_ptr->cdef_segment_rows_posted,
+                               pcs_ptr->cdef_segments_row_count);
+}
+
+// Posts the DLF segments of a picture back to the DLF threads
+static void dlf_post_segments(DlfContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                              uint32_t task_type) {
+    PictureControlSet *pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    EbObjectWrapper *  enc_dec_results_wrapper_ptr;
+    EncDecResults *    enc_dec_results_ptr;
+
+    for (uint32_t segment_index = 0; segment_index < pcs_ptr->dlf_segments_total_count;
+         ++segment_index) {
+        eb_get_empty_object(context_ptr->dlf_feedback_fifo_ptr, &enc_dec_results_wrapper_ptr);
+        enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+        enc_dec_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+        enc_dec_results_ptr->task_type       = task_type;
+        enc_dec_results_ptr->segment_index   = segment_index;
+        eb_post_full_object(enc_dec_results_wrapper_ptr);
+    }
+}
+
+/******************************************************
+ * dlf_search_segment
+ *  evaluates the filter level candidates of the search
+ *  round on a segment, the last segment of the round
+ *  steps the search and posts the next round, or the
+ *  filter segments once the levels are found
+ ******************************************************/
+static void dlf_search_segment(DlfContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                               uint32_t segment_index) {
+    PictureControlSet *pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    int64_t            seg_err[MAX_MB_PLANE][3];
+    EbBool             last_segment;
+
+    eb_av1_dlf_search_segment(context_ptr, pcs_ptr, segment_index, seg_err);
+
+    eb_block_on_mutex(pcs_ptr->dlf_mutex);
+    for (int32_t plane = 0; plane < MAX_MB_PLANE; plane++) {
+        DlfLevelSearch *search = &pcs_ptr->dlf_level_search[plane];
+        for (uint8_t i = 0; i < search->candidate_count; i++)
+            search->ss_err[search->candidates[i]] += seg_err[plane][i];
+    }
+    last_segment = ++pcs_ptr->tot_seg_dlf == pcs_ptr->dlf_segments_total_count;
+    if (last_segment) pcs_ptr->tot_seg_dlf = 0;
+    eb_release_mutex(pcs_ptr->dlf_mutex);
+
+    if (!last_segment) return;
+    if (eb_av1_dlf_search_next_round(pcs_ptr))
+        dlf_post_segments(context_ptr, pcs_wrapper_ptr, ENCDEC_RESULTS_DLF_SEARCH);
+    else {
+        eb_av1_loop_filter_frame_init(
+            &pcs_ptr->parent_pcs_ptr->frm_hdr, &pcs_ptr->parent_pcs_ptr->lf_info, 0, 3);
+        memset(pcs_ptr->dlf_horz_done, 0, sizeof(pcs_ptr->dlf_horz_done));
+        dlf_cdef_init(pcs_ptr);
+        dlf_post_segments(context_ptr, pcs_wrapper_ptr, ENCDEC_RESULTS_DLF_FILTER);
+    }
+}
+
+/******************************************************
+ * dlf_cdef_ready_rows
+ *  CDEF segment rows whose 64x64 blocks, and the lines
+ *  CDEF reads around them, are deblocked. The rows of a
+ *  filter segment are final once the segment below has
+ *  filtered its top edge.
+ ******************************************************/
+static uint32_t dlf_cdef_ready_rows(PictureControlSet *pcs_ptr) {
+    const uint32_t sb_size           = pcs_ptr->parent_pcs_ptr->scs_ptr->sb_size_pix;
+    const uint32_t pic_height        = pcs_ptr->parent_pcs_ptr->aligned_height;
+    const uint32_t pic_height_in_sb  = (pic_height + sb_size - 1) / sb_size;
+    const uint32_t pic_height_in_b64 = (pic_height + 64 - 1) / 64;
+    uint32_t       final_rows;
+    uint32_t       row_count = pcs_ptr->cdef_segment_rows_posted;
+    uint32_t       pending   = 0;
+
+    while (pending < pcs_ptr->dlf_segments_total_count && pcs_ptr->dlf_horz_done[pending])
+        pending++;
+    if (pending == pcs_ptr->dlf_segments_total_count) return pcs_ptr->cdef_segments_row_count;
+    // The top edge of the pending segment filters the lines above it
+    final_rows =
+        SEGMENT_START_IDX(pending, pic_height_in_sb, pcs_ptr->dlf_segments_total_count) * sb_size;
+    final_rows = final_rows > 8 ? final_rows - 8 : 0;
+    while (row_count < pcs_ptr->cdef_segments_row_count &&
+           MIN(SEGMENT_END_IDX(row_count, pic_height_in_b64, pcs_ptr->cdef_segments_row_count) *
+                       64 +
+                   CDEF_VBORDER,
+               pic_height) <= final_rows)
+        row_count++;
+    return row_count;
+}
+
+/******************************************************
+ * dlf_filter_segment
+ *  deblocks a band of SB rows: the vertical edges, then
+ *  the horizontal edges once the band above has its
+ *  vertical edges filtered. The CDEF segments above the
+ *  deblocked bands are posted as they are final, the
+ *  last segment posts the rest of the picture.
+ ******************************************************/
+static void dlf_filter_segment(DlfContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                               uint32_t segment_index) {
+    PictureControlSet *  pcs_ptr      = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    FrameHeader *        frm_hdr      = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    LoopFilterInfoN *    lf_info      = &pcs_ptr->parent_pcs_ptr->lf_info;
+    EbPictureBufferDesc *recon_buffer = get_lf_recon_picture(pcs_ptr);
+    const uint32_t       sb_size      = pcs_ptr->parent_pcs_ptr->scs_ptr->sb_size_pix;
+    const uint32_t       pic_height_in_sb =
+        (pcs_ptr->parent_pcs_ptr->aligned_height + sb_size - 1) / sb_size;
+    const uint32_t sb_row_start =
+        SEGMENT_START_IDX(segment_index, pic_height_in_sb, pcs_ptr->dlf_segments_total_count);
+    const uint32_t sb_row_end =
+        SEGMENT_END_IDX(segment_index, pic_height_in_sb, pcs_ptr->dlf_segments_total_count);
+    EbBool   last_segment;
+    uint32_t cdef_row_start, cdef_row_end;
+
+    eb_av1_loop_filter_sb_rows(
+        recon_buffer, pcs_ptr, frm_hdr, lf_info, 0, 3, sb_row_start, sb_row_end, VERT_EDGE);
+    // The band below reads the last rows of the band
+    if (segment_index + 1 < pcs_ptr->dlf_segments_total_count)
+        eb_post_semaphore(pcs_ptr->dlf_vert_done_semaphore[segment_index]);
+    if (segment_index) eb_block_on_semaphore(pcs_ptr->dlf_vert_done_semaphore[segment_index - 1]);
+    eb_av1_loop_filter_sb_rows(
+        recon_buffer, pcs_ptr, frm_hdr, lf_info, 0, 3, sb_row_start, sb_row_end, HORZ_EDGE);
+
+    eb_block_on_mutex(pcs_ptr->dlf_mutex);
+    pcs_ptr->dlf_horz_done[segment_index] = EB_TRUE;
+    last_segment   = ++pcs_ptr->tot_seg_dlf == pcs_ptr->dlf_segments_total_count;
+    cdef_row_start = pcs_ptr->cdef_segment_rows_posted;
+    // The last segment prepares the recon for restoration before posting the last CDEF rows
+    if (!last_segment) pcs_ptr->cdef_segment_rows_posted = (uint16_t)dlf_cdef_ready_rows(pcs_ptr);
+    cdef_row_end = pcs_ptr->cdef_segment_rows_posted;
+    eb_release_mutex(pcs_ptr->dlf_mutex);
+
+    if (cdef_row_end > cdef_row_start)
+        dlf_post_cdef_segment_rows(context_ptr, pcs_wrapper_ptr, cdef_row_start, cdef_row_end);
+    if (last_segment) dlf_post_cdef_segments(context_ptr, pcs_wrapper_ptr);
+}
+
+void dlf_picture_init(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+
+    pcs_ptr->dlf_segments_total_count =
+        (uint16_t)MIN(scs_ptr->dlf_segment_row_count,
+                      (pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) /
+                          scs_ptr->sb_size_pix);
+    pcs_ptr->dlf_rows_overlap = EB_FALSE;
+#if !TILES_PARALLEL
+    if (pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2 && pcs_ptr->dlf_segments_total_count > 1) {
+        eb_av1_loop_filter_init(pcs_ptr);
+        if (pcs_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
+            eb_av1_pick_filter_level(
+                NULL,
+                (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+                pcs_ptr,
+                LPF_PICK_FROM_Q);
+        }
+        memset(pcs_ptr->enc_dec_sb_row_done, 0, sizeof(pcs_ptr->enc_dec_sb_row_done));
+        pcs_ptr->enc_dec_completed_sb_rows = 0;
+        pcs_ptr->dlf_segments_posted       = 0;
+        pcs_ptr->tot_seg_dlf               = 0;
+        eb_av1_dlf_search_init(pcs_ptr);
+        pcs_ptr->dlf_rows_overlap = EB_TRUE;
+    }
+#endif
+}
+
 /******************************************************
  * Dlf Kernel
  ******************************************************/
@@ -98,10 +437,6 @@ void *dlf_kernel(void *input_ptr) {
     EbObjectWrapper *enc_dec_results_wrapper_ptr;
     EncDecResults *  enc_dec_results_ptr;
 
-    //// Output
-    EbObjectWrapper *  dlf_results_wrapper_ptr;
-    struct DlfResults *dlf_results_ptr;
-
     // SB Loop variables
     for (;;) {
         // Get EncDec Results
@@ -111,6 +446,21 @@ void *dlf_kernel(void *input_ptr) {
         pcs_ptr             = (PictureControlSet *)enc_dec_results_ptr->pcs_wrapper_ptr->object_ptr;
         scs_ptr             = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
 
+        if (enc_dec_results_ptr->task_type == ENCDEC_RESULTS_DLF_SEARCH) {
+            dlf_search_segment(context_ptr,
+                               enc_dec_results_ptr->pcs_wrapper_ptr,
+                               enc_dec_results_ptr->segment_index);
+            eb_release_object(enc_dec_results_wrapper_ptr);
+            continue;
+        }
+        if (enc_dec_results_ptr->task_type == ENCDEC_RESULTS_DLF_FILTER) {
+            dlf_filter_segment(context_ptr,
+                               enc_dec_results_ptr->pcs_wrapper_ptr,
+                               enc_dec_results_ptr->segment_index);
+            eb_release_object(enc_dec_results_wrapper_ptr);
+            continue;
+        }
+
         EbBool is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
 
         // TODO: remove the copy when entire 16bit pipeline is ready
@@ -128,110 +478,12 @@ void *dlf_kernel(void *input_ptr) {
                 recon_buffer = pcs_ptr->recon_picture16bit_ptr;
                 recon_buffer_8bit = pcs_ptr->recon_picture_ptr;
             }
-            //copy recon from 8bit to 16bit
-            uint8_t*  recon_8bit;
-            int32_t   recon_stride_8bit;
-            uint16_t* recon_16bit;
-            int32_t   recon_stride_16bit;
-            // Y
-            recon_16bit = (uint16_t*)(recon_buffer->buffer_y)
-                        + recon_buffer->origin_x
-                        + recon_buffer->origin_y * recon_buffer->stride_y;
-            recon_stride_16bit = recon_buffer->stride_y;
-            recon_8bit  = recon_buffer_8bit->buffer_y
-                        + recon_buffer_8bit->origin_x
-                        + recon_buffer_8bit->origin_y * recon_buffer_8bit->stride_y;
-            recon_stride_8bit = recon_buffer_8bit->stride_y;
-            for (int j = 0; j < recon_buffer->height; j++) {
-                for (int i = 0; i < recon_buffer->width; i++) {
-                    recon_16bit[i + j * recon_stride_16bit] =
-                        (uint16_t)recon_8bit[i + j * recon_stride_8bit];
-                }
-            }
-            // Cb
-            recon_16bit = (uint16_t*)(recon_buffer->buffer_cb)
-                        + recon_buffer->origin_x / 2
-                        + recon_buffer->origin_y / 2 * recon_buffer->stride_cb;
-            recon_stride_16bit = recon_buffer->stride_cb;
-            recon_8bit  = recon_buffer_8bit->buffer_cb
-                        + recon_buffer_8bit->origin_x / 2
-                        + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cb;
-            recon_stride_8bit = recon_buffer_8bit->stride_cb;
-            for (int j = 0; j < recon_buffer->height / 2; j++) {
-                for (int i = 0; i < recon_buffer->width / 2; i++) {
-                    recon_16bit[i + j * recon_stride_16bit] =
-                        (uint16_t)recon_8bit[i + j * recon_stride_8bit];
-                }
-            }
-            // Cr
-            recon_16bit = (uint16_t*)(recon_buffer->buffer_cr)
-                        + recon_buffer->origin_x / 2
-                        + recon_buffer->origin_y / 2 * recon_buffer->stride_cr;
-            recon_stride_16bit = recon_buffer->stride_cr;
-            recon_8bit  = recon_buffer_8bit->buffer_cr
-                        + recon_buffer_8bit->origin_x / 2
-                        + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cr;
-            recon_stride_8bit = recon_buffer_8bit->stride_cr;
-            for (int j = 0; j < recon_buffer->height / 2; j++) {
-                for (int i = 0; i < recon_buffer->width / 2; i++) {
-                    recon_16bit[i + j * recon_stride_16bit] =
-                        (uint16_t)recon_8bit[i + j * recon_stride_8bit];
-                }
-            }
-
-            // //copy input from 8bit to 16bit
-            uint8_t*  input_8bit;
-            int32_t   input_stride_8bit;
-            uint16_t* input_16bit;
-            int32_t   input_stride_16bit;
-            EbPictureBufferDesc* input_buffer_8bit = (EbPictureBufferDesc *)
-                pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-            EbPictureBufferDesc* input_buffer = (EbPictureBufferDesc*)pcs_ptr->input_frame16bit;
-            // Y
-            input_16bit = (uint16_t*)(input_buffer->buffer_y)
-                        + input_buffer->origin_x
-                        + input_buffer->origin_y * input_buffer->stride_y;
-            input_stride_16bit = input_buffer->stride_y;
-            input_8bit  = input_buffer_8bit->buffer_y
-                        + input_buffer_8bit->origin_x
-                        + input_buffer_8bit->origin_y * input_buffer_8bit->stride_y;
-            input_stride_8bit = input_buffer_8bit->stride_y;
-            for (int j = 0; j < input_buffer->height; j++) {
-                for (int i = 0; i < input_buffer->width; i++) {
-                    input_16bit[i + j * input_stride_16bit] =
-                        (uint16_t)input_8bit[i + j * input_stride_8bit];
-                }
-            }
-            // Cb
-            input_16bit = (uint16_t*)(input_buffer->buffer_cb)
-                        + input_buffer->origin_x / 2
-                        + input_buffer->origin_y / 2 * input_buffer->stride_cb;
-            input_stride_16bit = input_buffer->stride_cb;
-            input_8bit  = input_buffer_8bit->buffer_cb
-                        + input_buffer_8bit->origin_x / 2
-                        + input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cb;
-            input_stride_8bit = input_buffer_8bit->stride_cb;
-            for (int j = 0; j < input_buffer->height / 2; j++) {
-                for (int i = 0; i < input_buffer->width / 2; i++) {
-                    input_16bit[i + j * input_stride_16bit] =
-                        (uint16_t)input_8bit[i + j * input_stride_8bit];
-                }
-            }
-            // Cr
-            input_16bit = (uint16_t*)(input_buffer->buffer_cr)
-                        + input_buffer->origin_x / 2
-                        + input_buffer->origin_y / 2 * input_buffer->stride_cr;
-            input_stride_16bit = input_buffer->stride_cr;
-            input_8bit  = input_buffer_8bit->buffer_cr
-                        + input_buffer_8bit->origin_x / 2
-                        + input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cr;
-            input_stride_8bit = input_buffer_8bit->stride_cr;
-            for (int j = 0; j < input_buffer->height / 2; j++) {
-                for (int i = 0; i < input_buffer->width / 2; i++) {
-                    input_16bit[i + j * input_stride_16bit] =
-                        (uint16_t)input_8bit[i + j * input_stride_8bit];
-                }
-            }
+            picture_convert_8bit_to_16bit(recon_buffer_8bit, recon_buffer, 0, recon_buffer->height);
+            picture_convert_8bit_to_16bit(
+                (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+                pcs_ptr->input_frame16bit,
+                0,
+                pcs_ptr->input_frame16bit->height);
         }
 
         EbBool dlf_enable_flag = (EbBool)pcs_ptr->parent_pcs_ptr->loop_filter_mode;
@@ -273,6 +525,17 @@ void *dlf_kernel(void *input_ptr) {
                     LPF_PICK_FROM_Q);
             }
 
+            if (pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2 &&
+                pcs_ptr->dlf_segments_total_count > 1) {
+                // Segment parallel search and deblocking, the last filter segment posts to CDEF
+                pcs_ptr->tot_seg_dlf = 0;
+                eb_av1_dlf_search_init(pcs_ptr);
+                dlf_post_segments(
+                    context_ptr, enc_dec_results_ptr->pcs_wrapper_ptr, ENCDEC_RESULTS_DLF_SEARCH);
+                eb_release_object(enc_dec_results_wrapper_ptr);
+                continue;
+            }
+
             eb_av1_pick_filter_level(
                 context_ptr,
                 (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
@@ -289,193 +552,8 @@ void *dlf_kernel(void *input_ptr) {
             eb_av1_loop_filter_frame(recon_buffer, pcs_ptr, 0, 3);
         }
 
-        // TODO: remove the copy when entire 16bit pipeline is ready
-        if (scs_ptr->static_config.encoder_16bit_pipeline &&
-            scs_ptr->static_config.encoder_bit_depth == EB_8BIT &&
-            !scs_ptr->seq_header.enable_restoration &&
-            !scs_ptr->seq_header.enable_cdef) {
-            EbPictureBufferDesc *recon_buffer, *recon_buffer_8bit;
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
-                recon_buffer = ((EbReferenceObject *)
-                    pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                    ->reference_picture16bit;
-                recon_buffer_8bit = ((EbReferenceObject *)
-                    pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                    ->reference_picture;
-            } else {
-                recon_buffer = pcs_ptr->recon_picture16bit_ptr;
-                recon_buffer_8bit = pcs_ptr->recon_picture_ptr;
-            }
-            //copy recon from 16bit to 8bit
-            uint8_t*  recon_8bit;
-            int32_t   recon_stride_8bit;
-            uint16_t* recon_16bit;
-            int32_t   recon_stride_16bit;
-            // Y
-            recon_16bit = (uint16_t*)(recon_buffer->buffer_y)
-                        + recon_buffer->origin_x
-                        + recon_buffer->origin_y * recon_buffer->stride_y;
-            recon_stride_16bit = recon_buffer->stride_y;
-            recon_8bit  = recon_buffer_8bit->buffer_y
-                        + recon_buffer_8bit->origin_x
-                        + recon_buffer_8bit->origin_y * recon_buffer_8bit->stride_y;
-            recon_stride_8bit = recon_buffer_8bit->stride_y;
-            for (int j = 0; j < recon_buffer->height; j++) {
-                for (int i = 0; i < recon_buffer->width; i++) {
-                    recon_8bit[i + j * recon_stride_8bit] =
-                        (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                }
-            }
-            // Cb
-            recon_16bit = (uint16_t*)(recon_buffer->buffer_cb)
-                        + recon_buffer->origin_x / 2
-                        + recon_buffer->origin_y / 2 * recon_buffer->stride_cb;
-            recon_stride_16bit = recon_buffer->stride_cb;
-            recon_8bit  = recon_buffer_8bit->buffer_cb
-                        + recon_buffer_8bit->origin_x / 2
-                        + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cb;
-            recon_stride_8bit = recon_buffer_8bit->stride_cb;
-            for (int j = 0; j < recon_buffer->height / 2; j++) {
-                for (int i = 0; i < recon_buffer->width / 2; i++) {
-                    recon_8bit[i + j * recon_stride_8bit] =
-                        (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                }
-            }
-            // Cr
-            recon_16bit = (uint16_t*)(recon_buffer->buffer_cr)
-                        + recon_buffer->origin_x / 2
-                        + recon_buffer->origin_y / 2 * recon_buffer->stride_cr;
-            recon_stride_16bit = recon_buffer->stride_cr;
-            recon_8bit  = recon_buffer_8bit->buffer_cr
-                        + recon_buffer_8bit->origin_x / 2
-                        + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cr;
-            recon_stride_8bit = recon_buffer_8bit->stride_cr;
-            for (int j = 0; j < recon_buffer->height / 2; j++) {
-                for (int i = 0; i < recon_buffer->width / 2; i++) {
-                    recon_8bit[i + j * recon_stride_8bit] =
-                        (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                }
-            }
-        }
-
-        //pre-cdef prep
-        {
-            Av1Common *          cm = pcs_ptr->parent_pcs_ptr->av1_cm;
-            EbPictureBufferDesc *recon_picture_ptr;
-            if (is_16bit) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr =
-                        ((EbReferenceObject *)
-                             pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                            ->reference_picture16bit;
-                else
-                    recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
-            } else {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr =
-                        ((EbReferenceObject *)
-                             pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                            ->reference_picture;
-                else
-                    recon_picture_ptr = pcs_ptr->recon_picture_ptr;
-            }
-            if (scs_ptr->static_config.encoder_16bit_pipeline) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
-                    recon_picture_ptr = ((EbReferenceObject *)
-                        pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                        ->reference_picture16bit;
-                } else {
-                    recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
-                }
-                cm->use_highbitdepth = 1;
-            }
-            link_eb_to_aom_buffer_desc(recon_picture_ptr, cm->frame_to_show);
-            if (scs_ptr->seq_header.enable_restoration)
-                eb_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
-            if (scs_ptr->seq_header.enable_cdef && pcs_ptr->parent_pcs_ptr->cdef_filter_mode) {
-                if (scs_ptr->static_config.encoder_16bit_pipeline || is_16bit) {
-                    pcs_ptr->src[0] = (uint16_t *)recon_picture_ptr->buffer_y +
-                                      (recon_picture_ptr->origin_x +
-                                       recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
-                    pcs_ptr->src[1] =
-                        (uint16_t *)recon_picture_ptr->buffer_cb +
-                        (recon_picture_ptr->origin_x / 2 +
-                         recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cb);
-                    pcs_ptr->src[2] =
-                        (uint16_t *)recon_picture_ptr->buffer_cr +
-                        (recon_picture_ptr->origin_x / 2 +
-                         recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cr);
-
-                    EbPictureBufferDesc *input_picture_ptr = pcs_ptr->input_frame16bit;
-                    pcs_ptr->ref_coeff[0] =
-                        (uint16_t *)input_picture_ptr->buffer_y +
-                        (input_picture_ptr->origin_x +
-                         input_picture_ptr->origin_y * input_picture_ptr->stride_y);
-                    pcs_ptr->ref_coeff[1] =
-                        (uint16_t *)input_picture_ptr->buffer_cb +
-                        (input_picture_ptr->origin_x / 2 +
-                         input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb);
-                    pcs_ptr->ref_coeff[2] =
-                        (uint16_t *)input_picture_ptr->buffer_cr +
-                        (input_picture_ptr->origin_x / 2 +
-                         input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr);
-                } else {
-                    EbByte rec_ptr =
-                        &((recon_picture_ptr->buffer_y)[recon_picture_ptr->origin_x +
-                                                        recon_picture_ptr->origin_y *
-                                                            recon_picture_ptr->stride_y]);
-                    EbByte rec_ptr_cb =
-                        &((recon_picture_ptr->buffer_cb)[recon_picture_ptr->origin_x / 2 +
-                                                         recon_picture_ptr->origin_y / 2 *
-                                                             recon_picture_ptr->stride_cb]);
-                    EbByte rec_ptr_cr =
-                        &((recon_picture_ptr->buffer_cr)[recon_picture_ptr->origin_x / 2 +
-                                                         recon_picture_ptr->origin_y / 2 *
-                                                             recon_picture_ptr->stride_cr]);
-
-                    EbPictureBufferDesc *input_picture_ptr =
-                        (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-                    EbByte enh_ptr =
-                        &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x +
-                                                        input_picture_ptr->origin_y *
-                                                            input_picture_ptr->stride_y]);
-                    EbByte enh_ptr_cb =
-                        &((input_picture_ptr->buffer_cb)[input_picture_ptr->origin_x / 2 +
-                                                         input_picture_ptr->origin_y / 2 *
-                                                             input_picture_ptr->stride_cb]);
-                    EbByte enh_ptr_cr =
-                        &((input_picture_ptr->buffer_cr)[input_picture_ptr->origin_x / 2 +
-                                                         input_picture_ptr->origin_y / 2 *
-                                                             input_picture_ptr->stride_cr]);
-
-                    pcs_ptr->src[0] = (uint16_t *)rec_ptr;
-                    pcs_ptr->src[1] = (uint16_t *)rec_ptr_cb;
-                    pcs_ptr->src[2] = (uint16_t *)rec_ptr_cr;
-
-                    pcs_ptr->ref_coeff[0] = (uint16_t *)enh_ptr;
-                    pcs_ptr->ref_coeff[1] = (uint16_t *)enh_ptr_cb;
-                    pcs_ptr->ref_coeff[2] = (uint16_t *)enh_ptr_cr;
-                }
-            }
-        }
-
-        pcs_ptr->cdef_segments_column_count = scs_ptr->cdef_segment_column_count;
-        pcs_ptr->cdef_segments_row_count    = scs_ptr->cdef_segment_row_count;
-        pcs_ptr->cdef_segments_total_count =
-            (uint16_t)(pcs_ptr->cdef_segments_column_count * pcs_ptr->cdef_segments_row_count);
-        pcs_ptr->tot_seg_searched_cdef = 0;
-        uint32_t segment_index;
-
-        for (segment_index = 0; segment_index < pcs_ptr->cdef_segments_total_count;
-             ++segment_index) {
-            // Get Empty DLF Results to Cdef
-            eb_get_empty_object(context_ptr->dlf_output_fifo_ptr, &dlf_results_wrapper_ptr);
-            dlf_results_ptr = (struct DlfResults *)dlf_results_wrapper_ptr->object_ptr;
-            dlf_results_ptr->pcs_wrapper_ptr = enc_dec_results_ptr->pcs_wrapper_ptr;
-            dlf_results_ptr->segment_index   = segment_index;
-            // Post DLF Results
-            eb_post_full_object(dlf_results_wrapper_ptr);
-        }
+        dlf_cdef_init(pcs_ptr);
+        dlf_post_cdef_segments(context_ptr, enc_dec_results_ptr->pcs_wrapper_ptr);
 
         // Release EncDec Results
         eb_release_object(enc_dec_results_wrapper_ptr);
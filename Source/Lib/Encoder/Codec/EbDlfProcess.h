@@ -10,6 +10,7 @@
 #include "EbObject.h"
 #include "EbPictureBufferDesc.h"
 #include "EbSvtAv1Formats.h"
+#include "EbAv1Structs.h"
 
 /**************************************
  * Dlf Context
@@ -17,15 +18,26 @@
 typedef struct DlfContext {
     EbFifo *             dlf_input_fifo_ptr;
     EbFifo *             dlf_output_fifo_ptr;
+    EbFifo *             dlf_feedback_fifo_ptr; // DLF segments, back to the DLF input
     EbPictureBufferDesc *temp_lf_recon_picture_ptr;
     EbPictureBufferDesc *temp_lf_recon_picture16bit_ptr;
+    // Filter levels of the candidates evaluated by a search segment
+    FrameHeader     search_frm_hdr;
+    LoopFilterInfoN search_lf_info;
 } DlfContext;
 
 /**************************************
  * Extern Function Declarations
  **************************************/
 extern EbErrorType dlf_context_ctor(EbThreadContext *  thread_context_ptr,
-                                    const EbEncHandle *enc_handle_ptr, int index);
+                                    const EbEncHandle *enc_handle_ptr, int index,
+                                    int feedback_index);
+
+struct PictureControlSet;
+
+// Sets the DLF segments of a picture before EncDec, and starts the filter level search on the
+// SB rows EncDec completes (dlf_rows_overlap) when the segments are searched in parallel
+extern void dlf_picture_init(struct PictureControlSet *pcs_ptr);
 
 extern void *dlf_kernel(void *input_ptr);
 
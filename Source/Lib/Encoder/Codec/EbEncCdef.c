@@ -229,6 +229,52 @@ int32_t get_cdef_gi_step(int8_t cdef_filter_mode) {
     return gi_step;
 }
 
+// Filter blocks with fewer 8x8 blocks are evaluated on all of them by the fast search
+#define CDEF_FAST_SEARCH_MIN_BLOCKS 8
+
+int32_t get_cdef_search_candidates(PictureParentControlSet *ppcs,
+                                   int32_t                  gi_list[TOTAL_STRENGTHS]) {
+    const int32_t gi_step  = get_cdef_gi_step(ppcs->cdef_filter_mode);
+    const int32_t mid_gi   = ppcs->cdf_ref_frame_strength;
+    const int32_t start_gi = ppcs->use_ref_frame_cdef_strength && ppcs->cdef_filter_mode == 1
+                                 ? (AOMMAX(0, mid_gi - gi_step))
+                                 : 0;
+    const int32_t end_gi   = ppcs->use_ref_frame_cdef_strength
+                               ? AOMMIN(TOTAL_STRENGTHS, mid_gi + gi_step)
+                               : ppcs->cdef_filter_mode == 1 ? 8 : TOTAL_STRENGTHS;
+    const uint64_t sec_mask = (1 << CDEF_SEC_STRENGTHS) - 1;
+    uint64_t       mask     = ~(uint64_t)0;
+    int32_t        count    = 0;
+
+    // Fast search: the primary strengths of the reference +/- 1 (all secondary strengths), and
+    // no primary filtering. Without statistics (intra pictures), all the strengths.
+    if (ppcs->cdef_filter_mode == CDEF_FAST_SEARCH_MODE && ppcs->cdef_ref_strength_mask) {
+        mask = sec_mask;
+        for (int32_t gi = 0; gi < TOTAL_STRENGTHS; gi++) {
+            if (!((ppcs->cdef_ref_strength_mask >> gi) & 1)) continue;
+            const int32_t pri = gi / CDEF_SEC_STRENGTHS;
+            for (int32_t p = AOMMAX(pri - 1, 0); p <= AOMMIN(pri + 1, CDEF_PRI_STRENGTHS - 1); p++)
+                mask |= sec_mask << (p * CDEF_SEC_STRENGTHS);
+        }
+    }
+    for (int32_t gi = start_gi; gi < end_gi; gi++)
+        if ((mask >> gi) & 1) gi_list[count++] = gi;
+    return count;
+}
+
+int32_t cdef_subsample_list(CdefList *dst, const CdefList *src, int32_t cdef_count) {
+    int32_t count = 0;
+    // Checkerboard of the 8x8 blocks
+    if (cdef_count >= CDEF_FAST_SEARCH_MIN_BLOCKS)
+        for (int32_t bi = 0; bi < cdef_count; bi++)
+            if (!((src[bi].by + src[bi].bx) & 1)) dst[count++] = src[bi];
+    if (!count) {
+        memcpy(dst, src, cdef_count * sizeof(*src));
+        count = cdef_count;
+    }
+    return count;
+}
+
 int32_t eb_sb_all_skip(PictureControlSet *pcs_ptr, const Av1Common *const cm, int32_t mi_row,
                        int32_t mi_col) {
     int32_t maxc, maxr;
@@ -1189,8 +1235,6 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
 
     int32_t fbr, fbc;
 
-    int32_t pli;
-
     uint64_t      best_tot_mse = (uint64_t)1 << 63;
     uint64_t      tot_mse;
     int32_t       sb_count;
@@ -1200,22 +1244,17 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
     int32_t *     selected_strength = (int32_t *)malloc(nvfb * nhfb * sizeof(*sb_index));
     int32_t       best_frame_gi_cnt = 0;
     const int32_t total_strengths   = fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
-    int32_t       gi_step;
-    int32_t       mid_gi;
-    int32_t       start_gi;
-    int32_t       end_gi;
+    int32_t       gi_list[TOTAL_STRENGTHS];
+    int32_t       gi_count;
+    // Indices in gi_list of the selected strengths
+    int32_t sel_lev0[CDEF_MAX_STRENGTHS];
+    int32_t sel_lev1[CDEF_MAX_STRENGTHS];
 
     assert(sb_index != NULL);
     assert(selected_strength != NULL);
 
-    gi_step = get_cdef_gi_step(ppcs->cdef_filter_mode);
-
-    mid_gi   = ppcs->cdf_ref_frame_strength;
-    start_gi = ppcs->use_ref_frame_cdef_strength && ppcs->cdef_filter_mode == 1
-                   ? (AOMMAX(0, mid_gi - gi_step))
-                   : 0;
-    end_gi = ppcs->use_ref_frame_cdef_strength ? AOMMIN(total_strengths, mid_gi + gi_step)
-                                               : ppcs->cdef_filter_mode == 1 ? 8 : total_strengths;
+    // The mse of the evaluated strengths are packed, the searches run on [0, gi_count)
+    gi_count = get_cdef_search_candidates(ppcs, gi_list);
 
     uint64_t(*mse[2])[TOTAL_STRENGTHS];
     int32_t       pri_damping = 3 + (frm_hdr->quantization_params.base_q_idx >> 6);
@@ -1266,17 +1305,11 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
             // No filtering if the entire filter block is skipped
             if (eb_sb_all_skip(pcs_ptr, cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64)) continue;
 
-            for (pli = 0; pli < num_planes; pli++) {
-                if (pli == 0)
-                    memcpy(mse[0][sb_count],
-                           pcs_ptr->mse_seg[0][fbr * nhfb + fbc],
-                           TOTAL_STRENGTHS * sizeof(uint64_t));
-                if (pli == 2)
-                    memcpy(mse[1][sb_count],
-                           pcs_ptr->mse_seg[1][fbr * nhfb + fbc],
-                           TOTAL_STRENGTHS * sizeof(uint64_t));
-                sb_index[sb_count] = MI_SIZE_64X64 * fbr * pcs_ptr->mi_stride + MI_SIZE_64X64 * fbc;
+            for (i = 0; i < gi_count; i++) {
+                mse[0][sb_count][i] = pcs_ptr->mse_seg[0][fbr * nhfb + fbc][gi_list[i]];
+                mse[1][sb_count][i] = pcs_ptr->mse_seg[1][fbr * nhfb + fbc][gi_list[i]];
             }
+            sb_index[sb_count] = MI_SIZE_64X64 * fbr * pcs_ptr->mi_stride + MI_SIZE_64X64 * fbc;
             sb_count++;
         }
     }
@@ -1290,10 +1323,10 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
         nb_strengths                          = 1 << i;
         if (num_planes >= 3)
             tot_mse = joint_strength_search_dual(
-                best_lev0, best_lev1, nb_strengths, mse, sb_count, fast, start_gi, end_gi);
+                best_lev0, best_lev1, nb_strengths, mse, sb_count, fast, 0, gi_count);
         else
             tot_mse = joint_strength_search(
-                best_lev0, nb_strengths, mse[0], sb_count, fast, start_gi, end_gi);
+                best_lev0, nb_strengths, mse[0], sb_count, fast, 0, gi_count);
         /* Count superblock signalling cost. */
         const int total_bits =
             sb_count * i + nb_strengths * CDEF_STRENGTH_BITS * (num_planes > 1 ? 2 : 1);
@@ -1304,8 +1337,10 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
             best_tot_mse     = tot_mse;
             nb_strength_bits = i;
             for (j = 0; j < 1 << nb_strength_bits; j++) {
-                frm_hdr->cdef_params.cdef_y_strength[j]  = best_lev0[j];
-                frm_hdr->cdef_params.cdef_uv_strength[j] = best_lev1[j];
+                sel_lev0[j]                              = best_lev0[j];
+                sel_lev1[j]                              = best_lev1[j];
+                frm_hdr->cdef_params.cdef_y_strength[j]  = gi_list[best_lev0[j]];
+                frm_hdr->cdef_params.cdef_uv_strength[j] = gi_list[best_lev1[j]];
             }
         }
     }
@@ -1319,8 +1354,8 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
         uint64_t best_mse = (uint64_t)1 << 63;
         best_gi           = 0;
         for (gi = 0; gi < ppcs->nb_cdef_strengths; gi++) {
-            uint64_t curr = mse[0][i][frm_hdr->cdef_params.cdef_y_strength[gi]];
-            if (num_planes >= 3) curr += mse[1][i][frm_hdr->cdef_params.cdef_uv_strength[gi]];
+            uint64_t curr = mse[0][i][sel_lev0[gi]];
+            if (num_planes >= 3) curr += mse[1][i][sel_lev1[gi]];
             if (curr < best_mse) {
                 best_gi  = gi;
                 best_mse = curr;
@@ -28,6 +28,19 @@ void copy_cdef_16bit_to_16bit(uint16_t *dst, int32_t dstride, uint16_t *src, Cde
 
 int32_t get_cdef_gi_step(int8_t cdef_filter_mode);
 
+// cdef_filter_mode of the fast search: the strengths are evaluated on a checkerboard of the 8x8
+// blocks, and pruned to the neighbours of the strengths of the reference in the same layer
+#define CDEF_FAST_SEARCH_MODE 6
+
+struct PictureParentControlSet;
+
+// Sets the strength indices (gi) evaluated by the search of a picture, returns their count
+int32_t get_cdef_search_candidates(struct PictureParentControlSet *ppcs,
+                                   int32_t                         gi_list[TOTAL_STRENGTHS]);
+
+// Keeps the 8x8 blocks of a filter block evaluated by the fast search, returns their count
+int32_t cdef_subsample_list(CdefList *dst, const CdefList *src, int32_t cdef_count);
+
 
 #ifdef __cplusplus
 }
@@ -23,6 +23,8 @@
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbUtility.h"
 #include "grainSynthesis.h"
+#include "EbDeblockingFilter.h"
+#include "EbPictureOperators.h"
 
 #define FC_SKIP_TX_SR_TH025 125 // Fast cost skip tx search threshold.
 #define FC_SKIP_TX_SR_TH010 110 // Fast cost skip tx search threshold.
@@ -48,6 +50,7 @@ static void enc_dec_context_dctor(EbPtr p) {
     EB_DELETE(obj->inverse_quant_buffer);
     EB_DELETE(obj->input_sample16bit_buffer);
     if (obj->is_md_rate_estimation_ptr_owner) EB_FREE(obj->md_rate_estimation_ptr);
+    EB_FREE(obj->md_rate_est_base_fc);
     EB_FREE_ARRAY(obj);
 }
 
@@ -86,6 +89,7 @@ EbErrorType enc_dec_context_ctor(EbThreadContext *  thread_context_ptr,
     // MD rate Estimation tables
     EB_MALLOC(context_ptr->md_rate_estimation_ptr, sizeof(MdRateEstimationContext));
     context_ptr->is_md_rate_estimation_ptr_owner = EB_TRUE;
+    EB_MALLOC(context_ptr->md_rate_est_base_fc, sizeof(FRAME_CONTEXT));
 
     // Prediction Buffer
     {
@@ -1692,6 +1696,15 @@ EbErrorType signal_derivation_enc_dec_kernel_oq(SequenceControlSet * scs_ptr,
     else
         context_ptr->md_staging_mode = MD_STAGING_MODE_0;
 
+    // Set candidate cost cache
+    // 0                 OFF
+    // 1                 Reuse the fast loop distortion of inter candidates sharing the same
+    //                   block, reference(s) and MV(s) within the SB (across classes and PD passes)
+    // Only valid when md_stage_0 uses bilinear / no interpolation search and md_stage_1 redoes the
+    // prediction of the surviving candidates, i.e. when MD staging mode is not MD_STAGING_MODE_0.
+    context_ptr->md_cand_cost_cache_enabled =
+        (context_ptr->md_staging_mode != MD_STAGING_MODE_0) ? 1 : 0;
+
     // Set md staging count level
     // Level 0              minimum count = 1
     // Level 1              set towards the best possible partitioning (to further optimize)
@@ -2408,6 +2421,32 @@ void derive_start_end_depth(PictureControlSet *pcs_ptr, SuperBlock *sb_ptr, uint
         *e_depth = 0;
 }
 
+/******************************************************
+ * roi_map_static_sb
+ * Whether the region of interest map of the input picture
+ * hints a static SB (all the covered map blocks)
+ ******************************************************/
+static EbBool roi_map_static_sb(SequenceControlSet *scs_ptr, PictureControlSet *pcs_ptr,
+                                SuperBlock *sb_ptr) {
+    const uint8_t *roi_static_hint = pcs_ptr->parent_pcs_ptr->input_ptr->roi_static_hint;
+    uint32_t       map_width, start_x, start_y, end_x, end_y;
+
+    if (roi_static_hint == NULL || pcs_ptr->slice_type == I_SLICE) return EB_FALSE;
+    roi_map_sb_range(pcs_ptr->parent_pcs_ptr,
+                     sb_ptr->origin_x,
+                     sb_ptr->origin_y,
+                     scs_ptr->sb_size_pix,
+                     &map_width,
+                     &start_x,
+                     &start_y,
+                     &end_x,
+                     &end_y);
+    for (uint32_t y = start_y; y <= end_y; y++)
+        for (uint32_t x = start_x; x <= end_x; x++)
+            if (!roi_static_hint[y * map_width + x]) return EB_FALSE;
+    return EB_TRUE;
+}
+
 static void perform_pred_depth_refinement(SequenceControlSet *scs_ptr, PictureControlSet *pcs_ptr,
                                           ModeDecisionContext *context_ptr, uint32_t sb_index) {
     MdcSbData *results_ptr = &pcs_ptr->mdc_sb_array[sb_index];
@@ -2451,7 +2490,11 @@ static void perform_pred_depth_refinement(SequenceControlSet *scs_ptr, PictureCo
                     int8_t s_depth = 0;
                     int8_t e_depth = 0;
 
-                    if (context_ptr->pd_pass == PD_PASS_0) {
+                    if (context_ptr->pd_pass == PD_PASS_0 && context_ptr->roi_static_sb) {
+                        // static SB: the PD0 depth
+                        s_depth = 0;
+                        e_depth = 0;
+                    } else if (context_ptr->pd_pass == PD_PASS_0) {
                         derive_start_end_depth(pcs_ptr,
                                                sb_ptr,
                                                scs_ptr->seq_header.sb_size,
@@ -2651,6 +2694,66 @@ static void perform_pred_depth_refinement(SequenceControlSet *scs_ptr, PictureCo
     }
 }
 
+/******************************************************
+ * post_completed_sb_row
+ *  records a coded SB row, and posts the DLF search
+ *  segments whose SB rows are all coded (dlf_rows_overlap).
+ *  The 16 bit pipeline of an 8 bit input converts the
+ *  row to the 16 bit recon and input first.
+ ******************************************************/
+static void post_completed_sb_row(EncDecContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                                  uint32_t sb_row_index) {
+    PictureControlSet * pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    const uint32_t      sb_size = pcs_ptr->parent_pcs_ptr->scs_ptr->sb_size_pix;
+    const uint32_t      pic_height_in_sb =
+        (pcs_ptr->parent_pcs_ptr->aligned_height + sb_size - 1) / sb_size;
+    SequenceControlSet *scs_ptr = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    EbObjectWrapper *   enc_dec_results_wrapper_ptr;
+    EncDecResults *     enc_dec_results_ptr;
+    uint32_t            segment_start, segment_end;
+
+    if (scs_ptr->static_config.encoder_16bit_pipeline &&
+        scs_ptr->static_config.encoder_bit_depth == EB_8BIT) {
+        EbPictureBufferDesc *recon_buffer_8bit =
+            pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE
+                ? ((EbReferenceObject *)
+                       pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                      ->reference_picture
+                : pcs_ptr->recon_picture_ptr;
+        picture_convert_8bit_to_16bit(recon_buffer_8bit,
+                                      get_lf_recon_picture(pcs_ptr),
+                                      sb_row_index * sb_size,
+                                      (sb_row_index + 1) * sb_size);
+        picture_convert_8bit_to_16bit(
+            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+            pcs_ptr->input_frame16bit,
+            sb_row_index * sb_size,
+            (sb_row_index + 1) * sb_size);
+    }
+
+    eb_block_on_mutex(pcs_ptr->dlf_mutex);
+    pcs_ptr->enc_dec_sb_row_done[sb_row_index] = EB_TRUE;
+    while (pcs_ptr->enc_dec_completed_sb_rows < pic_height_in_sb &&
+           pcs_ptr->enc_dec_sb_row_done[pcs_ptr->enc_dec_completed_sb_rows])
+        pcs_ptr->enc_dec_completed_sb_rows++;
+    segment_start = segment_end = pcs_ptr->dlf_segments_posted;
+    while (segment_end < pcs_ptr->dlf_segments_total_count &&
+           SEGMENT_END_IDX(segment_end, pic_height_in_sb, pcs_ptr->dlf_segments_total_count) <=
+               pcs_ptr->enc_dec_completed_sb_rows)
+        segment_end++;
+    pcs_ptr->dlf_segments_posted = (uint16_t)segment_end;
+    eb_release_mutex(pcs_ptr->dlf_mutex);
+
+    for (uint32_t segment_index = segment_start; segment_index < segment_end; ++segment_index) {
+        eb_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
+        enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+        enc_dec_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+        enc_dec_results_ptr->task_type       = ENCDEC_RESULTS_DLF_SEARCH;
+        enc_dec_results_ptr->segment_index   = segment_index;
+        eb_post_full_object(enc_dec_results_wrapper_ptr);
+    }
+}
+
 /* EncDec (Encode Decode) Kernel */
 /*********************************************************************************
 *
@@ -2757,7 +2860,6 @@ void *enc_dec_kernel(void *input_ptr) {
         last_sb_flag = EB_FALSE;
         is_16bit     = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
         (void)is_16bit;
-        (void)end_of_row_flag;
         // SB Constants
         sb_sz              = (uint8_t)scs_ptr->sb_size_pix;
         sb_size_log2       = (uint8_t)Log2f(sb_sz);
@@ -2875,7 +2977,20 @@ void *enc_dec_kernel(void *input_ptr) {
                     context_ptr->sb_index = sb_index;
 
                     if (pcs_ptr->update_cdf) {
-                        pcs_ptr->rate_est_array[sb_index] = *pcs_ptr->md_rate_estimation_array;
+                        // The rate tables of the SB are derived incrementally from the last SB
+                        // estimated by this context (same picture), else from the frame tables:
+                        // only the CDFs that differ from the base CDFs are re-estimated.
+                        const FRAME_CONTEXT *rate_est_base_fc;
+                        if (context_ptr->md_rate_est_base_pcs == pcs_ptr &&
+                            context_ptr->md_rate_est_base_picture_number ==
+                                pcs_ptr->picture_number) {
+                            pcs_ptr->rate_est_array[sb_index] =
+                                pcs_ptr->rate_est_array[context_ptr->md_rate_est_base_sb_index];
+                            rate_est_base_fc = context_ptr->md_rate_est_base_fc;
+                        } else {
+                            pcs_ptr->rate_est_array[sb_index] = *pcs_ptr->md_rate_estimation_array;
+                            rate_est_base_fc = pcs_ptr->coeff_est_entropy_coder_ptr->fc;
+                        }
 #if MD_RATE_EST_ENH
                         if (scs_ptr->enc_dec_segment_row_count_array[pcs_ptr->temporal_layer_index] == 1 &&
                             scs_ptr->enc_dec_segment_col_count_array[pcs_ptr->temporal_layer_index] == 1) {
@@ -2932,16 +3047,24 @@ void *enc_dec_kernel(void *input_ptr) {
 #endif
 
                         // Initial Rate Estimation of the syntax elements
-                        av1_estimate_syntax_rate(&pcs_ptr->rate_est_array[sb_index],
-                                                 pcs_ptr->slice_type == I_SLICE,
-                                                 &pcs_ptr->ec_ctx_array[sb_index]);
+                        av1_update_syntax_rate(&pcs_ptr->rate_est_array[sb_index],
+                                               pcs_ptr->slice_type == I_SLICE,
+                                               &pcs_ptr->ec_ctx_array[sb_index],
+                                               rate_est_base_fc);
                         // Initial Rate Estimation of the Motion vectors
-                        av1_estimate_mv_rate(pcs_ptr,
-                                             &pcs_ptr->rate_est_array[sb_index],
-                                             &pcs_ptr->ec_ctx_array[sb_index]);
-
-                        av1_estimate_coefficients_rate(&pcs_ptr->rate_est_array[sb_index],
-                                                       &pcs_ptr->ec_ctx_array[sb_index]);
+                        av1_update_mv_rate(pcs_ptr,
+                                           &pcs_ptr->rate_est_array[sb_index],
+                                           &pcs_ptr->ec_ctx_array[sb_index],
+                                           rate_est_base_fc);
+
+                        av1_update_coefficients_rate(&pcs_ptr->rate_est_array[sb_index],
+                                                     &pcs_ptr->ec_ctx_array[sb_index],
+                                                     rate_est_base_fc);
+                        // The CDFs of the SB are the base of the next SB of this context
+                        *context_ptr->md_rate_est_base_fc = pcs_ptr->ec_ctx_array[sb_index];
+                        context_ptr->md_rate_est_base_pcs            = pcs_ptr;
+                        context_ptr->md_rate_est_base_picture_number = pcs_ptr->picture_number;
+                        context_ptr->md_rate_est_base_sb_index       = sb_index;
 
                         //let the candidate point to the new rate table.
                         uint32_t cand_index;
@@ -2955,6 +3078,10 @@ void *enc_dec_kernel(void *input_ptr) {
                     // Configure the SB
                     mode_decision_configure_sb(
                         context_ptr->md_context, pcs_ptr, (uint8_t)sb_ptr->qp);
+                    context_ptr->md_context->roi_static_sb =
+                        scs_ptr->static_config.enable_roi_map
+                            ? roi_map_static_sb(scs_ptr, pcs_ptr, sb_ptr)
+                            : EB_FALSE;
                     // Multi-Pass PD Path
                     // For each SB, all blocks are tested in PD0 (4421 blocks if 128x128 SB, and 1101 blocks if 64x64 SB).
                     // Then the PD0 predicted Partitioning Structure is refined by considering up to three refinements depths away from the predicted depth, both in the direction of smaller block sizes and in the direction of larger block sizes (up to Pred - 3 / Pred + 3 refinement). The selection of the refinement depth is performed using the cost
@@ -3012,9 +3139,10 @@ void *enc_dec_kernel(void *input_ptr) {
                                               sb_origin_x,
                                               sb_origin_y);
 
-                        if (pcs_ptr->parent_pcs_ptr->pic_depth_mode == PIC_MULTI_PASS_PD_MODE_1 ||
-                            pcs_ptr->parent_pcs_ptr->pic_depth_mode == PIC_MULTI_PASS_PD_MODE_2 ||
-                            pcs_ptr->parent_pcs_ptr->pic_depth_mode == PIC_MULTI_PASS_PD_MODE_3) {
+                        if ((pcs_ptr->parent_pcs_ptr->pic_depth_mode == PIC_MULTI_PASS_PD_MODE_1 ||
+                             pcs_ptr->parent_pcs_ptr->pic_depth_mode == PIC_MULTI_PASS_PD_MODE_2 ||
+                             pcs_ptr->parent_pcs_ptr->pic_depth_mode == PIC_MULTI_PASS_PD_MODE_3) &&
+                            !context_ptr->md_context->roi_static_sb) {
                             // [PD_PASS_1] Signal(s) derivation
                             context_ptr->md_context->pd_pass = PD_PASS_1;
                             signal_derivation_enc_dec_kernel_oq(
@@ -3101,6 +3229,10 @@ void *enc_dec_kernel(void *input_ptr) {
                              pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
                             ->intra_coded_area_sb[sb_index] = (uint8_t)(
                             (100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
+                    // The last SB row is posted once the picture data of the last SB is set
+                    if (end_of_row_flag && !last_sb_flag && pcs_ptr->dlf_rows_overlap)
+                        post_completed_sb_row(
+                            context_ptr, enc_dec_tasks_ptr->pcs_wrapper_ptr, y_sb_index);
                 }
                 x_sb_start_index = (x_sb_start_index > 0) ? x_sb_start_index - 1 : 0;
             }
@@ -3143,11 +3275,17 @@ void *enc_dec_kernel(void *input_ptr) {
             pcs_ptr->parent_pcs_ptr->av1x->rdmult = context_ptr->full_lambda;
         }
 
-        if (last_sb_flag) {
+        if (last_sb_flag && pcs_ptr->dlf_rows_overlap) {
+            // The DLF search segments of the picture are its DLF input
+            post_completed_sb_row(context_ptr,
+                                  enc_dec_tasks_ptr->pcs_wrapper_ptr,
+                                  (pcs_ptr->sb_total_count_pix - 1) / pic_width_in_sb);
+        } else if (last_sb_flag) {
             // Get Empty EncDec Results
             eb_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
             enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
             enc_dec_results_ptr->pcs_wrapper_ptr = enc_dec_tasks_ptr->pcs_wrapper_ptr;
+            enc_dec_results_ptr->task_type       = ENCDEC_RESULTS_PICTURE;
             //CHKN these are not needed for DLF
             enc_dec_results_ptr->completed_sb_row_index_start = 0;
             enc_dec_results_ptr->completed_sb_row_count =
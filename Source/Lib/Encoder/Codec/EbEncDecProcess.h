@@ -36,6 +36,14 @@ typedef struct EncDecContext {
     EbFifo *                 picture_demux_output_fifo_ptr; // to picture-manager
     MdRateEstimationContext *md_rate_estimation_ptr;
     EbBool                   is_md_rate_estimation_ptr_owner;
+
+    // Incremental SB rate estimation: the rate tables of the last SB estimated by this
+    // context (md_rate_est_base_sb_index) were derived from md_rate_est_base_fc
+    FRAME_CONTEXT *           md_rate_est_base_fc;
+    struct PictureControlSet *md_rate_est_base_pcs;
+    uint64_t                  md_rate_est_base_picture_number;
+    uint32_t                  md_rate_est_base_sb_index;
+
     ModeDecisionContext *    md_context;
     const BlockGeom *        blk_geom;
     // MCP Context
@@ -12,6 +12,12 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+// EncDec results task types: pictures coded by EncDec, and DLF segments posted back to the DLF
+// threads by the DLF kernel
+#define ENCDEC_RESULTS_PICTURE 0
+#define ENCDEC_RESULTS_DLF_SEARCH 1
+#define ENCDEC_RESULTS_DLF_FILTER 2
+
 /**************************************
      * Process Results
      **************************************/
@@ -20,6 +26,8 @@ typedef struct EncDecResults {
     EbObjectWrapper *pcs_wrapper_ptr;
     uint32_t         completed_sb_row_index_start;
     uint32_t         completed_sb_row_count;
+    uint32_t         task_type;
+    uint32_t         segment_index; // DLF segment tasks
 } EncDecResults;
 
 typedef struct DlfResults {
@@ -142,6 +142,7 @@ EbErrorType encode_context_ctor(EncodeContext* encode_context_ptr, EbPtr object_
 
     EB_CREATE_MUTEX(encode_context_ptr->sc_buffer_mutex);
     encode_context_ptr->enc_mode                      = SPEED_CONTROL_INIT_MOD;
+    encode_context_ptr->sc_superres_denom             = SCALE_NUMERATOR;
     encode_context_ptr->previous_selected_ref_qp      = 32;
     encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
     EB_CREATE_MUTEX(encode_context_ptr->shared_reference_mutex);
@@ -152,6 +152,7 @@ typedef struct EncodeContext {
     int64_t   sc_frame_out;
     EbHandle  sc_buffer_mutex;
     EbEncMode enc_mode;
+    uint8_t   sc_superres_denom; // superres denominator of intra frames in superres AUTO mode
 
     // Rate Control
     uint32_t previous_selected_ref_qp;
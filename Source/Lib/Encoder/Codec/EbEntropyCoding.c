@@ -4535,6 +4535,25 @@ EbErrorType encode_td_av1(uint8_t *output_bitstream_ptr) {
 
     return return_error;
 }
+
+/**************************************************
+* encode_padding_av1
+* Writes a padding OBU of at least min_size (and 2) bytes, returns its size
+**************************************************/
+uint32_t encode_padding_av1(uint8_t *output_bitstream_ptr, uint32_t min_size) {
+    assert(output_bitstream_ptr != NULL);
+    const uint32_t obu_payload_size  = min_size > 2 ? min_size - 2 : 0;
+    const uint32_t obu_header_size   = write_obu_header(OBU_PADDING, 0, output_bitstream_ptr);
+    size_t         length_field_size = 0;
+
+    if (eb_aom_uleb_encode(obu_payload_size,
+                           k_maximum_leb_128_size,
+                           output_bitstream_ptr + obu_header_size,
+                           &length_field_size) != 0)
+        return 0;
+    memset(output_bitstream_ptr + obu_header_size + length_field_size, 0, obu_payload_size);
+    return obu_header_size + (uint32_t)length_field_size + obu_payload_size;
+}
 static void av1_write_delta_q_index(FRAME_CONTEXT *frame_context, int32_t delta_qindex,
                                     AomWriter *w) {
     int32_t sign = delta_qindex < 0;
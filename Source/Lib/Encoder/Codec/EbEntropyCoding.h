@@ -212,6 +212,7 @@ extern int32_t eb_av1_get_pred_context_single_ref_p6(const MacroBlockD *xd);
 extern EbErrorType write_frame_header_av1(Bitstream *bitstream_ptr, SequenceControlSet *scs_ptr,
                                           PictureControlSet *pcs_ptr, uint8_t show_existing);
 extern EbErrorType encode_td_av1(uint8_t *bitstream_ptr);
+extern uint32_t    encode_padding_av1(uint8_t *bitstream_ptr, uint32_t min_size);
 extern EbErrorType encode_sps_av1(Bitstream *bitstream_ptr, SequenceControlSet *scs_ptr);
 
 //*******************************************************************************************//
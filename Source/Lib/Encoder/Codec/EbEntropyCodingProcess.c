@@ -489,14 +489,28 @@ static EbBool update_entropy_coding_rows(PictureControlSet *pcs_ptr, uint32_t *r
 #endif
 /******************************************************
  * Write Stat to File
- * write stat_struct per frame in the first pass
+ * write the stat record of a frame in the first pass, to the output
+ * stat callback if set, to the output stat file otherwise
  ******************************************************/
-void write_stat_to_file(SequenceControlSet *scs_ptr, StatStruct stat_struct, uint64_t ref_poc) {
+void write_stat_to_file(SequenceControlSet *scs_ptr, const StatStruct *stat_struct,
+                        uint64_t ref_poc) {
+    const uint32_t record_size = scs_ptr->stat_record_size;
     eb_block_on_mutex(scs_ptr->encode_context_ptr->stat_file_mutex);
-    int32_t fseek_return_value = fseek(
-        scs_ptr->static_config.output_stat_file, (long)ref_poc * sizeof(StatStruct), SEEK_SET);
-    if (fseek_return_value != 0) SVT_LOG("Error in fseek  returnVal %i\n", fseek_return_value);
-    fwrite(&stat_struct, sizeof(StatStruct), (size_t)1, scs_ptr->static_config.output_stat_file);
+    if (scs_ptr->static_config.output_stat_callback)
+        scs_ptr->static_config.output_stat_callback(
+            scs_ptr->static_config.output_stat_private_data,
+            ref_poc,
+            (const uint8_t *)stat_struct->referenced_area,
+            record_size);
+    else {
+        int32_t fseek_return_value = fseek(
+            scs_ptr->static_config.output_stat_file, (long)(ref_poc * record_size), SEEK_SET);
+        if (fseek_return_value != 0) SVT_LOG("Error in fseek  returnVal %i\n", fseek_return_value);
+        fwrite(stat_struct->referenced_area,
+               record_size,
+               (size_t)1,
+               scs_ptr->static_config.output_stat_file);
+    }
     eb_release_mutex(scs_ptr->encode_context_ptr->stat_file_mutex);
 }
 
@@ -700,7 +714,7 @@ void *entropy_coding_kernel(void *input_ptr) {
                         if (scs_ptr->use_output_stat_file && tile_cnt == 1 &&
                             !pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag)
                             write_stat_to_file(scs_ptr,
-                                               *pcs_ptr->parent_pcs_ptr->stat_struct_first_pass_ptr,
+                                               pcs_ptr->parent_pcs_ptr->stat_struct_first_pass_ptr,
                                                pcs_ptr->parent_pcs_ptr->picture_number);
                         if (pic_ready) {
                             // Release the List 0 Reference Pictures
@@ -711,9 +725,9 @@ void *entropy_coding_kernel(void *input_ptr) {
                                     pcs_ptr->ref_pic_ptr_array[0][ref_idx]->live_count == 1)
                                     write_stat_to_file(
                                         scs_ptr,
-                                        ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[0][ref_idx]
-                                             ->object_ptr)
-                                            ->stat_struct,
+                                        &((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[0][ref_idx]
+                                              ->object_ptr)
+                                             ->stat_struct,
                                         ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[0][ref_idx]
                                              ->object_ptr)
                                             ->ref_poc);
@@ -730,9 +744,9 @@ void *entropy_coding_kernel(void *input_ptr) {
                                     pcs_ptr->ref_pic_ptr_array[1][ref_idx]->live_count == 1)
                                     write_stat_to_file(
                                         scs_ptr,
-                                        ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[1][ref_idx]
-                                             ->object_ptr)
-                                            ->stat_struct,
+                                        &((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[1][ref_idx]
+                                              ->object_ptr)
+                                             ->stat_struct,
                                         ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[1][ref_idx]
                                              ->object_ptr)
                                             ->ref_poc);
@@ -836,7 +850,7 @@ void *entropy_coding_kernel(void *input_ptr) {
                         if (scs_ptr->use_output_stat_file &&
                             !pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag)
                             write_stat_to_file(scs_ptr,
-                                               *pcs_ptr->parent_pcs_ptr->stat_struct_first_pass_ptr,
+                                               pcs_ptr->parent_pcs_ptr->stat_struct_first_pass_ptr,
                                                pcs_ptr->parent_pcs_ptr->picture_number);
                         // Release the List 0 Reference Pictures
                         for (ref_idx = 0; ref_idx < pcs_ptr->parent_pcs_ptr->ref_list0_count;
@@ -846,9 +860,9 @@ void *entropy_coding_kernel(void *input_ptr) {
                                 pcs_ptr->ref_pic_ptr_array[0][ref_idx]->live_count == 1)
                                 write_stat_to_file(
                                     scs_ptr,
-                                    ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[0][ref_idx]
-                                         ->object_ptr)
-                                        ->stat_struct,
+                                    &((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[0][ref_idx]
+                                          ->object_ptr)
+                                         ->stat_struct,
                                     ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[0][ref_idx]
                                          ->object_ptr)
                                         ->ref_poc);
@@ -865,9 +879,9 @@ void *entropy_coding_kernel(void *input_ptr) {
                                 pcs_ptr->ref_pic_ptr_array[1][ref_idx]->live_count == 1)
                                 write_stat_to_file(
                                     scs_ptr,
-                                    ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[1][ref_idx]
-                                         ->object_ptr)
-                                        ->stat_struct,
+                                    &((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[1][ref_idx]
+                                          ->object_ptr)
+                                         ->stat_struct,
                                     ((EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[1][ref_idx]
                                          ->object_ptr)
                                         ->ref_poc);
@@ -2,6 +2,8 @@
 * Copyright(c) 2019 Intel Corporation
 * SPDX - License - Identifier: BSD - 2 - Clause - Patent
 */
+#include <math.h>
+
 #include "EbEncHandle.h"
 #include "EbPictureControlSet.h"
 #include "EbSequenceControlSet.h"
@@ -12,6 +14,8 @@
 #include "EbUtility.h"
 #include "EbReferenceObject.h"
 #include "EbResize.h"
+#include "EbResourceCoordinationProcess.h"
+#include "EbTemporalDependencyModel.h"
 
 /**************************************
  * Context
@@ -700,6 +704,181 @@ void update_motion_field_uniformity_over_time(EncodeContext *          encode_co
     }
     return;
 }
+/************************************************
+* Add the area of a block to the referenced area of the SBs it overlaps
+************************************************/
+static void add_referenced_block(uint32_t *referenced_area, uint32_t pic_width_in_sb, int32_t x,
+                                 int32_t y, int32_t size, uint32_t weight) {
+    for (int32_t sb_y = y / BLOCK_SIZE_64; sb_y <= (y + size - 1) / BLOCK_SIZE_64; sb_y++) {
+        for (int32_t sb_x = x / BLOCK_SIZE_64; sb_x <= (x + size - 1) / BLOCK_SIZE_64; sb_x++) {
+            const int32_t width =
+                MIN((sb_x + 1) * BLOCK_SIZE_64, x + size) - MAX(sb_x * BLOCK_SIZE_64, x);
+            const int32_t height =
+                MIN((sb_y + 1) * BLOCK_SIZE_64, y + size) - MAX(sb_y * BLOCK_SIZE_64, y);
+            referenced_area[sb_x + sb_y * pic_width_in_sb] += width * height * weight;
+        }
+    }
+}
+
+/************************************************
+* Accumulate Referenced Area
+** Adds to the stat_struct of ref_pcs_ptr the area of the 16x16 blocks of
+** pcs_ptr predicted from ref_pcs_ptr by their best ME candidate, weighted by
+** the temporal layer of pcs_ptr as done in the first pass. A block is only
+** counted when its ME distortion beats an intra estimate of the block (its
+** size times its standard deviation).
+************************************************/
+static void accumulate_referenced_area(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
+                                       PictureParentControlSet *ref_pcs_ptr) {
+    EbBool is_ref[MAX_NUM_OF_REF_PIC_LIST][REF_LIST_MAX_DEPTH];
+    EbBool referenced = EB_FALSE;
+
+    if (pcs_ptr->slice_type == I_SLICE) return;
+    for (uint8_t list_index = REF_LIST_0; list_index < MAX_NUM_OF_REF_PIC_LIST; list_index++) {
+        const uint8_t ref_count =
+            list_index == REF_LIST_0 ? pcs_ptr->ref_list0_count : pcs_ptr->ref_list1_count;
+        for (uint8_t ref_index = 0; ref_index < REF_LIST_MAX_DEPTH; ref_index++) {
+            is_ref[list_index][ref_index] =
+                ref_index < ref_count &&
+                pcs_ptr->ref_pic_poc_array[list_index][ref_index] == ref_pcs_ptr->picture_number;
+            referenced |= is_ref[list_index][ref_index];
+        }
+    }
+    if (!referenced) return;
+
+    uint32_t *     referenced_area = ref_pcs_ptr->stat_struct.referenced_area;
+    const uint32_t weight          = 1 << MAX(4 - (int32_t)pcs_ptr->temporal_layer_index, 0);
+    const uint32_t pic_width_in_sb = (pcs_ptr->aligned_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    const uint32_t pic_height_in_sb =
+        (pcs_ptr->aligned_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    const uint8_t list1_mv_offset = scs_ptr->mrp_mode == 0 ? 4 : 2;
+
+    for (uint32_t sb_index = 0; sb_index < pic_width_in_sb * pic_height_in_sb; sb_index++) {
+        const MeSbResults *me_results  = pcs_ptr->me_results[sb_index];
+        const int32_t      sb_origin_x = (sb_index % pic_width_in_sb) * BLOCK_SIZE_64;
+        const int32_t      sb_origin_y = (sb_index / pic_width_in_sb) * BLOCK_SIZE_64;
+
+        for (uint32_t pu_index = ME_TIER_ZERO_PU_16x16_0; pu_index <= ME_TIER_ZERO_PU_16x16_15;
+             pu_index++) {
+            if (!me_results->total_me_candidate_index[pu_index]) continue;
+            // the candidates are sorted by distortion
+            const MeCandidate *best = &me_results->me_candidate[pu_index][0];
+            const uint64_t     sad  = best->distortion;
+            if (sad * sad > (uint64_t)(16 * 16 * 16 * 16) * pcs_ptr->variance[sb_index][pu_index])
+                continue;
+
+            uint8_t pred_list[2], pred_ref[2], pred_count = 0;
+            if (best->direction == UNI_PRED_LIST_0) {
+                pred_list[pred_count] = REF_LIST_0;
+                pred_ref[pred_count++] = best->ref_idx_l0;
+            } else if (best->direction == UNI_PRED_LIST_1) {
+                pred_list[pred_count] = REF_LIST_1;
+                pred_ref[pred_count++] = best->ref_idx_l1;
+            } else {
+                pred_list[pred_count] = best->ref0_list;
+                pred_ref[pred_count++] = best->ref_idx_l0;
+                pred_list[pred_count] = best->ref1_list;
+                pred_ref[pred_count++] = best->ref_idx_l1;
+            }
+            for (uint8_t pred_index = 0; pred_index < pred_count; pred_index++) {
+                if (!is_ref[pred_list[pred_index]][pred_ref[pred_index]]) continue;
+                const uint8_t mv_index = (pred_list[pred_index] == REF_LIST_0 ? 0 : list1_mv_offset) +
+                                         pred_ref[pred_index];
+                const MvCandidate *mv = &me_results->me_mv_array[pu_index][mv_index];
+                // 16x16 PUs are in raster order, ME MVs in quarter pel
+                const uint32_t blk_index = pu_index - ME_TIER_ZERO_PU_16x16_0;
+                const int32_t  x = CLIP3(0,
+                                        (int32_t)pcs_ptr->aligned_width - 16,
+                                        sb_origin_x + (int32_t)(blk_index & 3) * 16 + (mv->x_mv >> 2));
+                const int32_t  y = CLIP3(0,
+                                        (int32_t)pcs_ptr->aligned_height - 16,
+                                        sb_origin_y + (int32_t)(blk_index >> 2) * 16 + (mv->y_mv >> 2));
+                add_referenced_block(referenced_area, pic_width_in_sb, x, y, 16, weight);
+            }
+        }
+    }
+}
+
+/************************************************
+* Lookahead Referenced Area
+** In process substitute of the first pass statistics, run when pcs_ptr leaves
+** the lookahead window: completes the referenced area of pcs_ptr with the
+** pictures of the window referencing it (the pictures preceding it added
+** theirs when leaving the window), adds the one of pcs_ptr to the pictures of
+** the window it references and derives the referenced area average of pcs_ptr.
+************************************************/
+static void lookahead_referenced_area(EncodeContext *encode_context_ptr, SequenceControlSet *scs_ptr,
+                                      PictureParentControlSet *pcs_ptr, uint32_t frames_in_sw) {
+    uint32_t queue_index = encode_context_ptr->initial_rate_control_reorder_queue_head_index;
+
+    for (uint32_t sw_index = 1; sw_index < frames_in_sw; sw_index++) {
+        queue_index = (queue_index == INITIAL_RATE_CONTROL_REORDER_QUEUE_MAX_DEPTH - 1)
+                          ? 0
+                          : queue_index + 1;
+        const InitialRateControlReorderEntry *queue_entry_ptr =
+            encode_context_ptr->initial_rate_control_reorder_queue[queue_index];
+        if (queue_entry_ptr->parent_pcs_wrapper_ptr == EB_NULL) break;
+        PictureParentControlSet *sw_pcs_ptr =
+            (PictureParentControlSet *)queue_entry_ptr->parent_pcs_wrapper_ptr->object_ptr;
+
+        accumulate_referenced_area(scs_ptr, sw_pcs_ptr, pcs_ptr);
+        accumulate_referenced_area(scs_ptr, pcs_ptr, sw_pcs_ptr);
+        if (sw_pcs_ptr->end_of_sequence_flag) break;
+    }
+    derive_referenced_area_avg(pcs_ptr, scs_ptr);
+}
+
+/************************************************
+* CRF Picture Complexity
+** ME SAD per pixel of an inter picture, normalized by the square root of the
+** distance to its first reference (the base layer pictures predict from
+** further away than the non reference ones), 0 for an intra picture
+************************************************/
+static double crf_picture_complexity(const PictureParentControlSet *pcs_ptr) {
+    const uint32_t pic_width_in_sb = (pcs_ptr->aligned_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    const uint32_t pic_height_in_sb =
+        (pcs_ptr->aligned_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    uint64_t sad = 0;
+
+    if (pcs_ptr->slice_type == I_SLICE) return 0;
+    for (uint32_t sb_index = 0; sb_index < pic_width_in_sb * pic_height_in_sb; sb_index++)
+        sad += pcs_ptr->rc_me_distortion[sb_index];
+    const int64_t distance =
+        MAX(ABS((int64_t)pcs_ptr->picture_number - (int64_t)pcs_ptr->ref_pic_poc_array[0][0]), 1);
+    return (double)sad / (pcs_ptr->aligned_width * pcs_ptr->aligned_height) /
+           sqrt((double)distance);
+}
+
+/************************************************
+* CRF Lookahead Complexity
+** Average complexity of the inter pictures of the lookahead window starting @
+** the head of the reorder queue (blurs the per picture and per temporal layer
+** variations)
+************************************************/
+static double crf_lookahead_complexity(EncodeContext *encode_context_ptr, uint32_t frames_in_sw) {
+    uint32_t queue_index = encode_context_ptr->initial_rate_control_reorder_queue_head_index;
+    double   complexity  = 0;
+    uint32_t inter_count = 0;
+
+    for (uint32_t sw_index = 0; sw_index < MAX(frames_in_sw, 1); sw_index++) {
+        const InitialRateControlReorderEntry *queue_entry_ptr =
+            encode_context_ptr->initial_rate_control_reorder_queue[queue_index];
+        if (queue_entry_ptr->parent_pcs_wrapper_ptr == EB_NULL) break;
+        const PictureParentControlSet *sw_pcs_ptr =
+            (PictureParentControlSet *)queue_entry_ptr->parent_pcs_wrapper_ptr->object_ptr;
+
+        if (sw_pcs_ptr->slice_type != I_SLICE) {
+            complexity += crf_picture_complexity(sw_pcs_ptr);
+            inter_count++;
+        }
+        if (sw_pcs_ptr->end_of_sequence_flag) break;
+        queue_index = (queue_index == INITIAL_RATE_CONTROL_REORDER_QUEUE_MAX_DEPTH - 1)
+                          ? 0
+                          : queue_index + 1;
+    }
+    return inter_count ? complexity / inter_count : 0;
+}
+
 InitialRateControlReorderEntry *determine_picture_offset_in_queue(
     EncodeContext *encode_context_ptr, PictureParentControlSet *pcs_ptr,
     MotionEstimationResults *in_results_ptr) {
@@ -904,6 +1083,9 @@ void *initial_rate_control_kernel(void *input_ptr) {
                 // Determine offset from the Head Ptr
                 queue_entry_ptr =
                     determine_picture_offset_in_queue(encode_context_ptr, pcs_ptr, in_results_ptr);
+            if (scs_ptr->use_lookahead_stats)
+                memset(pcs_ptr->stat_struct.referenced_area, 0, scs_ptr->stat_record_size);
+            pcs_ptr->tpl_valid = EB_FALSE;
 
             if (scs_ptr->static_config.rate_control_mode) {
                 if (scs_ptr->static_config.look_ahead_distance != 0) {
@@ -1088,6 +1270,16 @@ void *initial_rate_control_kernel(void *input_ptr) {
                                 : &pcs_ptr->stat_struct;
                         if (scs_ptr->use_output_stat_file)
                             memset(pcs_ptr->stat_struct_first_pass_ptr, 0, sizeof(StatStruct));
+                        if (scs_ptr->use_lookahead_stats && !loop_index)
+                            lookahead_referenced_area(
+                                encode_context_ptr, scs_ptr, pcs_ptr, frames_in_sw);
+                        if (scs_ptr->static_config.crf >= 0)
+                            pcs_ptr->crf_complexity =
+                                crf_lookahead_complexity(encode_context_ptr, frames_in_sw);
+                        // Temporal dependency model of the window, once per base layer picture
+                        if (scs_ptr->static_config.enable_tpl_la && !loop_index &&
+                            !pcs_ptr->tpl_valid)
+                            tpl_process_lookahead(encode_context_ptr, frames_in_sw);
                         // Get Empty Results Object
                         eb_get_empty_object(
                             context_ptr->initialrate_control_results_output_fifo_ptr,
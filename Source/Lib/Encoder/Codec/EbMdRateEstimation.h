@@ -210,6 +210,26 @@ extern void av1_estimate_mv_rate(
         struct PictureControlSet *pcs_ptr,
         MdRateEstimationContext  *md_rate_estimation_array,
         FRAME_CONTEXT            *fc);
+    /**************************************************************************
+    * Incremental rate update: md_rate_estimation_array holds the rates of
+    * base_fc, only the rates of the CDFs of fc that differ from base_fc
+    * (dirty CDFs) are recomputed. Same results as the av1_estimate_*()
+    * functions, which rebuild all the rates.
+    ***************************************************************************/
+    extern void av1_update_syntax_rate(
+        MdRateEstimationContext  *md_rate_estimation_array,
+        EbBool                    is_i_slice,
+        FRAME_CONTEXT            *fc,
+        const FRAME_CONTEXT      *base_fc);
+    extern void av1_update_coefficients_rate(
+        MdRateEstimationContext  *md_rate_estimation_array,
+        FRAME_CONTEXT            *fc,
+        const FRAME_CONTEXT      *base_fc);
+    extern void av1_update_mv_rate(
+        struct PictureControlSet *pcs_ptr,
+        MdRateEstimationContext  *md_rate_estimation_array,
+        FRAME_CONTEXT            *fc,
+        const FRAME_CONTEXT      *base_fc);
 #define AVG_CDF_WEIGHT_LEFT      3
 #define AVG_CDF_WEIGHT_TOP       1
 
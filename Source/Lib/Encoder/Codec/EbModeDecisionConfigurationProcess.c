@@ -22,6 +22,7 @@
 #include "EbModeDecisionConfigurationProcess.h"
 #include "EbRateControlResults.h"
 #include "EbEncDecTasks.h"
+#include "EbDlfProcess.h"
 #include "EbModeDecisionConfiguration.h"
 #include "EbReferenceObject.h"
 #include "EbModeDecisionProcess.h"
@@ -416,12 +417,41 @@ void set_reference_sg_ep(PictureControlSet *pcs_ptr) {
     }
 }
 
+/******************************************************
+* Get the strengths signaled by the reference in the
+* temporal layer of a picture (else the closest lower
+* layer), for the fast CDEF search
+******************************************************/
+static uint64_t get_reference_cdef_strength_mask(PictureControlSet *pcs_ptr) {
+    const uint8_t ref_count[2] = {
+        pcs_ptr->parent_pcs_ptr->ref_list0_count,
+        pcs_ptr->slice_type == B_SLICE ? pcs_ptr->parent_pcs_ptr->ref_list1_count : 0};
+    EbReferenceObject *best_ref_obj = NULL;
+
+    for (uint32_t list_index = REF_LIST_0; list_index <= REF_LIST_1; list_index++) {
+        for (uint32_t ref_idx = 0; ref_idx < ref_count[list_index]; ref_idx++) {
+            EbReferenceObject *ref_obj;
+            if (pcs_ptr->ref_pic_ptr_array[list_index][ref_idx] == NULL) continue;
+            ref_obj = (EbReferenceObject *)pcs_ptr->ref_pic_ptr_array[list_index][ref_idx]
+                          ->object_ptr;
+            if (ref_obj->tmp_layer_idx > pcs_ptr->temporal_layer_index) continue;
+            if (!best_ref_obj || ref_obj->tmp_layer_idx > best_ref_obj->tmp_layer_idx)
+                best_ref_obj = ref_obj;
+        }
+    }
+    return best_ref_obj ? best_ref_obj->cdef_strength_mask : 0;
+}
+
 /******************************************************
 * Set the reference cdef strength for a given picture
 ******************************************************/
 void set_reference_cdef_strength(PictureControlSet *pcs_ptr) {
     EbReferenceObject *ref_obj_l0, *ref_obj_l1;
     int32_t            strength;
+    pcs_ptr->parent_pcs_ptr->cdef_ref_strength_mask =
+        pcs_ptr->slice_type == I_SLICE || pcs_ptr->parent_pcs_ptr->scene_change_flag
+            ? 0
+            : get_reference_cdef_strength_mask(pcs_ptr);
     // NADER: set pcs_ptr->parent_pcs_ptr->use_ref_frame_cdef_strength 0 to test all strengths
     switch (pcs_ptr->slice_type) {
     case I_SLICE:
@@ -1820,6 +1850,9 @@ void *mode_decision_configuration_kernel(void *input_ptr) {
                 &pcs_ptr->ss_cfg, pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr->stride_y);
         }
 
+        // The DLF search may start on the first SB rows coded
+        dlf_picture_init(pcs_ptr);
+
         // Post the results to the MD processes
 #if TILES_PARALLEL
 
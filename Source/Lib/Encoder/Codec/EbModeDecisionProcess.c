@@ -4,6 +4,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "EbUtility.h"
 #include "EbModeDecisionProcess.h"
@@ -68,6 +69,7 @@ static void mode_decision_context_dctor(EbPtr p) {
     EB_FREE_ARRAY(obj->md_local_blk_unit);
     EB_FREE_ARRAY(obj->md_blk_arr_nsq);
     EB_FREE_ARRAY(obj->md_ep_pipe_sb);
+    EB_FREE_ARRAY(obj->md_cand_cost_cache);
 }
 
 /******************************************************
@@ -103,6 +105,10 @@ EbErrorType mode_decision_context_ctor(ModeDecisionContext *context_ptr, EbColor
     EB_MALLOC_ARRAY(context_ptr->md_blk_arr_nsq, BLOCK_MAX_COUNT_SB_128);
     EB_MALLOC_ARRAY(context_ptr->md_ep_pipe_sb, BLOCK_MAX_COUNT_SB_128);
 
+    // Candidate cost cache; tag 0 is never used by a SB so all entries start invalid
+    EB_CALLOC_ARRAY(context_ptr->md_cand_cost_cache, MD_CAND_COST_CACHE_SIZE);
+    context_ptr->md_cand_cost_cache_sb_tag = 0;
+
     // Fast Candidate Array
     EB_MALLOC_ARRAY(context_ptr->fast_candidate_array, MODE_DECISION_CANDIDATE_MAX_COUNT);
 
@@ -570,6 +576,13 @@ void mode_decision_configure_sb(ModeDecisionContext *context_ptr, PictureControl
     (void)pcs_ptr;
     //Disable Lambda update per SB
     context_ptr->qp = sb_qp;
+    // Invalidate the candidate cost cache of the previous SB
+    if (++context_ptr->md_cand_cost_cache_sb_tag == 0) {
+        memset(context_ptr->md_cand_cost_cache,
+               0,
+               sizeof(MdCandCostCacheEntry) * MD_CAND_COST_CACHE_SIZE);
+        context_ptr->md_cand_cost_cache_sb_tag = 1;
+    }
     // Asuming cb and cr offset to be the same for chroma QP in both slice and pps for lambda computation
 
     context_ptr->chroma_qp = (uint8_t)context_ptr->qp;
@@ -46,6 +46,9 @@ extern "C" {
 
 #define REFINE_ME_MV_EIGHT_PEL_REF_WINDOW 3
 
+#define MD_CAND_COST_CACHE_SIZE_LOG2 12
+#define MD_CAND_COST_CACHE_SIZE (1 << MD_CAND_COST_CACHE_SIZE_LOG2)
+
 /**************************************
       * Macros
       **************************************/
@@ -72,6 +75,24 @@ typedef struct MdEncPassCuData {
         [4]; // Store nonzero CoeffNum, per TU. If one TU, stored in 0, otherwise 4 tus stored in 0 to 3
 } MdEncPassCuData;
 
+/**************************************
+       * Candidate Cost Cache
+       **************************************/
+// Fast-loop distortion of an inter candidate, keyed by everything the prediction depends on.
+// The cache lives for one SB and is shared by all md_stage_0 calls of all PD passes of that SB.
+typedef struct MdCandCostCacheEntry {
+    uint32_t sb_tag; // owning SB; entries with a stale tag are invalid
+    uint16_t blkidx_mds;
+    uint8_t  ref_frame_type;
+    uint8_t  hbd_mode_decision;
+    uint8_t  compound_idx;
+    uint8_t  chroma_ready; // chroma_fast_distortion is valid
+    uint32_t interp_filters;
+    int16_t  mv[MAX_NUM_OF_REF_PIC_LIST][2];
+    uint32_t luma_fast_distortion;
+    uint64_t chroma_fast_distortion;
+} MdCandCostCacheEntry;
+
 typedef struct {
     uint8_t best_palette_color_map[MAX_PALETTE_SQUARE];
     int     kmeans_data_buf[2 * MAX_PALETTE_SQUARE];
@@ -402,6 +423,13 @@ typedef struct ModeDecisionContext {
 
     // Signal to control initial and final pass PD setting(s)
     PdPass pd_pass;
+    // Static SB of the input region of interest map: PD0 depth only, no PD1
+    EbBool roi_static_sb;
+
+    // Candidate cost cache (fast loop distortion reuse across md_stage_0 calls and PD passes)
+    MdCandCostCacheEntry *md_cand_cost_cache;
+    uint32_t              md_cand_cost_cache_sb_tag;
+    uint8_t               md_cand_cost_cache_enabled;
 
 } ModeDecisionContext;
 
@@ -12,6 +12,7 @@
 #include "EbPictureControlSet.h"
 #include "EbEntropyCoding.h"
 #include "EbRateControlTasks.h"
+#include "EbRateControlVbv.h"
 #include "EbTime.h"
 #include "EbModeDecisionProcess.h"
 #include "EbPictureDemuxResults.h"
@@ -39,6 +40,8 @@ typedef struct PacketizationContext {
     uint64_t     dpb_disp_order[8], dpb_dec_order[8];
     uint64_t     tot_shown_frames;
     uint64_t     disp_order_continuity_count;
+    VbvMode      vbv_mode;
+    VbvModel     vbv; // decoder buffer fed with the output TUs
 } PacketizationContext;
 
 static EbBool is_passthrough_data(EbLinkedListNode *data_node) { return data_node->passthrough; }
@@ -77,6 +80,17 @@ EbErrorType packetization_context_ctor(EbThreadContext *  thread_context_ptr,
         enc_handle_ptr->picture_demux_results_resource_ptr, demux_index);
     EB_MALLOC_ARRAY(context_ptr->pps_config, 1);
 
+    const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+    context_ptr->vbv_mode             = (VbvMode)scs_ptr->static_config.vbv_mode;
+    if (context_ptr->vbv_mode != VBV_MODE_OFF)
+        vbv_model_init(&context_ptr->vbv,
+                       scs_ptr->static_config.vbv_bufsize,
+                       scs_ptr->static_config.vbv_maxrate,
+                       scs_ptr->frame_rate,
+                       scs_ptr->static_config.vbv_init,
+                       scs_ptr->static_config.max_frame_size,
+                       context_ptr->vbv_mode == VBV_MODE_CBR);
+
     return EB_ErrorNone;
 }
 
@@ -612,6 +626,34 @@ static void encode_show_existing(EncodeContext *encode_context_ptr,
     output_stream_ptr->flags |= (EB_BUFFERFLAG_SHOW_EXT | EB_BUFFERFLAG_HAS_TD);
 }
 
+/**************************************************
+* vbv_process_tu
+* Removes an output TU from the VBV buffer model, padding it first in CBR
+* so the buffer does not overflow
+**************************************************/
+static void vbv_process_tu(PacketizationContext *context_ptr,
+                           EbBufferHeaderType   *output_stream_ptr) {
+    VbvModel *vbv           = &context_ptr->vbv;
+    uint32_t  padding_bytes =
+        vbv_model_padding_bytes(vbv, (uint64_t)output_stream_ptr->n_filled_len << 3);
+
+    if (padding_bytes) {
+        // the padding OBU header and size field take up to 1 + 8 bytes
+        padding_bytes = MAX(padding_bytes, 2);
+        if (output_stream_ptr->n_filled_len + padding_bytes + 8 <= output_stream_ptr->n_alloc_len)
+            output_stream_ptr->n_filled_len += encode_padding_av1(
+                output_stream_ptr->p_buffer + output_stream_ptr->n_filled_len, padding_bytes);
+    }
+    if (!vbv_model_update(vbv, (uint64_t)output_stream_ptr->n_filled_len << 3))
+        SVT_WARN("VBV violation @ TU %llu (%u bytes): %u underflows, %u overflows, "
+                 "%u oversized TUs\n",
+                 (unsigned long long)(vbv->tu_count - 1),
+                 output_stream_ptr->n_filled_len,
+                 vbv->underflow_count,
+                 vbv->overflow_count,
+                 vbv->oversize_count);
+}
+
 static void release_frames(EncodeContext *encode_context_ptr, int frames) {
     for (int i = 0; i < frames; i++) {
         PacketizationReorderEntry *queue_entry_ptr = get_reorder_queue_entry(encode_context_ptr, i);
@@ -867,6 +909,8 @@ void *packetization_kernel(void *input_ptr) {
             EbBool eos                = output_stream_ptr->flags &  EB_BUFFERFLAG_EOS;
 
             encode_tu(encode_context_ptr, frames, total_bytes, output_stream_ptr);
+            if (context_ptr->vbv_mode != VBV_MODE_OFF)
+                vbv_process_tu(context_ptr, output_stream_ptr);
 
             if (eos && queue_entry_ptr->has_show_existing)
                 clear_eos_flag(output_stream_ptr);
@@ -877,6 +921,8 @@ void *packetization_kernel(void *input_ptr) {
                 if (existed) {
                     EbBufferHeaderType *existed_output_stream_ptr = (EbBufferHeaderType *)existed->object_ptr;
                     encode_show_existing(encode_context_ptr, queue_entry_ptr, existed_output_stream_ptr);
+                    if (context_ptr->vbv_mode != VBV_MODE_OFF)
+                        vbv_process_tu(context_ptr, existed_output_stream_ptr);
                     if (eos)
                         set_eos_flag(existed_output_stream_ptr);
                     eb_post_full_object(existed);
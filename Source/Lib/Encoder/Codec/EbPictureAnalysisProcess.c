@@ -2991,7 +2991,14 @@ void set_picture_parameters_for_statistics_gathering(SequenceControlSet *scs_ptr
  ************************************************/
 void picture_pre_processing_operations(PictureParentControlSet *pcs_ptr,
                                        SequenceControlSet *scs_ptr, uint32_t sb_total_count) {
-    if (scs_ptr->film_grain_denoise_strength) {
+    if (scs_ptr->film_grain_denoise_strength && scs_ptr->static_config.fast_film_grain) {
+        // Fast film grain: the segments denoise their rows from this copy of the
+        // source, and the grain is modeled in picture decision
+        pcs_ptr->frm_hdr.film_grain_params.apply_grain = 0;
+        eb_aom_denoise_and_model_snapshot(pcs_ptr->denoise_and_model,
+                                          pcs_ptr->enhanced_picture_ptr,
+                                          scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    } else if (scs_ptr->film_grain_denoise_strength) {
         denoise_estimate_film_grain(scs_ptr, pcs_ptr);
     } else {
         //Reset the flat noise flag array to False for both RealTime/HighComplexity Modes
@@ -3218,6 +3225,45 @@ void sub_sample_chroma_generate_pixel_intensity_histogram_bins(
     }
     return;
 }
+/************************************************
+ * compute_sb_spatial_statistics
+ ** Compute Block Variance and Block Mean for all blocks of one SB
+ ************************************************/
+static void compute_sb_spatial_statistics(SequenceControlSet *     scs_ptr,
+                                          PictureParentControlSet *pcs_ptr,
+                                          EbPictureBufferDesc *    input_picture_ptr,
+                                          EbPictureBufferDesc *    input_padded_picture_ptr,
+                                          uint32_t                 sb_index) {
+    SbParams *sb_params = &pcs_ptr->sb_params_array[sb_index];
+
+    uint32_t sb_origin_x             = sb_params->origin_x;
+    uint32_t sb_origin_y             = sb_params->origin_y;
+    uint32_t input_luma_origin_index = (input_padded_picture_ptr->origin_y + sb_origin_y) *
+                                           input_padded_picture_ptr->stride_y +
+                                       input_padded_picture_ptr->origin_x + sb_origin_x;
+
+    uint32_t input_cb_origin_index =
+        ((input_picture_ptr->origin_y + sb_origin_y) >> 1) * input_picture_ptr->stride_cb +
+        ((input_picture_ptr->origin_x + sb_origin_x) >> 1);
+    uint32_t input_cr_origin_index =
+        ((input_picture_ptr->origin_y + sb_origin_y) >> 1) * input_picture_ptr->stride_cr +
+        ((input_picture_ptr->origin_x + sb_origin_x) >> 1);
+
+    compute_block_mean_compute_variance(
+        scs_ptr, pcs_ptr, input_padded_picture_ptr, sb_index, input_luma_origin_index);
+
+    if (sb_params->is_complete_sb) {
+        compute_chroma_block_mean(scs_ptr,
+                                  pcs_ptr,
+                                  input_picture_ptr,
+                                  sb_index,
+                                  input_cb_origin_index,
+                                  input_cr_origin_index);
+    } else {
+        zero_out_chroma_block_mean(pcs_ptr, sb_index);
+    }
+}
+
 /************************************************
  * compute_picture_spatial_statistics
  ** Compute Block Variance
@@ -3230,45 +3276,14 @@ void compute_picture_spatial_statistics(SequenceControlSet *     scs_ptr,
                                         EbPictureBufferDesc *    input_padded_picture_ptr,
                                         uint32_t                 sb_total_count) {
     uint32_t sb_index;
-    uint32_t sb_origin_x; // to avoid using child PCS
-    uint32_t sb_origin_y;
-    uint32_t input_luma_origin_index;
-    uint32_t input_cb_origin_index;
-    uint32_t input_cr_origin_index;
     uint64_t pic_tot_variance;
 
     // Variance
     pic_tot_variance = 0;
 
     for (sb_index = 0; sb_index < pcs_ptr->sb_total_count; ++sb_index) {
-        SbParams *sb_params = &pcs_ptr->sb_params_array[sb_index];
-
-        sb_origin_x             = sb_params->origin_x;
-        sb_origin_y             = sb_params->origin_y;
-        input_luma_origin_index = (input_padded_picture_ptr->origin_y + sb_origin_y) *
-                                      input_padded_picture_ptr->stride_y +
-                                  input_padded_picture_ptr->origin_x + sb_origin_x;
-
-        input_cb_origin_index =
-            ((input_picture_ptr->origin_y + sb_origin_y) >> 1) * input_picture_ptr->stride_cb +
-            ((input_picture_ptr->origin_x + sb_origin_x) >> 1);
-        input_cr_origin_index =
-            ((input_picture_ptr->origin_y + sb_origin_y) >> 1) * input_picture_ptr->stride_cr +
-            ((input_picture_ptr->origin_x + sb_origin_x) >> 1);
-
-        compute_block_mean_compute_variance(
-            scs_ptr, pcs_ptr, input_padded_picture_ptr, sb_index, input_luma_origin_index);
-
-        if (sb_params->is_complete_sb) {
-            compute_chroma_block_mean(scs_ptr,
-                                      pcs_ptr,
-                                      input_picture_ptr,
-                                      sb_index,
-                                      input_cb_origin_index,
-                                      input_cr_origin_index);
-        } else {
-            zero_out_chroma_block_mean(pcs_ptr, sb_index);
-        }
+        compute_sb_spatial_statistics(
+            scs_ptr, pcs_ptr, input_picture_ptr, input_padded_picture_ptr, sb_index);
 
         pic_tot_variance += (pcs_ptr->variance[sb_index][RASTER_SCAN_CU_INDEX_64x64]);
     }
@@ -3340,15 +3355,13 @@ void calculate_input_average_intensity(SequenceControlSet *     scs_ptr,
 }
 
 /************************************************
- * Gathering statistics per picture
+ * Gathering intensity statistics per picture
  ** Calculating the pixel intensity histogram bins per picture needed for SCD
- ** Computing Picture Variance
+ ** Calculating the average intensity per picture
  ************************************************/
-void gathering_picture_statistics(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
-                                  EbPictureBufferDesc *input_picture_ptr,
-                                  EbPictureBufferDesc *input_padded_picture_ptr,
-                                  EbPictureBufferDesc *sixteenth_decimated_picture_ptr,
-                                  uint32_t             sb_total_count) {
+static void gathering_picture_intensity_statistics(
+    SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
+    EbPictureBufferDesc *input_picture_ptr, EbPictureBufferDesc *sixteenth_decimated_picture_ptr) {
     uint64_t sum_avg_intensity_ttl_regions_luma = 0;
     uint64_t sum_avg_intensity_ttl_regions_cb   = 0;
     uint64_t sum_avg_intensity_ttl_regions_cr   = 0;
@@ -3374,6 +3387,20 @@ void gathering_picture_statistics(SequenceControlSet *scs_ptr, PictureParentCont
                                       sum_avg_intensity_ttl_regions_luma,
                                       sum_avg_intensity_ttl_regions_cb,
                                       sum_avg_intensity_ttl_regions_cr);
+}
+
+/************************************************
+ * Gathering statistics per picture
+ ** Calculating the pixel intensity histogram bins per picture needed for SCD
+ ** Computing Picture Variance
+ ************************************************/
+void gathering_picture_statistics(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
+                                  EbPictureBufferDesc *input_picture_ptr,
+                                  EbPictureBufferDesc *input_padded_picture_ptr,
+                                  EbPictureBufferDesc *sixteenth_decimated_picture_ptr,
+                                  uint32_t             sb_total_count) {
+    gathering_picture_intensity_statistics(
+        scs_ptr, pcs_ptr, input_picture_ptr, sixteenth_decimated_picture_ptr);
 
     compute_picture_spatial_statistics(
         scs_ptr, pcs_ptr, input_picture_ptr, input_padded_picture_ptr, sb_total_count);
@@ -3475,28 +3502,101 @@ void pad_picture_to_multiple_of_sb_dimensions(EbPictureBufferDesc *input_padded_
 }
 
 /************************************************
-* 1/4 & 1/16 input picture decimation
+ * Copy the luma rows [row_start, row_end) of the input picture to the padded picture
+ ************************************************/
+static void copy_input_to_padded_rows(EbPictureBufferDesc *input_picture_ptr,
+                                      EbPictureBufferDesc *input_padded_picture_ptr,
+                                      uint32_t row_start, uint32_t row_end) {
+    uint8_t *pa = input_padded_picture_ptr->buffer_y + input_padded_picture_ptr->origin_x +
+                  input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y;
+    uint8_t *in = input_picture_ptr->buffer_y + input_picture_ptr->origin_x +
+                  input_picture_ptr->origin_y * input_picture_ptr->stride_y;
+    for (uint32_t row = row_start; row < row_end; row++)
+        EB_MEMCPY(pa + row * input_padded_picture_ptr->stride_y,
+                  in + row * input_picture_ptr->stride_y,
+                  sizeof(uint8_t) * input_picture_ptr->width);
+}
+
+/************************************************
+ * Pad the luma rows [row_start, row_end) of the padded picture
+ ** The top/bottom borders are generated by the segments holding the first/last rows
+ ************************************************/
+static void pad_padded_picture_rows(EbPictureBufferDesc *input_padded_picture_ptr,
+                                    uint32_t row_start, uint32_t row_end) {
+    const uint32_t stride = input_padded_picture_ptr->stride_y;
+    EbByte         first_row =
+        input_padded_picture_ptr->buffer_y + input_padded_picture_ptr->origin_y * stride;
+    EbByte rows = first_row + input_padded_picture_ptr->origin_x + row_start * stride;
+
+    generate_padding_l(rows, stride, row_end - row_start, input_padded_picture_ptr->origin_x);
+    generate_padding_r(rows,
+                       stride,
+                       input_padded_picture_ptr->width,
+                       row_end - row_start,
+                       input_padded_picture_ptr->origin_x);
+    if (row_start == 0)
+        generate_padding_t(first_row, stride, stride, input_padded_picture_ptr->origin_y);
+    if (row_end == input_padded_picture_ptr->height)
+        generate_padding_b(first_row,
+                           stride,
+                           stride,
+                           input_padded_picture_ptr->height,
+                           input_padded_picture_ptr->origin_y);
+}
+
+/************************************************
+* 1/4 & 1/16 input picture decimation of the luma rows [row_start, row_end)
+** row_start must be a multiple of 4; the decimated pictures are not padded
 ************************************************/
-void downsample_decimation_input_picture(PictureParentControlSet *pcs_ptr,
-                                         EbPictureBufferDesc *    input_padded_picture_ptr,
-                                         EbPictureBufferDesc *    quarter_decimated_picture_ptr,
-                                         EbPictureBufferDesc *    sixteenth_decimated_picture_ptr) {
+static void downsample_decimation_input_rows(PictureParentControlSet *pcs_ptr,
+                                             EbPictureBufferDesc *    input_padded_picture_ptr,
+                                             EbPictureBufferDesc *    quarter_decimated_picture_ptr,
+                                             EbPictureBufferDesc *sixteenth_decimated_picture_ptr,
+                                             uint32_t row_start, uint32_t row_end) {
+    uint8_t *input_samples =
+        &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x +
+                                            (input_padded_picture_ptr->origin_y + row_start) *
+                                                input_padded_picture_ptr->stride_y];
+
     // Decimate input picture for HME L0 and L1
     if (pcs_ptr->enable_hme_flag || pcs_ptr->tf_enable_hme_flag) {
         if (pcs_ptr->enable_hme_level1_flag || pcs_ptr->tf_enable_hme_level1_flag) {
-            decimation_2d(
-                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x +
-                                                    input_padded_picture_ptr->origin_y *
-                                                        input_padded_picture_ptr->stride_y],
-                input_padded_picture_ptr->stride_y,
-                input_padded_picture_ptr->width,
-                input_padded_picture_ptr->height,
-                &quarter_decimated_picture_ptr
-                     ->buffer_y[quarter_decimated_picture_ptr->origin_x +
-                                quarter_decimated_picture_ptr->origin_x *
-                                    quarter_decimated_picture_ptr->stride_y],
-                quarter_decimated_picture_ptr->stride_y,
-                2);
+            decimation_2d(input_samples,
+                          input_padded_picture_ptr->stride_y,
+                          input_padded_picture_ptr->width,
+                          row_end - row_start,
+                          &quarter_decimated_picture_ptr
+                               ->buffer_y[quarter_decimated_picture_ptr->origin_x +
+                                          (quarter_decimated_picture_ptr->origin_x +
+                                           (row_start >> 1)) *
+                                              quarter_decimated_picture_ptr->stride_y],
+                          quarter_decimated_picture_ptr->stride_y,
+                          2);
+        }
+    }
+
+    // Always perform 1/16th decimation as
+    // Sixteenth Input Picture Decimation
+    decimation_2d(input_samples,
+                  input_padded_picture_ptr->stride_y,
+                  input_padded_picture_ptr->width,
+                  row_end - row_start,
+                  &sixteenth_decimated_picture_ptr
+                       ->buffer_y[sixteenth_decimated_picture_ptr->origin_x +
+                                  (sixteenth_decimated_picture_ptr->origin_x + (row_start >> 2)) *
+                                      sixteenth_decimated_picture_ptr->stride_y],
+                  sixteenth_decimated_picture_ptr->stride_y,
+                  4);
+}
+
+/************************************************
+* Padding of the 1/4 & 1/16 decimated pictures
+************************************************/
+static void pad_decimated_pictures(PictureParentControlSet *pcs_ptr,
+                                   EbPictureBufferDesc *    quarter_decimated_picture_ptr,
+                                   EbPictureBufferDesc *    sixteenth_decimated_picture_ptr) {
+    if (pcs_ptr->enable_hme_flag || pcs_ptr->tf_enable_hme_flag) {
+        if (pcs_ptr->enable_hme_level1_flag || pcs_ptr->tf_enable_hme_level1_flag) {
             generate_padding(&quarter_decimated_picture_ptr->buffer_y[0],
                              quarter_decimated_picture_ptr->stride_y,
                              quarter_decimated_picture_ptr->width,
@@ -3506,21 +3606,6 @@ void downsample_decimation_input_picture(PictureParentControlSet *pcs_ptr,
         }
     }
 
-    // Always perform 1/16th decimation as
-    // Sixteenth Input Picture Decimation
-    decimation_2d(
-        &input_padded_picture_ptr
-             ->buffer_y[input_padded_picture_ptr->origin_x +
-                        input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y],
-        input_padded_picture_ptr->stride_y,
-        input_padded_picture_ptr->width,
-        input_padded_picture_ptr->height,
-        &sixteenth_decimated_picture_ptr->buffer_y[sixteenth_decimated_picture_ptr->origin_x +
-                                                   sixteenth_decimated_picture_ptr->origin_x *
-                                                       sixteenth_decimated_picture_ptr->stride_y],
-        sixteenth_decimated_picture_ptr->stride_y,
-        4);
-
     generate_padding(&sixteenth_decimated_picture_ptr->buffer_y[0],
                      sixteenth_decimated_picture_ptr->stride_y,
                      sixteenth_decimated_picture_ptr->width,
@@ -3529,6 +3614,24 @@ void downsample_decimation_input_picture(PictureParentControlSet *pcs_ptr,
                      sixteenth_decimated_picture_ptr->origin_y);
 }
 
+/************************************************
+* 1/4 & 1/16 input picture decimation
+************************************************/
+void downsample_decimation_input_picture(PictureParentControlSet *pcs_ptr,
+                                         EbPictureBufferDesc *    input_padded_picture_ptr,
+                                         EbPictureBufferDesc *    quarter_decimated_picture_ptr,
+                                         EbPictureBufferDesc *    sixteenth_decimated_picture_ptr) {
+    downsample_decimation_input_rows(pcs_ptr,
+                                     input_padded_picture_ptr,
+                                     quarter_decimated_picture_ptr,
+                                     sixteenth_decimated_picture_ptr,
+                                     0,
+                                     input_padded_picture_ptr->height);
+
+    pad_decimated_pictures(
+        pcs_ptr, quarter_decimated_picture_ptr, sixteenth_decimated_picture_ptr);
+}
+
 int av1_count_colors_highbd(uint16_t *src, int stride, int rows, int cols, int bit_depth,
                             int *val_count) {
     assert(bit_depth <= 12);
@@ -3764,27 +3867,76 @@ static void is_screen_content(PictureParentControlSet *pcs_ptr, int bit_depth) {
 }
 
 /************************************************
- * 1/4 & 1/16 input picture downsampling (filtering)
+ * 1/4 & 1/16 input picture downsampling (filtering) of the luma rows [row_start, row_end)
+ ** row_start must be a multiple of 4; the downsampled pictures are not padded
  ************************************************/
-void downsample_filtering_input_picture(PictureParentControlSet *pcs_ptr,
-                                        EbPictureBufferDesc *    input_padded_picture_ptr,
-                                        EbPictureBufferDesc *    quarter_picture_ptr,
-                                        EbPictureBufferDesc *    sixteenth_picture_ptr) {
+static void downsample_filtering_input_rows(PictureParentControlSet *pcs_ptr,
+                                            EbPictureBufferDesc *    input_padded_picture_ptr,
+                                            EbPictureBufferDesc *    quarter_picture_ptr,
+                                            EbPictureBufferDesc *    sixteenth_picture_ptr,
+                                            uint32_t row_start, uint32_t row_end) {
+    // The last band covers the whole remainder of the downsampled pictures
+    const EbBool   last_rows     = (EbBool)(row_end >= input_padded_picture_ptr->height);
+    const uint32_t quarter_start = row_start >> 1;
+    const uint32_t quarter_end   = last_rows ? quarter_picture_ptr->height : row_end >> 1;
+    uint8_t *      input_samples =
+        &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x +
+                                            (input_padded_picture_ptr->origin_y + row_start) *
+                                                input_padded_picture_ptr->stride_y];
+    uint8_t *quarter_samples =
+        &quarter_picture_ptr->buffer_y[quarter_picture_ptr->origin_x +
+                                       (quarter_picture_ptr->origin_y + quarter_start) *
+                                           quarter_picture_ptr->stride_y];
+    uint8_t *sixteenth_samples =
+        &sixteenth_picture_ptr->buffer_y[sixteenth_picture_ptr->origin_x +
+                                         (sixteenth_picture_ptr->origin_x + (row_start >> 2)) *
+                                             sixteenth_picture_ptr->stride_y];
+
     // Downsample input picture for HME L0 and L1
     if (pcs_ptr->enable_hme_flag || pcs_ptr->tf_enable_hme_flag) {
         if (pcs_ptr->enable_hme_level1_flag || pcs_ptr->tf_enable_hme_level1_flag) {
-            downsample_2d(
-                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x +
-                                                    input_padded_picture_ptr->origin_y *
-                                                        input_padded_picture_ptr->stride_y],
-                input_padded_picture_ptr->stride_y,
-                input_padded_picture_ptr->width,
-                input_padded_picture_ptr->height,
-                &quarter_picture_ptr
-                     ->buffer_y[quarter_picture_ptr->origin_x +
-                                quarter_picture_ptr->origin_x * quarter_picture_ptr->stride_y],
-                quarter_picture_ptr->stride_y,
-                2);
+            downsample_2d(input_samples,
+                          input_padded_picture_ptr->stride_y,
+                          input_padded_picture_ptr->width,
+                          row_end - row_start,
+                          &quarter_picture_ptr->buffer_y[quarter_picture_ptr->origin_x +
+                                                         (quarter_picture_ptr->origin_x +
+                                                          quarter_start) *
+                                                             quarter_picture_ptr->stride_y],
+                          quarter_picture_ptr->stride_y,
+                          2);
+        }
+
+        if (pcs_ptr->enable_hme_level0_flag || pcs_ptr->tf_enable_hme_level0_flag) {
+            // Sixteenth Input Picture Downsampling
+            if (pcs_ptr->enable_hme_level1_flag || pcs_ptr->tf_enable_hme_level1_flag)
+                downsample_2d(quarter_samples,
+                              quarter_picture_ptr->stride_y,
+                              quarter_picture_ptr->width,
+                              quarter_end - quarter_start,
+                              sixteenth_samples,
+                              sixteenth_picture_ptr->stride_y,
+                              2);
+            else
+                downsample_2d(input_samples,
+                              input_padded_picture_ptr->stride_y,
+                              input_padded_picture_ptr->width,
+                              row_end - row_start,
+                              sixteenth_samples,
+                              sixteenth_picture_ptr->stride_y,
+                              4);
+        }
+    }
+}
+
+/************************************************
+ * Padding of the 1/4 & 1/16 downsampled (filtered) pictures
+ ************************************************/
+static void pad_filtered_pictures(PictureParentControlSet *pcs_ptr,
+                                  EbPictureBufferDesc *    quarter_picture_ptr,
+                                  EbPictureBufferDesc *    sixteenth_picture_ptr) {
+    if (pcs_ptr->enable_hme_flag || pcs_ptr->tf_enable_hme_flag) {
+        if (pcs_ptr->enable_hme_level1_flag || pcs_ptr->tf_enable_hme_level1_flag) {
             generate_padding(&quarter_picture_ptr->buffer_y[0],
                              quarter_picture_ptr->stride_y,
                              quarter_picture_ptr->width,
@@ -3794,34 +3946,6 @@ void downsample_filtering_input_picture(PictureParentControlSet *pcs_ptr,
         }
 
         if (pcs_ptr->enable_hme_level0_flag || pcs_ptr->tf_enable_hme_level0_flag) {
-            // Sixteenth Input Picture Downsampling
-            if (pcs_ptr->enable_hme_level1_flag || pcs_ptr->tf_enable_hme_level1_flag)
-                downsample_2d(
-                    &quarter_picture_ptr
-                         ->buffer_y[quarter_picture_ptr->origin_x +
-                                    quarter_picture_ptr->origin_y * quarter_picture_ptr->stride_y],
-                    quarter_picture_ptr->stride_y,
-                    quarter_picture_ptr->width,
-                    quarter_picture_ptr->height,
-                    &sixteenth_picture_ptr->buffer_y[sixteenth_picture_ptr->origin_x +
-                                                     sixteenth_picture_ptr->origin_x *
-                                                         sixteenth_picture_ptr->stride_y],
-                    sixteenth_picture_ptr->stride_y,
-                    2);
-            else
-                downsample_2d(
-                    &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x +
-                                                        input_padded_picture_ptr->origin_y *
-                                                            input_padded_picture_ptr->stride_y],
-                    input_padded_picture_ptr->stride_y,
-                    input_padded_picture_ptr->width,
-                    input_padded_picture_ptr->height,
-                    &sixteenth_picture_ptr->buffer_y[sixteenth_picture_ptr->origin_x +
-                                                     sixteenth_picture_ptr->origin_x *
-                                                         sixteenth_picture_ptr->stride_y],
-                    sixteenth_picture_ptr->stride_y,
-                    4);
-
             generate_padding(&sixteenth_picture_ptr->buffer_y[0],
                              sixteenth_picture_ptr->stride_y,
                              sixteenth_picture_ptr->width,
@@ -3832,6 +3956,169 @@ void downsample_filtering_input_picture(PictureParentControlSet *pcs_ptr,
     }
 }
 
+/************************************************
+ * 1/4 & 1/16 input picture downsampling (filtering)
+ ************************************************/
+void downsample_filtering_input_picture(PictureParentControlSet *pcs_ptr,
+                                        EbPictureBufferDesc *    input_padded_picture_ptr,
+                                        EbPictureBufferDesc *    quarter_picture_ptr,
+                                        EbPictureBufferDesc *    sixteenth_picture_ptr) {
+    downsample_filtering_input_rows(pcs_ptr,
+                                    input_padded_picture_ptr,
+                                    quarter_picture_ptr,
+                                    sixteenth_picture_ptr,
+                                    0,
+                                    input_padded_picture_ptr->height);
+
+    pad_filtered_pictures(pcs_ptr, quarter_picture_ptr, sixteenth_picture_ptr);
+}
+
+/************************************************
+ * Picture level operations performed once per picture, before any segment work
+ ** Borders preprocessing, denoising / film grain estimation, 422/444 => 420 conversion
+ ************************************************/
+static void picture_analysis_prep(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
+                                  EbPictureBufferDesc *input_padded_picture_ptr,
+                                  uint32_t             sb_total_count) {
+    EbPictureBufferDesc *input_picture_ptr = pcs_ptr->enhanced_picture_ptr;
+
+    // Mariana : save enhanced picture ptr, move this from here
+    pcs_ptr->enhanced_unscaled_picture_ptr = pcs_ptr->enhanced_picture_ptr;
+
+    generate_padding(input_picture_ptr->buffer_y,
+                     input_picture_ptr->stride_y,
+                     input_picture_ptr->width,
+                     input_picture_ptr->height,
+                     input_picture_ptr->origin_x,
+                     input_picture_ptr->origin_y);
+
+    // ME works on the source before denoising, so the copy to the padded picture
+    // cannot be deferred to the segments when the denoiser is on
+    if (scs_ptr->film_grain_denoise_strength)
+        copy_input_to_padded_rows(input_picture_ptr, input_padded_picture_ptr, 0,
+                                  input_picture_ptr->height);
+
+    // Set picture parameters to account for subpicture, picture scantype, and set regions by resolutions
+    set_picture_parameters_for_statistics_gathering(scs_ptr);
+
+    // Pad pictures to multiple min cu size
+    pad_picture_to_multiple_of_min_blk_size_dimensions(scs_ptr, input_picture_ptr);
+
+    // Pre processing operations performed on the input picture
+    picture_pre_processing_operations(pcs_ptr, scs_ptr, sb_total_count);
+    if (input_picture_ptr->color_format >= EB_YUV422) {
+        // Jing: Do the conversion of 422/444=>420 here since it's multi-threaded kernel
+        //       Reuse the Y, only add cb/cr in the newly created buffer desc
+        //       NOTE: since denoise may change the src, so this part is after picture_pre_processing_operations()
+        pcs_ptr->chroma_downsampled_picture_ptr->buffer_y = input_picture_ptr->buffer_y;
+        down_sample_chroma(input_picture_ptr, pcs_ptr->chroma_downsampled_picture_ptr);
+    } else
+        pcs_ptr->chroma_downsampled_picture_ptr = input_picture_ptr;
+}
+
+/************************************************
+ * Segment operations, performed on the SB rows [sb_row_start, sb_row_end)
+ ** Padded picture copy and padding, decimation, SB statistics
+ ************************************************/
+static void picture_analysis_segment(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
+                                     EbPaReferenceObject *pa_ref_obj_, uint32_t pic_width_in_sb,
+                                     uint32_t sb_row_start, uint32_t sb_row_end) {
+    EbPictureBufferDesc *input_picture_ptr = pcs_ptr->enhanced_picture_ptr;
+    EbPictureBufferDesc *input_padded_picture_ptr =
+        (EbPictureBufferDesc *)pa_ref_obj_->input_padded_picture_ptr;
+    const uint32_t row_start = sb_row_start * scs_ptr->sb_sz;
+    const uint32_t row_end = MIN(sb_row_end * scs_ptr->sb_sz, input_padded_picture_ptr->height);
+    uint32_t       sb_index;
+
+    if (scs_ptr->film_grain_denoise_strength && scs_ptr->static_config.fast_film_grain)
+        eb_aom_denoise_rows(pcs_ptr->denoise_and_model,
+                            input_picture_ptr,
+                            row_start,
+                            row_end,
+                            scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+
+    if (!scs_ptr->film_grain_denoise_strength)
+        copy_input_to_padded_rows(input_picture_ptr,
+                                  input_padded_picture_ptr,
+                                  row_start,
+                                  MIN(row_end, input_picture_ptr->height));
+
+    // Pad input picture to complete border SBs
+    pad_padded_picture_rows(input_padded_picture_ptr, row_start, row_end);
+
+    // 1/4 & 1/16 input picture decimation
+    downsample_decimation_input_rows(
+        pcs_ptr,
+        input_padded_picture_ptr,
+        (EbPictureBufferDesc *)pa_ref_obj_->quarter_decimated_picture_ptr,
+        (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_decimated_picture_ptr,
+        row_start,
+        row_end);
+
+    // 1/4 & 1/16 input picture downsampling through filtering
+    if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
+        downsample_filtering_input_rows(
+            pcs_ptr,
+            input_padded_picture_ptr,
+            (EbPictureBufferDesc *)pa_ref_obj_->quarter_filtered_picture_ptr,
+            (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_filtered_picture_ptr,
+            row_start,
+            row_end);
+    }
+
+    // Block variance and mean of the segment SBs
+    for (uint32_t sb_row = sb_row_start; sb_row < sb_row_end; ++sb_row) {
+        for (sb_index = sb_row * pic_width_in_sb;
+             sb_index < MIN((sb_row + 1) * pic_width_in_sb, pcs_ptr->sb_total_count);
+             ++sb_index) {
+            compute_sb_spatial_statistics(scs_ptr,
+                                          pcs_ptr,
+                                          pcs_ptr->chroma_downsampled_picture_ptr, //420 input
+                                          input_padded_picture_ptr,
+                                          sb_index);
+
+            // Hold the 64x64 variance and mean in the reference frame
+            pa_ref_obj_->variance[sb_index] = pcs_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64];
+            pa_ref_obj_->y_mean[sb_index]   = pcs_ptr->y_mean[sb_index][ME_TIER_ZERO_PU_64x64];
+        }
+    }
+}
+
+/************************************************
+ * Picture level operations performed once all the segments of a picture are done
+ ** Decimated pictures padding, histograms, picture variance, screen content detection
+ ************************************************/
+static void picture_analysis_finish(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
+                                    EbPaReferenceObject *pa_ref_obj_, uint32_t sb_total_count) {
+    uint64_t pic_tot_variance = 0;
+
+    pad_decimated_pictures(
+        pcs_ptr,
+        (EbPictureBufferDesc *)pa_ref_obj_->quarter_decimated_picture_ptr,
+        (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_decimated_picture_ptr);
+    if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
+        pad_filtered_pictures(pcs_ptr,
+                              (EbPictureBufferDesc *)pa_ref_obj_->quarter_filtered_picture_ptr,
+                              (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_filtered_picture_ptr);
+
+    // Gathering statistics of input picture, including Histogram Bins
+    gathering_picture_intensity_statistics(
+        scs_ptr,
+        pcs_ptr,
+        pcs_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
+        (EbPictureBufferDesc *)pa_ref_obj_
+            ->sixteenth_decimated_picture_ptr); // Hsan: always use decimated until studying the trade offs
+
+    for (uint32_t sb_index = 0; sb_index < pcs_ptr->sb_total_count; ++sb_index)
+        pic_tot_variance += (pcs_ptr->variance[sb_index][RASTER_SCAN_CU_INDEX_64x64]);
+    pcs_ptr->pic_avg_variance = (uint16_t)(pic_tot_variance / sb_total_count);
+
+    if (scs_ptr->static_config.screen_content_mode == 2) { // auto detect
+        is_screen_content(pcs_ptr, scs_ptr->static_config.encoder_bit_depth);
+    } else // off / on
+        pcs_ptr->sc_content_detected = scs_ptr->static_config.screen_content_mode;
+}
+
 /* Picture Analysis Kernel */
 
 /*********************************************************************************
@@ -3846,6 +4133,9 @@ void downsample_filtering_input_picture(PictureParentControlSet *pcs_ptr,
 *  in the picture, which are used in variance calculations. Since the Picture Analysis process is multithreaded,
 *  the pictures can be processed out of order as long as all image-modifying functions are completed before any
 *  statistics-gathering functions begin.
+*  Each picture is split into segments of SB rows: the first segment to start performs the picture based
+*  preprocessing, every segment then pads, decimates and gathers the SB statistics of its rows, and the last
+*  segment to complete gathers the picture statistics and posts the picture to Picture Decision.
 *
 * @param[in] Pictures
 *  The Picture Analysis Kernel performs pre-processing analysis as well as any intra-picture image conversion,
@@ -3868,14 +4158,17 @@ void *picture_analysis_kernel(void *input_ptr) {
     PictureAnalysisResults *     out_results_ptr;
     EbPaReferenceObject *        pa_ref_obj_;
 
-    EbPictureBufferDesc *input_padded_picture_ptr;
-    EbPictureBufferDesc *input_picture_ptr;
-
     // Variance
     uint32_t pic_width_in_sb;
     uint32_t pic_height_in_sb;
     uint32_t sb_total_count;
 
+    // Segments
+    uint32_t segment_index;
+    uint32_t sb_row_start;
+    uint32_t sb_row_end;
+    EbBool   picture_done;
+
     for (;;) {
         // Get Input Full Object
         eb_get_full_object(context_ptr->resource_coordination_results_input_fifo_ptr,
@@ -3883,110 +4176,65 @@ void *picture_analysis_kernel(void *input_ptr) {
 
         in_results_ptr = (ResourceCoordinationResults *)in_results_wrapper_ptr->object_ptr;
         pcs_ptr        = (PictureParentControlSet *)in_results_ptr->pcs_wrapper_ptr->object_ptr;
-
-        // Mariana : save enhanced picture ptr, move this from here
-        pcs_ptr->enhanced_unscaled_picture_ptr = pcs_ptr->enhanced_picture_ptr;
+        segment_index  = in_results_ptr->segment_index;
+        picture_done   = EB_TRUE;
 
         // There is no need to do processing for overlay picture. Overlay and AltRef share the same results.
         if (!pcs_ptr->is_overlay) {
-            scs_ptr           = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-            input_picture_ptr = pcs_ptr->enhanced_picture_ptr;
+            scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
 
             pa_ref_obj_ =
                 (EbPaReferenceObject *)pcs_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
-            input_padded_picture_ptr = (EbPictureBufferDesc *)pa_ref_obj_->input_padded_picture_ptr;
             // Variance
             pic_width_in_sb = (pcs_ptr->aligned_width + scs_ptr->sb_sz - 1) / scs_ptr->sb_sz;
             pic_height_in_sb = (pcs_ptr->aligned_height + scs_ptr->sb_sz - 1) / scs_ptr->sb_sz;
             sb_total_count = pic_width_in_sb * pic_height_in_sb;
-            generate_padding(input_picture_ptr->buffer_y,
-                             input_picture_ptr->stride_y,
-                             input_picture_ptr->width,
-                             input_picture_ptr->height,
-                             input_picture_ptr->origin_x,
-                             input_picture_ptr->origin_y);
-            {
-                uint8_t *pa =
-                    input_padded_picture_ptr->buffer_y + input_padded_picture_ptr->origin_x +
-                    input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y;
-                uint8_t *in = input_picture_ptr->buffer_y + input_picture_ptr->origin_x +
-                              input_picture_ptr->origin_y * input_picture_ptr->stride_y;
-                for (uint32_t row = 0; row < input_picture_ptr->height; row++)
-                    EB_MEMCPY(pa + row * input_padded_picture_ptr->stride_y,
-                              in + row * input_picture_ptr->stride_y,
-                              sizeof(uint8_t) * input_picture_ptr->width);
-            }
 
-            // Set picture parameters to account for subpicture, picture scantype, and set regions by resolutions
-            set_picture_parameters_for_statistics_gathering(scs_ptr);
-
-            // Pad pictures to multiple min cu size
-            pad_picture_to_multiple_of_min_blk_size_dimensions(scs_ptr, input_picture_ptr);
-
-            // Pre processing operations performed on the input picture
-            picture_pre_processing_operations(pcs_ptr, scs_ptr, sb_total_count);
-            if (input_picture_ptr->color_format >= EB_YUV422) {
-                // Jing: Do the conversion of 422/444=>420 here since it's multi-threaded kernel
-                //       Reuse the Y, only add cb/cr in the newly created buffer desc
-                //       NOTE: since denoise may change the src, so this part is after picture_pre_processing_operations()
-                pcs_ptr->chroma_downsampled_picture_ptr->buffer_y = input_picture_ptr->buffer_y;
-                down_sample_chroma(input_picture_ptr, pcs_ptr->chroma_downsampled_picture_ptr);
-            } else
-                pcs_ptr->chroma_downsampled_picture_ptr = input_picture_ptr;
-            // Pad input picture to complete border SBs
-            pad_picture_to_multiple_of_sb_dimensions(input_padded_picture_ptr);
-            // 1/4 & 1/16 input picture decimation
-            downsample_decimation_input_picture(
-                pcs_ptr,
-                input_padded_picture_ptr,
-                (EbPictureBufferDesc *)pa_ref_obj_->quarter_decimated_picture_ptr,
-                (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_decimated_picture_ptr);
-
-            // 1/4 & 1/16 input picture downsampling through filtering
-            if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
-                downsample_filtering_input_picture(
-                    pcs_ptr,
-                    input_padded_picture_ptr,
-                    (EbPictureBufferDesc *)pa_ref_obj_->quarter_filtered_picture_ptr,
-                    (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_filtered_picture_ptr);
+            // Only the first segment performs the picture based preprocessing, the
+            // other segments of the picture wait on the mutex until it is done
+            eb_block_on_mutex(pcs_ptr->pa_mutex);
+            if (pcs_ptr->pa_prep_done == 0) {
+                pcs_ptr->pa_prep_done = 1;
+                picture_analysis_prep(scs_ptr,
+                                      pcs_ptr,
+                                      (EbPictureBufferDesc *)pa_ref_obj_->input_padded_picture_ptr,
+                                      sb_total_count);
             }
+            eb_release_mutex(pcs_ptr->pa_mutex);
+
+            sb_row_start = segment_index * pic_height_in_sb / pcs_ptr->pa_segments_total_count;
+            sb_row_end = (segment_index + 1) * pic_height_in_sb / pcs_ptr->pa_segments_total_count;
+            picture_analysis_segment(
+                scs_ptr, pcs_ptr, pa_ref_obj_, pic_width_in_sb, sb_row_start, sb_row_end);
+
+            // Set the segment mask, the last segment completes the picture
+            eb_block_on_mutex(pcs_ptr->pa_mutex);
+            SEGMENT_COMPLETION_MASK_SET(pcs_ptr->pa_segments_completion_mask, segment_index);
+            picture_done = SEGMENT_COMPLETION_MASK_TEST(pcs_ptr->pa_segments_completion_mask,
+                                                        pcs_ptr->pa_segments_total_count);
+            eb_release_mutex(pcs_ptr->pa_mutex);
+
+            if (picture_done)
+                picture_analysis_finish(scs_ptr, pcs_ptr, pa_ref_obj_, sb_total_count);
+        } else
+            // Mariana : save enhanced picture ptr, move this from here
+            pcs_ptr->enhanced_unscaled_picture_ptr = pcs_ptr->enhanced_picture_ptr;
 
-            // Gathering statistics of input picture, including Variance Calculation, Histogram Bins
-            gathering_picture_statistics(
-                scs_ptr,
-                pcs_ptr,
-                pcs_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
-                input_padded_picture_ptr,
-                (EbPictureBufferDesc *)pa_ref_obj_
-                    ->sixteenth_decimated_picture_ptr, // Hsan: always use decimated until studying the trade offs
-                sb_total_count);
-
-            if (scs_ptr->static_config.screen_content_mode == 2) { // auto detect
-                is_screen_content(pcs_ptr,
-                                  scs_ptr->static_config.encoder_bit_depth);
-            } else // off / on
-                pcs_ptr->sc_content_detected = scs_ptr->static_config.screen_content_mode;
+        if (picture_done) {
+            // Get Empty Results Object
+            eb_get_empty_object(context_ptr->picture_analysis_results_output_fifo_ptr,
+                                &out_results_wrapper_ptr);
 
-            // Hold the 64x64 variance and mean in the reference frame
-            uint32_t sb_index;
-            for (sb_index = 0; sb_index < pcs_ptr->sb_total_count; ++sb_index) {
-                pa_ref_obj_->variance[sb_index] =
-                    pcs_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64];
-                pa_ref_obj_->y_mean[sb_index] = pcs_ptr->y_mean[sb_index][ME_TIER_ZERO_PU_64x64];
-            }
+            out_results_ptr = (PictureAnalysisResults *)out_results_wrapper_ptr->object_ptr;
+            out_results_ptr->pcs_wrapper_ptr = in_results_ptr->pcs_wrapper_ptr;
         }
-        // Get Empty Results Object
-        eb_get_empty_object(context_ptr->picture_analysis_results_output_fifo_ptr,
-                            &out_results_wrapper_ptr);
-
-        out_results_ptr = (PictureAnalysisResults *)out_results_wrapper_ptr->object_ptr;
-        out_results_ptr->pcs_wrapper_ptr = in_results_ptr->pcs_wrapper_ptr;
 
         // Release the Input Results
         eb_release_object(in_results_wrapper_ptr);
 
         // Post the Full Results Object
-        eb_post_full_object(out_results_wrapper_ptr);
+        if (picture_done)
+            eb_post_full_object(out_results_wrapper_ptr);
     }
     return EB_NULL;
 }
@@ -10,6 +10,9 @@
 #include "EbNoiseExtractAVX2.h"
 #include "EbPictureControlSet.h"
 
+/* Upper bound on the SB-row segments of one picture (completion is tracked in a 64-bit mask) */
+#define PA_MAX_SEGMENT_ROW_COUNT 32
+
 /***************************************
  * Extern Function Declaration
  ***************************************/
@@ -223,6 +223,9 @@ void picture_control_set_dctor(EbPtr p) {
     EB_DESTROY_MUTEX(obj->intra_mutex);
     EB_DESTROY_MUTEX(obj->cdef_search_mutex);
     EB_DESTROY_MUTEX(obj->rest_search_mutex);
+    EB_DESTROY_MUTEX(obj->dlf_mutex);
+    for (int32_t segment_index = 0; segment_index < DLF_MAX_SEGMENT_ROW_COUNT; segment_index++)
+        EB_DESTROY_SEMAPHORE(obj->dlf_vert_done_semaphore[segment_index]);
 }
 #else
 void picture_control_set_dctor(EbPtr p) {
@@ -319,6 +322,9 @@ void picture_control_set_dctor(EbPtr p) {
     EB_DESTROY_MUTEX(obj->intra_mutex);
     EB_DESTROY_MUTEX(obj->cdef_search_mutex);
     EB_DESTROY_MUTEX(obj->rest_search_mutex);
+    EB_DESTROY_MUTEX(obj->dlf_mutex);
+    for (int32_t segment_index = 0; segment_index < DLF_MAX_SEGMENT_ROW_COUNT; segment_index++)
+        EB_DESTROY_SEMAPHORE(obj->dlf_vert_done_semaphore[segment_index]);
 }
 #endif
 // Token buffer is only used for palette tokens.
@@ -1762,6 +1768,10 @@ EbErrorType picture_control_set_ctor(PictureControlSet *object_ptr, EbPtr object
 
     EB_CREATE_MUTEX(object_ptr->cdef_search_mutex);
 
+    EB_CREATE_MUTEX(object_ptr->dlf_mutex);
+    for (int32_t segment_index = 0; segment_index < DLF_MAX_SEGMENT_ROW_COUNT; segment_index++)
+        EB_CREATE_SEMAPHORE(object_ptr->dlf_vert_done_semaphore[segment_index], 0, 1);
+
     //object_ptr->mse_seg[0] = (uint64_t(*)[64])eb_aom_malloc(sizeof(**object_ptr->mse_seg) *  picture_sb_width * picture_sb_height);
     // object_ptr->mse_seg[1] = (uint64_t(*)[64])eb_aom_malloc(sizeof(**object_ptr->mse_seg) *  picture_sb_width * picture_sb_height);
 
@@ -1859,6 +1869,11 @@ static void picture_parent_control_set_dctor(EbPtr p) {
     // SB noise variance array
     EB_FREE_ARRAY(obj->sb_flat_noise_array);
     EB_FREE_ARRAY(obj->sb_depth_mode_array);
+    EB_FREE_ARRAY(obj->tpl_sb_intra_cost);
+    EB_FREE_ARRAY(obj->tpl_sb_propagate_cost);
+    EB_FREE_ARRAY(obj->tpl_intra_cost);
+    EB_FREE_ARRAY(obj->tpl_inter_cost);
+    EB_FREE_ARRAY(obj->tpl_mc_flow);
 
     if (obj->av1_cm) {
         const int32_t num_planes = 3; // av1_num_planes(cm);
@@ -1886,6 +1901,7 @@ static void picture_parent_control_set_dctor(EbPtr p) {
     EB_DESTROY_SEMAPHORE(obj->temp_filt_done_semaphore);
     EB_DESTROY_MUTEX(obj->temp_filt_mutex);
     EB_DESTROY_MUTEX(obj->debug_mutex);
+    EB_DESTROY_MUTEX(obj->pa_mutex);
 #if TILES_PARALLEL
     EB_FREE_ARRAY(obj->tile_group_info);
 #endif
@@ -2019,9 +2035,18 @@ EbErrorType picture_parent_control_set_ctor(PictureParentControlSet *object_ptr,
     EB_MALLOC_ARRAY(object_ptr->sb_flat_noise_array, object_ptr->sb_total_count);
     EB_CREATE_MUTEX(object_ptr->rc_distortion_histogram_mutex);
     EB_MALLOC_ARRAY(object_ptr->sb_depth_mode_array, object_ptr->sb_total_count);
+    if (init_data_ptr->enable_tpl_la) {
+        // TPL statistics, on the 16x16 blocks of the 64x64 SBs
+        EB_MALLOC_ARRAY(object_ptr->tpl_sb_intra_cost, object_ptr->sb_total_count);
+        EB_MALLOC_ARRAY(object_ptr->tpl_sb_propagate_cost, object_ptr->sb_total_count);
+        EB_MALLOC_ARRAY(object_ptr->tpl_intra_cost, object_ptr->sb_total_count << 4);
+        EB_MALLOC_ARRAY(object_ptr->tpl_inter_cost, object_ptr->sb_total_count << 4);
+        EB_MALLOC_ARRAY(object_ptr->tpl_mc_flow, object_ptr->sb_total_count << 4);
+    }
     EB_CREATE_SEMAPHORE(object_ptr->temp_filt_done_semaphore, 0, 1);
     EB_CREATE_MUTEX(object_ptr->temp_filt_mutex);
     EB_CREATE_MUTEX(object_ptr->debug_mutex);
+    EB_CREATE_MUTEX(object_ptr->pa_mutex);
     EB_MALLOC_ARRAY(object_ptr->av1_cm, 1);
 
     object_ptr->av1_cm->interp_filter = SWITCHABLE;
@@ -2075,6 +2100,7 @@ EbErrorType picture_parent_control_set_ctor(PictureParentControlSet *object_ptr,
         fg_init_data.encoder_bit_depth    = init_data_ptr->bit_depth;
         fg_init_data.encoder_color_format = init_data_ptr->color_format;
         fg_init_data.noise_level          = init_data_ptr->film_grain_noise_level;
+        fg_init_data.fast_film_grain      = (uint8_t)init_data_ptr->fast_film_grain;
         fg_init_data.width                = init_data_ptr->picture_width;
         fg_init_data.height               = init_data_ptr->picture_height;
         fg_init_data.stride_y = init_data_ptr->picture_width + init_data_ptr->left_padding +
@@ -2280,3 +2306,35 @@ EbErrorType picture_parent_control_set_creator(EbPtr *object_dbl_ptr, EbPtr obje
 
     return EB_ErrorNone;
 }
+
+uint32_t roi_map_block_count(const SequenceControlSet *scs_ptr) {
+    return ((scs_ptr->max_input_luma_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64) *
+           ((scs_ptr->max_input_luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64);
+}
+
+void roi_map_sb_range(const PictureParentControlSet *pcs_ptr, uint32_t sb_origin_x,
+                      uint32_t sb_origin_y, uint32_t sb_size, uint32_t *map_width,
+                      uint32_t *start_x, uint32_t *start_y, uint32_t *end_x, uint32_t *end_y) {
+    const SequenceControlSet *scs_ptr    = pcs_ptr->scs_ptr;
+    const uint32_t            src_width  = scs_ptr->max_input_luma_width;
+    const uint32_t            src_height = scs_ptr->max_input_luma_height;
+    const uint32_t            map_height = (src_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+
+    *map_width = (src_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    // the map is @ the source resolution, the SB @ the coded one
+    *start_x = (uint32_t)((uint64_t)sb_origin_x * src_width / pcs_ptr->aligned_width) /
+               BLOCK_SIZE_64;
+    *start_y = (uint32_t)((uint64_t)sb_origin_y * src_height / pcs_ptr->aligned_height) /
+               BLOCK_SIZE_64;
+    *end_x = (uint32_t)((uint64_t)(sb_origin_x + sb_size) * src_width / pcs_ptr->aligned_width -
+                        1) /
+             BLOCK_SIZE_64;
+    *end_y = (uint32_t)((uint64_t)(sb_origin_y + sb_size) * src_height /
+                            pcs_ptr->aligned_height -
+                        1) /
+             BLOCK_SIZE_64;
+    *start_x = MIN(*start_x, *map_width - 1);
+    *start_y = MIN(*start_y, map_height - 1);
+    *end_x   = MIN(*end_x, *map_width - 1);
+    *end_y   = MIN(*end_y, map_height - 1);
+}
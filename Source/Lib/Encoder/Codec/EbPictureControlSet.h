@@ -205,6 +205,22 @@ typedef struct SpeedFeatures {
 
 } SpeedFeatures;
 
+// Max DLF segments (bands of SB rows) of a picture
+#define DLF_MAX_SEGMENT_ROW_COUNT 32
+
+// Filter level search of a plane, stepped once per round of DLF search segments
+typedef struct DlfLevelSearch {
+    int32_t filt_mid;
+    int32_t filt_best; // -1 until filt_mid is evaluated
+    int32_t filter_step;
+    int32_t filt_direction;
+    int64_t best_err;
+    int64_t ss_err[MAX_LOOP_FILTER + 1]; // summed over the segments, -1: not evaluated
+    int32_t candidates[3]; // levels evaluated by the current round
+    uint8_t candidate_count;
+    EbBool  done;
+} DlfLevelSearch;
+
 typedef struct PictureControlSet {
     EbDctor          dctor;
     EbObjectWrapper *scs_wrapper_ptr;
@@ -267,6 +283,21 @@ typedef struct PictureControlSet {
     uint8_t  cdef_segments_column_count;
     uint8_t  cdef_segments_row_count;
 
+    // DLF segments (bands of SB rows)
+    uint16_t       dlf_segments_total_count;
+    uint16_t       tot_seg_dlf; // segments done in the current search round / filter pass
+    EbHandle       dlf_mutex;
+    EbHandle       dlf_vert_done_semaphore[DLF_MAX_SEGMENT_ROW_COUNT];
+    DlfLevelSearch dlf_level_search[MAX_MB_PLANE];
+    // Wavefront: the first search round runs on the SB rows coded by EncDec, and the CDEF
+    // segments are posted as the filter segments above them are deblocked
+    EbBool   dlf_rows_overlap;
+    EbBool   enc_dec_sb_row_done[MAX_SB_ROWS];
+    uint16_t enc_dec_completed_sb_rows; // SB rows coded, from the top of the picture
+    uint16_t dlf_segments_posted; // search segments of the first round posted by EncDec
+    EbBool   dlf_horz_done[DLF_MAX_SEGMENT_ROW_COUNT];
+    uint16_t cdef_segment_rows_posted;
+
     uint64_t (*mse_seg[2])[TOTAL_STRENGTHS];
 
     uint16_t *src[3]; //dlfed recon in 16bit form
@@ -656,6 +687,12 @@ typedef struct PictureParentControlSet {
     int      kf_zeromotion_pct; // percent of zero motion blocks
     uint8_t  fade_out_from_black;
     uint8_t  fade_in_to_black;
+    // Sliding window scene change detection: deltas to the previous picture
+    EbBool   scd_delta_valid;
+    double   scd_sad_delta;
+    double   scd_hist_delta;
+    EbBool   scd_flash;
+    EbBool   scd_fade;
     EbBool   is_pan;
     EbBool   is_tilt;
     uint8_t *sb_flat_noise_array;
@@ -693,6 +730,12 @@ typedef struct PictureParentControlSet {
     uint8_t  me_segments_row_count;
     uint64_t me_segments_completion_mask;
 
+    // Picture analysis segments (SB rows)
+    uint8_t  pa_segments_total_count;
+    uint64_t pa_segments_completion_mask;
+    uint8_t  pa_prep_done;
+    EbHandle pa_mutex;
+
     // Motion Estimation Results
     uint8_t       max_number_of_pus_per_sb;
     uint8_t       max_number_of_candidates_per_block;
@@ -842,6 +885,7 @@ typedef struct PictureParentControlSet {
     int32_t             cdef_frame_strength;
     int32_t             cdf_ref_frame_strength;
     int32_t             use_ref_frame_cdef_strength;
+    uint64_t            cdef_ref_strength_mask; // strengths of the reference in the same layer
     uint8_t             nsq_search_level;
     uint8_t             palette_mode;
     uint8_t             nsq_max_shapes_md; // max number of shapes to be tested in MD
@@ -885,6 +929,16 @@ typedef struct PictureParentControlSet {
     struct StatStruct stat_struct; // stat_struct used in the second pass
     uint64_t          referenced_area_avg; // average referenced area per frame
     uint8_t           referenced_area_has_non_zero;
+    // Temporal dependency model (TPL) results, set in the lookahead window
+    EbBool    tpl_valid;
+    double    tpl_r0; // intra cost over the intra + propagated cost of the picture
+    uint64_t *tpl_sb_intra_cost; // per 64x64 SB
+    uint64_t *tpl_sb_propagate_cost; // per 64x64 SB: intra cost + propagated (mc flow) cost
+    uint32_t *tpl_intra_cost; // per 16x16 block
+    uint32_t *tpl_inter_cost; // per 16x16 block
+    uint64_t *tpl_mc_flow; // per 16x16 block
+    uint64_t  vbv_predicted_bits; // size predicted by the VBV rate control, until the feedback
+    double    crf_complexity; // CRF: motion compensated complexity of the lookahead window, 0: none
 #if GLOBAL_WARPED_MOTION
     uint8_t gm_level;
 #endif
@@ -908,6 +962,8 @@ typedef struct PictureParentControlSet {
     uint16_t frame_height;
 
     EbBool frame_superres_enabled;
+    // Superres denominator picked by speed control for superres AUTO mode
+    uint8_t sc_superres_denom;
 #if MUS_ME
     uint8_t prune_ref_based_me;
 #endif
@@ -937,12 +993,14 @@ typedef struct PictureControlSetInitData {
     uint8_t   speed_control;
     uint8_t   hbd_mode_decision;
     uint16_t  film_grain_noise_level;
+    EbBool    fast_film_grain;
     EbBool    ext_block_flag;
     uint8_t   mrp_mode;
     uint8_t   cdf_mode;
     uint8_t   nsq_present;
     uint8_t   over_boundary_block_mode;
     uint8_t   mfmv;
+    EbBool    enable_tpl_la;
 #if TILES_PARALLEL
     //init value for child pcs
     uint8_t tile_row_count;
@@ -972,6 +1030,16 @@ extern EbErrorType picture_parent_control_set_creator(EbPtr *object_dbl_ptr,
 
 extern EbErrorType me_sb_results_ctor(MeSbResults *obj_ptr, uint32_t max_number_of_blks_per_sb,
                                       uint8_t mrp_mode, uint32_t maxNumberOfMeCandidatesPerPU);
+
+// Entries of the region of interest maps of the input pictures (64x64 blocks of the source)
+extern uint32_t roi_map_block_count(const struct SequenceControlSet *scs_ptr);
+
+// Region of interest map blocks [start_x, end_x] x [start_y, end_y] covered by a SB of the
+// (possibly scaled) picture, map_width: blocks per map row
+extern void roi_map_sb_range(const PictureParentControlSet *pcs_ptr, uint32_t sb_origin_x,
+                             uint32_t sb_origin_y, uint32_t sb_size, uint32_t *map_width,
+                             uint32_t *start_x, uint32_t *start_y, uint32_t *end_x,
+                             uint32_t *end_y);
 #ifdef __cplusplus
 }
 #endif
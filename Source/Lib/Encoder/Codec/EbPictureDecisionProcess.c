@@ -21,6 +21,8 @@
 #include "EbPictureAnalysisResults.h"
 #include "EbPictureDecisionResults.h"
 #include "EbReferenceObject.h"
+#include "EbSceneChangeDetection.h"
+#include "EbEncCdef.h"
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbTemporalFiltering.h"
 #include "EbObject.h"
@@ -59,6 +61,7 @@ typedef struct PictureDecisionContext
     uint32_t    **ahd_running_avg_cr;
     uint32_t    **ahd_running_avg;
     EbBool        is_scene_change_detected;
+    ScdContext    scd_context;
 
     // Dynamic GOP
     uint32_t      ttl_region_activity_cost[MAX_NUMBER_OF_REGIONS_IN_WIDTH][MAX_NUMBER_OF_REGIONS_IN_HEIGHT];
@@ -82,6 +85,8 @@ typedef struct PictureDecisionContext
     EbBool        mini_gop_toggle;    //mini GOP toggling since last Key Frame  K-0-1-0-1-0-K-0-1-0-1-K-0-1.....
     uint8_t       last_i_picture_sc_detection;
     uint64_t      key_poc;
+    // Fast film grain: grain of the last key frame / scene cut, reused until the next one
+    AomFilmGrain  film_grain_params;
 } PictureDecisionContext;
 
 uint64_t  get_ref_poc(PictureDecisionContext *context, uint64_t curr_picture_number, int32_t delta_poc)
@@ -96,6 +101,27 @@ uint64_t  get_ref_poc(PictureDecisionContext *context, uint64_t curr_picture_num
     return ref_poc;
 }
 
+/************************************************
+ * Fast film grain
+ ** The grain is modeled on the first picture, the key frames and the scene cuts,
+ ** in display order, and the other pictures reuse the last estimate. The source
+ ** was denoised by the picture analysis segments.
+ ************************************************/
+static void set_fast_film_grain_params(PictureDecisionContext  *context_ptr,
+                                       SequenceControlSet      *scs_ptr,
+                                       PictureParentControlSet *pcs_ptr) {
+    if (pcs_ptr->picture_number == 0 || pcs_ptr->idr_flag || pcs_ptr->cra_flag ||
+        pcs_ptr->scene_change_flag) {
+        eb_aom_denoise_and_model_estimate(pcs_ptr->denoise_and_model,
+                                          pcs_ptr->enhanced_picture_ptr,
+                                          &context_ptr->film_grain_params,
+                                          scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+        scs_ptr->seq_header.film_grain_params_present |=
+            context_ptr->film_grain_params.apply_grain;
+    }
+    pcs_ptr->frm_hdr.film_grain_params = context_ptr->film_grain_params;
+}
+
 typedef struct {
     MvReferenceFrame ref_type;
     int used;
@@ -302,6 +328,7 @@ EbErrorType picture_decision_context_ctor(
     }
 
     context_ptr->reset_running_avg = EB_TRUE;
+    scd_context_init(&context_ptr->scd_context);
 
     return EB_ErrorNone;
 }
@@ -314,7 +341,9 @@ EbBool scene_transition_detector(
 {
     PictureParentControlSet       *prev_pcs_ptr = parent_pcs_window[0];
     PictureParentControlSet       *current_pcs_ptr = parent_pcs_window[1];
-    PictureParentControlSet       *future_pcs_ptr = parent_pcs_window[2];
+    // No future picture in real time: the abrupt changes are told from the past only (no flash
+    // detection)
+    PictureParentControlSet       *future_pcs_ptr = parent_pcs_window[2] ? parent_pcs_window[2] : current_pcs_ptr;
 
     // calculating the frame threshold based on the number of 64x64 blocks in the frame
     uint32_t  region_threshhold;
@@ -522,6 +551,55 @@ EbErrorType initialize_mini_gop_activity_array(
     return return_error;
 }
 
+/***************************************************************************************************
+* Adapts mini GOP activity array
+* A complete mini GOP is kept when the mean SAD delta of its pictures to their predecessor (temporal
+* activity) times its length is within ADAPTIVE_MINI_GOP_COST_TH, and split otherwise, down to
+* 4 pictures. A mini GOP including a fade is at most 8 pictures long.
+***************************************************************************************************/
+#define ADAPTIVE_MINI_GOP_COST_TH 64.0
+EbErrorType adapt_mini_gop_activity_array(
+    PictureDecisionContext        *context_ptr,
+    EncodeContext                 *encode_context_ptr,
+    uint32_t                       max_hierarchical_levels) {
+    EbErrorType return_error = EB_ErrorNone;
+
+    uint32_t MinigopIndex;
+
+    // Loop over all mini GOPs
+    for (MinigopIndex = 0; MinigopIndex < MINI_GOP_MAX_COUNT; ++MinigopIndex) {
+        const MiniGopStats *mini_gop_stats = get_mini_gop_stats(MinigopIndex);
+        EbBool              split;
+
+        if (mini_gop_stats->hierarchical_levels > max_hierarchical_levels)
+            split = EB_TRUE;
+        // Incomplete mini GOP: the complete parts are used, the rest is handled as incomplete
+        else if (mini_gop_stats->end_index >= encode_context_ptr->pre_assignment_buffer_count)
+            split = mini_gop_stats->hierarchical_levels > MIN_HIERARCHICAL_LEVEL;
+        else if (mini_gop_stats->hierarchical_levels == MIN_HIERARCHICAL_LEVEL)
+            split = EB_FALSE;
+        else {
+            double   activity = 0;
+            uint32_t delta_count = 0;
+            EbBool   is_fade = EB_FALSE;
+            for (uint32_t pic_index = mini_gop_stats->start_index; pic_index <= mini_gop_stats->end_index; ++pic_index) {
+                PictureParentControlSet *pcs_ptr = (PictureParentControlSet*)encode_context_ptr->pre_assignment_buffer[pic_index]->object_ptr;
+                if (pcs_ptr->scd_delta_valid) {
+                    activity += pcs_ptr->scd_sad_delta;
+                    delta_count++;
+                }
+                is_fade |= pcs_ptr->scd_fade;
+            }
+            activity = delta_count ? activity / delta_count : 0;
+            split = (activity * mini_gop_stats->lenght > ADAPTIVE_MINI_GOP_COST_TH) ||
+                (is_fade && mini_gop_stats->hierarchical_levels > 3);
+        }
+        context_ptr->mini_gop_activity_array[MinigopIndex] = split;
+    }
+
+    return return_error;
+}
+
 /***************************************************************************************************
 * Generates block picture map
 *
@@ -991,6 +1069,8 @@ EbErrorType signal_derivation_multi_processes_oq(
     // 3                                            8 step refinement
     // 4                                            16 step refinement
     // 5                                            64 step refinement
+    // 6                                            fast search (subsampled blocks, strengths of
+    //                                              the reference in the same layer)
     if (scs_ptr->seq_header.enable_cdef && frm_hdr->allow_intrabc == 0) {
         if (scs_ptr->static_config.cdef_mode == DEFAULT) {
             if (sc_content_detected)
@@ -999,8 +1079,10 @@ EbErrorType signal_derivation_multi_processes_oq(
                 else
                     pcs_ptr->cdef_filter_mode = 0;
             else
-                if (pcs_ptr->enc_mode <= ENC_M7)
+                if (pcs_ptr->enc_mode <= ENC_M3)
                     pcs_ptr->cdef_filter_mode = 5;
+                else if (pcs_ptr->enc_mode <= ENC_M7)
+                    pcs_ptr->cdef_filter_mode = CDEF_FAST_SEARCH_MODE;
                 else
                     pcs_ptr->cdef_filter_mode = 2;
         } else
@@ -1015,6 +1097,7 @@ EbErrorType signal_derivation_multi_processes_oq(
     // 2                                            1 step refinement
     // 3                                            4 step refinement
     // 4                                            16 step refinement
+    // 5                                            16 step refinement, coarse to fine
 
     Av1Common* cm = pcs_ptr->av1_cm;
     if (scs_ptr->static_config.sg_filter_mode == DEFAULT) {
@@ -1023,8 +1106,10 @@ EbErrorType signal_derivation_multi_processes_oq(
                 cm->sg_filter_mode = 4;
             else
                 cm->sg_filter_mode = 0;
-        else if (pcs_ptr->enc_mode <= ENC_M2)
+        else if (pcs_ptr->enc_mode <= ENC_M1)
             cm->sg_filter_mode = 4;
+        else if (pcs_ptr->enc_mode <= ENC_M2)
+            cm->sg_filter_mode = 5;
         else if (pcs_ptr->enc_mode <= ENC_M6)
             cm->sg_filter_mode = 3;
         else
@@ -4266,6 +4351,8 @@ void* picture_decision_kernel(void *input_ptr)
             }
 
             pcs_ptr->pic_decision_reorder_queue_idx = queue_entry_index;
+            pcs_ptr->scd_delta_valid = EB_FALSE;
+            pcs_ptr->scd_flash = EB_FALSE;
         }
         // Process the head of the Picture Decision Reordering Queue (Entry N)
         // P.S. The Picture Decision Reordering Queue should be parsed in the display order to be able to construct a pred structure
@@ -4312,7 +4399,17 @@ void* picture_decision_kernel(void *input_ptr)
             if (pcs_ptr->idr_flag == EB_TRUE)
                 context_ptr->last_solid_color_frame_poc = 0xFFFFFFFF;
             if (window_avail == EB_TRUE && queue_entry_ptr->picture_number > 0) {
-                if (scs_ptr->static_config.scene_change_detection) {
+                if (scs_ptr->static_config.scene_change_detection == 2) {
+                    uint32_t future_count = 0;
+                    while (future_count < scs_ptr->scd_delay && parent_pcs_window[2 + future_count])
+                        future_count++;
+                    pcs_ptr->scene_change_flag = scd_sliding_window_detector(
+                        &context_ptr->scd_context,
+                        scs_ptr,
+                        parent_pcs_window,
+                        future_count);
+                }
+                else if (scs_ptr->static_config.scene_change_detection) {
                     pcs_ptr->scene_change_flag = scene_transition_detector(
                         context_ptr,
                         scs_ptr,
@@ -4321,12 +4418,22 @@ void* picture_decision_kernel(void *input_ptr)
                 }
                 else
                     pcs_ptr->scene_change_flag = EB_FALSE;
-                pcs_ptr->cra_flag = (pcs_ptr->scene_change_flag == EB_TRUE) ?
-                    EB_TRUE :
-                    pcs_ptr->cra_flag;
+                // A cut starts a closed GOP (key frame) when the intra refresh is IDR
+                if (pcs_ptr->scene_change_flag == EB_TRUE &&
+                    scs_ptr->static_config.scene_change_detection == 2 &&
+                    scs_ptr->intra_refresh_type == IDR_REFRESH)
+                    pcs_ptr->idr_flag = EB_TRUE;
+                else
+                    pcs_ptr->cra_flag = (pcs_ptr->scene_change_flag == EB_TRUE) ?
+                        EB_TRUE :
+                        pcs_ptr->cra_flag;
 
                 // Store scene change in context
                 context_ptr->is_scene_change_detected = pcs_ptr->scene_change_flag;
+
+                // Temporal activity of the picture, to size its mini GOP
+                if (scs_ptr->static_config.adaptive_mini_gop)
+                    scd_update_picture_delta(scs_ptr, parent_pcs_window[0], pcs_ptr);
             }
 
             if (window_avail == EB_TRUE || frame_passthrough == EB_TRUE)
@@ -4375,6 +4482,9 @@ void* picture_decision_kernel(void *input_ptr)
 
                 encode_context_ptr->pre_assignment_buffer_eos_flag = (pcs_ptr->end_of_sequence_flag) ? (uint32_t)EB_TRUE : encode_context_ptr->pre_assignment_buffer_eos_flag;
 
+                if (scs_ptr->film_grain_denoise_strength && scs_ptr->static_config.fast_film_grain)
+                    set_fast_film_grain_params(context_ptr, scs_ptr, pcs_ptr);
+
                 // Increment the Pre-Assignment Buffer Intra Count
                 encode_context_ptr->pre_assignment_buffer_intra_count += (pcs_ptr->idr_flag || pcs_ptr->cra_flag);
                 encode_context_ptr->pre_assignment_buffer_idr_count += pcs_ptr->idr_flag;
@@ -4383,6 +4493,8 @@ void* picture_decision_kernel(void *input_ptr)
                 if (scs_ptr->static_config.rate_control_mode)
                 {
                     // Increment the Intra Period Position
+                    // Rate control splits the sequence in intra periods by picture number, so the
+                    // periodic intra pictures stay on that fixed grid across the scene cuts
                     encode_context_ptr->intra_period_position = (encode_context_ptr->intra_period_position == (uint32_t)scs_ptr->intra_period_length) ? 0 : encode_context_ptr->intra_period_position + 1;
                 }
                 else
@@ -4422,16 +4534,23 @@ void* picture_decision_kernel(void *input_ptr)
                         } else {
                             //minigop 4,8,16,32
                             if (encode_context_ptr->pre_assignment_buffer_count > 1) {
-                                initialize_mini_gop_activity_array(
+                                if (scs_ptr->static_config.adaptive_mini_gop)
+                                    adapt_mini_gop_activity_array(
+                                        context_ptr,
+                                        encode_context_ptr,
+                                        scs_ptr->static_config.hierarchical_levels);
+                                else {
+                                    initialize_mini_gop_activity_array(
                                         context_ptr);
 
-                                if (encode_context_ptr->pre_assignment_buffer_count >= 32)
-                                    context_ptr->mini_gop_activity_array[L6_INDEX] = EB_FALSE;
-                                if (encode_context_ptr->pre_assignment_buffer_count >= 16)
-                                    context_ptr->mini_gop_activity_array[L5_0_INDEX] = EB_FALSE;
-                                if (encode_context_ptr->pre_assignment_buffer_count >= 8) {
-                                    context_ptr->mini_gop_activity_array[L4_0_INDEX] = EB_FALSE;
-                                    context_ptr->mini_gop_activity_array[L4_1_INDEX] = EB_FALSE;
+                                    if (encode_context_ptr->pre_assignment_buffer_count >= 32)
+                                        context_ptr->mini_gop_activity_array[L6_INDEX] = EB_FALSE;
+                                    if (encode_context_ptr->pre_assignment_buffer_count >= 16)
+                                        context_ptr->mini_gop_activity_array[L5_0_INDEX] = EB_FALSE;
+                                    if (encode_context_ptr->pre_assignment_buffer_count >= 8) {
+                                        context_ptr->mini_gop_activity_array[L4_0_INDEX] = EB_FALSE;
+                                        context_ptr->mini_gop_activity_array[L4_1_INDEX] = EB_FALSE;
+                                    }
                                 }
 
                                 generate_picture_window_split(
@@ -4904,6 +5023,9 @@ void* picture_decision_kernel(void *input_ptr)
                                     ) ) {
 #endif
                                 int altref_nframes = pcs_ptr->scs_ptr->static_config.altref_nframes;
+                                // the adaptive mode selects the frames per block in the largest window
+                                if (pcs_ptr->scs_ptr->static_config.adaptive_altref)
+                                    altref_nframes = ALTREF_MAX_NFRAMES;
                                 if (pcs_ptr->idr_flag) {
 
                                     //initilize list
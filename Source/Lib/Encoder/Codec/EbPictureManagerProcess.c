@@ -80,7 +80,8 @@ static void configure_picture_edges(SequenceControlSet *scs_ptr, PictureControlS
 
     return;
 }
-void write_stat_to_file(SequenceControlSet *scs_ptr, StatStruct stat_struct, uint64_t ref_poc);
+void write_stat_to_file(SequenceControlSet *scs_ptr, const StatStruct *stat_struct,
+                        uint64_t ref_poc);
 
 static void picture_manager_context_dctor(EbPtr p) {
     EbThreadContext *      thread_context_ptr = (EbThreadContext *)p;
@@ -1427,9 +1428,9 @@ void *picture_manager_kernel(void *input_ptr) {
                         reference_entry_ptr->reference_object_ptr->live_count == 1)
                         write_stat_to_file(
                             scs_ptr,
-                            ((EbReferenceObject *)
-                                 reference_entry_ptr->reference_object_ptr->object_ptr)
-                                ->stat_struct,
+                            &((EbReferenceObject *)
+                                  reference_entry_ptr->reference_object_ptr->object_ptr)
+                                 ->stat_struct,
                             ((EbReferenceObject *)
                                  reference_entry_ptr->reference_object_ptr->object_ptr)
                                 ->ref_poc);
@@ -1160,6 +1160,82 @@ void product_coding_loop_init_fast_loop(ModeDecisionContext *context_ptr,
     return;
 }
 
+/*******************************************
+* Candidate Cost Cache
+*   The fast loop prediction of a simple translation inter candidate only depends on the block,
+*   the reference frame(s), the MV(s), the compound weighting and the interpolation filter(s);
+*   the resulting distortion is cached so that identical predictions coming from different
+*   candidate classes or from a later PD pass of the same SB skip prediction and SAD.
+*******************************************/
+static INLINE EbBool md_cand_cost_cache_eligible(ModeDecisionContext *  context_ptr,
+                                                 ModeDecisionCandidate *candidate_ptr) {
+    return context_ptr->md_cand_cost_cache_enabled && candidate_ptr->type == INTER_MODE &&
+           !candidate_ptr->use_intrabc && candidate_ptr->motion_mode == SIMPLE_TRANSLATION &&
+           !candidate_ptr->is_interintra_used &&
+           (!candidate_ptr->is_compound ||
+            candidate_ptr->interinter_comp.type == COMPOUND_AVERAGE ||
+            candidate_ptr->interinter_comp.type == COMPOUND_DISTWTD);
+}
+
+static INLINE void md_cand_cost_cache_get_mvs(ModeDecisionCandidate *candidate_ptr,
+                                              int16_t mv[MAX_NUM_OF_REF_PIC_LIST][2]) {
+    const EbPredDirection dir = candidate_ptr->prediction_direction[0];
+    mv[REF_LIST_0][0] = (dir == UNI_PRED_LIST_1) ? 0 : candidate_ptr->motion_vector_xl0;
+    mv[REF_LIST_0][1] = (dir == UNI_PRED_LIST_1) ? 0 : candidate_ptr->motion_vector_yl0;
+    mv[REF_LIST_1][0] = (dir == UNI_PRED_LIST_0) ? 0 : candidate_ptr->motion_vector_xl1;
+    mv[REF_LIST_1][1] = (dir == UNI_PRED_LIST_0) ? 0 : candidate_ptr->motion_vector_yl1;
+}
+
+static MdCandCostCacheEntry *md_cand_cost_cache_get_entry(ModeDecisionContext *  context_ptr,
+                                                          ModeDecisionCandidate *candidate_ptr) {
+    if (!md_cand_cost_cache_eligible(context_ptr, candidate_ptr)) return NULL;
+    int16_t mv[MAX_NUM_OF_REF_PIC_LIST][2];
+    md_cand_cost_cache_get_mvs(candidate_ptr, mv);
+    uint32_t hash = context_ptr->blk_geom->blkidx_mds * 0x9E3779B1u;
+    hash ^= candidate_ptr->ref_frame_type * 0x85EBCA6Bu;
+    hash ^= ((uint32_t)(uint16_t)mv[REF_LIST_0][0] | ((uint32_t)(uint16_t)mv[REF_LIST_0][1] << 16)) *
+            0xC2B2AE35u;
+    hash ^= ((uint32_t)(uint16_t)mv[REF_LIST_1][0] | ((uint32_t)(uint16_t)mv[REF_LIST_1][1] << 16)) *
+            0x27D4EB2Fu;
+    hash ^= hash >> 15;
+    return &context_ptr->md_cand_cost_cache[hash & (MD_CAND_COST_CACHE_SIZE - 1)];
+}
+
+static INLINE EbBool md_cand_cost_cache_hit(ModeDecisionContext *  context_ptr,
+                                            MdCandCostCacheEntry * entry,
+                                            ModeDecisionCandidate *candidate_ptr,
+                                            EbBool                 chroma_dist_needed) {
+    int16_t mv[MAX_NUM_OF_REF_PIC_LIST][2];
+    if (entry->sb_tag != context_ptr->md_cand_cost_cache_sb_tag ||
+        entry->blkidx_mds != context_ptr->blk_geom->blkidx_mds ||
+        entry->ref_frame_type != candidate_ptr->ref_frame_type ||
+        entry->hbd_mode_decision != context_ptr->hbd_mode_decision ||
+        entry->compound_idx != (candidate_ptr->is_compound ? candidate_ptr->compound_idx : 1) ||
+        entry->interp_filters != candidate_ptr->interp_filters ||
+        (chroma_dist_needed && !entry->chroma_ready))
+        return EB_FALSE;
+    md_cand_cost_cache_get_mvs(candidate_ptr, mv);
+    return memcmp(entry->mv, mv, sizeof(mv)) == 0;
+}
+
+static INLINE void md_cand_cost_cache_store(ModeDecisionContext *  context_ptr,
+                                            MdCandCostCacheEntry * entry,
+                                            ModeDecisionCandidate *candidate_ptr,
+                                            uint32_t luma_fast_distortion,
+                                            uint64_t chroma_fast_distortion,
+                                            EbBool chroma_dist_needed) {
+    entry->sb_tag            = context_ptr->md_cand_cost_cache_sb_tag;
+    entry->blkidx_mds        = context_ptr->blk_geom->blkidx_mds;
+    entry->ref_frame_type    = candidate_ptr->ref_frame_type;
+    entry->hbd_mode_decision = context_ptr->hbd_mode_decision;
+    entry->compound_idx      = candidate_ptr->is_compound ? candidate_ptr->compound_idx : 1;
+    entry->interp_filters    = candidate_ptr->interp_filters;
+    md_cand_cost_cache_get_mvs(candidate_ptr, entry->mv);
+    entry->luma_fast_distortion   = luma_fast_distortion;
+    entry->chroma_fast_distortion = chroma_fast_distortion;
+    entry->chroma_ready           = (uint8_t)chroma_dist_needed;
+}
+
 void fast_loop_core(ModeDecisionCandidateBuffer *candidate_buffer, PictureControlSet *pcs_ptr,
                     ModeDecisionContext *context_ptr, EbPictureBufferDesc *input_picture_ptr,
                     uint32_t input_origin_index, uint32_t input_cb_origin_in_index,
@@ -1183,117 +1259,137 @@ void fast_loop_core(ModeDecisionCandidateBuffer *candidate_buffer, PictureContro
     // Set default interp_filters
     candidate_buffer->candidate_ptr->interp_filters =
         (context_ptr->md_staging_use_bilinear) ? av1_make_interp_filters(BILINEAR, BILINEAR) : 0;
-    product_prediction_fun_table[candidate_buffer->candidate_ptr->use_intrabc
-                                     ? INTER_MODE
-                                     : candidate_ptr->type](
-        context_ptr->hbd_mode_decision, context_ptr, pcs_ptr, candidate_buffer);
-
-    // Distortion
-    // Y
-    if (use_ssd) {
-        EbSpatialFullDistType spatial_full_dist_type_fun = context_ptr->hbd_mode_decision
-                                                               ? full_distortion_kernel16_bits
-                                                               : spatial_full_distortion_kernel;
-
-        candidate_buffer->candidate_ptr->luma_fast_distortion = (uint32_t)(
-            luma_fast_distortion = spatial_full_dist_type_fun(input_picture_ptr->buffer_y,
-                                                              input_origin_index,
-                                                              input_picture_ptr->stride_y,
-                                                              prediction_ptr->buffer_y,
-                                                              cu_origin_index,
-                                                              prediction_ptr->stride_y,
-                                                              context_ptr->blk_geom->bwidth,
-                                                              context_ptr->blk_geom->bheight));
+    const EbBool chroma_dist_needed = context_ptr->blk_geom->has_uv &&
+                                      context_ptr->chroma_level <= CHROMA_MODE_1 &&
+                                      context_ptr->md_staging_skip_inter_chroma_pred == EB_FALSE;
+    MdCandCostCacheEntry *cache_entry =
+        use_ssd ? NULL : md_cand_cost_cache_get_entry(context_ptr, candidate_ptr);
+    if (cache_entry &&
+        md_cand_cost_cache_hit(context_ptr, cache_entry, candidate_ptr, chroma_dist_needed)) {
+        // Same prediction already evaluated for this block: reuse the distortion(s)
+        candidate_ptr->luma_fast_distortion = cache_entry->luma_fast_distortion;
+        luma_fast_distortion                = cache_entry->luma_fast_distortion;
+        chroma_fast_distortion = chroma_dist_needed ? cache_entry->chroma_fast_distortion : 0;
     } else {
-        assert((context_ptr->blk_geom->bwidth >> 3) < 17);
-        if (!context_ptr->hbd_mode_decision) {
-            candidate_buffer->candidate_ptr->luma_fast_distortion =
-                (uint32_t)(luma_fast_distortion = nxm_sad_kernel_sub_sampled(
-                               input_picture_ptr->buffer_y + input_origin_index,
-                               input_picture_ptr->stride_y,
-                               prediction_ptr->buffer_y + cu_origin_index,
-                               prediction_ptr->stride_y,
-                               context_ptr->blk_geom->bheight,
-                               context_ptr->blk_geom->bwidth));
-        } else {
-            candidate_buffer->candidate_ptr->luma_fast_distortion =
-                (uint32_t)(luma_fast_distortion = sad_16b_kernel(
-                               ((uint16_t *)input_picture_ptr->buffer_y) + input_origin_index,
-                               input_picture_ptr->stride_y,
-                               ((uint16_t *)prediction_ptr->buffer_y) + cu_origin_index,
-                               prediction_ptr->stride_y,
-                               context_ptr->blk_geom->bheight,
-                               context_ptr->blk_geom->bwidth));
-        }
-    }
+        product_prediction_fun_table[candidate_buffer->candidate_ptr->use_intrabc
+                                         ? INTER_MODE
+                                         : candidate_ptr->type](
+            context_ptr->hbd_mode_decision, context_ptr, pcs_ptr, candidate_buffer);
 
-    if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level <= CHROMA_MODE_1 &&
-        context_ptr->md_staging_skip_inter_chroma_pred == EB_FALSE) {
+        // Distortion
+        // Y
         if (use_ssd) {
             EbSpatialFullDistType spatial_full_dist_type_fun = context_ptr->hbd_mode_decision
                                                                    ? full_distortion_kernel16_bits
                                                                    : spatial_full_distortion_kernel;
 
-            chroma_fast_distortion =
-                spatial_full_dist_type_fun(input_picture_ptr->buffer_cb,
-                                           input_cb_origin_in_index,
-                                           input_picture_ptr->stride_cb,
-                                           candidate_buffer->prediction_ptr->buffer_cb,
-                                           cu_chroma_origin_index,
-                                           prediction_ptr->stride_cb,
-                                           context_ptr->blk_geom->bwidth_uv,
-                                           context_ptr->blk_geom->bheight_uv);
-
-            chroma_fast_distortion +=
-                spatial_full_dist_type_fun(input_picture_ptr->buffer_cr,
-                                           input_cr_origin_in_index,
-                                           input_picture_ptr->stride_cb,
-                                           candidate_buffer->prediction_ptr->buffer_cr,
-                                           cu_chroma_origin_index,
-                                           prediction_ptr->stride_cr,
-                                           context_ptr->blk_geom->bwidth_uv,
-                                           context_ptr->blk_geom->bheight_uv);
+            candidate_buffer->candidate_ptr->luma_fast_distortion = (uint32_t)(
+                luma_fast_distortion = spatial_full_dist_type_fun(input_picture_ptr->buffer_y,
+                                                                  input_origin_index,
+                                                                  input_picture_ptr->stride_y,
+                                                                  prediction_ptr->buffer_y,
+                                                                  cu_origin_index,
+                                                                  prediction_ptr->stride_y,
+                                                                  context_ptr->blk_geom->bwidth,
+                                                                  context_ptr->blk_geom->bheight));
         } else {
-            assert((context_ptr->blk_geom->bwidth_uv >> 3) < 17);
-
+            assert((context_ptr->blk_geom->bwidth >> 3) < 17);
             if (!context_ptr->hbd_mode_decision) {
-                chroma_fast_distortion = nxm_sad_kernel_sub_sampled(
-                    input_picture_ptr->buffer_cb + input_cb_origin_in_index,
-                    input_picture_ptr->stride_cb,
-                    candidate_buffer->prediction_ptr->buffer_cb + cu_chroma_origin_index,
-                    prediction_ptr->stride_cb,
-                    context_ptr->blk_geom->bheight_uv,
-                    context_ptr->blk_geom->bwidth_uv);
-
-                chroma_fast_distortion += nxm_sad_kernel_sub_sampled(
-                    input_picture_ptr->buffer_cr + input_cr_origin_in_index,
-                    input_picture_ptr->stride_cr,
-                    candidate_buffer->prediction_ptr->buffer_cr + cu_chroma_origin_index,
-                    prediction_ptr->stride_cr,
-                    context_ptr->blk_geom->bheight_uv,
-                    context_ptr->blk_geom->bwidth_uv);
+                candidate_buffer->candidate_ptr->luma_fast_distortion =
+                    (uint32_t)(luma_fast_distortion = nxm_sad_kernel_sub_sampled(
+                                   input_picture_ptr->buffer_y + input_origin_index,
+                                   input_picture_ptr->stride_y,
+                                   prediction_ptr->buffer_y + cu_origin_index,
+                                   prediction_ptr->stride_y,
+                                   context_ptr->blk_geom->bheight,
+                                   context_ptr->blk_geom->bwidth));
             } else {
-                chroma_fast_distortion = sad_16b_kernel(
-                    ((uint16_t *)input_picture_ptr->buffer_cb) + input_cb_origin_in_index,
-                    input_picture_ptr->stride_cb,
-                    ((uint16_t *)candidate_buffer->prediction_ptr->buffer_cb) +
-                        cu_chroma_origin_index,
-                    prediction_ptr->stride_cb,
-                    context_ptr->blk_geom->bheight_uv,
-                    context_ptr->blk_geom->bwidth_uv);
-
-                chroma_fast_distortion += sad_16b_kernel(
-                    ((uint16_t *)input_picture_ptr->buffer_cr) + input_cr_origin_in_index,
-                    input_picture_ptr->stride_cr,
-                    ((uint16_t *)candidate_buffer->prediction_ptr->buffer_cr) +
-                        cu_chroma_origin_index,
-                    prediction_ptr->stride_cr,
-                    context_ptr->blk_geom->bheight_uv,
-                    context_ptr->blk_geom->bwidth_uv);
+                candidate_buffer->candidate_ptr->luma_fast_distortion =
+                    (uint32_t)(luma_fast_distortion = sad_16b_kernel(
+                                   ((uint16_t *)input_picture_ptr->buffer_y) + input_origin_index,
+                                   input_picture_ptr->stride_y,
+                                   ((uint16_t *)prediction_ptr->buffer_y) + cu_origin_index,
+                                   prediction_ptr->stride_y,
+                                   context_ptr->blk_geom->bheight,
+                                   context_ptr->blk_geom->bwidth));
             }
         }
-    } else
-        chroma_fast_distortion = 0;
+
+        if (chroma_dist_needed) {
+            if (use_ssd) {
+                EbSpatialFullDistType spatial_full_dist_type_fun = context_ptr->hbd_mode_decision
+                                                                       ? full_distortion_kernel16_bits
+                                                                       : spatial_full_distortion_kernel;
+
+                chroma_fast_distortion =
+                    spatial_full_dist_type_fun(input_picture_ptr->buffer_cb,
+                                               input_cb_origin_in_index,
+                                               input_picture_ptr->stride_cb,
+                                               candidate_buffer->prediction_ptr->buffer_cb,
+                                               cu_chroma_origin_index,
+                                               prediction_ptr->stride_cb,
+                                               context_ptr->blk_geom->bwidth_uv,
+                                               context_ptr->blk_geom->bheight_uv);
+
+                chroma_fast_distortion +=
+                    spatial_full_dist_type_fun(input_picture_ptr->buffer_cr,
+                                               input_cr_origin_in_index,
+                                               input_picture_ptr->stride_cb,
+                                               candidate_buffer->prediction_ptr->buffer_cr,
+                                               cu_chroma_origin_index,
+                                               prediction_ptr->stride_cr,
+                                               context_ptr->blk_geom->bwidth_uv,
+                                               context_ptr->blk_geom->bheight_uv);
+            } else {
+                assert((context_ptr->blk_geom->bwidth_uv >> 3) < 17);
+
+                if (!context_ptr->hbd_mode_decision) {
+                    chroma_fast_distortion = nxm_sad_kernel_sub_sampled(
+                        input_picture_ptr->buffer_cb + input_cb_origin_in_index,
+                        input_picture_ptr->stride_cb,
+                        candidate_buffer->prediction_ptr->buffer_cb + cu_chroma_origin_index,
+                        prediction_ptr->stride_cb,
+                        context_ptr->blk_geom->bheight_uv,
+                        context_ptr->blk_geom->bwidth_uv);
+
+                    chroma_fast_distortion += nxm_sad_kernel_sub_sampled(
+                        input_picture_ptr->buffer_cr + input_cr_origin_in_index,
+                        input_picture_ptr->stride_cr,
+                        candidate_buffer->prediction_ptr->buffer_cr + cu_chroma_origin_index,
+                        prediction_ptr->stride_cr,
+                        context_ptr->blk_geom->bheight_uv,
+                        context_ptr->blk_geom->bwidth_uv);
+                } else {
+                    chroma_fast_distortion = sad_16b_kernel(
+                        ((uint16_t *)input_picture_ptr->buffer_cb) + input_cb_origin_in_index,
+                        input_picture_ptr->stride_cb,
+                        ((uint16_t *)candidate_buffer->prediction_ptr->buffer_cb) +
+                            cu_chroma_origin_index,
+                        prediction_ptr->stride_cb,
+                        context_ptr->blk_geom->bheight_uv,
+                        context_ptr->blk_geom->bwidth_uv);
+
+                    chroma_fast_distortion += sad_16b_kernel(
+                        ((uint16_t *)input_picture_ptr->buffer_cr) + input_cr_origin_in_index,
+                        input_picture_ptr->stride_cr,
+                        ((uint16_t *)candidate_buffer->prediction_ptr->buffer_cr) +
+                            cu_chroma_origin_index,
+                        prediction_ptr->stride_cr,
+                        context_ptr->blk_geom->bheight_uv,
+                        context_ptr->blk_geom->bwidth_uv);
+                }
+            }
+        } else
+            chroma_fast_distortion = 0;
+
+        if (cache_entry)
+            md_cand_cost_cache_store(context_ptr,
+                                     cache_entry,
+                                     candidate_ptr,
+                                     (uint32_t)luma_fast_distortion,
+                                     chroma_fast_distortion,
+                                     chroma_dist_needed);
+    }
     // Fast Cost
     *(candidate_buffer->fast_cost_ptr) = av1_product_fast_cost_func_table[candidate_ptr->type](
         blk_ptr,
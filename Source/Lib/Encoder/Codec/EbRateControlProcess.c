@@ -14,6 +14,7 @@
 * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
 */
 #include <stdlib.h>
+#include <math.h>
 
 #include "EbDefinitions.h"
 #include "EbEncHandle.h"
@@ -26,8 +27,10 @@
 
 #include "EbRateControlResults.h"
 #include "EbRateControlTasks.h"
+#include "EbRateControlVbv.h"
 
 #include "EbSegmentation.h"
+#include "EbTemporalDependencyModel.h"
 #include "EbLog.h"
 
 static const uint32_t rate_percentage_layer_array[EB_MAX_TEMPORAL_LAYERS][EB_MAX_TEMPORAL_LAYERS] =
@@ -150,6 +153,13 @@ typedef struct RateControlContext {
 
     uint32_t qp_scaling_map[EB_MAX_TEMPORAL_LAYERS][MAX_REF_QP_NUM];
     uint32_t qp_scaling_map_i_slice[MAX_REF_QP_NUM];
+
+    // VBV: decoder buffer predicted from the coded pictures fed back and the
+    // predicted size of the pictures with a QP but not coded yet (pending)
+    VbvModel vbv;
+    uint64_t vbv_pending_bits;
+    uint32_t vbv_pending_tus;
+    double   vbv_rq_coeff[EB_MAX_TEMPORAL_LAYERS + 1]; // bits * q, per layer then I slices
 } RateControlContext;
 
 // calculate the QP based on the QP scaling
@@ -481,6 +491,48 @@ uint64_t predict_bits(EncodeContext *              encode_context_ptr,
     return total_bits;
 }
 
+/******************************************************
+ * Shared Rate Control
+ *   The attached encoders add the extra bits they generate to the shared
+ *   budget, and steer their sliding window rate towards the average deviation
+ *   of all the chunks.
+ ******************************************************/
+void shared_rc_attach(EbSharedRateControl *shared_rc) {
+    eb_block_on_mutex(shared_rc->mutex);
+    shared_rc->encoder_count++;
+    shared_rc->total_encoder_count++;
+    eb_release_mutex(shared_rc->mutex);
+}
+
+void shared_rc_detach(EbSharedRateControl *shared_rc) {
+    eb_block_on_mutex(shared_rc->mutex);
+    shared_rc->encoder_count--;
+    eb_release_mutex(shared_rc->mutex);
+}
+
+static void add_extra_bits_gen(RateControlContext *context_ptr, SequenceControlSet *scs_ptr,
+                               int64_t extra_bits) {
+    EbSharedRateControl *shared_rc = scs_ptr->static_config.shared_rc;
+    context_ptr->extra_bits_gen += extra_bits;
+    if (shared_rc) {
+        eb_block_on_mutex(shared_rc->mutex);
+        shared_rc->extra_bits_gen += extra_bits;
+        eb_release_mutex(shared_rc->mutex);
+    }
+}
+
+static int64_t get_extra_bits_gen(RateControlContext *context_ptr, SequenceControlSet *scs_ptr) {
+    EbSharedRateControl *shared_rc = scs_ptr->static_config.shared_rc;
+    int64_t              extra_bits_gen;
+    if (!shared_rc) return context_ptr->extra_bits_gen;
+    eb_block_on_mutex(shared_rc->mutex);
+    // The bits of the detached encoders stay in the sum, so share it among all the encoders
+    // attached so far
+    extra_bits_gen = shared_rc->extra_bits_gen / (int64_t)MAX(shared_rc->total_encoder_count, 1);
+    eb_release_mutex(shared_rc->mutex);
+    return extra_bits_gen;
+}
+
 void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                                      EncodeContext *              encode_context_ptr,
                                      RateControlContext *         context_ptr,
@@ -515,6 +567,7 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
     EbBool   tables_updated;
 
     uint64_t bit_constraint_per_sw = 0;
+    int64_t  extra_bits_gen        = get_extra_bits_gen(context_ptr, scs_ptr);
 
     RateControlTables *rate_control_tables_ptr;
     EbBitNumber *      sad_bits_array_ptr;
@@ -566,15 +619,13 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
             selected_ref_qp = max_coded_poc_selected_ref_qp;
 
             // Update the QP for the sliding window based on the status of RC
-            if ((context_ptr->extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size << 3)))
+            if ((extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size << 3)))
                 selected_ref_qp = (uint32_t)MAX((int32_t)selected_ref_qp - 2, 0);
-            else if ((context_ptr->extra_bits_gen >
-                      (int64_t)(context_ptr->virtual_buffer_size << 2)))
+            else if ((extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size << 2)))
                 selected_ref_qp = (uint32_t)MAX((int32_t)selected_ref_qp - 1, 0);
-            if ((context_ptr->extra_bits_gen < -(int64_t)(context_ptr->virtual_buffer_size << 2)))
+            if ((extra_bits_gen < -(int64_t)(context_ptr->virtual_buffer_size << 2)))
                 selected_ref_qp += 2;
-            else if ((context_ptr->extra_bits_gen <
-                      -(int64_t)(context_ptr->virtual_buffer_size << 1)))
+            else if ((extra_bits_gen < -(int64_t)(context_ptr->virtual_buffer_size << 1)))
                 selected_ref_qp += 1;
             if ((pcs_ptr->frames_in_sw < (uint32_t)(scs_ptr->intra_period_length + 1)) &&
                 (pcs_ptr->picture_number % ((scs_ptr->intra_period_length + 1)) == 0)) {
@@ -692,18 +743,15 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                                     (scs_ptr->static_config.look_ahead_distance + 1);
 
             // Update the target rate for the sliding window based on the status of RC
-            if ((context_ptr->extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size * 10)))
+            if ((extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size * 10)))
                 bit_constraint_per_sw = bit_constraint_per_sw * 130 / 100;
-            else if ((context_ptr->extra_bits_gen >
-                      (int64_t)(context_ptr->virtual_buffer_size << 3)))
+            else if ((extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size << 3)))
                 bit_constraint_per_sw = bit_constraint_per_sw * 120 / 100;
-            else if ((context_ptr->extra_bits_gen >
-                      (int64_t)(context_ptr->virtual_buffer_size << 2)))
+            else if ((extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size << 2)))
                 bit_constraint_per_sw = bit_constraint_per_sw * 110 / 100;
-            if ((context_ptr->extra_bits_gen < -(int64_t)(context_ptr->virtual_buffer_size << 3)))
+            if ((extra_bits_gen < -(int64_t)(context_ptr->virtual_buffer_size << 3)))
                 bit_constraint_per_sw = bit_constraint_per_sw * 80 / 100;
-            else if ((context_ptr->extra_bits_gen <
-                      -(int64_t)(context_ptr->virtual_buffer_size << 2)))
+            else if ((extra_bits_gen < -(int64_t)(context_ptr->virtual_buffer_size << 2)))
                 bit_constraint_per_sw = bit_constraint_per_sw * 90 / 100;
             // Loop over proper QPs and find the Predicted bits for that QP. Find the QP with the closest total predicted rate to target bits for the sliding window.
             previous_selected_ref_qp =
@@ -1044,6 +1092,18 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
     }
     eb_release_mutex(scs_ptr->encode_context_ptr->rate_table_update_mutex);
 }
+/******************************************************
+ * lookahead_qp_offset
+ * QP offset of a base layer picture from its referenced area average
+ * (referenced area per pixel, 64: fully referenced by the lookahead window)
+ ******************************************************/
+static int32_t lookahead_qp_offset(uint64_t referenced_area_avg) {
+    if (referenced_area_avg >= 48) return -2;
+    if (referenced_area_avg >= 32) return -1;
+    if (referenced_area_avg < 8) return 1;
+    return 0;
+}
+
 void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                                       RateControlContext *             context_ptr,
                                       RateControlLayerContext *        rate_control_layer_ptr,
@@ -1517,6 +1577,14 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
                     (uint8_t)CLIP3((uint32_t)ref_qp - 1, pcs_ptr->picture_qp, pcs_ptr->picture_qp);
             }
         }
+        // lower / raise the QP of the base layer pictures the most / least referenced in the
+        // lookahead window
+        if (scs_ptr->use_lookahead_stats && pcs_ptr->temporal_layer_index == 0 &&
+            pcs_ptr->parent_pcs_ptr->referenced_area_has_non_zero)
+            pcs_ptr->picture_qp = (uint8_t)MAX(
+                (int32_t)pcs_ptr->picture_qp +
+                    lookahead_qp_offset(pcs_ptr->parent_pcs_ptr->referenced_area_avg),
+                0);
         // limiting the QP between min Qp allowed and max Qp allowed
         pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
                                              scs_ptr->static_config.max_qp_allowed,
@@ -1795,12 +1863,14 @@ void frame_level_rc_feedback_picture_vbr(PictureParentControlSet *parentpicture_
                          (scs_ptr->static_config.intra_period_length + 1)) >>
                         RC_PRECISION) -
                     (int64_t)parentpicture_control_set_ptr->target_bit_rate * 3 / 4;
-                context_ptr->extra_bits_gen -=
-                    (int64_t)(
-                        (parentpicture_control_set_ptr->total_num_bits * context_ptr->frame_rate /
-                         (scs_ptr->static_config.intra_period_length + 1)) >>
-                        RC_PRECISION) -
-                    (int64_t)parentpicture_control_set_ptr->target_bit_rate * 3 / 4;
+                add_extra_bits_gen(
+                    context_ptr,
+                    scs_ptr,
+                    (int64_t)parentpicture_control_set_ptr->target_bit_rate * 3 / 4 -
+                        (int64_t)((parentpicture_control_set_ptr->total_num_bits *
+                                   context_ptr->frame_rate /
+                                   (scs_ptr->static_config.intra_period_length + 1)) >>
+                                  RC_PRECISION));
             }
         }
 
@@ -1819,8 +1889,10 @@ void frame_level_rc_feedback_picture_vbr(PictureParentControlSet *parentpicture_
                     (int64_t)rate_control_param_ptr->previous_virtual_buffer_level +
                     (int64_t)previous_frame_bit_actual -
                     (int64_t)rate_control_layer_ptr->channel_bit_rate;
-                context_ptr->extra_bits_gen -= (int64_t)previous_frame_bit_actual -
-                                               (int64_t)rate_control_layer_ptr->channel_bit_rate;
+                add_extra_bits_gen(context_ptr,
+                                   scs_ptr,
+                                   (int64_t)rate_control_layer_ptr->channel_bit_rate -
+                                       (int64_t)previous_frame_bit_actual);
             }
             if (parentpicture_control_set_ptr->hierarchical_levels > 1 &&
                 rate_control_layer_ptr->frame_same_distortion_min_qp_count > 10) {
@@ -3837,6 +3909,14 @@ void init_rc(RateControlContext *context_ptr, PictureControlSet *pcs_ptr,
         context_ptr->base_layer_frames_avg_qp       = scs_ptr->static_config.qp;
         context_ptr->base_layer_intra_frames_avg_qp = scs_ptr->static_config.qp;
     }
+    if (scs_ptr->static_config.vbv_mode != VBV_MODE_OFF)
+        vbv_model_init(&context_ptr->vbv,
+                       scs_ptr->static_config.vbv_bufsize,
+                       scs_ptr->static_config.vbv_maxrate,
+                       scs_ptr->frame_rate,
+                       scs_ptr->static_config.vbv_init,
+                       scs_ptr->static_config.max_frame_size,
+                       scs_ptr->static_config.vbv_mode == VBV_MODE_CBR);
 
     for (uint32_t base_qp = 0; base_qp < MAX_REF_QP_NUM; base_qp++) {
         if (base_qp < 64) {
@@ -5053,6 +5133,9 @@ static int adaptive_qindex_calc(PictureControlSet *pcs_ptr, RATE_CONTROL *rc, in
                          (kf_high - kf_low)) /
                         max_qp_scaling_avg_comp_i) +
                        kf_low;
+        // The propagated cost of the picture replaces the complexity when available
+        if (pcs_ptr->parent_pcs_ptr->tpl_valid)
+            rc->kf_boost = tpl_get_kf_boost(pcs_ptr->parent_pcs_ptr);
         // Baseline value derived from cpi->active_worst_quality and kf boost.
         active_best_quality = get_kf_active_quality(rc, active_worst_quality, bit_depth);
         // Allow somewhat lower kf minq with small image formats.
@@ -5085,6 +5168,10 @@ static int adaptive_qindex_calc(PictureControlSet *pcs_ptr, RATE_CONTROL *rc, in
              pcs_ptr->parent_pcs_ptr->filtered_sse >= HIGH_FILTERED_THRESHOLD)
                 ? (float_t)1.3
                 : 1;
+        if (pcs_ptr->parent_pcs_ptr->tpl_valid) {
+            rc->gfu_boost        = tpl_get_gfu_boost(pcs_ptr->parent_pcs_ptr);
+            rc->arf_boost_factor = 1;
+        }
         q = active_worst_quality;
 
         // non ref frame or repeated frames with re-encode
@@ -5189,6 +5276,29 @@ static int cqp_qindex_calc(
     return q;
 }
 #endif
+// CRF: share of the complexity changes not compensated by the qindex (x264 qcomp)
+#define CRF_QCOMP 0.6
+// Lookahead complexity (ME SAD per pixel) coded @ the CRF qindex
+#define CRF_REF_COMPLEXITY 3.0
+#define CRF_MAX_Q_RATIO 2.0
+/******************************************************
+ * crf_qindex_calc
+ * Modulates the CRF qindex by the lookahead complexity:
+ * q scales with complexity^(1 - qcomp), so the complex
+ * (masking) content gets a higher q, the static content
+ * a lower one
+ ******************************************************/
+static int32_t crf_qindex_calc(PictureControlSet *pcs_ptr, int32_t qindex) {
+    SequenceControlSet *scs_ptr   = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const AomBitDepth   bit_depth = (AomBitDepth)scs_ptr->static_config.encoder_bit_depth;
+    const double        complexity = pcs_ptr->parent_pcs_ptr->crf_complexity;
+
+    if (complexity <= 0) return qindex;
+    double q_ratio = pow(complexity / CRF_REF_COMPLEXITY, 1.0 - CRF_QCOMP);
+    q_ratio        = CLIP3(1.0 / CRF_MAX_Q_RATIO, CRF_MAX_Q_RATIO, q_ratio);
+    const double q_val = eb_av1_convert_qindex_to_q(qindex, bit_depth);
+    return CLIP3(MINQ, MAXQ, qindex + eb_av1_compute_qdelta(q_val, q_val * q_ratio, bit_depth));
+}
 /******************************************************
  * sb_qp_derivation_two_pass
  * Calculates the QP per SB based on the referenced area
@@ -5200,7 +5310,8 @@ static void sb_qp_derivation_two_pass(PictureControlSet *pcs_ptr) {
     uint32_t            sb_addr;
 
     pcs_ptr->parent_pcs_ptr->average_qp = 0;
-    if (scs_ptr->use_input_stat_file && pcs_ptr->temporal_layer_index <= 0)
+    if ((scs_ptr->use_input_stat_file || scs_ptr->use_lookahead_stats) &&
+        pcs_ptr->temporal_layer_index <= 0)
         pcs_ptr->parent_pcs_ptr->frm_hdr.delta_q_params.delta_q_present = 1;
     else
         pcs_ptr->parent_pcs_ptr->frm_hdr.delta_q_params.delta_q_present = 0;
@@ -5457,6 +5568,166 @@ static void sb_qp_derivation(PictureControlSet *pcs_ptr) {
         }
     }
 }
+/******************************************************
+ * sb_qp_apply_roi_map
+ * Adds the delta qp of the region of interest map of the
+ * input picture to the SB qp (average delta of the map
+ * blocks covered by the SB)
+ ******************************************************/
+static void sb_qp_apply_roi_map(PictureControlSet *pcs_ptr) {
+    PictureParentControlSet *ppcs_ptr     = pcs_ptr->parent_pcs_ptr;
+    SequenceControlSet *     scs_ptr      = ppcs_ptr->scs_ptr;
+    const int8_t *           roi_delta_qp = ppcs_ptr->input_ptr->roi_delta_qp;
+    EbBool                   has_delta_qp = EB_FALSE;
+
+    if (roi_delta_qp == NULL) return;
+    ppcs_ptr->average_qp = 0;
+    for (uint32_t sb_addr = 0; sb_addr < pcs_ptr->sb_total_count_pix; ++sb_addr) {
+        SuperBlock *sb_ptr = pcs_ptr->sb_ptr_array[sb_addr];
+        uint32_t    map_width, start_x, start_y, end_x, end_y;
+        int32_t     delta_qp = 0;
+
+        roi_map_sb_range(ppcs_ptr,
+                         sb_ptr->origin_x,
+                         sb_ptr->origin_y,
+                         scs_ptr->sb_size_pix,
+                         &map_width,
+                         &start_x,
+                         &start_y,
+                         &end_x,
+                         &end_y);
+        for (uint32_t y = start_y; y <= end_y; y++)
+            for (uint32_t x = start_x; x <= end_x; x++) delta_qp += roi_delta_qp[y * map_width + x];
+        delta_qp /= (int32_t)((end_x - start_x + 1) * (end_y - start_y + 1));
+        sb_ptr->qp       = (uint8_t)CLIP3((int32_t)scs_ptr->static_config.min_qp_allowed,
+                                    (int32_t)scs_ptr->static_config.max_qp_allowed,
+                                    (int32_t)sb_ptr->qp + delta_qp);
+        sb_ptr->delta_qp = (int)ppcs_ptr->picture_qp - (int)sb_ptr->qp;
+        if (sb_ptr->delta_qp) has_delta_qp = EB_TRUE;
+        ppcs_ptr->average_qp += sb_ptr->qp;
+    }
+    if (has_delta_qp) ppcs_ptr->frm_hdr.delta_q_params.delta_q_present = 1;
+}
+/******************************************************
+ * sb_qp_derivation_tpl
+ * Calculates the QP per SB of the base layer pictures from
+ * the temporal dependency model: q / sqrt(beta) per SB
+ ******************************************************/
+static void sb_qp_derivation_tpl(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *scs_ptr = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    SuperBlock *        sb_ptr;
+    uint32_t            sb_addr;
+
+    pcs_ptr->parent_pcs_ptr->average_qp = 0;
+    if (pcs_ptr->temporal_layer_index == 0)
+        pcs_ptr->parent_pcs_ptr->frm_hdr.delta_q_params.delta_q_present = 1;
+    else
+        pcs_ptr->parent_pcs_ptr->frm_hdr.delta_q_params.delta_q_present = 0;
+
+    if (pcs_ptr->parent_pcs_ptr->frm_hdr.delta_q_params.delta_q_present) {
+        const AomBitDepth bit_depth = (AomBitDepth)scs_ptr->static_config.encoder_bit_depth;
+        const uint32_t    sb_size   = scs_ptr->seq_header.sb_size == BLOCK_128X128 ? 128 : 64;
+        const double      q_val     = eb_av1_convert_qindex_to_q(
+            quantizer_to_qindex[(uint8_t)pcs_ptr->parent_pcs_ptr->picture_qp], bit_depth);
+
+        for (sb_addr = 0; sb_addr < pcs_ptr->sb_total_count_pix; ++sb_addr) {
+            sb_ptr            = pcs_ptr->sb_ptr_array[sb_addr];
+            const double beta = tpl_get_sb_beta(
+                pcs_ptr->parent_pcs_ptr, sb_ptr->origin_x, sb_ptr->origin_y, sb_size);
+            // qindex delta to QP delta, rounded to the nearest
+            int delta_qindex = eb_av1_compute_qdelta(q_val, q_val / sqrt(beta), bit_depth);
+            int delta_qp     = (delta_qindex + (delta_qindex < 0 ? -2 : 2)) / 4;
+            delta_qp         = CLIP3(-TPL_MAX_SB_DELTA_QP, TPL_MAX_SB_DELTA_QP, delta_qp);
+
+            sb_ptr->qp       = CLIP3(scs_ptr->static_config.min_qp_allowed,
+                               scs_ptr->static_config.max_qp_allowed,
+                               ((int16_t)pcs_ptr->parent_pcs_ptr->picture_qp + (int16_t)delta_qp));
+            sb_ptr->delta_qp = (int)pcs_ptr->parent_pcs_ptr->picture_qp - (int)sb_ptr->qp;
+            pcs_ptr->parent_pcs_ptr->average_qp += sb_ptr->qp;
+        }
+    } else {
+        for (sb_addr = 0; sb_addr < pcs_ptr->sb_total_count_pix; ++sb_addr) {
+            sb_ptr           = pcs_ptr->sb_ptr_array[sb_addr];
+            sb_ptr->qp       = (uint8_t)pcs_ptr->picture_qp;
+            sb_ptr->delta_qp = 0;
+            pcs_ptr->parent_pcs_ptr->average_qp += sb_ptr->qp;
+        }
+    }
+}
+
+// Number of TUs (displayed frames) the coded picture adds to the output
+static uint32_t vbv_tu_count(const PictureParentControlSet *ppcs_ptr) {
+    return (ppcs_ptr->frm_hdr.show_frame ? 1 : 0) + (ppcs_ptr->has_show_existing ? 1 : 0);
+}
+
+static uint32_t vbv_rq_slot(const PictureParentControlSet *ppcs_ptr) {
+    return ppcs_ptr->slice_type == I_SLICE ? EB_MAX_TEMPORAL_LAYERS
+                                           : ppcs_ptr->temporal_layer_index;
+}
+
+static double vbv_qp_to_q(const SequenceControlSet *scs_ptr, uint8_t qp) {
+    return eb_av1_convert_qindex_to_q(quantizer_to_qindex[qp],
+                                      (AomBitDepth)scs_ptr->static_config.encoder_bit_depth);
+}
+
+/******************************************************
+ * vbv_constrain_qp
+ * Raises the picture QP until its predicted size (R-Q model: bits * q is
+ * constant per layer) keeps the predicted VBV buffer above its low mark and
+ * within the max frame size; in CBR, lowers it while the picture would
+ * overflow the buffer (rather than padding it)
+ ******************************************************/
+static void vbv_constrain_qp(RateControlContext *context_ptr, SequenceControlSet *scs_ptr,
+                             PictureControlSet *pcs_ptr) {
+    PictureParentControlSet *ppcs_ptr = pcs_ptr->parent_pcs_ptr;
+    const double             rc_q     = vbv_qp_to_q(scs_ptr, (uint8_t)pcs_ptr->picture_qp);
+    double                   rq_coeff = context_ptr->vbv_rq_coeff[vbv_rq_slot(ppcs_ptr)];
+    // no picture of the kind coded yet: assume the RC QP hits the rate
+    if (rq_coeff <= 0)
+        rq_coeff = context_ptr->vbv.fill_per_tu * (pcs_ptr->slice_type == I_SLICE ? 4 : 1) * rc_q;
+
+    const double fullness = MAX(vbv_model_pending_fullness(&context_ptr->vbv,
+                                                           context_ptr->vbv_pending_bits,
+                                                           context_ptr->vbv_pending_tus),
+                                0);
+    const double max_bits = vbv_model_max_tu_bits(&context_ptr->vbv, fullness);
+    const double min_bits =
+        vbv_tu_count(ppcs_ptr) ? vbv_model_min_tu_bits(&context_ptr->vbv, fullness) : 0;
+    uint8_t qp = (uint8_t)pcs_ptr->picture_qp;
+
+    while (qp < scs_ptr->static_config.max_qp_allowed &&
+           rq_coeff / vbv_qp_to_q(scs_ptr, qp) > max_bits)
+        qp++;
+    if (qp == pcs_ptr->picture_qp) {
+        while (qp > scs_ptr->static_config.min_qp_allowed &&
+               rq_coeff / vbv_qp_to_q(scs_ptr, qp) < min_bits &&
+               rq_coeff / vbv_qp_to_q(scs_ptr, qp - 1) <= max_bits)
+            qp--;
+    }
+    pcs_ptr->picture_qp          = qp;
+    ppcs_ptr->vbv_predicted_bits = (uint64_t)(rq_coeff / vbv_qp_to_q(scs_ptr, qp));
+    context_ptr->vbv_pending_bits += ppcs_ptr->vbv_predicted_bits;
+    context_ptr->vbv_pending_tus += vbv_tu_count(ppcs_ptr);
+}
+
+// Replaces the predicted size of a coded picture by its actual size
+static void vbv_feedback_picture(RateControlContext *context_ptr, SequenceControlSet *scs_ptr,
+                                 PictureParentControlSet *ppcs_ptr) {
+    const uint32_t tus  = vbv_tu_count(ppcs_ptr);
+    const uint32_t slot = vbv_rq_slot(ppcs_ptr);
+    const double   rq_coeff =
+        (double)ppcs_ptr->total_num_bits * vbv_qp_to_q(scs_ptr, (uint8_t)ppcs_ptr->picture_qp);
+
+    context_ptr->vbv_pending_bits -=
+        MIN(context_ptr->vbv_pending_bits, ppcs_ptr->vbv_predicted_bits);
+    context_ptr->vbv_pending_tus -= MIN(context_ptr->vbv_pending_tus, tus);
+    context_ptr->vbv.fullness = MAX(
+        vbv_model_pending_fullness(&context_ptr->vbv, ppcs_ptr->total_num_bits, tus), 0);
+    context_ptr->vbv_rq_coeff[slot] = context_ptr->vbv_rq_coeff[slot] > 0
+                                          ? (context_ptr->vbv_rq_coeff[slot] + rq_coeff) / 2
+                                          : rq_coeff;
+}
+
 void *rate_control_kernel(void *input_ptr) {
     // Context
     EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
@@ -5577,7 +5848,11 @@ void *rate_control_kernel(void *input_ptr) {
 
                 if (scs_ptr->static_config.enable_qp_scaling_flag &&
                     pcs_ptr->parent_pcs_ptr->qp_on_the_fly == EB_FALSE) {
-                    const int32_t qindex = quantizer_to_qindex[(uint8_t)scs_ptr->static_config.qp];
+                    const int32_t qindex =
+                        scs_ptr->static_config.crf >= 0
+                            ? crf_qindex_calc(
+                                  pcs_ptr, quantizer_to_qindex[(uint8_t)scs_ptr->static_config.qp])
+                            : quantizer_to_qindex[(uint8_t)scs_ptr->static_config.qp];
 #if !QPS_CHANGE
                     const double  q_val  = eb_av1_convert_qindex_to_q(
                         qindex, (AomBitDepth)scs_ptr->static_config.encoder_bit_depth);
@@ -5587,7 +5862,7 @@ void *rate_control_kernel(void *input_ptr) {
                     if (!scs_ptr->use_output_stat_file &&
                         pcs_ptr->parent_pcs_ptr->frames_in_sw >= QPS_SW_THRESH) {
                         // Content adaptive qp assignment
-                        if (scs_ptr->use_input_stat_file &&
+                        if ((scs_ptr->use_input_stat_file || scs_ptr->use_lookahead_stats) &&
                             !pcs_ptr->parent_pcs_ptr->sc_content_detected &&
                             pcs_ptr->parent_pcs_ptr->referenced_area_has_non_zero)
                             new_qindex = adaptive_qindex_calc_two_pass(pcs_ptr, &rc, qindex);
@@ -5634,6 +5909,21 @@ void *rate_control_kernel(void *input_ptr) {
                                        (frm_hdr->quantization_params.base_q_idx + 2) >> 2);
                 }
 
+                else if (scs_ptr->static_config.crf >= 0 &&
+                         pcs_ptr->parent_pcs_ptr->qp_on_the_fly == EB_FALSE) {
+                    // CRF without QP scaling: only the lookahead complexity modulation
+                    frm_hdr->quantization_params.base_q_idx = (uint8_t)CLIP3(
+                        (int32_t)quantizer_to_qindex[scs_ptr->static_config.min_qp_allowed],
+                        (int32_t)quantizer_to_qindex[scs_ptr->static_config.max_qp_allowed],
+                        crf_qindex_calc(pcs_ptr,
+                                        quantizer_to_qindex[(uint8_t)scs_ptr->static_config.qp]));
+
+                    pcs_ptr->picture_qp =
+                        (uint8_t)CLIP3((int32_t)scs_ptr->static_config.min_qp_allowed,
+                                       (int32_t)scs_ptr->static_config.max_qp_allowed,
+                                       (frm_hdr->quantization_params.base_q_idx + 2) >> 2);
+                }
+
                 else if (pcs_ptr->parent_pcs_ptr->qp_on_the_fly == EB_TRUE) {
                     pcs_ptr->picture_qp =
                         (uint8_t)CLIP3((int32_t)scs_ptr->static_config.min_qp_allowed,
@@ -5670,6 +5960,8 @@ void *rate_control_kernel(void *input_ptr) {
                 pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
                                                      scs_ptr->static_config.max_qp_allowed,
                                                      pcs_ptr->picture_qp);
+                if (scs_ptr->static_config.vbv_mode != VBV_MODE_OFF)
+                    vbv_constrain_qp(context_ptr, scs_ptr, pcs_ptr);
                 frm_hdr->quantization_params.base_q_idx = quantizer_to_qindex[pcs_ptr->picture_qp];
             }
 
@@ -5717,9 +6009,11 @@ void *rate_control_kernel(void *input_ptr) {
             if (scs_ptr->static_config.enable_adaptive_quantization == 2 &&
                 pcs_ptr->parent_pcs_ptr->frames_in_sw >= QPS_SW_THRESH &&
                 !pcs_ptr->parent_pcs_ptr->sc_content_detected && !scs_ptr->use_output_stat_file)
-                if (scs_ptr->use_input_stat_file &&
+                if ((scs_ptr->use_input_stat_file || scs_ptr->use_lookahead_stats) &&
                     pcs_ptr->parent_pcs_ptr->referenced_area_has_non_zero)
                     sb_qp_derivation_two_pass(pcs_ptr);
+                else if (pcs_ptr->parent_pcs_ptr->tpl_valid)
+                    sb_qp_derivation_tpl(pcs_ptr);
                 else
                     sb_qp_derivation(pcs_ptr);
             else {
@@ -5733,6 +6027,7 @@ void *rate_control_kernel(void *input_ptr) {
                     pcs_ptr->parent_pcs_ptr->average_qp += sb_ptr->qp;
                 }
             }
+            if (scs_ptr->static_config.enable_roi_map) sb_qp_apply_roi_map(pcs_ptr);
             // Get Empty Rate Control Results Buffer
             eb_get_empty_object(context_ptr->rate_control_output_results_fifo_ptr,
                                 &rate_control_results_wrapper_ptr);
@@ -5803,6 +6098,8 @@ void *rate_control_kernel(void *input_ptr) {
                     (int64_t)context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_frame;
 
                 high_level_rc_feed_back_picture(parentpicture_control_set_ptr, scs_ptr);
+                if (scs_ptr->static_config.vbv_mode != VBV_MODE_OFF)
+                    vbv_feedback_picture(context_ptr, scs_ptr, parentpicture_control_set_ptr);
                 if (scs_ptr->static_config.rate_control_mode == 1)
                     frame_level_rc_feedback_picture_vbr(
                         parentpicture_control_set_ptr, scs_ptr, context_ptr);
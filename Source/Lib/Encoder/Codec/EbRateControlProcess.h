@@ -109,12 +109,27 @@ typedef struct RateControlLayerContext {
 
 } RateControlLayerContext;
 
+/**************************************
+ * Shared Rate Control
+ *   Rate budget shared by the encoders of the
+ *   chunks of a sequence
+ **************************************/
+struct EbSharedRateControl {
+    EbHandle mutex;
+    int64_t  extra_bits_gen; // extra bits generated by all the attached encoders
+    uint32_t encoder_count; // number of attached encoders
+    uint32_t total_encoder_count; // number of encoders attached so far, detached ones included
+};
+
 /**************************************
  * Extern Function Declarations
  **************************************/
 EbErrorType rate_control_context_ctor(EbThreadContext *  thread_context_ptr,
                                       const EbEncHandle *enc_handle_ptr);
 
+void shared_rc_attach(EbSharedRateControl *shared_rc);
+void shared_rc_detach(EbSharedRateControl *shared_rc);
+
 extern void *rate_control_kernel(void *input_ptr);
 
 #endif // EbRateControl_h
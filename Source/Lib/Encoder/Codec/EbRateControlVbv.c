@@ -0,0 +1,67 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <string.h>
+
+#include "EbRateControlVbv.h"
+#include "EbUtility.h"
+
+void vbv_model_init(VbvModel *vbv, uint32_t buffer_size, uint32_t max_rate, uint32_t frame_rate,
+                    uint32_t initial_fullness, uint32_t max_tu_size, EbBool cbr) {
+    memset(vbv, 0, sizeof(*vbv));
+    vbv->buffer_size = (double)buffer_size;
+    vbv->fill_per_tu = frame_rate ? (double)max_rate * (1 << 16) / frame_rate : 0;
+    vbv->fullness    = vbv->buffer_size * MIN(initial_fullness, 100) / 100;
+    vbv->max_tu_bits = (double)max_tu_size;
+    vbv->cbr         = cbr;
+}
+
+double vbv_model_pending_fullness(const VbvModel *vbv, uint64_t pending_bits,
+                                  uint32_t pending_tus) {
+    const double fullness = vbv->fullness - (double)pending_bits + pending_tus * vbv->fill_per_tu;
+    return MIN(fullness, vbv->buffer_size);
+}
+
+double vbv_model_max_tu_bits(const VbvModel *vbv, double fullness) {
+    double max_bits = fullness - vbv->buffer_size * VBV_MIN_FULLNESS_PERCENT / 100;
+    if (vbv->max_tu_bits > 0) max_bits = MIN(max_bits, vbv->max_tu_bits);
+    return MAX(max_bits, 0);
+}
+
+double vbv_model_min_tu_bits(const VbvModel *vbv, double fullness) {
+    if (!vbv->cbr) return 0;
+    return MAX(fullness + vbv->fill_per_tu - vbv->buffer_size, 0);
+}
+
+uint32_t vbv_model_padding_bytes(const VbvModel *vbv, uint64_t tu_bits) {
+    const double excess_bits = vbv_model_min_tu_bits(vbv, vbv->fullness) - (double)tu_bits;
+    return excess_bits > 0 ? (uint32_t)((excess_bits + 7) / 8) : 0;
+}
+
+EbBool vbv_model_update(VbvModel *vbv, uint64_t tu_bits) {
+    EbBool compliant = EB_TRUE;
+
+    vbv->tu_count++;
+    if (vbv->max_tu_bits > 0 && (double)tu_bits > vbv->max_tu_bits) {
+        vbv->oversize_count++;
+        compliant = EB_FALSE;
+    }
+    if ((double)tu_bits > vbv->fullness) {
+        // the decoder stalls until the TU is received
+        vbv->underflow_count++;
+        compliant     = EB_FALSE;
+        vbv->fullness = 0;
+    } else
+        vbv->fullness -= (double)tu_bits;
+    vbv->fullness += vbv->fill_per_tu;
+    if (vbv->fullness > vbv->buffer_size) {
+        if (vbv->cbr) {
+            vbv->overflow_count++;
+            compliant = EB_FALSE;
+        }
+        vbv->fullness = vbv->buffer_size;
+    }
+    return compliant;
+}
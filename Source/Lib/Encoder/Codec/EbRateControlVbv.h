@@ -0,0 +1,72 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbRateControlVbv_h
+#define EbRateControlVbv_h
+
+#include "EbDefinitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**************************************
+ * VBV (leaky bucket) decoder buffer model
+ *
+ * The decoder buffer receives the bitstream at the max rate and removes a
+ * temporal unit (TU) at each displayed frame. The buffer underflows when a TU
+ * is larger than the buffer fullness. In CBR the buffer keeps filling at the
+ * max rate, so it overflows when the TUs are too small (the TUs are then
+ * padded); in VBR the input stops when the buffer is full.
+ **************************************/
+
+// Lowest buffer fullness, in percent of the buffer size, targeted by the rate control
+#define VBV_MIN_FULLNESS_PERCENT 10
+
+typedef enum VbvMode {
+    VBV_MODE_OFF,
+    VBV_MODE_VBR,
+    VBV_MODE_CBR,
+    VBV_MODE_TOTAL
+} VbvMode;
+
+typedef struct VbvModel {
+    double   buffer_size; // in bits
+    double   fill_per_tu; // bits received between 2 TU removals
+    double   fullness; // bits in the buffer before the next TU removal
+    double   max_tu_bits; // TU size cap, 0: no cap
+    EbBool   cbr;
+    uint64_t tu_count;
+    uint32_t underflow_count;
+    uint32_t overflow_count;
+    uint32_t oversize_count; // TUs above the size cap
+} VbvModel;
+
+// max_rate in bits/second, frame_rate in Q16 frames/second (as the SCS frame_rate),
+// initial_fullness in percent of buffer_size, max_tu_size in bits (0: no cap)
+void vbv_model_init(VbvModel *vbv, uint32_t buffer_size, uint32_t max_rate, uint32_t frame_rate,
+                    uint32_t initial_fullness, uint32_t max_tu_size, EbBool cbr);
+
+// Fullness expected before the next TU removal once the pending_tus TUs of pending_bits
+// (coded, or with a QP assigned, but not yet removed) are removed
+double vbv_model_pending_fullness(const VbvModel *vbv, uint64_t pending_bits,
+                                  uint32_t pending_tus);
+
+// Largest next TU keeping the buffer above VBV_MIN_FULLNESS_PERCENT, within the size cap
+double vbv_model_max_tu_bits(const VbvModel *vbv, double fullness);
+
+// Smallest next TU not overflowing the buffer (CBR), 0 in VBR
+double vbv_model_min_tu_bits(const VbvModel *vbv, double fullness);
+
+// Bytes to add to a TU of tu_bits to prevent a buffer overflow (CBR), 0 in VBR
+uint32_t vbv_model_padding_bytes(const VbvModel *vbv, uint64_t tu_bits);
+
+// Removes a TU of tu_bits and fills the buffer until the next removal.
+// Returns EB_FALSE when the TU violates the model (underflow, overflow or size cap).
+EbBool vbv_model_update(VbvModel *vbv, uint64_t tu_bits);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbRateControlVbv_h
@@ -29,6 +29,7 @@ typedef struct EbReferenceObject {
     uint8_t              average_intensity;
     AomFilmGrain         film_grain_params; //Film grain parameters for a reference frame
     uint32_t             cdef_frame_strength;
+    uint64_t             cdef_strength_mask; // luma and chroma strengths (gi) signaled, 0: none
     int8_t               sg_frame_ep;
     FRAME_CONTEXT        frame_context;
     EbWarpedMotionParams global_motion[TOTAL_REFS_PER_FRAME];
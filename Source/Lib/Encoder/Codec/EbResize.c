@@ -982,7 +982,7 @@ void calc_superres_params(superres_params_type *spr_params, SequenceControlSet *
         !scs_ptr->seq_header.enable_restoration) { return; }
 
     // remove assertion when rest of the modes are implemented
-    assert(superres_mode <= SUPERRES_RANDOM);
+    assert(superres_mode != SUPERRES_QTHRESH);
 
     switch (superres_mode) {
     case SUPERRES_NONE: spr_params->superres_denom = SCALE_NUMERATOR; break;
@@ -993,9 +993,11 @@ void calc_superres_params(superres_params_type *spr_params, SequenceControlSet *
             spr_params->superres_denom = cfg_denom;
         break;
     case SUPERRES_RANDOM: spr_params->superres_denom = (uint8_t)(lcg_rand16(&seed) % 9 + 8); break;
-    //SUPERRES_QTHRESH and SUPERRES_AUTO are not yet implemented
+    // The denominator follows the speed control: it only rises above SCALE_NUMERATOR once the
+    // fastest preset cannot keep up with the target frame rate
+    case SUPERRES_AUTO: spr_params->superres_denom = pcs_ptr->sc_superres_denom; break;
+    //SUPERRES_QTHRESH is not yet implemented
     case SUPERRES_QTHRESH: break;
-    case SUPERRES_AUTO: break;
     default: break;
     }
 
@@ -1096,9 +1098,7 @@ void init_resize_picture(SequenceControlSet *scs_ptr, PictureParentControlSet *p
     calc_superres_params(&spr_params, scs_ptr, pcs_ptr);
 
     if (spr_params.superres_denom != SCALE_NUMERATOR) {
-
-        scs_ptr->seq_header.enable_superres = 1; // enable sequence level super-res flag
-                                                 // if super-res is ON for any frame
+        assert(scs_ptr->seq_header.enable_superres);
 
         // Allocate downsampled picture buffer descriptor
         downscaled_source_buffer_desc_ctor(
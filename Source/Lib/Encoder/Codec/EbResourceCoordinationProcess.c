@@ -206,6 +206,29 @@ EbErrorType signal_derivation_pre_analysis_oq(SequenceControlSet *     scs_ptr,
     return return_error;
 }
 
+//******************************************************************************//
+// Move one step along the speed ladder. In superres AUTO mode the ladder continues past the
+// fastest preset: the intra frames are then coded at a reduced width, one superres denominator
+// at a time, and the full width is restored before the preset is lowered again.
+//******************************************************************************//
+static void apply_speed_control_delta(SequenceControlSet *scs_ptr, int8_t encoder_mode_delta) {
+    EncodeContext *encode_context_ptr = scs_ptr->encode_context_ptr;
+
+    if (scs_ptr->static_config.superres_mode == SUPERRES_AUTO) {
+        if (encoder_mode_delta > 0 && encode_context_ptr->enc_mode == MAX_ENC_PRESET) {
+            encode_context_ptr->sc_superres_denom =
+                MIN(encode_context_ptr->sc_superres_denom + 1, MAX_SUPERRES_DENOM);
+            return;
+        }
+        if (encoder_mode_delta < 0 && encode_context_ptr->sc_superres_denom > SCALE_NUMERATOR) {
+            encode_context_ptr->sc_superres_denom--;
+            return;
+        }
+    }
+    encode_context_ptr->enc_mode = (EbEncMode)CLIP3(
+        1, MAX_ENC_PRESET, (int8_t)encode_context_ptr->enc_mode + encoder_mode_delta);
+}
+
 //******************************************************************************//
 // Modify the Enc mode based on the buffer Status
 // Inputs: TargetSpeed, Status of the SCbuffer
@@ -297,9 +320,8 @@ void speed_buffer_control(ResourceCoordinationContext *context_ptr,
             encoder_mode_delta += 1;
             change_cond = 7;
         }
-        encoder_mode_delta                    = CLIP3(-1, 1, encoder_mode_delta);
-        scs_ptr->encode_context_ptr->enc_mode = (EbEncMode)CLIP3(
-            1, MAX_ENC_PRESET, (int8_t)scs_ptr->encode_context_ptr->enc_mode + encoder_mode_delta);
+        encoder_mode_delta = CLIP3(-1, 1, encoder_mode_delta);
+        apply_speed_control_delta(scs_ptr, encoder_mode_delta);
 
         // Update previous stats
         context_ptr->previous_frame_in_check1 = scs_ptr->encode_context_ptr->sc_frame_in;
@@ -334,9 +356,8 @@ void speed_buffer_control(ResourceCoordinationContext *context_ptr,
             change_cond        = 8;
         }
 
-        encoder_mode_delta                    = CLIP3(-1, 1, encoder_mode_delta);
-        scs_ptr->encode_context_ptr->enc_mode = (EbEncMode)CLIP3(
-            1, MAX_ENC_PRESET, (int8_t)scs_ptr->encode_context_ptr->enc_mode + encoder_mode_delta);
+        encoder_mode_delta = CLIP3(-1, 1, encoder_mode_delta);
+        apply_speed_control_delta(scs_ptr, encoder_mode_delta);
 
         // Update previous stats
         context_ptr->previous_frame_in_check2 = scs_ptr->encode_context_ptr->sc_frame_in;
@@ -379,7 +400,8 @@ void speed_buffer_control(ResourceCoordinationContext *context_ptr,
     else
         context_ptr->average_enc_mod = 0;
     // Set the encoder level
-    pcs_ptr->enc_mode = scs_ptr->encode_context_ptr->enc_mode;
+    pcs_ptr->enc_mode          = scs_ptr->encode_context_ptr->enc_mode;
+    pcs_ptr->sc_superres_denom = scs_ptr->encode_context_ptr->sc_superres_denom;
 
     eb_release_mutex(scs_ptr->encode_context_ptr->sc_buffer_mutex);
     context_ptr->prev_enc_mod = scs_ptr->encode_context_ptr->enc_mode;
@@ -642,26 +664,49 @@ static void copy_input_buffer(SequenceControlSet *sequenceControlSet, EbBufferHe
 }
 /******************************************************
  * Read Stat from File
- * reads StatStruct per frame from the file and stores under pcs_ptr
+ * reads the stat record of a frame from the input stat buffer if set, from
+ * the input stat file otherwise, and stores it under pcs_ptr
  ******************************************************/
 static void read_stat_from_file(PictureParentControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
-    eb_block_on_mutex(scs_ptr->encode_context_ptr->stat_file_mutex);
-
-    int32_t fseek_return_value = fseek(scs_ptr->static_config.input_stat_file,
-                                       (long)pcs_ptr->picture_number * sizeof(StatStruct),
-                                       SEEK_SET);
+    const uint32_t record_size = scs_ptr->stat_record_size;
+    const uint64_t offset      = pcs_ptr->picture_number * record_size;
+
+    if (scs_ptr->static_config.input_stat_buffer) {
+        // Read only buffer: no lock and no copy of the unused part of stat_struct
+        if (offset + record_size <= scs_ptr->static_config.input_stat_buffer_size)
+            memcpy(pcs_ptr->stat_struct.referenced_area,
+                   scs_ptr->static_config.input_stat_buffer + offset,
+                   record_size);
+        else {
+            SVT_LOG("Error: no input stat for picture %u\n", (uint32_t)pcs_ptr->picture_number);
+            memset(pcs_ptr->stat_struct.referenced_area, 0, record_size);
+        }
+    } else {
+        eb_block_on_mutex(scs_ptr->encode_context_ptr->stat_file_mutex);
+        int32_t fseek_return_value =
+            fseek(scs_ptr->static_config.input_stat_file, (long)offset, SEEK_SET);
 
-    if (fseek_return_value != 0) {
-        SVT_LOG("Error in fseek  returnVal %i\n", (int)fseek_return_value);
-    }
-    size_t fread_return_value = fread(&pcs_ptr->stat_struct,
-                                      (size_t)1,
-                                      sizeof(StatStruct),
-                                      scs_ptr->static_config.input_stat_file);
-    if (fread_return_value != sizeof(StatStruct)) {
-        SVT_LOG("Error in freed  returnVal %i\n", (int)fread_return_value);
+        if (fseek_return_value != 0) {
+            SVT_LOG("Error in fseek  returnVal %i\n", (int)fseek_return_value);
+        }
+        size_t fread_return_value = fread(pcs_ptr->stat_struct.referenced_area,
+                                          (size_t)1,
+                                          record_size,
+                                          scs_ptr->static_config.input_stat_file);
+        if (fread_return_value != record_size) {
+            SVT_LOG("Error in freed  returnVal %i\n", (int)fread_return_value);
+        }
+        eb_release_mutex(scs_ptr->encode_context_ptr->stat_file_mutex);
     }
+    derive_referenced_area_avg(pcs_ptr, scs_ptr);
+}
 
+/******************************************************
+ * Derive Referenced Area Avg
+ * averages the referenced area of the stat_struct of the picture, in pixels
+ * of the referencing pictures per pixel of the picture
+ ******************************************************/
+void derive_referenced_area_avg(PictureParentControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
     uint64_t referenced_area_avg          = 0;
     uint64_t referenced_area_has_non_zero = 0;
     for (int sb_addr = 0; sb_addr < scs_ptr->sb_total_count; ++sb_addr) {
@@ -677,7 +722,6 @@ static void read_stat_from_file(PictureParentControlSet *pcs_ptr, SequenceContro
             referenced_area_avg * (scs_ptr->intra_period_length + 1) / TWO_PASS_IR_THRSHLD;
     pcs_ptr->referenced_area_avg          = referenced_area_avg;
     pcs_ptr->referenced_area_has_non_zero = referenced_area_has_non_zero ? 1 : 0;
-    eb_release_mutex(scs_ptr->encode_context_ptr->stat_file_mutex);
 }
 
 
@@ -836,8 +880,11 @@ void *resource_coordination_kernel(void *input_ptr) {
             sb_geom_init(scs_ptr);
             scs_ptr->enable_altrefs = scs_ptr->static_config.enable_altrefs ? EB_TRUE : EB_FALSE;
 
-            // initialize sequence level enable_superres
-            scs_ptr->seq_header.enable_superres = 0;
+            // initialize sequence level enable_superres. It is set up front whenever a superres
+            // mode is on since the denominator of later frames can change at run time, and the
+            // sequence header sent with the first key frame has to allow it
+            scs_ptr->seq_header.enable_superres =
+                scs_ptr->static_config.superres_mode > SUPERRES_NONE;
 
             if (scs_ptr->static_config.inter_intra_compound == DEFAULT) {
                 // Set inter-intra mode      Settings
@@ -984,8 +1031,10 @@ void *resource_coordination_kernel(void *input_ptr) {
 
             if (scs_ptr->static_config.speed_control_flag) {
                 speed_buffer_control(context_ptr, pcs_ptr, scs_ptr);
-            } else
-                pcs_ptr->enc_mode = (EbEncMode)scs_ptr->static_config.enc_mode;
+            } else {
+                pcs_ptr->enc_mode          = (EbEncMode)scs_ptr->static_config.enc_mode;
+                pcs_ptr->sc_superres_denom = SCALE_NUMERATOR;
+            }
             //  If the mode of the second pass is not set from CLI, it is set to enc_mode
             pcs_ptr->snd_pass_enc_mode =
                 (scs_ptr->use_output_stat_file &&
@@ -1105,17 +1154,40 @@ void *resource_coordination_kernel(void *input_ptr) {
             if (pcs_ptr->picture_number > 0 && (prev_pcs_wrapper_ptr != NULL)) {
                 ((PictureParentControlSet *)prev_pcs_wrapper_ptr->object_ptr)
                     ->end_of_sequence_flag = end_of_sequence_flag;
-                eb_get_empty_object(context_ptr->resource_coordination_results_output_fifo_ptr,
-                                    &output_wrapper_ptr);
-                out_results_ptr = (ResourceCoordinationResults *)output_wrapper_ptr->object_ptr;
-                out_results_ptr->pcs_wrapper_ptr = prev_pcs_wrapper_ptr;
                 // since overlay frame has the end of sequence set properly, set the end of sequence to true in the alt ref picture
                 if (((PictureParentControlSet *)prev_pcs_wrapper_ptr->object_ptr)->is_overlay &&
                     end_of_sequence_flag)
                     ((PictureParentControlSet *)prev_pcs_wrapper_ptr->object_ptr)
                         ->alt_ref_ppcs_ptr->end_of_sequence_flag = EB_TRUE;
-                // Post the finished Results Object
-                eb_post_full_object(output_wrapper_ptr);
+
+                // Initialize the picture analysis segments (bands of SB rows)
+                PictureParentControlSet *prev_pcs_ptr =
+                    (PictureParentControlSet *)prev_pcs_wrapper_ptr->object_ptr;
+                SequenceControlSet *prev_scs_ptr =
+                    (SequenceControlSet *)prev_pcs_ptr->scs_wrapper_ptr->object_ptr;
+                uint32_t pic_height_in_sb =
+                    (prev_pcs_ptr->aligned_height + prev_scs_ptr->sb_sz - 1) / prev_scs_ptr->sb_sz;
+                prev_pcs_ptr->pa_segments_total_count =
+                    prev_pcs_ptr->is_overlay
+                        ? 1
+                        : (uint8_t)MIN(prev_scs_ptr->picture_analysis_segment_row_count,
+                                       pic_height_in_sb);
+                prev_pcs_ptr->pa_segments_completion_mask = 0;
+                prev_pcs_ptr->pa_prep_done                = 0;
+
+                for (uint32_t segment_index = 0;
+                     segment_index < prev_pcs_ptr->pa_segments_total_count;
+                     ++segment_index) {
+                    eb_get_empty_object(
+                        context_ptr->resource_coordination_results_output_fifo_ptr,
+                        &output_wrapper_ptr);
+                    out_results_ptr =
+                        (ResourceCoordinationResults *)output_wrapper_ptr->object_ptr;
+                    out_results_ptr->pcs_wrapper_ptr = prev_pcs_wrapper_ptr;
+                    out_results_ptr->segment_index   = segment_index;
+                    // Post the finished Results Object
+                    eb_post_full_object(output_wrapper_ptr);
+                }
             }
             prev_pcs_wrapper_ptr = pcs_wrapper_ptr;
         }
@@ -17,6 +17,12 @@ EbErrorType resource_coordination_context_ctor(EbThreadContext* thread_context_p
                                                EbEncHandle*     enc_handle_ptr);
 
 extern void* resource_coordination_kernel(void* input_ptr);
+
+struct PictureParentControlSet;
+struct SequenceControlSet;
+// Derives referenced_area_avg / referenced_area_has_non_zero from the picture stat_struct
+extern void derive_referenced_area_avg(struct PictureParentControlSet* pcs_ptr,
+                                       struct SequenceControlSet*      scs_ptr);
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@
 #include "EbPsnr.h"
 #include "EbReferenceObject.h"
 #include "EbPictureControlSet.h"
+#include "EbPictureOperators.h"
 
 #define DEBUG_UPSCALING 0
 
@@ -128,7 +129,8 @@ EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
 
         EB_NEW(context_ptr->org_rec_frame, eb_picture_buffer_desc_ctor, (EbPtr)&init_data);
 
-        EB_MALLOC_ALIGNED(context_ptr->rst_tmpbuf, RESTORATION_TMPBUF_SIZE);
+        // The self-guided filter search also keeps the integral images of a unit
+        EB_MALLOC_ALIGNED(context_ptr->rst_tmpbuf, RESTORATION_TMPBUF_SIZE + SGRPROJ_II_BUF_SIZE);
     }
 
     EbPictureBufferDescInitData temp_lf_recon_desc_init_data;
@@ -559,11 +561,6 @@ void *rest_kernel(void *input_ptr) {
             // TODO: remove the copy when entire 16bit pipeline is ready
             if (scs_ptr->static_config.encoder_16bit_pipeline &&
                 scs_ptr->static_config.encoder_bit_depth == EB_8BIT) {
-                //copy recon from 16bit to 8bit
-                uint8_t*  recon_8bit;
-                int32_t   recon_stride_8bit;
-                uint16_t* recon_16bit;
-                int32_t   recon_stride_16bit;
                 EbPictureBufferDesc *recon_buffer, *recon_buffer_8bit;
                 if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
                     recon_buffer = ((EbReferenceObject *)
@@ -576,51 +573,7 @@ void *rest_kernel(void *input_ptr) {
                     recon_buffer = pcs_ptr->recon_picture16bit_ptr;
                     recon_buffer_8bit = pcs_ptr->recon_picture_ptr;
                 }
-                // Y
-                recon_16bit = (uint16_t*)(recon_buffer->buffer_y)
-                            + recon_buffer->origin_x
-                            + recon_buffer->origin_y * recon_buffer->stride_y;
-                recon_stride_16bit = recon_buffer->stride_y;
-                recon_8bit  = recon_buffer_8bit->buffer_y
-                            + recon_buffer_8bit->origin_x
-                            + recon_buffer_8bit->origin_y * recon_buffer_8bit->stride_y;
-                recon_stride_8bit = recon_buffer_8bit->stride_y;
-                for (int j = 0; j < recon_buffer->height; j++) {
-                    for (int i = 0; i < recon_buffer->width; i++) {
-                        recon_8bit[i + j * recon_stride_8bit] =
-                            (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                    }
-                }
-                // Cb
-                recon_16bit = (uint16_t*)(recon_buffer->buffer_cb)
-                            + recon_buffer->origin_x / 2
-                            + recon_buffer->origin_y / 2 * recon_buffer->stride_cb;
-                recon_stride_16bit = recon_buffer->stride_cb;
-                recon_8bit  = recon_buffer_8bit->buffer_cb
-                            + recon_buffer_8bit->origin_x / 2
-                            + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cb;
-                recon_stride_8bit = recon_buffer_8bit->stride_cb;
-                for (int j = 0; j < recon_buffer->height / 2; j++) {
-                    for (int i = 0; i < recon_buffer->width / 2; i++) {
-                        recon_8bit[i + j * recon_stride_8bit] =
-                            (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                    }
-                }
-                // Cr
-                recon_16bit = (uint16_t*)(recon_buffer->buffer_cr)
-                            + recon_buffer->origin_x / 2
-                            + recon_buffer->origin_y / 2 * recon_buffer->stride_cr;
-                recon_stride_16bit = recon_buffer->stride_cr;
-                recon_8bit  = recon_buffer_8bit->buffer_cr
-                            + recon_buffer_8bit->origin_x / 2
-                            + recon_buffer_8bit->origin_y / 2 * recon_buffer_8bit->stride_cr;
-                recon_stride_8bit = recon_buffer_8bit->stride_cr;
-                for (int j = 0; j < recon_buffer->height / 2; j++) {
-                    for (int i = 0; i < recon_buffer->width / 2; i++) {
-                        recon_8bit[i + j * recon_stride_8bit] =
-                            (uint8_t)recon_16bit[i + j * recon_stride_16bit];
-                    }
-                }
+                picture_convert_16bit_to_8bit(recon_buffer, recon_buffer_8bit, 0, recon_buffer->height);
             }
 
             if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
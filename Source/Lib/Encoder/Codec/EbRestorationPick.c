@@ -542,50 +542,78 @@ static INLINE void encode_xq(int32_t *xq, int32_t *xqd, const SgrParamsType *par
     }
 }
 
-// Apply the self-guided filter across an entire restoration unit.
-static INLINE void apply_sgr(int32_t sgr_params_idx, const uint8_t *dat8, int32_t width,
-                             int32_t height, int32_t dat_stride, int32_t use_highbd,
-                             int32_t bit_depth, int32_t pu_width, int32_t pu_height, int32_t *flt0,
-                             int32_t *flt1, int32_t flt_stride) {
-    for (int32_t i = 0; i < height; i += pu_height) {
-        const int32_t  h        = AOMMIN(pu_height, height - i);
-        int32_t *      flt0_row = flt0 + i * flt_stride;
-        int32_t *      flt1_row = flt1 + i * flt_stride;
-        const uint8_t *dat8_row = dat8 + i * dat_stride;
-
-        // Iterate over the stripe in blocks of width pu_width
-        for (int32_t j = 0; j < width; j += pu_width) {
-            const int32_t w = AOMMIN(pu_width, width - j);
-
-            //CHKN SSE
-            eb_av1_selfguided_restoration(dat8_row + j,
-                                          w,
-                                          h,
-                                          dat_stride,
-                                          flt0_row + j,
-                                          flt1_row + j,
-                                          flt_stride,
-                                          sgr_params_idx,
-                                          bit_depth,
-                                          use_highbd);
-        }
-    }
+// Coarse to fine search of the parameter sets: the centres of the groups of
+// SGRPROJ_COARSE_STEP sets of the range, then the neighbours of the best centre
+#define SG_COARSE_SEARCH_MODE 5
+#define SGRPROJ_COARSE_STEP 3
+
+// Filters the whole restoration unit with the parameter set ep, from the
+// integral images of the unit, and returns the error of the best projection
+static int64_t search_selfguided_ep(int32_t ep, const uint8_t *dat8, int32_t width, int32_t height,
+                                    int32_t dat_stride, const uint8_t *src8, int32_t src_stride,
+                                    int32_t use_highbitdepth, int32_t bit_depth, int32_t *sgr_buf,
+                                    int32_t *flt0, int32_t *flt1, int32_t flt_stride,
+                                    int32_t exqd[2]) {
+    const SgrParamsType *const params = &eb_sgr_params[ep];
+    int32_t                    exq[2];
+
+    eb_av1_selfguided_restoration_ii(dat8,
+                                     width,
+                                     height,
+                                     dat_stride,
+                                     sgr_buf,
+                                     flt0,
+                                     flt1,
+                                     flt_stride,
+                                     ep,
+                                     bit_depth,
+                                     use_highbitdepth);
+    aom_clear_system_state();
+    get_proj_subspace(src8,
+                      width,
+                      height,
+                      src_stride,
+                      dat8,
+                      dat_stride,
+                      use_highbitdepth,
+                      flt0,
+                      flt_stride,
+                      flt1,
+                      flt_stride,
+                      exq,
+                      params);
+    aom_clear_system_state();
+    encode_xq(exq, exqd, params);
+    return finer_search_pixel_proj_error(src8,
+                                         width,
+                                         height,
+                                         src_stride,
+                                         dat8,
+                                         dat_stride,
+                                         use_highbitdepth,
+                                         flt0,
+                                         flt_stride,
+                                         flt1,
+                                         flt_stride,
+                                         2,
+                                         exqd,
+                                         params);
 }
 
 static SgrprojInfo search_selfguided_restoration(
     const uint8_t *dat8, int32_t width, int32_t height, int32_t dat_stride, const uint8_t *src8,
-    int32_t src_stride, int32_t use_highbitdepth, int32_t bit_depth, int32_t pu_width,
-    int32_t pu_height, int32_t *rstbuf, int8_t sg_ref_frame_ep[2],
-    int32_t sg_frame_ep_cnt[SGRPROJ_PARAMS], int8_t step) {
-    int32_t *flt0 = rstbuf;
-    int32_t *flt1 = flt0 + RESTORATION_UNITPELS_MAX;
+    int32_t src_stride, int32_t use_highbitdepth, int32_t bit_depth, int32_t *rstbuf,
+    int8_t sg_ref_frame_ep[2], int32_t sg_frame_ep_cnt[SGRPROJ_PARAMS], int8_t step,
+    EbBool coarse, int64_t sse_none, int64_t *best_err) {
+    int32_t *flt0    = rstbuf;
+    int32_t *flt1    = flt0 + RESTORATION_UNITPELS_MAX;
+    int32_t *sgr_buf = flt1 + RESTORATION_UNITPELS_MAX;
     int32_t  ep, bestep = 0;
     int64_t  besterr = -1;
     int32_t  exqd[2], bestxqd[2] = {0, 0};
     int32_t  flt_stride = ((width + 7) & ~7) + 8;
-    assert(pu_width == (RESTORATION_PROC_UNIT_SIZE >> 1) || pu_width == RESTORATION_PROC_UNIT_SIZE);
-    assert(pu_height == (RESTORATION_PROC_UNIT_SIZE >> 1) ||
-           pu_height == RESTORATION_PROC_UNIT_SIZE);
+    int8_t   ep_list[SGRPROJ_PARAMS];
+    int32_t  ep_count = 0;
     int8_t mid_ep = sg_ref_frame_ep[0] < 0 && sg_ref_frame_ep[1] < 0
                         ? 0
                         : sg_ref_frame_ep[1] < 0
@@ -600,57 +628,48 @@ static SgrprojInfo search_selfguided_restoration(
                         ? SGRPROJ_PARAMS
                         : AOMMIN(SGRPROJ_PARAMS, mid_ep + step);
 
-    for (ep = start_ep; ep < end_ep; ep++) {
-        int32_t exq[2];
-        apply_sgr(ep,
-                  dat8,
-                  width,
-                  height,
-                  dat_stride,
-                  use_highbitdepth,
-                  bit_depth,
-                  pu_width,
-                  pu_height,
-                  flt0,
-                  flt1,
-                  flt_stride);
-        aom_clear_system_state();
-        const SgrParamsType *const params = &eb_sgr_params[ep];
-        get_proj_subspace(src8,
-                          width,
-                          height,
-                          src_stride,
-                          dat8,
-                          dat_stride,
-                          use_highbitdepth,
-                          flt0,
-                          flt_stride,
-                          flt1,
-                          flt_stride,
-                          exq,
-                          params);
-        aom_clear_system_state();
-        encode_xq(exq, exqd, params);
-        int64_t err = finer_search_pixel_proj_error(src8,
-                                                    width,
-                                                    height,
-                                                    src_stride,
-                                                    dat8,
-                                                    dat_stride,
-                                                    use_highbitdepth,
-                                                    flt0,
-                                                    flt_stride,
-                                                    flt1,
-                                                    flt_stride,
-                                                    2,
-                                                    exqd,
-                                                    params);
-        if (besterr == -1 || err < besterr) {
-            bestep     = ep;
-            besterr    = err;
-            bestxqd[0] = exqd[0];
-            bestxqd[1] = exqd[1];
+    coarse = coarse && end_ep - start_ep > SGRPROJ_COARSE_STEP;
+    if (coarse) {
+        for (ep = start_ep + SGRPROJ_COARSE_STEP / 2; ep - SGRPROJ_COARSE_STEP / 2 < end_ep;
+             ep += SGRPROJ_COARSE_STEP)
+            ep_list[ep_count++] = (int8_t)AOMMIN(ep, end_ep - 1);
+    } else {
+        for (ep = start_ep; ep < end_ep; ep++) ep_list[ep_count++] = (int8_t)ep;
+    }
+
+    // The integral images of the unit are shared by all the parameter sets
+    if (ep_count)
+        eb_av1_selfguided_integral_images(
+            dat8, width, height, dat_stride, sgr_buf, use_highbitdepth);
+
+    for (int32_t pass = 0; pass < 2; pass++) {
+        for (int32_t i = 0; i < ep_count; i++) {
+            int64_t err = search_selfguided_ep(ep_list[i],
+                                               dat8,
+                                               width,
+                                               height,
+                                               dat_stride,
+                                               src8,
+                                               src_stride,
+                                               use_highbitdepth,
+                                               bit_depth,
+                                               sgr_buf,
+                                               flt0,
+                                               flt1,
+                                               flt_stride,
+                                               exqd);
+            if (besterr == -1 || err < besterr) {
+                bestep     = ep_list[i];
+                besterr    = err;
+                bestxqd[0] = exqd[0];
+                bestxqd[1] = exqd[1];
+            }
         }
+        // No refinement when the unit is already best left unfiltered
+        if (!coarse || besterr >= sse_none) break;
+        ep_count = 0;
+        for (ep = AOMMAX(bestep - 1, start_ep); ep <= AOMMIN(bestep + 1, end_ep - 1); ep++)
+            if (ep != bestep) ep_list[ep_count++] = (int8_t)ep;
     }
     sg_frame_ep_cnt[bestep]++;
 
@@ -658,6 +677,7 @@ static SgrprojInfo search_selfguided_restoration(
     ret.ep     = bestep;
     ret.xqd[0] = bestxqd[0];
     ret.xqd[1] = bestxqd[1];
+    *best_err  = besterr;
     return ret;
 }
 extern int32_t eb_aom_count_primitive_refsubexpfin(uint16_t n, uint16_t k, uint16_t ref,
@@ -688,6 +708,7 @@ int8_t get_sg_step(int8_t sg_filter_mode) {
     case 2: step = 1; break;
     case 3: step = 4; break;
     case 4: step = 16; break;
+    case SG_COARSE_SEARCH_MODE: step = 16; break;
     default: step = 16; break;
     }
     return step;
@@ -1263,12 +1284,8 @@ static void search_sgrproj_seg(const RestorationTileLimits *limits, const Av1Pix
     const uint8_t *src_start =
         rsc->src_buffer + limits->v_start * rsc->src_stride + limits->h_start;
 
-    const int32_t is_uv           = rsc->plane > 0;
-    const int32_t ss_x            = is_uv && cm->subsampling_x;
-    const int32_t ss_y            = is_uv && cm->subsampling_y;
-    const int32_t procunit_width  = RESTORATION_PROC_UNIT_SIZE >> ss_x;
-    const int32_t procunit_height = RESTORATION_PROC_UNIT_SIZE >> ss_y;
-    int8_t        step            = get_sg_step(cm->sg_filter_mode);
+    int8_t  step = get_sg_step(cm->sg_filter_mode);
+    int64_t best_err;
 
     rusi->sgrproj = search_selfguided_restoration(dgd_start,
                                                   limits->h_end - limits->h_start,
@@ -1278,12 +1295,20 @@ static void search_sgrproj_seg(const RestorationTileLimits *limits, const Av1Pix
                                                   rsc->src_stride,
                                                   highbd,
                                                   bit_depth,
-                                                  procunit_width,
-                                                  procunit_height,
                                                   rsc->tmpbuf,
                                                   cm->sg_ref_frame_ep,
                                                   cm->sg_frame_ep_cnt,
-                                                  step);
+                                                  step,
+                                                  cm->sg_filter_mode == SG_COARSE_SEARCH_MODE,
+                                                  rusi->sse[RESTORE_NONE],
+                                                  &best_err);
+
+    // The projection error not below the error of the unit left unfiltered,
+    // RESTORE_NONE is the best type: skip filtering the unit
+    if (best_err >= rusi->sse[RESTORE_NONE]) {
+        rusi->sse[RESTORE_SGRPROJ] = INT64_MAX;
+        return;
+    }
 
     RestorationUnitInfo rui;
     rui.restoration_type = RESTORE_SGRPROJ;
@@ -0,0 +1,233 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <string.h>
+
+#include "EbSceneChangeDetection.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "EbReferenceObject.h"
+#include "EbUtility.h"
+#include "aom_dsp_rtcd.h"
+
+// Cut: SAD delta above SCD_CUT_RATIO x the window median + SCD_CUT_MIN_SAD (per 1/16 decimated
+// luma sample), with more than SCD_CUT_MIN_HIST of the histograms changed
+#define SCD_CUT_RATIO 3.0
+#define SCD_CUT_MIN_SAD 6.0
+#define SCD_CUT_MIN_HIST 0.25
+// Fade: average luma intensity moving by at least 1 in the same direction over
+// SCD_FADE_MIN_LENGTH pictures, and by SCD_FADE_MIN_RANGE overall
+#define SCD_FADE_MIN_LENGTH 5
+#define SCD_FADE_MIN_RANGE 12
+// Average luma intensity of a faded out picture
+#define SCD_BLACK_INTENSITY 32
+#define SCD_WINDOW_MAX_LENGTH (SCD_HISTORY_LENGTH + SCD_MAX_FUTURE_COUNT + 1)
+
+static const uint32_t scd_zero_bins[HISTOGRAM_NUMBER_OF_BINS] = {0};
+
+void scd_context_init(ScdContext *context_ptr) { memset(context_ptr, 0, sizeof(*context_ptr)); }
+
+/************************************************
+ * scd_sad_delta
+ *  mean absolute difference of the 1/16 decimated
+ *  luma of 2 pictures, over the whole 16x16 blocks
+ ************************************************/
+static double scd_sad_delta(PictureParentControlSet *pcs_a, PictureParentControlSet *pcs_b) {
+    const EbPictureBufferDesc *pic_a =
+        ((EbPaReferenceObject *)pcs_a->pa_reference_picture_wrapper_ptr->object_ptr)
+            ->sixteenth_decimated_picture_ptr;
+    const EbPictureBufferDesc *pic_b =
+        ((EbPaReferenceObject *)pcs_b->pa_reference_picture_wrapper_ptr->object_ptr)
+            ->sixteenth_decimated_picture_ptr;
+    const uint32_t width  = MIN(pic_a->width, pic_b->width) & ~15;
+    const uint32_t height = MIN(pic_a->height, pic_b->height) & ~15;
+    uint64_t       sad    = 0;
+
+    if (!width || !height) return 0;
+    for (uint32_t y = 0; y < height; y += 16) {
+        const uint8_t *src_a =
+            pic_a->buffer_y + (pic_a->origin_y + y) * pic_a->stride_y + pic_a->origin_x;
+        const uint8_t *src_b =
+            pic_b->buffer_y + (pic_b->origin_y + y) * pic_b->stride_y + pic_b->origin_x;
+        for (uint32_t x = 0; x < width; x += 16)
+            sad += eb_aom_sad16x16(src_a + x, pic_a->stride_y, src_b + x, pic_b->stride_y);
+    }
+    return (double)sad / (width * height);
+}
+
+/************************************************
+ * scd_hist_delta
+ *  share of the histogram samples of 2 pictures that
+ *  changed bin, max of the luma and the chroma, [0, 1]
+ ************************************************/
+static double scd_hist_delta(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_a,
+                             PictureParentControlSet *pcs_b) {
+    uint64_t diff[3]  = {0};
+    uint64_t total[3] = {0};
+    double   ratio[3];
+
+    for (uint32_t region_w = 0; region_w < scs_ptr->picture_analysis_number_of_regions_per_width;
+         region_w++) {
+        for (uint32_t region_h = 0;
+             region_h < scs_ptr->picture_analysis_number_of_regions_per_height;
+             region_h++) {
+            for (uint32_t comp = 0; comp < 3; comp++) {
+                const uint32_t *hist_a = pcs_a->picture_histogram[region_w][region_h][comp];
+                const uint32_t *hist_b = pcs_b->picture_histogram[region_w][region_h][comp];
+                diff[comp] += eb_hist_abs_diff(hist_a, hist_b, HISTOGRAM_NUMBER_OF_BINS);
+                // the bins being positive, their difference to empty bins is their sum
+                total[comp] += eb_hist_abs_diff(hist_a, scd_zero_bins, HISTOGRAM_NUMBER_OF_BINS) +
+                               eb_hist_abs_diff(hist_b, scd_zero_bins, HISTOGRAM_NUMBER_OF_BINS);
+            }
+        }
+    }
+    for (uint32_t comp = 0; comp < 3; comp++)
+        ratio[comp] = total[comp] ? (double)diff[comp] / total[comp] : 0;
+    return MAX(ratio[0], (ratio[1] + ratio[2]) / 2);
+}
+
+void scd_update_picture_delta(SequenceControlSet *scs_ptr, PictureParentControlSet *prev_pcs_ptr,
+                              PictureParentControlSet *pcs_ptr) {
+    if (pcs_ptr->scd_delta_valid) return;
+    pcs_ptr->scd_sad_delta   = scd_sad_delta(prev_pcs_ptr, pcs_ptr);
+    pcs_ptr->scd_hist_delta  = scd_hist_delta(scs_ptr, prev_pcs_ptr, pcs_ptr);
+    pcs_ptr->scd_delta_valid = EB_TRUE;
+}
+
+static double scd_median(double *values, uint32_t count) {
+    // insertion sort, the window is small
+    for (uint32_t i = 1; i < count; i++) {
+        const double value = values[i];
+        uint32_t     j     = i;
+        for (; j > 0 && values[j - 1] > value; j--) values[j] = values[j - 1];
+        values[j] = value;
+    }
+    return count ? values[count / 2] : 0;
+}
+
+static void scd_push_sad(ScdContext *context_ptr, double sad) {
+    if (context_ptr->sad_count == SCD_HISTORY_LENGTH) {
+        memmove(context_ptr->sad_history,
+                context_ptr->sad_history + 1,
+                (SCD_HISTORY_LENGTH - 1) * sizeof(context_ptr->sad_history[0]));
+        context_ptr->sad_count--;
+    }
+    context_ptr->sad_history[context_ptr->sad_count++] = sad;
+}
+
+static void scd_push_intensity(ScdContext *context_ptr, uint8_t intensity) {
+    if (context_ptr->intensity_count == SCD_HISTORY_LENGTH) {
+        memmove(context_ptr->intensity_history,
+                context_ptr->intensity_history + 1,
+                SCD_HISTORY_LENGTH - 1);
+        context_ptr->intensity_count--;
+    }
+    context_ptr->intensity_history[context_ptr->intensity_count++] = intensity;
+}
+
+/************************************************
+ * scd_detect_fade
+ *  length of the monotonic run of the average luma
+ *  intensity through the current picture (@ index cur
+ *  of intensity), 0 when the run is not a fade
+ ************************************************/
+static uint32_t scd_detect_fade(const uint8_t *intensity, uint32_t count, uint32_t cur,
+                                int32_t *direction, uint8_t *start_intensity,
+                                uint8_t *end_intensity) {
+    const int32_t dir   = intensity[cur] > intensity[cur - 1] ? 1 : -1;
+    uint32_t      first = cur - 1;
+    uint32_t      last  = cur;
+
+    if (intensity[cur] == intensity[cur - 1]) return 0;
+    while (first > 0 && (intensity[first] - intensity[first - 1]) * dir > 0) first--;
+    while (last + 1 < count && (intensity[last + 1] - intensity[last]) * dir > 0) last++;
+    if (last - first + 1 < SCD_FADE_MIN_LENGTH ||
+        ABS(intensity[last] - intensity[first]) < SCD_FADE_MIN_RANGE)
+        return 0;
+    *direction       = dir;
+    *start_intensity = intensity[first];
+    *end_intensity   = intensity[last];
+    return last - first + 1;
+}
+
+EbBool scd_sliding_window_detector(ScdContext *context_ptr, SequenceControlSet *scs_ptr,
+                                   PictureParentControlSet **parent_pcs_window,
+                                   uint32_t                  future_count) {
+    PictureParentControlSet *prev_pcs_ptr    = parent_pcs_window[0];
+    PictureParentControlSet *current_pcs_ptr = parent_pcs_window[1];
+    double                   window_sad[SCD_WINDOW_MAX_LENGTH];
+    uint8_t                  intensity[SCD_WINDOW_MAX_LENGTH];
+    uint32_t                 window_count = 0;
+    uint32_t                 intensity_count;
+    uint32_t                 cur;
+    int32_t                  fade_direction       = 0;
+    uint8_t                  fade_start_intensity = 0;
+    uint8_t                  fade_end_intensity   = 0;
+    EbBool                   is_cut;
+
+    future_count = MIN(future_count, SCD_MAX_FUTURE_COUNT);
+    current_pcs_ptr->scd_flash = EB_FALSE;
+    current_pcs_ptr->scd_fade  = EB_FALSE;
+
+    scd_update_picture_delta(scs_ptr, prev_pcs_ptr, current_pcs_ptr);
+    for (uint32_t i = 0; i < future_count; i++)
+        scd_update_picture_delta(scs_ptr, parent_pcs_window[1 + i], parent_pcs_window[2 + i]);
+
+    // Window: past deltas of the scene and look ahead deltas
+    for (uint32_t i = 0; i < context_ptr->sad_count; i++)
+        window_sad[window_count++] = context_ptr->sad_history[i];
+    for (uint32_t i = 0; i < future_count; i++)
+        window_sad[window_count++] = parent_pcs_window[2 + i]->scd_sad_delta;
+
+    // Back from a flash, the previous picture is not the reference of the delta
+    is_cut = !prev_pcs_ptr->scd_flash &&
+             current_pcs_ptr->scd_sad_delta >
+                 SCD_CUT_RATIO * scd_median(window_sad, window_count) + SCD_CUT_MIN_SAD &&
+             current_pcs_ptr->scd_hist_delta > SCD_CUT_MIN_HIST;
+
+    // Flash: the next picture is back to the previous one
+    if (is_cut && future_count) {
+        const double skip_sad = scd_sad_delta(prev_pcs_ptr, parent_pcs_window[2]);
+        if (skip_sad * SCD_CUT_RATIO < current_pcs_ptr->scd_sad_delta &&
+            scd_hist_delta(scs_ptr, prev_pcs_ptr, parent_pcs_window[2]) < SCD_CUT_MIN_HIST) {
+            current_pcs_ptr->scd_flash = EB_TRUE;
+            is_cut                     = EB_FALSE;
+        }
+    }
+
+    // Fade: intensities of the past pictures of the scene, then of the look ahead pictures
+    if (!context_ptr->intensity_count)
+        scd_push_intensity(context_ptr, prev_pcs_ptr->average_intensity[0]);
+    intensity_count = context_ptr->intensity_count;
+    memcpy(intensity, context_ptr->intensity_history, intensity_count);
+    cur                          = intensity_count;
+    intensity[intensity_count++] = current_pcs_ptr->average_intensity[0];
+    for (uint32_t i = 0; i < future_count; i++)
+        intensity[intensity_count++] = parent_pcs_window[2 + i]->average_intensity[0];
+    if (!current_pcs_ptr->scd_flash &&
+        scd_detect_fade(intensity,
+                        intensity_count,
+                        cur,
+                        &fade_direction,
+                        &fade_start_intensity,
+                        &fade_end_intensity)) {
+        current_pcs_ptr->scd_fade = EB_TRUE;
+        is_cut                    = EB_FALSE;
+        if (fade_direction < 0 && fade_end_intensity < SCD_BLACK_INTENSITY)
+            current_pcs_ptr->fade_in_to_black = 1;
+        else if (fade_direction > 0 && fade_start_intensity < SCD_BLACK_INTENSITY)
+            current_pcs_ptr->fade_out_from_black = 1;
+    }
+
+    // A cut starts a new scene: the window restarts from the current picture
+    if (is_cut)
+        scd_context_init(context_ptr);
+    else if (!current_pcs_ptr->scd_flash && !prev_pcs_ptr->scd_flash)
+        scd_push_sad(context_ptr, current_pcs_ptr->scd_sad_delta);
+    if (!current_pcs_ptr->scd_flash)
+        scd_push_intensity(context_ptr, current_pcs_ptr->average_intensity[0]);
+
+    return is_cut;
+}
@@ -0,0 +1,57 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbSceneChangeDetection_h
+#define EbSceneChangeDetection_h
+
+#include "EbDefinitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**************************************
+ * Sliding window scene change detection
+ *
+ * Each picture is compared to its predecessor in display order: mean SAD of
+ * the 1/16 decimated luma, and normalized histogram difference of the 3
+ * components (regions of the picture analysis). A cut is a picture whose SAD
+ * delta stands out from the deltas of the window (past pictures of the scene
+ * and look ahead pictures), with a large histogram difference. A flash is a
+ * cut whose next picture matches the previous one, a fade a monotonic run of
+ * the average luma intensity across the window; neither is a cut.
+ **************************************/
+
+// Past pictures of the scene kept in the window
+#define SCD_HISTORY_LENGTH 8
+// Max look ahead pictures in the window
+#define SCD_MAX_FUTURE_COUNT 6
+
+typedef struct ScdContext {
+    double   sad_history[SCD_HISTORY_LENGTH]; // SAD deltas, oldest first
+    uint32_t sad_count;
+    uint8_t  intensity_history[SCD_HISTORY_LENGTH]; // average luma intensities, oldest first
+    uint32_t intensity_count;
+} ScdContext;
+
+struct SequenceControlSet;
+struct PictureParentControlSet;
+
+void scd_context_init(ScdContext *context_ptr);
+
+// Sets the deltas of a picture to its predecessor, once per picture (scd_delta_valid)
+void scd_update_picture_delta(struct SequenceControlSet *     scs_ptr,
+                              struct PictureParentControlSet *prev_pcs_ptr,
+                              struct PictureParentControlSet *pcs_ptr);
+
+// Detects a cut @ parent_pcs_window[1] (0: previous picture, 2 and up: future_count look ahead
+// pictures), and sets the flash / fade flags of the picture
+EbBool scd_sliding_window_detector(ScdContext *context_ptr, struct SequenceControlSet *scs_ptr,
+                                   struct PictureParentControlSet **parent_pcs_window,
+                                   uint32_t                         future_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbSceneChangeDetection_h
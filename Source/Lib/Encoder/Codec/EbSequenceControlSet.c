@@ -385,10 +385,14 @@ EbErrorType copy_sequence_control_set(SequenceControlSet *dst, SequenceControlSe
     dst->down_sampling_method_me_search = src->down_sampling_method_me_search;
     dst->tf_segment_column_count        = src->tf_segment_column_count;
     dst->tf_segment_row_count           = src->tf_segment_row_count;
+    dst->picture_analysis_segment_row_count = src->picture_analysis_segment_row_count;
+    dst->dlf_segment_row_count          = src->dlf_segment_row_count;
     dst->over_boundary_block_mode       = src->over_boundary_block_mode;
     dst->mfmv_enabled                   = src->mfmv_enabled;
     dst->use_input_stat_file            = src->use_input_stat_file;
+    dst->use_lookahead_stats            = src->use_lookahead_stats;
     dst->use_output_stat_file           = src->use_output_stat_file;
+    dst->stat_record_size               = src->stat_record_size;
     dst->scd_delay                      = src->scd_delay;
     return EB_ErrorNone;
 }
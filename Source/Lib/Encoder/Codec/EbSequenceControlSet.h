@@ -101,9 +101,13 @@ typedef struct SequenceControlSet {
     (The signal changes per preset; 0: compound disabled, 1: compound enabled) Default is 1. */
     uint8_t compound_mode;
 
-    /*!< Temporary input / output statistics files for 2-pass encoding */
+    /*!< Input / output statistics (file, buffer or callback) for 2-pass encoding */
     EbBool use_input_stat_file;
     EbBool use_output_stat_file;
+    /*!< 2-pass statistics derived from the lookahead ME instead of an input stat file */
+    EbBool use_lookahead_stats;
+    /*!< Size in bytes of the statistics record of a picture */
+    uint32_t stat_record_size;
 
     /*!< Sequence resolution parameters */
     uint32_t          chroma_format_idc;
@@ -164,6 +168,8 @@ typedef struct SequenceControlSet {
     uint32_t rest_segment_row_count;
     uint32_t tf_segment_column_count;
     uint32_t tf_segment_row_count;
+    uint32_t picture_analysis_segment_row_count;
+    uint32_t dlf_segment_row_count;
 
     /*!< Picture, reference, recon and input output buffer count */
     uint32_t picture_control_set_pool_init_count;
@@ -0,0 +1,273 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <math.h>
+#include <string.h>
+
+#include "EbTemporalDependencyModel.h"
+#include "EbEncodeContext.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "EbMotionEstimationContext.h"
+#include "EbUtility.h"
+
+#define TPL_BLK_SIZE 16
+#define TPL_BLK_PER_SB_LOG2 4 // 4x4 16x16 blocks per 64x64 SB
+
+static INLINE uint32_t tpl_pic_width_in_sb(const PictureParentControlSet *pcs_ptr) {
+    return (pcs_ptr->aligned_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+}
+
+static INLINE uint32_t tpl_pic_height_in_sb(const PictureParentControlSet *pcs_ptr) {
+    return (pcs_ptr->aligned_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+}
+
+// Index of a 16x16 block from its position in 16x16 units; the blocks of an SB are in raster order
+static INLINE uint32_t tpl_blk_index(uint32_t pic_width_in_sb, uint32_t blk_x, uint32_t blk_y) {
+    const uint32_t sb_index = (blk_x >> 2) + (blk_y >> 2) * pic_width_in_sb;
+    return (sb_index << TPL_BLK_PER_SB_LOG2) + ((blk_y & 3) << 2) + (blk_x & 3);
+}
+
+/************************************************
+* TPL Block Costs
+** Intra cost: size of the block times its standard deviation (a DC prediction
+** SAD estimate). Inter cost: distortion of the best ME candidate, when lower.
+************************************************/
+static void tpl_block_costs(PictureParentControlSet *pcs_ptr) {
+    const uint32_t pic_width_in_sb = tpl_pic_width_in_sb(pcs_ptr);
+    const uint32_t sb_count        = pic_width_in_sb * tpl_pic_height_in_sb(pcs_ptr);
+
+    for (uint32_t sb_index = 0; sb_index < sb_count; sb_index++) {
+        const MeSbResults *me_results  = pcs_ptr->me_results[sb_index];
+        const uint32_t     sb_origin_x = (sb_index % pic_width_in_sb) * BLOCK_SIZE_64;
+        const uint32_t     sb_origin_y = (sb_index / pic_width_in_sb) * BLOCK_SIZE_64;
+
+        for (uint32_t blk = 0; blk < (1 << TPL_BLK_PER_SB_LOG2); blk++) {
+            const uint32_t blk_index = (sb_index << TPL_BLK_PER_SB_LOG2) + blk;
+            const uint32_t pu_index  = ME_TIER_ZERO_PU_16x16_0 + blk;
+            pcs_ptr->tpl_mc_flow[blk_index] = 0;
+            if (sb_origin_x + (blk & 3) * TPL_BLK_SIZE >= pcs_ptr->aligned_width ||
+                sb_origin_y + (blk >> 2) * TPL_BLK_SIZE >= pcs_ptr->aligned_height) {
+                pcs_ptr->tpl_intra_cost[blk_index] = 0;
+                pcs_ptr->tpl_inter_cost[blk_index] = 0;
+                continue;
+            }
+            const uint32_t intra_cost =
+                MAX(1,
+                    (uint32_t)(TPL_BLK_SIZE * TPL_BLK_SIZE *
+                               sqrt((double)pcs_ptr->variance[sb_index][pu_index])));
+            uint32_t inter_cost = intra_cost;
+            if (pcs_ptr->slice_type != I_SLICE && me_results->total_me_candidate_index[pu_index])
+                // the candidates are sorted by distortion
+                inter_cost = MIN(inter_cost, me_results->me_candidate[pu_index][0].distortion);
+            pcs_ptr->tpl_intra_cost[blk_index] = intra_cost;
+            pcs_ptr->tpl_inter_cost[blk_index] = inter_cost;
+        }
+    }
+}
+
+/************************************************
+* TPL Propagate
+** Adds to the mc flow of the blocks of the references of pcs_ptr found in the
+** window the share of the cost of each block of pcs_ptr saved by its best ME
+** candidate, split by area over the blocks the MV points to (and in halves
+** between the two references of a bi-pred candidate). The mc flow of pcs_ptr
+** is complete: all the pictures referencing it are later in decode order.
+************************************************/
+static void tpl_propagate(PictureParentControlSet *pcs_ptr, PictureParentControlSet **sw_pcs,
+                          uint32_t sw_count) {
+    PictureParentControlSet *ref_pcs[MAX_NUM_OF_REF_PIC_LIST][REF_LIST_MAX_DEPTH];
+    EbBool                   referenced = EB_FALSE;
+
+    if (pcs_ptr->slice_type == I_SLICE) return;
+    for (uint8_t list_index = REF_LIST_0; list_index < MAX_NUM_OF_REF_PIC_LIST; list_index++) {
+        const uint8_t ref_count =
+            list_index == REF_LIST_0 ? pcs_ptr->ref_list0_count : pcs_ptr->ref_list1_count;
+        for (uint8_t ref_index = 0; ref_index < REF_LIST_MAX_DEPTH; ref_index++) {
+            ref_pcs[list_index][ref_index] = NULL;
+            if (ref_index >= ref_count) continue;
+            for (uint32_t sw_index = 0; sw_index < sw_count; sw_index++) {
+                if (sw_pcs[sw_index]->picture_number ==
+                    pcs_ptr->ref_pic_poc_array[list_index][ref_index]) {
+                    ref_pcs[list_index][ref_index] = sw_pcs[sw_index];
+                    referenced                     = EB_TRUE;
+                    break;
+                }
+            }
+        }
+    }
+    if (!referenced) return;
+
+    const uint32_t pic_width_in_sb = tpl_pic_width_in_sb(pcs_ptr);
+    const uint32_t sb_count        = pic_width_in_sb * tpl_pic_height_in_sb(pcs_ptr);
+    const uint8_t  list1_mv_offset = pcs_ptr->scs_ptr->mrp_mode == 0 ? 4 : 2;
+
+    for (uint32_t sb_index = 0; sb_index < sb_count; sb_index++) {
+        const MeSbResults *me_results  = pcs_ptr->me_results[sb_index];
+        const int32_t      sb_origin_x = (sb_index % pic_width_in_sb) * BLOCK_SIZE_64;
+        const int32_t      sb_origin_y = (sb_index / pic_width_in_sb) * BLOCK_SIZE_64;
+
+        for (uint32_t blk = 0; blk < (1 << TPL_BLK_PER_SB_LOG2); blk++) {
+            const uint32_t blk_index  = (sb_index << TPL_BLK_PER_SB_LOG2) + blk;
+            const uint32_t pu_index   = ME_TIER_ZERO_PU_16x16_0 + blk;
+            const uint32_t intra_cost = pcs_ptr->tpl_intra_cost[blk_index];
+            const uint32_t inter_cost = pcs_ptr->tpl_inter_cost[blk_index];
+            if (inter_cost >= intra_cost || !me_results->total_me_candidate_index[pu_index])
+                continue;
+            uint64_t propagate_amount = (intra_cost + pcs_ptr->tpl_mc_flow[blk_index]) *
+                                        (intra_cost - inter_cost) / intra_cost;
+
+            const MeCandidate *best = &me_results->me_candidate[pu_index][0];
+            uint8_t            pred_list[2], pred_ref[2], pred_count = 0;
+            if (best->direction == UNI_PRED_LIST_0) {
+                pred_list[pred_count]  = REF_LIST_0;
+                pred_ref[pred_count++] = best->ref_idx_l0;
+            } else if (best->direction == UNI_PRED_LIST_1) {
+                pred_list[pred_count]  = REF_LIST_1;
+                pred_ref[pred_count++] = best->ref_idx_l1;
+            } else {
+                pred_list[pred_count]  = best->ref0_list;
+                pred_ref[pred_count++] = best->ref_idx_l0;
+                pred_list[pred_count]  = best->ref1_list;
+                pred_ref[pred_count++] = best->ref_idx_l1;
+                propagate_amount >>= 1;
+            }
+            for (uint8_t pred_index = 0; pred_index < pred_count; pred_index++) {
+                PictureParentControlSet *ref_pcs_ptr =
+                    ref_pcs[pred_list[pred_index]][pred_ref[pred_index]];
+                if (!ref_pcs_ptr) continue;
+                const uint8_t mv_index =
+                    (pred_list[pred_index] == REF_LIST_0 ? 0 : list1_mv_offset) +
+                    pred_ref[pred_index];
+                const MvCandidate *mv = &me_results->me_mv_array[pu_index][mv_index];
+                // ME MVs in quarter pel
+                const int32_t x = CLIP3(0,
+                                        (int32_t)pcs_ptr->aligned_width - TPL_BLK_SIZE,
+                                        sb_origin_x + (int32_t)(blk & 3) * TPL_BLK_SIZE +
+                                            (mv->x_mv >> 2));
+                const int32_t y = CLIP3(0,
+                                        (int32_t)pcs_ptr->aligned_height - TPL_BLK_SIZE,
+                                        sb_origin_y + (int32_t)(blk >> 2) * TPL_BLK_SIZE +
+                                            (mv->y_mv >> 2));
+                // spread the amount over the (up to 4) blocks overlapped by the prediction
+                for (int32_t blk_y = y / TPL_BLK_SIZE; blk_y <= (y + TPL_BLK_SIZE - 1) / TPL_BLK_SIZE;
+                     blk_y++) {
+                    for (int32_t blk_x = x / TPL_BLK_SIZE;
+                         blk_x <= (x + TPL_BLK_SIZE - 1) / TPL_BLK_SIZE;
+                         blk_x++) {
+                        const int32_t width  = MIN((blk_x + 1) * TPL_BLK_SIZE, x + TPL_BLK_SIZE) -
+                                              MAX(blk_x * TPL_BLK_SIZE, x);
+                        const int32_t height = MIN((blk_y + 1) * TPL_BLK_SIZE, y + TPL_BLK_SIZE) -
+                                               MAX(blk_y * TPL_BLK_SIZE, y);
+                        ref_pcs_ptr->tpl_mc_flow[tpl_blk_index(pic_width_in_sb, blk_x, blk_y)] +=
+                            propagate_amount * (uint32_t)(width * height) /
+                            (TPL_BLK_SIZE * TPL_BLK_SIZE);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void tpl_derive_results(PictureParentControlSet *pcs_ptr) {
+    const uint32_t sb_count = tpl_pic_width_in_sb(pcs_ptr) * tpl_pic_height_in_sb(pcs_ptr);
+    uint64_t       intra_cost = 0, propagate_cost = 0;
+
+    for (uint32_t sb_index = 0; sb_index < sb_count; sb_index++) {
+        uint64_t sb_intra_cost = 0, sb_propagate_cost = 0;
+        for (uint32_t blk = 0; blk < (1 << TPL_BLK_PER_SB_LOG2); blk++) {
+            const uint32_t blk_index = (sb_index << TPL_BLK_PER_SB_LOG2) + blk;
+            sb_intra_cost += pcs_ptr->tpl_intra_cost[blk_index];
+            sb_propagate_cost +=
+                pcs_ptr->tpl_intra_cost[blk_index] + pcs_ptr->tpl_mc_flow[blk_index];
+        }
+        pcs_ptr->tpl_sb_intra_cost[sb_index]     = sb_intra_cost;
+        pcs_ptr->tpl_sb_propagate_cost[sb_index] = sb_propagate_cost;
+        intra_cost += sb_intra_cost;
+        propagate_cost += sb_propagate_cost;
+    }
+    pcs_ptr->tpl_r0    = propagate_cost ? (double)intra_cost / (double)propagate_cost : 1.0;
+    pcs_ptr->tpl_valid = EB_TRUE;
+}
+
+/************************************************
+* TPL Process Lookahead
+** Called when the head of the IRC reorder queue leaves the lookahead window
+** without valid TPL results: the window then starts right after a base layer
+** picture (or is the first one), so the results of the pictures up to the
+** next base layer picture have the propagation of the following mini GOP.
+************************************************/
+void tpl_process_lookahead(EncodeContext *encode_context_ptr, uint32_t frames_in_sw) {
+    PictureParentControlSet *sw_pcs[MAX_LAD + 1];
+    PictureParentControlSet *decode_order_pcs[MAX_LAD + 1];
+    uint32_t                 sw_count    = 0;
+    uint32_t                 queue_index = encode_context_ptr->initial_rate_control_reorder_queue_head_index;
+
+    frames_in_sw = MIN(frames_in_sw, MAX_LAD + 1);
+    while (sw_count < frames_in_sw) {
+        const InitialRateControlReorderEntry *queue_entry_ptr =
+            encode_context_ptr->initial_rate_control_reorder_queue[queue_index];
+        if (queue_entry_ptr->parent_pcs_wrapper_ptr == EB_NULL) break;
+        sw_pcs[sw_count] =
+            (PictureParentControlSet *)queue_entry_ptr->parent_pcs_wrapper_ptr->object_ptr;
+        if (sw_pcs[sw_count++]->end_of_sequence_flag) break;
+        queue_index = (queue_index == INITIAL_RATE_CONTROL_REORDER_QUEUE_MAX_DEPTH - 1)
+                          ? 0
+                          : queue_index + 1;
+    }
+    if (!sw_count) return;
+
+    // Sort the window in decode order
+    for (uint32_t sw_index = 0; sw_index < sw_count; sw_index++) {
+        uint32_t insert_index = sw_index;
+        tpl_block_costs(sw_pcs[sw_index]);
+        while (insert_index &&
+               decode_order_pcs[insert_index - 1]->decode_order > sw_pcs[sw_index]->decode_order) {
+            decode_order_pcs[insert_index] = decode_order_pcs[insert_index - 1];
+            insert_index--;
+        }
+        decode_order_pcs[insert_index] = sw_pcs[sw_index];
+    }
+    // Propagate from the last decoded picture backwards
+    for (uint32_t decode_index = sw_count; decode_index > 0; decode_index--)
+        tpl_propagate(decode_order_pcs[decode_index - 1], sw_pcs, sw_count);
+
+    for (uint32_t sw_index = 0; sw_index < sw_count; sw_index++) {
+        tpl_derive_results(sw_pcs[sw_index]);
+        if (sw_index && sw_pcs[sw_index]->temporal_layer_index == 0) break;
+    }
+}
+
+static double tpl_frames_factor(const PictureParentControlSet *pcs_ptr) {
+    return CLIP3(4.0, 10.0, sqrt((double)pcs_ptr->frames_in_sw));
+}
+
+int32_t tpl_get_kf_boost(const PictureParentControlSet *pcs_ptr) {
+    return (int32_t)((75.0 + 14.0 * tpl_frames_factor(pcs_ptr)) / pcs_ptr->tpl_r0);
+}
+
+int32_t tpl_get_gfu_boost(const PictureParentControlSet *pcs_ptr) {
+    return (int32_t)((200.0 + 10.0 * tpl_frames_factor(pcs_ptr)) / pcs_ptr->tpl_r0);
+}
+
+double tpl_get_sb_beta(const PictureParentControlSet *pcs_ptr, uint32_t sb_origin_x,
+                       uint32_t sb_origin_y, uint32_t sb_size) {
+    const uint32_t pic_width_in_sb  = tpl_pic_width_in_sb(pcs_ptr);
+    const uint32_t pic_height_in_sb = tpl_pic_height_in_sb(pcs_ptr);
+    uint64_t       intra_cost = 0, propagate_cost = 0;
+
+    for (uint32_t sb_y = sb_origin_y / BLOCK_SIZE_64;
+         sb_y < MIN(pic_height_in_sb, (sb_origin_y + sb_size) / BLOCK_SIZE_64);
+         sb_y++) {
+        for (uint32_t sb_x = sb_origin_x / BLOCK_SIZE_64;
+             sb_x < MIN(pic_width_in_sb, (sb_origin_x + sb_size) / BLOCK_SIZE_64);
+             sb_x++) {
+            intra_cost += pcs_ptr->tpl_sb_intra_cost[sb_x + sb_y * pic_width_in_sb];
+            propagate_cost += pcs_ptr->tpl_sb_propagate_cost[sb_x + sb_y * pic_width_in_sb];
+        }
+    }
+    // beta = r0 / rk, with rk the intra over propagated cost ratio of the SB
+    return intra_cost ? pcs_ptr->tpl_r0 * (double)propagate_cost / (double)intra_cost : 1.0;
+}
@@ -0,0 +1,48 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTemporalDependencyModel_h
+#define EbTemporalDependencyModel_h
+
+#include "EbDefinitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**************************************
+ * Temporal Dependency Model (TPL)
+ *
+ * Estimates, on the 16x16 blocks of the pictures of the lookahead window, an
+ * intra cost and an inter cost from the source variance and the ME results,
+ * then propagates, in reverse decode order, the share of the cost of each
+ * block that its prediction saves onto the blocks of its references (mc flow).
+ * The ratio of the intra cost to the intra + propagated cost (r0) drives the
+ * qindex boost of the picture and, relative to the one of the picture, the QP
+ * offset of each SB.
+ **************************************/
+
+// Max absolute SB QP offset derived from the TPL statistics
+#define TPL_MAX_SB_DELTA_QP 8
+
+struct EncodeContext;
+struct PictureParentControlSet;
+
+// Runs the model over the lookahead window starting @ the head of the IRC reorder queue and
+// sets the TPL results of the window pictures up to the first base layer picture (included)
+void tpl_process_lookahead(struct EncodeContext *encode_context_ptr, uint32_t frames_in_sw);
+
+// Boosts of a picture with valid TPL results, in the kf_boost / gfu_boost units of the RC
+int32_t tpl_get_kf_boost(const struct PictureParentControlSet *pcs_ptr);
+int32_t tpl_get_gfu_boost(const struct PictureParentControlSet *pcs_ptr);
+
+// Ratio of the r0 of the picture over the one of the area (64x64 SB aligned) of an SB; the SB
+// deserves a lower QP when above 1
+double tpl_get_sb_beta(const struct PictureParentControlSet *pcs_ptr, uint32_t sb_origin_x,
+                       uint32_t sb_origin_y, uint32_t sb_size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbTemporalDependencyModel_h
@@ -1114,92 +1114,144 @@ static void apply_filtering_block(int block_row, int block_col, EbByte *src, uin
     }
 }
 
-// Apply filtering to the central picture
-static void apply_filtering_central(EbByte *pred, uint32_t **accum, uint16_t **count,
+// Apply filtering to the central picture, directly from the source block
+static void apply_filtering_central(EbByte *src, const uint32_t *stride, uint32_t **accum,
+                                    uint16_t **count, const uint32_t *stride_pred,
                                     uint16_t blk_width, uint16_t blk_height, uint32_t ss_x,
                                     uint32_t ss_y) {
-    uint16_t i, j, k;
-    uint16_t blk_height_y  = blk_height;
-    uint16_t blk_width_y   = blk_width;
+    uint16_t i, j;
     uint16_t blk_height_ch = blk_height >> ss_y;
     uint16_t blk_width_ch  = blk_width >> ss_x;
-    uint16_t blk_stride_y  = blk_width;
-    uint16_t blk_stride_ch = blk_width >> ss_x;
 
     int       filter_weight = INIT_WEIGHT;
     const int modifier      = filter_weight * WEIGHT_MULTIPLIER;
 
     // Luma
-    k = 0;
-    for (i = 0; i < blk_height_y; i++) {
-        for (j = 0; j < blk_width_y; j++) {
-            accum[C_Y][k] += modifier * pred[C_Y][i * blk_stride_y + j];
-            count[C_Y][k] += modifier;
-            ++k;
+    for (i = 0; i < blk_height; i++) {
+        for (j = 0; j < blk_width; j++) {
+            accum[C_Y][i * stride_pred[C_Y] + j] += modifier * src[C_Y][i * stride[C_Y] + j];
+            count[C_Y][i * stride_pred[C_Y] + j] += modifier;
         }
     }
 
     // Chroma
-    k = 0;
     for (i = 0; i < blk_height_ch; i++) {
         for (j = 0; j < blk_width_ch; j++) {
-            accum[C_U][k] += modifier * pred[C_U][i * blk_stride_ch + j];
-            count[C_U][k] += modifier;
+            accum[C_U][i * stride_pred[C_U] + j] += modifier * src[C_U][i * stride[C_U] + j];
+            count[C_U][i * stride_pred[C_U] + j] += modifier;
 
-            accum[C_V][k] += modifier * pred[C_V][i * blk_stride_ch + j];
-            count[C_V][k] += modifier;
-            ++k;
+            accum[C_V][i * stride_pred[C_V] + j] += modifier * src[C_V][i * stride[C_V] + j];
+            count[C_V][i * stride_pred[C_V] + j] += modifier;
         }
     }
 }
 
-// Apply filtering to the central picture
-static void apply_filtering_central_highbd(uint16_t **pred_16bit, uint32_t **accum,
-                                           uint16_t **count, uint16_t blk_width,
+// Apply filtering to the central picture, directly from the source block
+static void apply_filtering_central_highbd(uint16_t **src_16bit, const uint32_t *stride,
+                                           uint32_t **accum, uint16_t **count,
+                                           const uint32_t *stride_pred, uint16_t blk_width,
                                            uint16_t blk_height, uint32_t ss_x, uint32_t ss_y) {
-    uint16_t i, j, k;
-    uint16_t blk_height_y  = blk_height;
-    uint16_t blk_width_y   = blk_width;
+    uint16_t i, j;
     uint16_t blk_height_ch = blk_height >> ss_y;
     uint16_t blk_width_ch  = blk_width >> ss_x;
-    uint16_t blk_stride_y  = blk_width;
-    uint16_t blk_stride_ch = blk_width >> ss_x;
 
     int       filter_weight = INIT_WEIGHT;
     const int modifier      = filter_weight * WEIGHT_MULTIPLIER;
 
     // Luma
-    k = 0;
-    for (i = 0; i < blk_height_y; i++) {
-        for (j = 0; j < blk_width_y; j++) {
-            accum[C_Y][k] += modifier * pred_16bit[C_Y][i * blk_stride_y + j];
-            count[C_Y][k] += modifier;
-            ++k;
+    for (i = 0; i < blk_height; i++) {
+        for (j = 0; j < blk_width; j++) {
+            accum[C_Y][i * stride_pred[C_Y] + j] += modifier * src_16bit[C_Y][i * stride[C_Y] + j];
+            count[C_Y][i * stride_pred[C_Y] + j] += modifier;
         }
     }
 
     // Chroma
-    k = 0;
     for (i = 0; i < blk_height_ch; i++) {
         for (j = 0; j < blk_width_ch; j++) {
-            accum[C_U][k] += modifier * pred_16bit[C_U][i * blk_stride_ch + j];
-            count[C_U][k] += modifier;
+            accum[C_U][i * stride_pred[C_U] + j] += modifier * src_16bit[C_U][i * stride[C_U] + j];
+            count[C_U][i * stride_pred[C_U] + j] += modifier;
 
-            accum[C_V][k] += modifier * pred_16bit[C_V][i * blk_stride_ch + j];
-            count[C_V][k] += modifier;
-            ++k;
+            accum[C_V][i * stride_pred[C_V] + j] += modifier * src_16bit[C_V][i * stride[C_V] + j];
+            count[C_V][i * stride_pred[C_V] + j] += modifier;
         }
     }
 }
 
 uint32_t get_mds_idx(uint32_t orgx, uint32_t orgy, uint32_t size, uint32_t use_128x128);
 
+// Pack to 16 bit the area of the reference picture the 16x16 blocks of the 64x64 block can
+// predict from (ME MVs, 1/8-pel refinement and interpolation taps), instead of the whole picture.
+// The area is written at its own position in ref_16bit, which has the layout of the reference.
+static void pack_highbd_ref_window(const MeContext *context_ptr,
+                                   const EbPictureBufferDesc *pic_ptr_ref, uint16_t **ref_16bit,
+                                   uint32_t sb_origin_x, uint32_t sb_origin_y, uint32_t ss_x,
+                                   uint32_t ss_y) {
+    int32_t min_mv_x = 0, max_mv_x = 0, min_mv_y = 0, max_mv_y = 0;
+
+    for (uint32_t pu_index = 0; pu_index < N_16X16_BLOCKS; pu_index++) {
+        const uint32_t mv_index = tab16x16[pu_index];
+        // 1/8-pel MVs, refined by +/-1 in tf_inter_prediction()
+        const int32_t mv_x = _MVXT(context_ptr->p_best_mv16x16[mv_index]) << 1;
+        const int32_t mv_y = _MVYT(context_ptr->p_best_mv16x16[mv_index]) << 1;
+
+        min_mv_x = AOMMIN(min_mv_x, (mv_x - 1) >> 3);
+        max_mv_x = AOMMAX(max_mv_x, (mv_x + 1 + 7) >> 3);
+        min_mv_y = AOMMIN(min_mv_y, (mv_y - 1) >> 3);
+        max_mv_y = AOMMAX(max_mv_y, (mv_y + 1 + 7) >> 3);
+    }
+
+    const int32_t width_y  = pic_ptr_ref->stride_y;
+    const int32_t height_y = 2 * pic_ptr_ref->origin_y + pic_ptr_ref->height;
+    const int32_t blk_x    = pic_ptr_ref->origin_x + sb_origin_x;
+    const int32_t blk_y    = pic_ptr_ref->origin_y + sb_origin_y;
+    const int32_t x0       = AOMMAX(0, blk_x + min_mv_x - AOM_INTERP_EXTEND);
+    const int32_t x1       = AOMMIN(width_y, blk_x + BW + max_mv_x + AOM_INTERP_EXTEND);
+    const int32_t y0       = AOMMAX(0, blk_y + min_mv_y - AOM_INTERP_EXTEND);
+    const int32_t y1       = AOMMIN(height_y, blk_y + BH + max_mv_y + AOM_INTERP_EXTEND);
+
+    if (x1 <= x0 || y1 <= y0) return;
+    pack2d_src(pic_ptr_ref->buffer_y + y0 * pic_ptr_ref->stride_y + x0,
+               pic_ptr_ref->stride_y,
+               pic_ptr_ref->buffer_bit_inc_y + y0 * pic_ptr_ref->stride_bit_inc_y + x0,
+               pic_ptr_ref->stride_bit_inc_y,
+               ref_16bit[C_Y] + y0 * pic_ptr_ref->stride_y + x0,
+               pic_ptr_ref->stride_y,
+               x1 - x0,
+               y1 - y0);
+
+    // Chroma MVs have the same size in chroma samples, add the chroma taps
+    const int32_t cx0 = AOMMAX(0, (x0 >> ss_x) - AOM_INTERP_EXTEND);
+    const int32_t cx1 =
+        AOMMIN((int32_t)pic_ptr_ref->stride_cb, ((x1 + ss_x) >> ss_x) + AOM_INTERP_EXTEND);
+    const int32_t cy0 = AOMMAX(0, (y0 >> ss_y) - AOM_INTERP_EXTEND);
+    const int32_t cy1 = AOMMIN(height_y >> ss_y, ((y1 + ss_y) >> ss_y) + AOM_INTERP_EXTEND);
+
+    pack2d_src(pic_ptr_ref->buffer_cb + cy0 * pic_ptr_ref->stride_cb + cx0,
+               pic_ptr_ref->stride_cb,
+               pic_ptr_ref->buffer_bit_inc_cb + cy0 * pic_ptr_ref->stride_bit_inc_cb + cx0,
+               pic_ptr_ref->stride_bit_inc_cb,
+               ref_16bit[C_U] + cy0 * pic_ptr_ref->stride_cb + cx0,
+               pic_ptr_ref->stride_cb,
+               cx1 - cx0,
+               cy1 - cy0);
+    pack2d_src(pic_ptr_ref->buffer_cr + cy0 * pic_ptr_ref->stride_cr + cx0,
+               pic_ptr_ref->stride_cr,
+               pic_ptr_ref->buffer_bit_inc_cr + cy0 * pic_ptr_ref->stride_bit_inc_cr + cx0,
+               pic_ptr_ref->stride_bit_inc_cr,
+               ref_16bit[C_V] + cy0 * pic_ptr_ref->stride_cr + cx0,
+               pic_ptr_ref->stride_cr,
+               cx1 - cx0,
+               cy1 - cy0);
+}
+
 static void tf_inter_prediction(PictureParentControlSet *pcs_ptr, MeContext *context_ptr,
                                 EbPictureBufferDesc *pic_ptr_ref, EbByte *pred,
                                 uint16_t **pred_16bit, uint32_t *stride_pred, EbByte *src,
-                                uint16_t **src_16bit, uint32_t *stride_src, uint32_t sb_origin_x,
-                                uint32_t sb_origin_y, uint32_t ss_x, uint32_t ss_y,
-                                const int *use_16x16_subblocks, int encoder_bit_depth) {
+                                uint16_t **src_16bit, uint32_t *stride_src, uint16_t **ref_16bit,
+                                uint32_t sb_origin_x, uint32_t sb_origin_y, uint32_t ss_x,
+                                uint32_t ss_y, const int *use_16x16_subblocks,
+                                const int *use_blk_32x32, int encoder_bit_depth) {
     const InterpFilters interp_filters = av1_make_interp_filters(MULTITAP_SHARP, MULTITAP_SHARP);
 
     EbBool is_highbd = (encoder_bit_depth == 8) ? (uint8_t)EB_FALSE : (uint8_t)EB_TRUE;
@@ -1236,9 +1288,9 @@ static void tf_inter_prediction(PictureParentControlSet *pcs_ptr, MeContext *con
         prediction_ptr.buffer_cb = (uint8_t *)pred_16bit[C_U];
         prediction_ptr.buffer_cr = (uint8_t *)pred_16bit[C_V];
 
-        reference_ptr.buffer_y  = (uint8_t *)malloc(pic_ptr_ref->luma_size * sizeof(uint16_t));
-        reference_ptr.buffer_cb = (uint8_t *)malloc(pic_ptr_ref->chroma_size * sizeof(uint16_t));
-        reference_ptr.buffer_cr = (uint8_t *)malloc(pic_ptr_ref->chroma_size * sizeof(uint16_t));
+        reference_ptr.buffer_y  = (uint8_t *)ref_16bit[C_Y];
+        reference_ptr.buffer_cb = (uint8_t *)ref_16bit[C_U];
+        reference_ptr.buffer_cr = (uint8_t *)ref_16bit[C_V];
 
         reference_ptr.origin_x  = pic_ptr_ref->origin_x;
         reference_ptr.origin_y  = pic_ptr_ref->origin_y;
@@ -1248,37 +1300,13 @@ static void tf_inter_prediction(PictureParentControlSet *pcs_ptr, MeContext *con
         reference_ptr.width     = pic_ptr_ref->width;
         reference_ptr.height    = pic_ptr_ref->height;
 
-        uint32_t height_y = (uint32_t)(2 * reference_ptr.origin_y + reference_ptr.height);
-
-        pack2d_src(pic_ptr_ref->buffer_y,
-                   reference_ptr.stride_y,
-                   pic_ptr_ref->buffer_bit_inc_y,
-                   pic_ptr_ref->stride_bit_inc_y,
-                   (uint16_t *)reference_ptr.buffer_y,
-                   reference_ptr.stride_y,
-                   reference_ptr.stride_y,
-                   height_y);
-
-        pack2d_src(pic_ptr_ref->buffer_cb,
-                   reference_ptr.stride_cb,
-                   pic_ptr_ref->buffer_bit_inc_cb,
-                   pic_ptr_ref->stride_bit_inc_cb,
-                   (uint16_t *)reference_ptr.buffer_cb,
-                   reference_ptr.stride_cb,
-                   reference_ptr.stride_cb,
-                   height_y >> ss_y);
-
-        pack2d_src(pic_ptr_ref->buffer_cr,
-                   reference_ptr.stride_cr,
-                   pic_ptr_ref->buffer_bit_inc_cr,
-                   pic_ptr_ref->stride_bit_inc_cr,
-                   (uint16_t *)reference_ptr.buffer_cr,
-                   reference_ptr.stride_cr,
-                   reference_ptr.stride_cr,
-                   height_y >> ss_y);
+        pack_highbd_ref_window(
+            context_ptr, pic_ptr_ref, ref_16bit, sb_origin_x, sb_origin_y, ss_x, ss_y);
     }
 
     for (uint32_t idx_32x32 = 0; idx_32x32 < 4; idx_32x32++) {
+        // 32x32 blocks not filtered with this frame are not predicted
+        if (!use_blk_32x32[idx_32x32]) continue;
         if (use_16x16_subblocks[idx_32x32] != 0) {
             uint32_t bsize = 16;
 
@@ -1433,110 +1461,91 @@ static void tf_inter_prediction(PictureParentControlSet *pcs_ptr, MeContext *con
             }
         }
     }
+}
 
-    if (is_highbd) {
-        free(reference_ptr.buffer_y);
-        free(reference_ptr.buffer_cb);
-        free(reference_ptr.buffer_cr);
+// Normalize the filter output of a plane of the block and write it to the filtered picture
+static void normalize_filtered_plane(uint8_t *dst, uint16_t *dst_16bit, uint32_t dst_stride,
+                                     const uint32_t *accum, const uint16_t *count,
+                                     uint32_t accum_stride, uint16_t blk_width,
+                                     uint16_t blk_height, uint64_t *filtered_sse,
+                                     EbBool is_highbd) {
+    for (uint16_t i = 0; i < blk_height; i++) {
+        for (uint16_t j = 0; j < blk_width; j++) {
+            const uint32_t k   = i * accum_stride + j;
+            const uint32_t pos = i * dst_stride + j;
+            const int32_t  pel = (int32_t)OD_DIVU(accum[k] + (count[k] >> 1), count[k]);
+            const int32_t  diff =
+                (is_highbd ? (int32_t)dst_16bit[pos] : (int32_t)dst[pos]) - pel;
+
+            *filtered_sse += (uint64_t)((int64_t)diff * diff);
+            if (!is_highbd)
+                dst[pos] = (uint8_t)pel;
+            else
+                dst_16bit[pos] = (uint16_t)pel;
+        }
     }
 }
 
 static void get_final_filtered_pixels(EbByte *   src_center_ptr_start,
                                       uint16_t **altref_buffer_highbd_start, uint32_t **accum,
                                       uint16_t **count, const uint32_t *stride,
-                                      int blk_y_src_offset, int blk_ch_src_offset,
-                                      uint16_t blk_width_ch, uint16_t blk_height_ch,
+                                      const uint32_t *stride_pred, int blk_y_src_offset,
+                                      int blk_ch_src_offset, uint16_t blk_width,
+                                      uint16_t blk_height, uint32_t ss_x, uint32_t ss_y,
                                       uint64_t *filtered_sse, uint64_t *filtered_sse_uv,
                                       EbBool is_highbd) {
-    int i, j, k;
+    const int blk_src_offset[COLOR_CHANNELS] = {
+        blk_y_src_offset, blk_ch_src_offset, blk_ch_src_offset};
+
+    for (int c = C_Y; c <= C_V; c++) {
+        normalize_filtered_plane(
+            is_highbd ? NULL : src_center_ptr_start[c] + blk_src_offset[c],
+            is_highbd ? altref_buffer_highbd_start[c] + blk_src_offset[c] : NULL,
+            stride[c],
+            accum[c],
+            count[c],
+            stride_pred[c],
+            c == C_Y ? blk_width : (uint16_t)(blk_width >> ss_x),
+            c == C_Y ? blk_height : (uint16_t)(blk_height >> ss_y),
+            c == C_Y ? filtered_sse : filtered_sse_uv,
+            is_highbd);
+    }
+}
 
-    if (!is_highbd) {
-        // Process luma
-        int pos = blk_y_src_offset;
-        for (i = 0, k = 0; i < BH; i++) {
-            for (j = 0; j < BW; j++, k++) {
-                (*filtered_sse) +=
-                    (uint64_t)(
-                        (int32_t)src_center_ptr_start[C_Y][pos] -
-                        (int32_t)OD_DIVU(accum[C_Y][k] + (count[C_Y][k] >> 1), count[C_Y][k])) *
-                    ((int32_t)src_center_ptr_start[C_Y][pos] -
-                     (int32_t)OD_DIVU(accum[C_Y][k] + (count[C_Y][k] >> 1), count[C_Y][k]));
-                src_center_ptr_start[C_Y][pos] =
-                    (uint8_t)OD_DIVU(accum[C_Y][k] + (count[C_Y][k] >> 1), count[C_Y][k]);
-                pos++;
-            }
-            pos += stride[C_Y] - BW;
-        }
-        // Process chroma
-        pos = blk_ch_src_offset;
-        for (i = 0, k = 0; i < blk_height_ch; i++) {
-            for (j = 0; j < blk_width_ch; j++, k++) {
-                (*filtered_sse_uv) +=
-                    (uint64_t)(
-                        (int32_t)src_center_ptr_start[C_U][pos] -
-                        (int32_t)OD_DIVU(accum[C_U][k] + (count[C_U][k] >> 1), count[C_U][k])) *
-                    ((int32_t)src_center_ptr_start[C_U][pos] -
-                     (int32_t)OD_DIVU(accum[C_U][k] + (count[C_U][k] >> 1), count[C_U][k]));
-                (*filtered_sse_uv) +=
-                    (uint64_t)(
-                        (int32_t)src_center_ptr_start[C_V][pos] -
-                        (int32_t)OD_DIVU(accum[C_V][k] + (count[C_V][k] >> 1), count[C_V][k])) *
-                    ((int32_t)src_center_ptr_start[C_V][pos] -
-                     (int32_t)OD_DIVU(accum[C_V][k] + (count[C_V][k] >> 1), count[C_V][k]));
-                src_center_ptr_start[C_U][pos] =
-                    (uint8_t)OD_DIVU(accum[C_U][k] + (count[C_U][k] >> 1), count[C_U][k]);
-                src_center_ptr_start[C_V][pos] =
-                    (uint8_t)OD_DIVU(accum[C_V][k] + (count[C_V][k] >> 1), count[C_V][k]);
-                pos++;
-            }
-            pos += stride[C_U] - blk_width_ch;
-        }
-    } else {
-        // Process luma
-        int pos = blk_y_src_offset;
-        for (i = 0, k = 0; i < BH; i++) {
-            for (j = 0; j < BW; j++, k++) {
-                (*filtered_sse) +=
-                    (uint64_t)(
-                        (int32_t)altref_buffer_highbd_start[C_Y][pos] -
-                        (int32_t)OD_DIVU(accum[C_Y][k] + (count[C_Y][k] >> 1), count[C_Y][k])) *
-                    ((int32_t)altref_buffer_highbd_start[C_Y][pos] -
-                     (int32_t)OD_DIVU(accum[C_Y][k] + (count[C_Y][k] >> 1), count[C_Y][k]));
-                altref_buffer_highbd_start[C_Y][pos] =
-                    (uint16_t)OD_DIVU(accum[C_Y][k] + (count[C_Y][k] >> 1), count[C_Y][k]);
-                pos++;
-            }
-            pos += stride[C_Y] - BW;
-        }
-        // Process chroma
-        pos = blk_ch_src_offset;
-        for (i = 0, k = 0; i < blk_height_ch; i++) {
-            for (j = 0; j < blk_width_ch; j++, k++) {
-                (*filtered_sse_uv) +=
-                    (uint64_t)(
-                        (int32_t)altref_buffer_highbd_start[C_U][pos] -
-                        (int32_t)OD_DIVU(accum[C_U][k] + (count[C_U][k] >> 1), count[C_U][k])) *
-                    ((int32_t)altref_buffer_highbd_start[C_U][pos] -
-                     (int32_t)OD_DIVU(accum[C_U][k] + (count[C_U][k] >> 1), count[C_U][k]));
-                (*filtered_sse_uv) +=
-                    (uint64_t)(
-                        (int32_t)altref_buffer_highbd_start[C_V][pos] -
-                        (int32_t)OD_DIVU(accum[C_V][k] + (count[C_V][k] >> 1), count[C_V][k])) *
-                    ((int32_t)altref_buffer_highbd_start[C_V][pos] -
-                     (int32_t)OD_DIVU(accum[C_V][k] + (count[C_V][k] >> 1), count[C_V][k]));
-                altref_buffer_highbd_start[C_U][pos] =
-                    (uint16_t)OD_DIVU(accum[C_U][k] + (count[C_U][k] >> 1), count[C_U][k]);
-                altref_buffer_highbd_start[C_V][pos] =
-                    (uint16_t)OD_DIVU(accum[C_V][k] + (count[C_V][k] >> 1), count[C_V][k]);
-                pos++;
-            }
-            pos += stride[C_U] - blk_width_ch;
-        }
+// Order the frames by distance to the central frame, alternating past and future frames, so that
+// each direction is processed from the adjacent frame outwards
+static void get_tf_frame_order(int *frame_order, int num_frames, int index_center) {
+    int n = 0;
+
+    frame_order[n++] = index_center;
+    for (int dist = 1; n < num_frames; dist++) {
+        if (index_center - dist >= 0) frame_order[n++] = index_center - dist;
+        if (index_center + dist < num_frames) frame_order[n++] = index_center + dist;
+    }
+}
+
+// Adaptive frame selection for the 32x32 blocks of a frame, from their ME SAD. The adjacent frame
+// of each direction is always used and gives the reference SAD. A farther frame is dropped for a
+// block whose SAD grows past the reference (e.g. across an occlusion), and so are the frames
+// beyond it in the same direction.
+static void select_tf_blocks(const uint32_t *sad_32x32, uint32_t *ref_sad_32x32, int distance,
+                             int *active_blk_32x32, int *use_blk_32x32) {
+    for (int idx_32x32 = 0; idx_32x32 < N_32X32_BLOCKS; idx_32x32++) {
+        if (distance == 1)
+            ref_sad_32x32[idx_32x32] = sad_32x32[idx_32x32];
+        else if ((uint64_t)sad_32x32[idx_32x32] * TF_ADAPTIVE_SAD_DEN >
+                 (uint64_t)ref_sad_32x32[idx_32x32] * TF_ADAPTIVE_SAD_NUM +
+                     TF_ADAPTIVE_SAD_OFFSET * (BLK_PELS >> 2) * TF_ADAPTIVE_SAD_DEN)
+            active_blk_32x32[idx_32x32] = 0;
+        use_blk_32x32[idx_32x32] = active_blk_32x32[idx_32x32];
     }
 }
 
 // Produce the filtered alt-ref picture
 // - core function
+// The motion compensated 64x64 blocks of all the frames are computed first, then the filtering
+// runs one 32x32 block at a time through all the frames, so that its accumulators stay in the L1
+// cache until they are normalized into the filtered picture.
 static EbErrorType produce_temporally_filtered_pic(
     PictureParentControlSet **list_picture_control_set_ptr,
     EbPictureBufferDesc **list_input_picture_ptr, uint8_t altref_strength, uint8_t index_center,
@@ -1549,16 +1558,41 @@ static EbErrorType produce_temporally_filtered_pic(
         accumulator, accumulator + BLK_PELS, accumulator + (BLK_PELS << 1)};
     uint16_t *count[COLOR_CHANNELS] = {counter, counter + BLK_PELS, counter + (BLK_PELS << 1)};
 
-    EbByte    predictor       = {NULL};
-    uint16_t *predictor_16bit = {NULL};
+    PictureParentControlSet *picture_control_set_ptr_central =
+        list_picture_control_set_ptr[index_center];
+    EbPictureBufferDesc *input_picture_ptr_central = list_input_picture_ptr[index_center];
+    const int            num_frames = picture_control_set_ptr_central->past_altref_nframes +
+                           picture_control_set_ptr_central->future_altref_nframes + 1;
+    const EbBool         adaptive_altref =
+        picture_control_set_ptr_central->scs_ptr->static_config.adaptive_altref;
+    int                  frame_order[ALTREF_MAX_NFRAMES];
+    if (adaptive_altref)
+        get_tf_frame_order(frame_order, num_frames, index_center);
+    else
+        for (frame_index = 0; frame_index < num_frames; frame_index++)
+            frame_order[frame_index] = frame_index;
+
+    // Predicted blocks of all the frames, and 16 bit references packed around the block
+    EbByte    predictor                                      = NULL;
+    uint16_t *predictor_16bit                                = NULL;
+    uint16_t *ref_16bit[COLOR_CHANNELS]                      = {NULL};
+    EbByte    pred[ALTREF_MAX_NFRAMES][COLOR_CHANNELS]       = {{NULL}};
+    uint16_t *pred_16bit[ALTREF_MAX_NFRAMES][COLOR_CHANNELS] = {{NULL}};
     if (!is_highbd) {
-        EB_MALLOC_ALIGNED_ARRAY(predictor, BLK_PELS * COLOR_CHANNELS);
+        EB_CALLOC_ALIGNED_ARRAY(predictor, BLK_PELS * COLOR_CHANNELS * num_frames);
+        for (frame_index = 0; frame_index < num_frames; frame_index++)
+            for (int c = C_Y; c <= C_V; c++)
+                pred[frame_index][c] = predictor + (frame_index * COLOR_CHANNELS + c) * BLK_PELS;
     } else {
-        EB_MALLOC_ALIGNED_ARRAY(predictor_16bit, BLK_PELS * COLOR_CHANNELS);
+        EB_CALLOC_ALIGNED_ARRAY(predictor_16bit, BLK_PELS * COLOR_CHANNELS * num_frames);
+        for (frame_index = 0; frame_index < num_frames; frame_index++)
+            for (int c = C_Y; c <= C_V; c++)
+                pred_16bit[frame_index][c] =
+                    predictor_16bit + (frame_index * COLOR_CHANNELS + c) * BLK_PELS;
+        EB_MALLOC_ARRAY(ref_16bit[C_Y], input_picture_ptr_central->luma_size);
+        EB_MALLOC_ARRAY(ref_16bit[C_U], input_picture_ptr_central->chroma_size);
+        EB_MALLOC_ARRAY(ref_16bit[C_V], input_picture_ptr_central->chroma_size);
     }
-    EbByte    pred[COLOR_CHANNELS] = {predictor, predictor + BLK_PELS, predictor + (BLK_PELS << 1)};
-    uint16_t *pred_16bit[COLOR_CHANNELS] = {
-        predictor_16bit, predictor_16bit + BLK_PELS, predictor_16bit + (BLK_PELS << 1)};
 
     EbByte    src_center_ptr_start[COLOR_CHANNELS], src_center_ptr[COLOR_CHANNELS] = {NULL};
     uint16_t *altref_buffer_highbd_start[COLOR_CHANNELS],
@@ -1567,10 +1601,6 @@ static EbErrorType produce_temporally_filtered_pic(
     uint32_t blk_row, blk_col;
     int      blk_y_src_offset = 0, blk_ch_src_offset = 0;
 
-    PictureParentControlSet *picture_control_set_ptr_central =
-        list_picture_control_set_ptr[index_center];
-    EbPictureBufferDesc *input_picture_ptr_central = list_input_picture_ptr[index_center];
-
     int encoder_bit_depth =
         (int)picture_control_set_ptr_central->scs_ptr->static_config.encoder_bit_depth;
 
@@ -1648,212 +1678,243 @@ static EbErrorType produce_temporally_filtered_pic(
             blk_y_src_offset  = (blk_col * BW) + (blk_row * BH) * stride[C_Y];
             blk_ch_src_offset = (blk_col * blk_width_ch) + (blk_row * blk_height_ch) * stride[C_U];
 
-            // reset accumulator and count
-            memset(accumulator, 0, BLK_PELS * COLOR_CHANNELS * sizeof(accumulator[0]));
-            memset(counter, 0, BLK_PELS * COLOR_CHANNELS * sizeof(counter[0]));
-
-            int blk_fw[N_16X16_BLOCKS];
+            int blk_fw[ALTREF_MAX_NFRAMES][N_16X16_BLOCKS];
+            int use_blk_32x32[ALTREF_MAX_NFRAMES][N_32X32_BLOCKS];
+            // 32x32 blocks still filtered with the frames of each direction (past, future)
+            int      active_blk_32x32[2][N_32X32_BLOCKS] = {{1, 1, 1, 1}, {1, 1, 1, 1}};
+            uint32_t ref_sad_32x32[2][N_32X32_BLOCKS];
             int use_16x16_subblocks[N_32X32_BLOCKS] = {0};
             int me_16x16_subblock_vf[N_16X16_BLOCKS];
             int me_32x32_subblock_vf[N_32X32_BLOCKS];
 
-            populate_list_with_value(blk_fw, 16, INIT_WEIGHT);
-
-            // for every frame to filter
-            for (frame_index = 0;
-                 frame_index < (picture_control_set_ptr_central->past_altref_nframes +
-                                picture_control_set_ptr_central->future_altref_nframes + 1);
-                 frame_index++) {
-                if (!is_highbd) {
-                    src_center_ptr[C_Y] = src_center_ptr_start[C_Y] + blk_y_src_offset;
-                    src_center_ptr[C_U] = src_center_ptr_start[C_U] + blk_ch_src_offset;
-                    src_center_ptr[C_V] = src_center_ptr_start[C_V] + blk_ch_src_offset;
-                } else {
-                    altref_buffer_highbd_ptr[C_Y] =
-                        altref_buffer_highbd_start[C_Y] + blk_y_src_offset;
-                    altref_buffer_highbd_ptr[C_U] =
-                        altref_buffer_highbd_start[C_U] + blk_ch_src_offset;
-                    altref_buffer_highbd_ptr[C_V] =
-                        altref_buffer_highbd_start[C_V] + blk_ch_src_offset;
-                }
+            if (!is_highbd) {
+                src_center_ptr[C_Y] = src_center_ptr_start[C_Y] + blk_y_src_offset;
+                src_center_ptr[C_U] = src_center_ptr_start[C_U] + blk_ch_src_offset;
+                src_center_ptr[C_V] = src_center_ptr_start[C_V] + blk_ch_src_offset;
+            } else {
+                altref_buffer_highbd_ptr[C_Y] = altref_buffer_highbd_start[C_Y] + blk_y_src_offset;
+                altref_buffer_highbd_ptr[C_U] = altref_buffer_highbd_start[C_U] + blk_ch_src_offset;
+                altref_buffer_highbd_ptr[C_V] = altref_buffer_highbd_start[C_V] + blk_ch_src_offset;
+            }
 
-                // ------------
-                // Step 1: motion estimation + compensation
-                // ------------
+            // ------------
+            // Step 1: motion estimation + compensation, for every frame to filter
+            // ------------
+            for (int order_index = 0; order_index < num_frames; order_index++) {
+                frame_index = frame_order[order_index];
 #if DIST_BASED_ME_SEARCH_AREA
                 me_context_ptr->me_context_ptr->tf_frame_index = frame_index ;
                 me_context_ptr->me_context_ptr->tf_index_center = index_center;
 #endif
                 // if frame to process is the center frame
                 if (frame_index == index_center) {
-                    // skip MC (central frame)
-
-                    populate_list_with_value(blk_fw, N_16X16_BLOCKS, 2);
-                    populate_list_with_value(use_16x16_subblocks, N_32X32_BLOCKS, 0);
-
-                    if (!is_highbd) {
-                        pic_copy_kernel_8bit(
-                            src_center_ptr[C_Y], stride[C_Y], pred[C_Y], stride_pred[C_Y], BW, BH);
-                        pic_copy_kernel_8bit(src_center_ptr[C_U],
-                                             stride[C_U],
-                                             pred[C_U],
-                                             stride_pred[C_U],
-                                             blk_width_ch,
-                                             blk_height_ch);
-                        pic_copy_kernel_8bit(src_center_ptr[C_V],
-                                             stride[C_V],
-                                             pred[C_V],
-                                             stride_pred[C_V],
-                                             blk_width_ch,
-                                             blk_height_ch);
-                    } else {
-                        pic_copy_kernel_16bit(altref_buffer_highbd_ptr[C_Y],
-                                              stride[C_Y],
-                                              pred_16bit[C_Y],
-                                              stride_pred[C_Y],
-                                              BW,
-                                              BH);
-                        pic_copy_kernel_16bit(altref_buffer_highbd_ptr[C_U],
-                                              stride[C_U],
-                                              pred_16bit[C_U],
-                                              stride_pred[C_U],
-                                              blk_width_ch,
-                                              blk_height_ch);
-                        pic_copy_kernel_16bit(altref_buffer_highbd_ptr[C_V],
-                                              stride[C_V],
-                                              pred_16bit[C_V],
-                                              stride_pred[C_V],
-                                              blk_width_ch,
-                                              blk_height_ch);
-                    }
+                    // skip MC (central frame), it is filtered from the source
+                    populate_list_with_value(blk_fw[frame_index], N_16X16_BLOCKS, 2);
+                    populate_list_with_value(use_blk_32x32[frame_index], N_32X32_BLOCKS, 1);
+                    continue;
+                }
 
-                } else {
-                    // Initialize ME context
-                    create_me_context_and_picture_control(
-                        me_context_ptr,
-                        list_picture_control_set_ptr[frame_index],
-                        list_picture_control_set_ptr[index_center],
-                        input_picture_ptr_central,
-                        blk_row,
-                        blk_col,
-                        ss_x,
-                        ss_y);
-
-                    // Perform ME - context_ptr will store the outputs (MVs, buffers, etc)
-                    // Block-based MC using open-loop HME + refinement
-                    motion_estimate_sb(
-                        picture_control_set_ptr_central, // source picture control set -> references come from here
-                        (uint32_t)blk_row * blk_cols + blk_col,
-                        (uint32_t)blk_col * BW, // x block
-                        (uint32_t)blk_row * BH, // y block
-                        context_ptr,
-                        input_picture_ptr_central); // source picture
-
-                    EbBool use_16x16_subblocks_only =
-                        EB_TRUE; // TODO: hardcoded to use 16x16 subblocks only, however,
-                        // the support for the use of 32x32 subblocks as well is almost complete
-                        // experiments have shown low gains by adding this possibility
-                    populate_list_with_value(use_16x16_subblocks, N_32X32_BLOCKS, 1);
-
-                    // Perform MC using the information acquired using the ME step
-                    tf_inter_prediction(picture_control_set_ptr_central,
-                                        context_ptr,
-                                        list_input_picture_ptr[frame_index],
-                                        pred,
-                                        pred_16bit,
-                                        stride_pred,
-                                        src_center_ptr,
-                                        altref_buffer_highbd_ptr,
-                                        stride,
-                                        (uint32_t)blk_col * BW,
-                                        (uint32_t)blk_row * BH,
-                                        ss_x,
-                                        ss_y,
-                                        use_16x16_subblocks,
-                                        encoder_bit_depth);
-
-                    // Retrieve distortion (variance) on 32x32 and 16x16 sub-blocks
-                    if (!is_highbd)
-                        get_me_distortion(me_32x32_subblock_vf,
-                                          me_16x16_subblock_vf,
-                                          pred[C_Y],
-                                          stride_pred[C_Y],
-                                          src_center_ptr[C_Y],
-                                          stride[C_Y]);
-                    else
-                        get_me_distortion_highbd(me_32x32_subblock_vf,
-                                                 me_16x16_subblock_vf,
-                                                 pred_16bit[C_Y],
-                                                 stride_pred[C_Y],
-                                                 altref_buffer_highbd_ptr[C_Y],
-                                                 stride[C_Y]);
-
-                    // Get sub-block filter weights depending on the variance
-                    get_blk_fw_using_dist(me_32x32_subblock_vf,
-                                          me_16x16_subblock_vf,
-                                          use_16x16_subblocks_only,
-                                          blk_fw,
-                                          is_highbd);
+                const int dir = frame_index < index_center ? 0 : 1;
+                // the adaptive mode skips the frames no block of the direction uses any more
+                if (adaptive_altref &&
+                    !(active_blk_32x32[dir][0] | active_blk_32x32[dir][1] |
+                      active_blk_32x32[dir][2] | active_blk_32x32[dir][3])) {
+                    populate_list_with_value(use_blk_32x32[frame_index], N_32X32_BLOCKS, 0);
+                    continue;
                 }
 
-                // ------------
-                // Step 2: temporal filtering using the motion compensated blocks
-                // ------------
+                // Initialize ME context
+                create_me_context_and_picture_control(
+                    me_context_ptr,
+                    list_picture_control_set_ptr[frame_index],
+                    list_picture_control_set_ptr[index_center],
+                    input_picture_ptr_central,
+                    blk_row,
+                    blk_col,
+                    ss_x,
+                    ss_y);
+
+                // Perform ME - context_ptr will store the outputs (MVs, buffers, etc)
+                // Block-based MC using open-loop HME + refinement
+                motion_estimate_sb(
+                    picture_control_set_ptr_central, // source picture control set -> references come from here
+                    (uint32_t)blk_row * blk_cols + blk_col,
+                    (uint32_t)blk_col * BW, // x block
+                    (uint32_t)blk_row * BH, // y block
+                    context_ptr,
+                    input_picture_ptr_central); // source picture
+
+                EbBool use_16x16_subblocks_only =
+                    EB_TRUE; // TODO: hardcoded to use 16x16 subblocks only, however,
+                // the support for the use of 32x32 subblocks as well is almost complete
+                // experiments have shown low gains by adding this possibility
+                populate_list_with_value(use_16x16_subblocks, N_32X32_BLOCKS, 1);
+
+                if (adaptive_altref)
+                    select_tf_blocks(context_ptr->p_best_sad_32x32,
+                                     ref_sad_32x32[dir],
+                                     ABS(frame_index - index_center),
+                                     active_blk_32x32[dir],
+                                     use_blk_32x32[frame_index]);
+                else
+                    populate_list_with_value(use_blk_32x32[frame_index], N_32X32_BLOCKS, 1);
+
+                // Perform MC using the information acquired using the ME step
+                tf_inter_prediction(picture_control_set_ptr_central,
+                                    context_ptr,
+                                    list_input_picture_ptr[frame_index],
+                                    pred[frame_index],
+                                    pred_16bit[frame_index],
+                                    stride_pred,
+                                    src_center_ptr,
+                                    altref_buffer_highbd_ptr,
+                                    stride,
+                                    ref_16bit,
+                                    (uint32_t)blk_col * BW,
+                                    (uint32_t)blk_row * BH,
+                                    ss_x,
+                                    ss_y,
+                                    use_16x16_subblocks,
+                                    use_blk_32x32[frame_index],
+                                    encoder_bit_depth);
+
+                // Retrieve distortion (variance) on 32x32 and 16x16 sub-blocks
+                if (!is_highbd)
+                    get_me_distortion(me_32x32_subblock_vf,
+                                      me_16x16_subblock_vf,
+                                      pred[frame_index][C_Y],
+                                      stride_pred[C_Y],
+                                      src_center_ptr[C_Y],
+                                      stride[C_Y]);
+                else
+                    get_me_distortion_highbd(me_32x32_subblock_vf,
+                                             me_16x16_subblock_vf,
+                                             pred_16bit[frame_index][C_Y],
+                                             stride_pred[C_Y],
+                                             altref_buffer_highbd_ptr[C_Y],
+                                             stride[C_Y]);
+
+                // Get sub-block filter weights depending on the variance
+                get_blk_fw_using_dist(me_32x32_subblock_vf,
+                                      me_16x16_subblock_vf,
+                                      use_16x16_subblocks_only,
+                                      blk_fw[frame_index],
+                                      is_highbd);
+            }
 
-                // if frame to process is the center frame
-                if (frame_index == index_center) {
-                    if (!is_highbd)
-                        apply_filtering_central(pred, accum, count, BW, BH, ss_x, ss_y);
-                    else
-                        apply_filtering_central_highbd(
-                            pred_16bit, accum, count, BW, BH, ss_x, ss_y);
-                } else {
-                    // split filtering function into 32x32 blocks
-                    // TODO: implement a 64x64 SIMD version
-                    for (int block_row = 0; block_row < 2; block_row++) {
-                        for (int block_col = 0; block_col < 2; block_col++) {
+            // ------------
+            // Step 2: temporal filtering using the motion compensated blocks, and normalization,
+            // one 32x32 block at a time
+            // ------------
+            for (int block_row = 0; block_row < 2; block_row++) {
+                for (int block_col = 0; block_col < 2; block_col++) {
+                    const uint16_t sub_blk_width  = BW >> 1;
+                    const uint16_t sub_blk_height = BH >> 1;
+                    const int      sub_blk_y_offset =
+                        block_row * sub_blk_height * stride[C_Y] + block_col * sub_blk_width;
+                    const int sub_blk_ch_offset =
+                        block_row * (sub_blk_height >> ss_y) * stride[C_U] +
+                        block_col * (sub_blk_width >> ss_x);
+                    uint32_t *sub_blk_accum[COLOR_CHANNELS];
+                    uint16_t *sub_blk_count[COLOR_CHANNELS];
+                    EbByte    sub_blk_src[COLOR_CHANNELS]        = {NULL};
+                    uint16_t *sub_blk_src_16bit[COLOR_CHANNELS] = {NULL};
+
+                    for (int c = C_Y; c <= C_V; c++) {
+                        const uint16_t w = c == C_Y ? sub_blk_width : sub_blk_width >> ss_x;
+                        const uint16_t h = c == C_Y ? sub_blk_height : sub_blk_height >> ss_y;
+                        const int      offset =
+                            block_row * h * stride_pred[c] + block_col * w;
+
+                        sub_blk_accum[c] = accum[c] + offset;
+                        sub_blk_count[c] = count[c] + offset;
+                        for (uint16_t i = 0; i < h; i++) {
+                            memset(sub_blk_accum[c] + i * stride_pred[c], 0, w * sizeof(uint32_t));
+                            memset(sub_blk_count[c] + i * stride_pred[c], 0, w * sizeof(uint16_t));
+                        }
+                        if (!is_highbd)
+                            sub_blk_src[c] = src_center_ptr[c] +
+                                             (c == C_Y ? sub_blk_y_offset : sub_blk_ch_offset);
+                        else
+                            sub_blk_src_16bit[c] =
+                                altref_buffer_highbd_ptr[c] +
+                                (c == C_Y ? sub_blk_y_offset : sub_blk_ch_offset);
+                    }
+
+                    for (frame_index = 0; frame_index < num_frames; frame_index++) {
+                        if (!use_blk_32x32[frame_index][block_row * 2 + block_col]) continue;
+                        // if frame to process is the center frame
+                        if (frame_index == index_center) {
+                            if (!is_highbd)
+                                apply_filtering_central(sub_blk_src,
+                                                        stride,
+                                                        sub_blk_accum,
+                                                        sub_blk_count,
+                                                        stride_pred,
+                                                        sub_blk_width,
+                                                        sub_blk_height,
+                                                        ss_x,
+                                                        ss_y);
+                            else
+                                apply_filtering_central_highbd(sub_blk_src_16bit,
+                                                               stride,
+                                                               sub_blk_accum,
+                                                               sub_blk_count,
+                                                               stride_pred,
+                                                               sub_blk_width,
+                                                               sub_blk_height,
+                                                               ss_x,
+                                                               ss_y);
+                        } else {
                             apply_filtering_block(block_row,
                                                   block_col,
                                                   src_center_ptr,
                                                   altref_buffer_highbd_ptr,
-                                                  pred,
-                                                  pred_16bit,
+                                                  pred[frame_index],
+                                                  pred_16bit[frame_index],
                                                   accum,
                                                   count,
                                                   stride,
                                                   stride_pred,
-                                                  BW >> 1, // fixed 32x32
-                                                  BH >> 1, // fixed 32x32
+                                                  sub_blk_width,
+                                                  sub_blk_height,
                                                   ss_x, // chroma sub-sampling in x
                                                   ss_y, // chroma sub-sampling in y
                                                   altref_strength,
-                                                  blk_fw,
+                                                  blk_fw[frame_index],
                                                   is_highbd);
                         }
                     }
+
+                    // Normalize filter output to produce temporally filtered frame
+                    get_final_filtered_pixels(src_center_ptr_start,
+                                              altref_buffer_highbd_start,
+                                              sub_blk_accum,
+                                              sub_blk_count,
+                                              stride,
+                                              stride_pred,
+                                              blk_y_src_offset + sub_blk_y_offset,
+                                              blk_ch_src_offset + sub_blk_ch_offset,
+                                              sub_blk_width,
+                                              sub_blk_height,
+                                              ss_x,
+                                              ss_y,
+                                              filtered_sse,
+                                              filtered_sse_uv,
+                                              is_highbd);
                 }
             }
-
-            // Normalize filter output to produce temporally filtered frame
-            get_final_filtered_pixels(src_center_ptr_start,
-                                      altref_buffer_highbd_start,
-                                      accum,
-                                      count,
-                                      stride,
-                                      blk_y_src_offset,
-                                      blk_ch_src_offset,
-                                      blk_width_ch,
-                                      blk_height_ch,
-                                      filtered_sse,
-                                      filtered_sse_uv,
-                                      is_highbd);
         }
     }
 
     if (!is_highbd)
         EB_FREE_ALIGNED_ARRAY(predictor);
-    else
+    else {
         EB_FREE_ALIGNED_ARRAY(predictor_16bit);
+        EB_FREE_ARRAY(ref_16bit[C_Y]);
+        EB_FREE_ARRAY(ref_16bit[C_U]);
+        EB_FREE_ARRAY(ref_16bit[C_V]);
+    }
 
     return EB_ErrorNone;
 }
@@ -55,6 +55,13 @@
 #define OD_DIVU_DMAX (1024)
 #define AHD_TH_WEIGHT 20
 
+// Adaptive frame selection: a 32x32 block stops using the frames of a direction once the ME SAD
+// exceeds (TF_ADAPTIVE_SAD_NUM / TF_ADAPTIVE_SAD_DEN) times the SAD of the adjacent frame, plus
+// TF_ADAPTIVE_SAD_OFFSET per pixel
+#define TF_ADAPTIVE_SAD_NUM 3
+#define TF_ADAPTIVE_SAD_DEN 2
+#define TF_ADAPTIVE_SAD_OFFSET 2
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -632,11 +632,14 @@ void setup_rtcd_internal(CPU_FLAGS flags) {
     SET_AVX2(noise_extract_chroma_weak,
              noise_extract_chroma_weak_c,
              noise_extract_chroma_weak_avx2_intrin);
-    SET_SSE41(
-        svt_av1_apply_filtering, svt_av1_apply_filtering_c, svt_av1_apply_temporal_filter_sse4_1);
-    SET_SSE41(svt_av1_apply_filtering_highbd,
-              svt_av1_apply_filtering_highbd_c,
-              svt_av1_highbd_apply_temporal_filter_sse4_1);
+    SET_SSE41_AVX512(svt_av1_apply_filtering,
+                     svt_av1_apply_filtering_c,
+                     svt_av1_apply_temporal_filter_sse4_1,
+                     svt_av1_apply_temporal_filter_avx512);
+    SET_SSE41_AVX512(svt_av1_apply_filtering_highbd,
+                     svt_av1_apply_filtering_highbd_c,
+                     svt_av1_highbd_apply_temporal_filter_sse4_1,
+                     svt_av1_highbd_apply_temporal_filter_avx512);
     SET_AVX2_AVX512(combined_averaging_ssd,
                     combined_averaging_ssd_c,
                     combined_averaging_ssd_avx2,
@@ -689,6 +692,7 @@ void setup_rtcd_internal(CPU_FLAGS flags) {
                   compute_interm_var_four8x8_helper_sse2,
                   compute_interm_var_four8x8_avx2_intrin);
     SET_AVX2(sad_16b_kernel, sad_16b_kernel_c, sad_16bit_kernel_avx2);
+    SET_AVX2(eb_hist_abs_diff, eb_hist_abs_diff_c, eb_hist_abs_diff_avx2);
     SET_AVX2(av1_compute_cross_correlation,
              av1_compute_cross_correlation_c,
              av1_compute_cross_correlation_avx2);
@@ -699,6 +703,13 @@ void setup_rtcd_internal(CPU_FLAGS flags) {
 
     eb_av1_get_nz_map_contexts = eb_av1_get_nz_map_contexts_c;
     if (flags & HAS_SSE2) eb_av1_get_nz_map_contexts = eb_av1_get_nz_map_contexts_sse2;
+    if (flags & HAS_AVX2) eb_av1_get_nz_map_contexts = eb_av1_get_nz_map_contexts_avx2;
+
+    eb_av1_update_coeff_eob_fast = eb_av1_update_coeff_eob_fast_c;
+    if (flags & HAS_AVX2) eb_av1_update_coeff_eob_fast = eb_av1_update_coeff_eob_fast_avx2;
+#ifndef NON_AVX512_SUPPORT
+    if (flags & HAS_AVX512F) eb_av1_update_coeff_eob_fast = eb_av1_update_coeff_eob_fast_avx512;
+#endif
 
 #if RESTRUCTURE_SAD
     SET_AVX2(pme_sad_loop_kernel, pme_sad_loop_kernel_c, pme_sad_loop_kernel_avx2);
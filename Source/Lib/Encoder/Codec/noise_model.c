@@ -1251,24 +1251,21 @@ static float *get_half_cos_window(int32_t block_size) {
                                              int32_t   w,                                          \
                                              int32_t   h,                                          \
                                              int32_t   stride,                                     \
-                                             int32_t   chroma_sub_w,                               \
-                                             int32_t   chroma_sub_h,                               \
-                                             int32_t   block_size,                                 \
-                                             float     block_normalization) {                          \
-        for (int32_t y = 0; y < (h >> chroma_sub_h); ++y) {                                        \
-            for (int32_t x = 0; x < (w >> chroma_sub_w); ++x) {                                    \
-                const int32_t result_idx = (y + (block_size >> chroma_sub_h)) * result_stride +    \
-                                           x + (block_size >> chroma_sub_w);                       \
-                INT_TYPE new_val =                                                                 \
+                                             int32_t   result_offset_x,                            \
+                                             float     block_normalization) {                      \
+        for (int32_t y = 0; y < h; ++y) {                                                          \
+            for (int32_t x = 0; x < w; ++x) {                                                      \
+                const int32_t result_idx = y * result_stride + x + result_offset_x;                \
+                INT_TYPE      new_val =                                                            \
                     (INT_TYPE)AOMMIN(AOMMAX(result[result_idx] * block_normalization + 0.5f, 0),   \
                                      block_normalization);                                         \
                 const float err = -(((float)new_val) / block_normalization - result[result_idx]);  \
                 denoised[y * stride + x] = new_val;                                                \
-                if (x + 1 < (w >> chroma_sub_w)) { result[result_idx + 1] += err * 7.0f / 16.0f; } \
-                if (y + 1 < (h >> chroma_sub_h)) {                                                 \
+                if (x + 1 < w) { result[result_idx + 1] += err * 7.0f / 16.0f; }                   \
+                if (y + 1 < h) {                                                                   \
                     if (x > 0) { result[result_idx + result_stride - 1] += err * 3.0f / 16.0f; }   \
                     result[result_idx + result_stride] += err * 5.0f / 16.0f;                      \
-                    if (x + 1 < (w >> chroma_sub_w)) {                                             \
+                    if (x + 1 < w) {                                                               \
                         result[result_idx + result_stride + 1] += err * 1.0f / 16.0f;              \
                     }                                                                              \
                 }                                                                                  \
@@ -1279,10 +1276,15 @@ static float *get_half_cos_window(int32_t block_size) {
 DITHER_AND_QUANTIZE(uint8_t, lowbd);
 DITHER_AND_QUANTIZE(uint16_t, highbd);
 
-int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3], int32_t w,
-                                 int32_t h, int32_t stride[3], int32_t chroma_sub[2],
-                                 float *noise_psd[3], int32_t block_size, int32_t bit_depth,
-                                 int32_t use_highbd) {
+/* Wiener filter the luma rows [row_start, row_end) (and the co-located chroma rows)
+ * into denoised. Only the half overlapped blocks touching the band are filtered, and
+ * the accumulation buffer covers the band rows only, so bands can be denoised
+ * independently. The error diffusion of the dithering stops at the band edges. */
+static int32_t wiener_denoise_2d_rows(const uint8_t *const data[3], uint8_t *denoised[3],
+                                      int32_t w, int32_t h, int32_t stride[3],
+                                      int32_t chroma_sub[2], float *noise_psd[3],
+                                      int32_t block_size, int32_t bit_depth, int32_t use_highbd,
+                                      int32_t row_start, int32_t row_end) {
     float *plane = NULL, *window_full = NULL, *window_chroma = NULL;
     DECLARE_ALIGNED(32, float, *block);
     block                          = NULL;
@@ -1292,7 +1294,7 @@ int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised
     const int32_t          num_blocks_w  = (w + block_size - 1) / block_size;
     const int32_t          num_blocks_h  = (h + block_size - 1) / block_size;
     const int32_t          result_stride = (num_blocks_w + 2) * block_size;
-    const int32_t          result_height = (num_blocks_h + 2) * block_size;
+    const int32_t          result_height = row_end - row_start;
     float *                result        = NULL;
     int32_t                init_success  = 1;
     AomFlatBlockFinder     block_finder_full;
@@ -1306,7 +1308,7 @@ int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised
     }
     init_success &=
         eb_aom_flat_block_finder_init(&block_finder_full, block_size, bit_depth, use_highbd);
-    result  = (float *)malloc((num_blocks_h + 2) * block_size * result_stride * sizeof(*result));
+    result  = (float *)malloc(result_height * result_stride * sizeof(*result));
     plane   = (float *)malloc(block_size * block_size * sizeof(*plane));
     block   = (float *)eb_aom_memalign(32, 2 * block_size * block_size * sizeof(*block));
     block_d = (double *)malloc(block_size * block_size * sizeof(*block_d));
@@ -1333,30 +1335,32 @@ int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised
         const int32_t          chroma_sub_h    = c > 0 ? chroma_sub[1] : 0;
         const int32_t          chroma_sub_w    = c > 0 ? chroma_sub[0] : 0;
         struct aom_noise_tx_t *tx              = (c > 0 && chroma_sub[0] > 0) ? tx_chroma : tx_full;
+        const int32_t          block_w         = block_size >> chroma_sub_w;
+        const int32_t          block_h         = block_size >> chroma_sub_h;
+        const int32_t          band_start      = row_start >> chroma_sub_h;
+        const int32_t          band_end        = row_end >> chroma_sub_h;
         if (!data[c] || !denoised[c]) continue;
         if (c > 0 && chroma_sub[0] != 0) block_finder = &block_finder_chroma;
         memset(result, 0, sizeof(*result) * result_stride * result_height);
         // Do overlapped block processing (half overlapped). The block rows can
         // easily be done in parallel
-        for (int32_t offsy = 0; offsy < (block_size >> chroma_sub_h);
-             offsy += (block_size >> chroma_sub_h) / 2) {
-            for (int32_t offsx = 0; offsx < (block_size >> chroma_sub_w);
-                 offsx += (block_size >> chroma_sub_w) / 2) {
+        for (int32_t offsy = 0; offsy < block_h; offsy += block_h / 2) {
+            for (int32_t offsx = 0; offsx < block_w; offsx += block_w / 2) {
                 // Pad the boundary when processing each block-set.
                 for (int32_t by = -1; by < num_blocks_h; ++by) {
+                    const int32_t block_y = by * block_h + offsy;
+                    if (block_y + block_h <= band_start || block_y >= band_end) continue;
                     for (int32_t bx = -1; bx < num_blocks_w; ++bx) {
-                        const int32_t pixels_per_block =
-                            (block_size >> chroma_sub_w) * (block_size >> chroma_sub_h);
-                        eb_aom_flat_block_finder_extract_block(
-                            block_finder,
-                            data[c],
-                            w >> chroma_sub_w,
-                            h >> chroma_sub_h,
-                            stride[c],
-                            bx * (block_size >> chroma_sub_w) + offsx,
-                            by * (block_size >> chroma_sub_h) + offsy,
-                            plane_d,
-                            block_d);
+                        const int32_t pixels_per_block = block_w * block_h;
+                        eb_aom_flat_block_finder_extract_block(block_finder,
+                                                               data[c],
+                                                               w >> chroma_sub_w,
+                                                               h >> chroma_sub_h,
+                                                               stride[c],
+                                                               bx * block_w + offsx,
+                                                               block_y,
+                                                               plane_d,
+                                                               block_d);
                         for (int32_t j = 0; j < pixels_per_block; ++j) {
                             block[j] = (float)block_d[j];
                             plane[j] = (float)plane_d[j];
@@ -1370,16 +1374,15 @@ int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised
                         // it to the sum of plane + block when composing the results).
                         pointwise_multiply(window_function, plane, pixels_per_block);
 
-                        for (int32_t y = 0; y < (block_size >> chroma_sub_h); ++y) {
-                            const int32_t y_result =
-                                y + (by + 1) * (block_size >> chroma_sub_h) + offsy;
-                            for (int32_t x = 0; x < (block_size >> chroma_sub_w); ++x) {
-                                const int32_t x_result =
-                                    x + (bx + 1) * (block_size >> chroma_sub_w) + offsx;
+                        for (int32_t y = AOMMAX(0, band_start - block_y);
+                             y < AOMMIN(block_h, band_end - block_y);
+                             ++y) {
+                            const int32_t y_result = y + block_y - band_start;
+                            for (int32_t x = 0; x < block_w; ++x) {
+                                const int32_t x_result = x + (bx + 1) * block_w + offsx;
                                 result[y_result * result_stride + x_result] +=
-                                    (block[y * (block_size >> chroma_sub_w) + x] +
-                                     plane[y * (block_size >> chroma_sub_w) + x]) *
-                                    window_function[y * (block_size >> chroma_sub_w) + x];
+                                    (block[y * block_w + x] + plane[y * block_w + x]) *
+                                    window_function[y * block_w + x];
                             }
                         }
                     }
@@ -1389,24 +1392,20 @@ int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised
         if (use_highbd) {
             dither_and_quantize_highbd(result,
                                        result_stride,
-                                       (uint16_t *)denoised[c],
-                                       w,
-                                       h,
+                                       (uint16_t *)denoised[c] + band_start * stride[c],
+                                       w >> chroma_sub_w,
+                                       band_end - band_start,
                                        stride[c],
-                                       chroma_sub_w,
-                                       chroma_sub_h,
-                                       block_size,
+                                       block_w,
                                        k_block_normalization);
         } else {
             dither_and_quantize_lowbd(result,
                                       result_stride,
-                                      denoised[c],
-                                      w,
-                                      h,
+                                      denoised[c] + band_start * stride[c],
+                                      w >> chroma_sub_w,
+                                      band_end - band_start,
                                       stride[c],
-                                      chroma_sub_w,
-                                      chroma_sub_h,
-                                      block_size,
+                                      block_w,
                                       k_block_normalization);
         }
     }
@@ -1428,6 +1427,24 @@ int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised
     return init_success;
 }
 
+int32_t eb_aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3], int32_t w,
+                                 int32_t h, int32_t stride[3], int32_t chroma_sub[2],
+                                 float *noise_psd[3], int32_t block_size, int32_t bit_depth,
+                                 int32_t use_highbd) {
+    return wiener_denoise_2d_rows(data,
+                                  denoised,
+                                  w,
+                                  h,
+                                  stride,
+                                  chroma_sub,
+                                  noise_psd,
+                                  block_size,
+                                  bit_depth,
+                                  use_highbd,
+                                  0,
+                                  h);
+}
+
 EbErrorType eb_aom_denoise_and_model_alloc(AomDenoiseAndModel *ctx, int32_t bit_depth,
                                            int32_t block_size, float noise_level) {
     ctx->block_size  = block_size;
@@ -1456,7 +1473,7 @@ static void denoise_and_model_dctor(EbPtr p) {
 EbErrorType denoise_and_model_ctor(AomDenoiseAndModel *object_ptr, EbPtr object_init_data_ptr) {
     DenoiseAndModelInitData *init_data_ptr = (DenoiseAndModelInitData *)object_init_data_ptr;
     EbErrorType              return_error  = EB_ErrorNone;
-    uint32_t                 use_highbd    = init_data_ptr->encoder_bit_depth > EB_8BIT ? 10 : 8;
+    const uint32_t           use_highbd    = init_data_ptr->encoder_bit_depth > EB_8BIT;
 
     int32_t chroma_sub_log2[2] = {1, 1}; //todo: send chroma subsampling
     chroma_sub_log2[0]         = (init_data_ptr->encoder_color_format == EB_YUV444 ? 1 : 2) - 1;
@@ -1486,7 +1503,8 @@ EbErrorType denoise_and_model_ctor(AomDenoiseAndModel *object_ptr, EbPtr object_
                     (object_ptr->uv_stride * (object_ptr->height >> chroma_sub_log2[0]))
                         << use_highbd);
 
-    if (use_highbd) {
+    // The fast film grain path keeps a copy of the noisy source for the noise modeling
+    if (use_highbd || init_data_ptr->fast_film_grain) {
         EB_MALLOC_ARRAY(object_ptr->packed[0], (object_ptr->y_stride * object_ptr->height));
         EB_MALLOC_ARRAY(object_ptr->packed[1],
                         (object_ptr->uv_stride * (object_ptr->height >> chroma_sub_log2[0])));
@@ -1497,12 +1515,25 @@ EbErrorType denoise_and_model_ctor(AomDenoiseAndModel *object_ptr, EbPtr object_
     return return_error;
 }
 
-static int32_t denoise_and_model_realloc_if_necessary(struct AomDenoiseAndModel *ctx,
-                                                      EbPictureBufferDesc *sd, int32_t use_highbd) {
+static void denoise_and_model_init_psd(struct AomDenoiseAndModel *ctx) {
     int32_t chroma_sub_log2[2] = {1, 1}; //todo: send chroma subsampling
 
     const int32_t block_size = ctx->block_size;
 
+    // Simply use a flat PSD (although we could use the flat blocks to estimate
+    // PSD) those to estimate an actual noise PSD)
+    const float y_noise_level =
+        eb_aom_noise_psd_get_default_value(ctx->block_size, ctx->noise_level);
+    const float uv_noise_level =
+        eb_aom_noise_psd_get_default_value(ctx->block_size >> chroma_sub_log2[1], ctx->noise_level);
+    for (int32_t i = 0; i < block_size * block_size; ++i) {
+        ctx->noise_psd[0][i] = y_noise_level;
+        ctx->noise_psd[1][i] = ctx->noise_psd[2][i] = uv_noise_level;
+    }
+}
+
+static int32_t denoise_and_model_realloc_if_necessary(struct AomDenoiseAndModel *ctx,
+                                                      EbPictureBufferDesc *sd, int32_t use_highbd) {
     free(ctx->flat_blocks);
     ctx->flat_blocks = NULL;
 
@@ -1524,16 +1555,7 @@ static int32_t denoise_and_model_realloc_if_necessary(struct AomDenoiseAndModel
         return 0;
     }
 
-    // Simply use a flat PSD (although we could use the flat blocks to estimate
-    // PSD) those to estimate an actual noise PSD)
-    const float y_noise_level =
-        eb_aom_noise_psd_get_default_value(ctx->block_size, ctx->noise_level);
-    const float uv_noise_level =
-        eb_aom_noise_psd_get_default_value(ctx->block_size >> chroma_sub_log2[1], ctx->noise_level);
-    for (int32_t i = 0; i < block_size * block_size; ++i) {
-        ctx->noise_psd[0][i] = y_noise_level;
-        ctx->noise_psd[1][i] = ctx->noise_psd[2][i] = uv_noise_level;
-    }
+    denoise_and_model_init_psd(ctx);
     return 1;
 }
 
@@ -1581,18 +1603,22 @@ static void pack_2d_pic(EbPictureBufferDesc *input_picture, uint16_t *packed[3])
                input_picture->height >> 1);
 }
 
-static void unpack_2d_pic(uint8_t *packed[3], EbPictureBufferDesc *outputPicturePtr) {
+static void unpack_2d_pic_rows(uint8_t *packed[3], EbPictureBufferDesc *outputPicturePtr,
+                               int32_t row_start, int32_t row_end) {
+    const int32_t chroma_row_start = row_start >> 1;
+    const int32_t chroma_row_end   = row_end >> 1;
     uint32_t luma_buffer_offset =
-        ((outputPicturePtr->origin_y) * outputPicturePtr->stride_y) + (outputPicturePtr->origin_x);
+        ((outputPicturePtr->origin_y + row_start) * outputPicturePtr->stride_y) +
+        (outputPicturePtr->origin_x);
     uint32_t chroma_buffer_offset =
-        (((outputPicturePtr->origin_y) >> 1) * outputPicturePtr->stride_cb) +
+        (((outputPicturePtr->origin_y >> 1) + chroma_row_start) * outputPicturePtr->stride_cb) +
         ((outputPicturePtr->origin_x) >> 1);
     uint16_t luma_width    = (uint16_t)(outputPicturePtr->width);
     uint16_t chroma_width  = luma_width >> 1;
-    uint16_t luma_height   = (uint16_t)(outputPicturePtr->height);
-    uint16_t chroma_height = luma_height >> 1;
+    uint16_t luma_height   = (uint16_t)(row_end - row_start);
+    uint16_t chroma_height = (uint16_t)(chroma_row_end - chroma_row_start);
 
-    un_pack2d((uint16_t *)(packed[0]),
+    un_pack2d((uint16_t *)(packed[0]) + row_start * outputPicturePtr->stride_y,
               outputPicturePtr->stride_y,
               outputPicturePtr->buffer_y + luma_buffer_offset,
               outputPicturePtr->stride_y,
@@ -1601,7 +1627,7 @@ static void unpack_2d_pic(uint8_t *packed[3], EbPictureBufferDesc *outputPicture
               luma_width,
               luma_height);
 
-    un_pack2d((uint16_t *)(packed[1]),
+    un_pack2d((uint16_t *)(packed[1]) + chroma_row_start * outputPicturePtr->stride_cb,
               outputPicturePtr->stride_cb,
               outputPicturePtr->buffer_cb + chroma_buffer_offset,
               outputPicturePtr->stride_cb,
@@ -1610,7 +1636,7 @@ static void unpack_2d_pic(uint8_t *packed[3], EbPictureBufferDesc *outputPicture
               chroma_width,
               chroma_height);
 
-    un_pack2d((uint16_t *)(packed[2]),
+    un_pack2d((uint16_t *)(packed[2]) + chroma_row_start * outputPicturePtr->stride_cr,
               outputPicturePtr->stride_cr,
               outputPicturePtr->buffer_cr + chroma_buffer_offset,
               outputPicturePtr->stride_cr,
@@ -1620,6 +1646,10 @@ static void unpack_2d_pic(uint8_t *packed[3], EbPictureBufferDesc *outputPicture
               chroma_height);
 }
 
+static void unpack_2d_pic(uint8_t *packed[3], EbPictureBufferDesc *outputPicturePtr) {
+    unpack_2d_pic_rows(packed, outputPicturePtr, 0, outputPicturePtr->height);
+}
+
 int32_t eb_aom_denoise_and_model_run(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
                                      AomFilmGrain *film_grain, int32_t use_highbd) {
     const int32_t block_size = ctx->block_size;
@@ -1707,3 +1737,117 @@ int32_t eb_aom_denoise_and_model_run(struct AomDenoiseAndModel *ctx, EbPictureBu
 
     return 1;
 }
+
+static void get_picture_planes(EbPictureBufferDesc *sd, uint8_t *raw_data[3]) {
+    raw_data[0] = sd->buffer_y + sd->origin_y * sd->stride_y + sd->origin_x;
+    raw_data[1] = sd->buffer_cb + sd->stride_cb * (sd->origin_y >> 1) + (sd->origin_x >> 1);
+    raw_data[2] = sd->buffer_cr + sd->stride_cr * (sd->origin_y >> 1) + (sd->origin_x >> 1);
+}
+
+int32_t eb_aom_denoise_and_model_snapshot(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
+                                          int32_t use_highbd) {
+    if (!ctx->packed[0]) return 0;
+
+    denoise_and_model_init_psd(ctx);
+
+    if (!use_highbd) {
+        uint8_t *raw_data[3];
+        get_picture_planes(sd, raw_data);
+        memcpy(ctx->packed[0], raw_data[0], sd->stride_y * sd->height);
+        memcpy(ctx->packed[1], raw_data[1], sd->stride_cb * (sd->height >> 1));
+        memcpy(ctx->packed[2], raw_data[2], sd->stride_cr * (sd->height >> 1));
+    } else
+        pack_2d_pic(sd, ctx->packed);
+    return 1;
+}
+
+int32_t eb_aom_denoise_rows(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
+                            int32_t row_start, int32_t row_end, int32_t use_highbd) {
+    int32_t chroma_sub_log2[2] = {1, 1};
+    int32_t strides[3]         = {sd->stride_y, sd->stride_cb, sd->stride_cr};
+
+    row_end = AOMMIN(row_end, (int32_t)sd->height);
+    if (row_start >= row_end) return 1;
+
+    const uint8_t *const data[3] = {
+        (uint8_t *)ctx->packed[0], (uint8_t *)ctx->packed[1], (uint8_t *)ctx->packed[2]};
+
+    if (!wiener_denoise_2d_rows(data,
+                                ctx->denoised,
+                                sd->width,
+                                sd->height,
+                                strides,
+                                chroma_sub_log2,
+                                ctx->noise_psd,
+                                ctx->block_size,
+                                ctx->bit_depth,
+                                use_highbd,
+                                row_start,
+                                row_end)) {
+        SVT_ERROR("Unable to denoise image\n");
+        return 0;
+    }
+
+    if (!use_highbd) {
+        uint8_t *     raw_data[3];
+        const int32_t chroma_row_start = row_start >> 1;
+        const int32_t chroma_rows      = (row_end >> 1) - chroma_row_start;
+        get_picture_planes(sd, raw_data);
+        memcpy(raw_data[0] + row_start * strides[0],
+               ctx->denoised[0] + row_start * strides[0],
+               strides[0] * (row_end - row_start));
+        memcpy(raw_data[1] + chroma_row_start * strides[1],
+               ctx->denoised[1] + chroma_row_start * strides[1],
+               strides[1] * chroma_rows);
+        memcpy(raw_data[2] + chroma_row_start * strides[2],
+               ctx->denoised[2] + chroma_row_start * strides[2],
+               strides[2] * chroma_rows);
+    } else
+        unpack_2d_pic_rows(ctx->denoised, sd, row_start, row_end);
+    return 1;
+}
+
+int32_t eb_aom_denoise_and_model_estimate(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
+                                          AomFilmGrain *film_grain, int32_t use_highbd) {
+    int32_t chroma_sub_log2[2] = {1, 1};
+    int32_t strides[3]         = {sd->stride_y, sd->stride_cb, sd->stride_cr};
+
+    film_grain->apply_grain = 0;
+    if (!denoise_and_model_realloc_if_necessary(ctx, sd, use_highbd)) {
+        SVT_ERROR("Unable to realloc buffers\n");
+        return 0;
+    }
+
+    const uint8_t *const data[3] = {
+        (uint8_t *)ctx->packed[0], (uint8_t *)ctx->packed[1], (uint8_t *)ctx->packed[2]};
+
+    eb_aom_flat_block_finder_run(
+        &ctx->flat_block_finder, data[0], sd->width, sd->height, strides[0], ctx->flat_blocks);
+
+    const AomNoiseStatus status = eb_aom_noise_model_update(&ctx->noise_model,
+                                                            data,
+                                                            (const uint8_t *const *)ctx->denoised,
+                                                            sd->width,
+                                                            sd->height,
+                                                            strides,
+                                                            chroma_sub_log2,
+                                                            ctx->flat_blocks,
+                                                            ctx->block_size);
+
+    int32_t ret = 1;
+    if (status == AOM_NOISE_STATUS_OK || status == AOM_NOISE_STATUS_DIFFERENT_NOISE_TYPE) {
+        eb_aom_noise_model_save_latest(&ctx->noise_model);
+        if (eb_aom_noise_model_get_grain_parameters(&ctx->noise_model, film_grain))
+            film_grain->apply_grain = 1;
+        else {
+            SVT_ERROR("Unable to get grain parameters.\n");
+            ret = 0;
+        }
+    }
+    eb_aom_flat_block_finder_free(&ctx->flat_block_finder);
+    eb_aom_noise_model_free(&ctx->noise_model);
+    free(ctx->flat_blocks);
+    ctx->flat_blocks = NULL;
+
+    return ret;
+}
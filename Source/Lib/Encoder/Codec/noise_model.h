@@ -206,6 +206,7 @@ typedef struct DenoiseAndModelInitData {
     uint16_t noise_level;
     uint32_t encoder_bit_depth;
     uint32_t encoder_color_format;
+    uint8_t  fast_film_grain;
 
     uint16_t width;
     uint16_t height;
@@ -336,6 +337,36 @@ struct AomDenoiseAndModel;
 int32_t eb_aom_denoise_and_model_run(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
                                      AomFilmGrain *film_grain, int32_t use_highbd);
 
+/*!\brief Keep a copy of the noisy input for the fast film grain path.
+     *
+     * The copy is the source of eb_aom_denoise_rows() and of the noise modeling
+     * in eb_aom_denoise_and_model_estimate(), so that the input buffer can be
+     * denoised in place, row band by row band, from several threads.
+     * Only 4:2:0 input is supported. Returns false when the context holds no
+     * buffer for the copy.
+     */
+int32_t eb_aom_denoise_and_model_snapshot(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
+                                          int32_t use_highbd);
+
+/*!\brief Denoise the luma rows [row_start, row_end) of the input buffer.
+     *
+     * The band is Wiener filtered from the snapshot taken with
+     * eb_aom_denoise_and_model_snapshot(), kept in the context denoised buffers,
+     * and written back to the input buffer. Bands can be processed concurrently.
+     */
+int32_t eb_aom_denoise_rows(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
+                            int32_t row_start, int32_t row_end, int32_t use_highbd);
+
+/*!\brief Model the noise removed by eb_aom_denoise_rows().
+     *
+     * Runs the flat block detection and the noise model fit on the snapshot and
+     * on the denoised rows of the whole picture, and populates film_grain. The
+     * input buffer is left untouched. grain.apply_grain is false when no noise
+     * estimate could be made.
+     */
+int32_t eb_aom_denoise_and_model_estimate(struct AomDenoiseAndModel *ctx, EbPictureBufferDesc *sd,
+                                          AomFilmGrain *film_grain, int32_t use_highbd);
+
 /*!\brief Allocates a context that can be used for denoising and noise modeling.
      *
      * \param[in]  bit_depth   Bit depth of buffers this will be run on.
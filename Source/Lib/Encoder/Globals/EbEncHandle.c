@@ -330,6 +330,9 @@ int32_t set_parent_pcs(EbSvtAv1EncConfiguration*   config, uint32_t core_count,
                         config->frame_rate);
         uint32_t ppcs_count     = fps;
         uint32_t min_ppcs_count = (2 << config->hierarchical_levels) + 1; // min picture count to start encoding
+        // Real time: no input buffering beyond the pictures in flight
+        if (config->real_time_mode)
+            return (int32_t)min_ppcs_count;
         fps        = fps > 120 ? 120   : fps;
         fps        = fps < 24  ? 24    : fps;
 
@@ -377,6 +380,8 @@ int32_t set_parent_pcs(EbSvtAv1EncConfiguration*   config, uint32_t core_count,
 EbErrorType load_default_buffer_configuration_settings(
     SequenceControlSet       *scs_ptr){
     EbErrorType           return_error = EB_ErrorNone;
+    // SCD / TF future pictures, none in real time
+    const uint32_t        scd_lad = scs_ptr->static_config.real_time_mode ? 0 : SCD_LAD;
 #if !MD_RATE_EST_ENH
     uint32_t enc_dec_seg_h = (scs_ptr->static_config.super_block_size == 128) ?
         ((scs_ptr->max_input_luma_height + 64) / 128) :
@@ -415,7 +420,7 @@ EbErrorType load_default_buffer_configuration_settings(
     if (return_ppcs == -1)
         return EB_ErrorInsufficientResources;
     uint32_t input_pic = (uint32_t)return_ppcs;
-    scs_ptr->input_buffer_fifo_init_count = input_pic + SCD_LAD + scs_ptr->static_config.look_ahead_distance;
+    scs_ptr->input_buffer_fifo_init_count = input_pic + scd_lad + scs_ptr->static_config.look_ahead_distance;
     scs_ptr->output_stream_buffer_fifo_init_count =
         scs_ptr->input_buffer_fifo_init_count + 4;
 #if MD_RATE_EST_ENH
@@ -498,27 +503,35 @@ EbErrorType load_default_buffer_configuration_settings(
 
     scs_ptr->tf_segment_column_count = me_seg_w;//1;//
     scs_ptr->tf_segment_row_count =  me_seg_h;//1;//
+
+    // Picture analysis segments: bands of SB rows, so large pictures are analysed by several threads
+    scs_ptr->picture_analysis_segment_row_count = (core_count == SINGLE_CORE_COUNT) ? 1 :
+        CLIP3(1, PA_MAX_SEGMENT_ROW_COUNT, ((scs_ptr->max_input_luma_height + 32) / BLOCK_SIZE_64) >> 2);
+
+    // DLF segments: bands of 2 SB rows, deblocked and searched by several threads
+    scs_ptr->dlf_segment_row_count = (core_count == SINGLE_CORE_COUNT) ? 1 :
+        CLIP3(1, DLF_MAX_SEGMENT_ROW_COUNT, ((scs_ptr->max_input_luma_height + 32) / BLOCK_SIZE_64) >> 1);
     //#====================== Data Structures and Picture Buffers ======================
-    scs_ptr->picture_control_set_pool_init_count       = input_pic + SCD_LAD + scs_ptr->static_config.look_ahead_distance;
+    scs_ptr->picture_control_set_pool_init_count       = input_pic + scd_lad + scs_ptr->static_config.look_ahead_distance;
     if (scs_ptr->static_config.enable_overlays)
         scs_ptr->picture_control_set_pool_init_count = MAX(scs_ptr->picture_control_set_pool_init_count,
             scs_ptr->static_config.look_ahead_distance + // frames in the LAD
             scs_ptr->static_config.look_ahead_distance / (1 << scs_ptr->static_config.hierarchical_levels) + 1 +  // number of overlayes in the LAD
-            ((1 << scs_ptr->static_config.hierarchical_levels) + SCD_LAD) * 2 +// minigop formation in PD + SCD_LAD *(normal pictures + potential pictures )
+            ((1 << scs_ptr->static_config.hierarchical_levels) + scd_lad) * 2 +// minigop formation in PD + scd_lad *(normal pictures + potential pictures )
             (1 << scs_ptr->static_config.hierarchical_levels)); // minigop in PM
     scs_ptr->picture_control_set_pool_init_count_child = MAX(MAX(MIN(3, core_count/2), core_count / 6), 1);
     scs_ptr->reference_picture_buffer_init_count       = MAX((uint32_t)(input_pic >> 1),
                                                                           (uint32_t)((1 << scs_ptr->static_config.hierarchical_levels) + 2)) +
-                                                                          scs_ptr->static_config.look_ahead_distance + SCD_LAD;
+                                                                          scs_ptr->static_config.look_ahead_distance + scd_lad;
     scs_ptr->pa_reference_picture_buffer_init_count    = MAX((uint32_t)(input_pic >> 1),
                                                                           (uint32_t)((1 << scs_ptr->static_config.hierarchical_levels) + 2)) +
-                                                                          scs_ptr->static_config.look_ahead_distance + SCD_LAD;
+                                                                          scs_ptr->static_config.look_ahead_distance + scd_lad;
     scs_ptr->output_recon_buffer_fifo_init_count       = scs_ptr->reference_picture_buffer_init_count;
     scs_ptr->overlay_input_picture_buffer_init_count   = scs_ptr->static_config.enable_overlays ?
-                                                                          (2 << scs_ptr->static_config.hierarchical_levels) + SCD_LAD : 1;
+                                                                          (2 << scs_ptr->static_config.hierarchical_levels) + scd_lad : 1;
     //Future frames window in Scene Change Detection (SCD) / TemporalFiltering
     scs_ptr->scd_delay =
-        scs_ptr->static_config.enable_altrefs || scs_ptr->static_config.scene_change_detection ? SCD_LAD : 0;
+        scs_ptr->static_config.enable_altrefs || scs_ptr->static_config.scene_change_detection ? scd_lad : 0;
 
     // bistream buffer will be allocated at run time. app will free the buffer once written to file.
     scs_ptr->output_stream_buffer_fifo_init_count = PICTURE_DECISION_PA_REFERENCE_QUEUE_MAX_DEPTH;
@@ -1005,10 +1018,12 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         input_data.speed_control = (uint8_t)enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.speed_control_flag;
         input_data.hbd_mode_decision = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.enable_hbd_mode_decision;
         input_data.film_grain_noise_level = enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.film_grain_denoise_strength;
+        input_data.fast_film_grain = enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.fast_film_grain;
         input_data.bit_depth = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.encoder_bit_depth;
         input_data.ext_block_flag = (uint8_t)enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.ext_block_flag;
         input_data.mrp_mode = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->mrp_mode;
         input_data.nsq_present = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->nsq_present;
+        input_data.enable_tpl_la = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.enable_tpl_la;
 #if TILES_PARALLEL
         input_data.log2_tile_rows = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.tile_rows;
         input_data.log2_tile_cols = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.tile_columns;
@@ -1407,7 +1422,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             enc_handle_ptr->enc_dec_results_resource_ptr,
             eb_system_resource_ctor,
             enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_fifo_init_count,
-            enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count,
+            // EncDec processes, then DLF processes (DLF segments)
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count +
+                enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count,
             enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count,
             enc_dec_results_creator,
             &enc_dec_result_init_data,
@@ -1598,7 +1615,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             enc_handle_ptr->dlf_context_ptr_array[process_index],
             dlf_context_ctor,
             enc_handle_ptr,
-            process_index);
+            process_index,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count + process_index);
     }
 
     //CDEF Contexts
@@ -1720,6 +1738,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
 #endif
     eb_print_memory_usage();
 
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.shared_rc)
+        shared_rc_attach(enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.shared_rc);
+
     return return_error;
 }
 
@@ -1732,9 +1753,47 @@ __attribute__((visibility("default")))
 EB_API EbErrorType eb_deinit_encoder(EbComponentType *svt_enc_component){
     if(svt_enc_component == NULL)
         return EB_ErrorBadParameter;
+    EbEncHandle *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
+    if (enc_handle_ptr && enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.shared_rc) {
+        shared_rc_detach(enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.shared_rc);
+        enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.shared_rc = NULL;
+    }
     return EB_ErrorNone;
 }
 
+/**********************************
+* Create / Destroy Shared Rate Control
+**********************************/
+#ifdef __GNUC__
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_create_shared_rc(EbSharedRateControl **shared_rc)
+{
+    if (shared_rc == NULL)
+        return EB_ErrorBadParameter;
+    *shared_rc = (EbSharedRateControl*)calloc(1, sizeof(EbSharedRateControl));
+    if (*shared_rc == NULL)
+        return EB_ErrorInsufficientResources;
+    (*shared_rc)->mutex = eb_create_mutex();
+    if ((*shared_rc)->mutex == NULL) {
+        free(*shared_rc);
+        *shared_rc = NULL;
+        return EB_ErrorInsufficientResources;
+    }
+    return EB_ErrorNone;
+}
+
+#ifdef __GNUC__
+__attribute__((visibility("default")))
+#endif
+EB_API void eb_svt_enc_destroy_shared_rc(EbSharedRateControl *shared_rc)
+{
+    if (shared_rc == NULL)
+        return;
+    eb_destroy_mutex(shared_rc->mutex);
+    free(shared_rc);
+}
+
 EbErrorType eb_svt_enc_init_parameter(
     EbSvtAv1EncConfiguration * config_ptr);
 
@@ -1935,6 +1994,8 @@ void set_param_based_on_input(SequenceControlSet *scs_ptr)
     derive_input_resolution(
         &scs_ptr->input_resolution,
         scs_ptr->seq_header.max_frame_width*scs_ptr->seq_header.max_frame_height);
+    scs_ptr->stat_record_size = (uint32_t)EB_TWO_PASS_STAT_RECORD_SIZE(
+        scs_ptr->seq_header.max_frame_width, scs_ptr->seq_header.max_frame_height);
     // In two pass encoding, the first pass uses sb size=64
     if (scs_ptr->use_output_stat_file)
         scs_ptr->static_config.super_block_size = 64;
@@ -2049,6 +2110,8 @@ void copy_api_from_app(
     scs_ptr->static_config.intra_period_length = ((EbSvtAv1EncConfiguration*)config_struct)->intra_period_length;
     scs_ptr->static_config.intra_refresh_type = ((EbSvtAv1EncConfiguration*)config_struct)->intra_refresh_type;
     scs_ptr->static_config.hierarchical_levels = ((EbSvtAv1EncConfiguration*)config_struct)->hierarchical_levels;
+    scs_ptr->static_config.adaptive_mini_gop = ((EbSvtAv1EncConfiguration*)config_struct)->adaptive_mini_gop;
+    scs_ptr->static_config.real_time_mode = ((EbSvtAv1EncConfiguration*)config_struct)->real_time_mode;
     scs_ptr->static_config.enc_mode = ((EbSvtAv1EncConfiguration*)config_struct)->enc_mode;
     scs_ptr->static_config.snd_pass_enc_mode = ((EbSvtAv1EncConfiguration*)config_struct)->snd_pass_enc_mode;
     scs_ptr->intra_period_length = scs_ptr->static_config.intra_period_length;
@@ -2057,8 +2120,15 @@ void copy_api_from_app(
     scs_ptr->static_config.use_qp_file = ((EbSvtAv1EncConfiguration*)config_struct)->use_qp_file;
     scs_ptr->static_config.input_stat_file = ((EbSvtAv1EncConfiguration*)config_struct)->input_stat_file;
     scs_ptr->static_config.output_stat_file = ((EbSvtAv1EncConfiguration*)config_struct)->output_stat_file;
-    scs_ptr->use_input_stat_file = scs_ptr->static_config.input_stat_file ? 1 : 0;
-    scs_ptr->use_output_stat_file = scs_ptr->static_config.output_stat_file ? 1 : 0;
+    scs_ptr->static_config.input_stat_buffer = ((EbSvtAv1EncConfiguration*)config_struct)->input_stat_buffer;
+    scs_ptr->static_config.input_stat_buffer_size = ((EbSvtAv1EncConfiguration*)config_struct)->input_stat_buffer_size;
+    scs_ptr->static_config.output_stat_callback = ((EbSvtAv1EncConfiguration*)config_struct)->output_stat_callback;
+    scs_ptr->static_config.output_stat_private_data = ((EbSvtAv1EncConfiguration*)config_struct)->output_stat_private_data;
+    scs_ptr->static_config.shared_rc = ((EbSvtAv1EncConfiguration*)config_struct)->shared_rc;
+    scs_ptr->static_config.enable_lookahead_pass = ((EbSvtAv1EncConfiguration*)config_struct)->enable_lookahead_pass;
+    scs_ptr->use_input_stat_file = (scs_ptr->static_config.input_stat_file || scs_ptr->static_config.input_stat_buffer) ? 1 : 0;
+    scs_ptr->use_output_stat_file = (scs_ptr->static_config.output_stat_file || scs_ptr->static_config.output_stat_callback) ? 1 : 0;
+    scs_ptr->use_lookahead_stats = scs_ptr->static_config.enable_lookahead_pass && !scs_ptr->use_input_stat_file && !scs_ptr->use_output_stat_file;
     // Deblock Filter
     scs_ptr->static_config.disable_dlf_flag = ((EbSvtAv1EncConfiguration*)config_struct)->disable_dlf_flag;
 
@@ -2178,6 +2248,7 @@ void copy_api_from_app(
     scs_ptr->static_config.scene_change_detection = ((EbSvtAv1EncConfiguration*)config_struct)->scene_change_detection;
     scs_ptr->static_config.rate_control_mode = ((EbSvtAv1EncConfiguration*)config_struct)->rate_control_mode;
     scs_ptr->static_config.look_ahead_distance = ((EbSvtAv1EncConfiguration*)config_struct)->look_ahead_distance;
+    scs_ptr->static_config.enable_tpl_la = ((EbSvtAv1EncConfiguration*)config_struct)->enable_tpl_la;
     scs_ptr->static_config.frame_rate = ((EbSvtAv1EncConfiguration*)config_struct)->frame_rate;
     scs_ptr->static_config.frame_rate_denominator = ((EbSvtAv1EncConfiguration*)config_struct)->frame_rate_denominator;
     scs_ptr->static_config.frame_rate_numerator = ((EbSvtAv1EncConfiguration*)config_struct)->frame_rate_numerator;
@@ -2185,6 +2256,11 @@ void copy_api_from_app(
     scs_ptr->static_config.target_bit_rate = ((EbSvtAv1EncConfiguration*)config_struct)->target_bit_rate;
 
     scs_ptr->static_config.vbv_bufsize = ((EbSvtAv1EncConfiguration*)config_struct)->vbv_bufsize;
+    scs_ptr->static_config.vbv_mode = ((EbSvtAv1EncConfiguration*)config_struct)->vbv_mode;
+    scs_ptr->static_config.vbv_maxrate = ((EbSvtAv1EncConfiguration*)config_struct)->vbv_maxrate ?
+        ((EbSvtAv1EncConfiguration*)config_struct)->vbv_maxrate : scs_ptr->static_config.target_bit_rate;
+    scs_ptr->static_config.vbv_init = ((EbSvtAv1EncConfiguration*)config_struct)->vbv_init;
+    scs_ptr->static_config.max_frame_size = ((EbSvtAv1EncConfiguration*)config_struct)->max_frame_size;
 
     scs_ptr->static_config.max_qp_allowed = (scs_ptr->static_config.rate_control_mode) ?
         ((EbSvtAv1EncConfiguration*)config_struct)->max_qp_allowed :
@@ -2197,6 +2273,7 @@ void copy_api_from_app(
     //Segmentation
     //TODO: check RC mode and set only when RC is enabled in the final version.
     scs_ptr->static_config.enable_adaptive_quantization = config_struct->enable_adaptive_quantization;
+    scs_ptr->static_config.enable_roi_map = config_struct->enable_roi_map;
 
     // Misc
     scs_ptr->static_config.encoder_bit_depth = ((EbSvtAv1EncConfiguration*)config_struct)->encoder_bit_depth;
@@ -2205,6 +2282,12 @@ void copy_api_from_app(
         SVT_LOG("SVT [Warning]: Color format EB_YUV400 not supported, set to EB_YUV420\n");
         scs_ptr->static_config.encoder_color_format = EB_YUV420;
     }
+    scs_ptr->static_config.fast_film_grain = config_struct->fast_film_grain;
+    if (scs_ptr->static_config.fast_film_grain &&
+        scs_ptr->static_config.encoder_color_format != EB_YUV420) {
+        SVT_LOG("SVT [Warning]: Fast film grain only supports EB_YUV420, set to 0\n");
+        scs_ptr->static_config.fast_film_grain = EB_FALSE;
+    }
     scs_ptr->chroma_format_idc = (uint32_t)(scs_ptr->static_config.encoder_color_format);
     scs_ptr->encoder_bit_depth = (uint32_t)(scs_ptr->static_config.encoder_bit_depth);
 
@@ -2237,6 +2320,10 @@ void copy_api_from_app(
     scs_ptr->static_config.unpin_lp1 = ((EbSvtAv1EncConfiguration*)config_struct)->unpin_lp1;
     scs_ptr->static_config.target_socket = ((EbSvtAv1EncConfiguration*)config_struct)->target_socket;
     scs_ptr->static_config.qp = ((EbSvtAv1EncConfiguration*)config_struct)->qp;
+    scs_ptr->static_config.crf = ((EbSvtAv1EncConfiguration*)config_struct)->crf;
+    // CRF: the quality level replaces the qp
+    if (scs_ptr->static_config.crf >= 0 && scs_ptr->static_config.crf <= MAX_QP_VALUE)
+        scs_ptr->static_config.qp = (uint32_t)scs_ptr->static_config.crf;
     scs_ptr->static_config.recon_enabled = ((EbSvtAv1EncConfiguration*)config_struct)->recon_enabled;
 
     // Extract frame rate from Numerator and Denominator if not 0
@@ -2253,6 +2340,7 @@ void copy_api_from_app(
     scs_ptr->static_config.enable_altrefs = config_struct->enable_altrefs;
     scs_ptr->static_config.altref_strength = config_struct->altref_strength;
     scs_ptr->static_config.altref_nframes = config_struct->altref_nframes;
+    scs_ptr->static_config.adaptive_altref = config_struct->adaptive_altref;
     scs_ptr->static_config.enable_overlays = config_struct->enable_overlays;
 
     scs_ptr->static_config.superres_mode = config_struct->superres_mode;
@@ -2297,6 +2385,16 @@ void copy_api_from_app(
         }
     }
 
+    // Real time: flat prediction structure, no future picture used
+    if (scs_ptr->static_config.real_time_mode) {
+        scs_ptr->static_config.hierarchical_levels = 0;
+        scs_ptr->max_temporal_layers = 0;
+        scs_ptr->static_config.look_ahead_distance = 0;
+        scs_ptr->static_config.enable_altrefs = EB_FALSE;
+        scs_ptr->static_config.enable_overlays = EB_FALSE;
+        scs_ptr->static_config.adaptive_mini_gop = EB_FALSE;
+    }
+
     return;
 }
 
@@ -2398,7 +2496,19 @@ static EbErrorType verify_settings(
         SVT_LOG("Error instance %u: QP must be [0 - %d]\n", channel_number + 1, MAX_QP_VALUE);
         return_error = EB_ErrorBadParameter;
     }
-    if (config->hierarchical_levels != 3 && config->hierarchical_levels != 4 && config->hierarchical_levels != 5) {
+    if (config->crf < -1 || config->crf > MAX_QP_VALUE) {
+        SVT_LOG("Error instance %u: CRF must be [-1 - %d]\n", channel_number + 1, MAX_QP_VALUE);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->crf >= 0 && config->rate_control_mode != 0) {
+        SVT_LOG("Error instance %u: CRF is only supported with RateControlMode 0\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->crf >= 0 && config->use_qp_file) {
+        SVT_LOG("Error instance %u: CRF is not supported with UseQpFile\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (!config->real_time_mode && config->hierarchical_levels != 3 && config->hierarchical_levels != 4 && config->hierarchical_levels != 5) {
         SVT_LOG("Error instance %u: Hierarchical Levels supported [3-5]\n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
     }
@@ -2508,6 +2618,35 @@ static EbErrorType verify_settings(
         SVT_LOG("Error Instance %u: The rate control mode must be [0 - 2] \n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
     }
+    if (config->vbv_mode > 2) {
+        SVT_LOG("Error Instance %u: The VBV mode must be [0 - 2] \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->vbv_mode && (config->rate_control_mode == 0 || config->vbv_bufsize == 0)) {
+        SVT_LOG("Error Instance %u: The VBV model requires a rate control mode and a VBV buffer size \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->vbv_mode && (config->vbv_init == 0 || config->vbv_init > 100)) {
+        SVT_LOG("Error Instance %u: The VBV initial fullness must be [1 - 100] \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->shared_rc && config->rate_control_mode != 1) {
+        SVT_LOG("Error Instance %u: The shared rate control requires the rate control mode 1 \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->enable_lookahead_pass && (config->input_stat_file || config->input_stat_buffer ||
+        config->output_stat_file || config->output_stat_callback)) {
+        SVT_LOG("Error Instance %u: The lookahead pass cannot be combined with input / output stats \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->enable_lookahead_pass && config->look_ahead_distance == 0) {
+        SVT_LOG("Error Instance %u: The lookahead pass requires a lookahead distance \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+    if (config->enable_tpl_la && config->look_ahead_distance == 0) {
+        SVT_LOG("Error Instance %u: The temporal dependency model requires a lookahead distance \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
     if ((config->rate_control_mode == 3|| config->rate_control_mode == 2) && config->look_ahead_distance != (uint32_t)config->intra_period_length && config->intra_period_length >= 0) {
         SVT_LOG("Error Instance %u: The rate control mode 2/3 LAD must be equal to intra_period \n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
@@ -2532,8 +2671,8 @@ static EbErrorType verify_settings(
         return_error = EB_ErrorBadParameter;
     }
 
-    if (config->scene_change_detection > 1) {
-        SVT_LOG("Error Instance %u: The scene change detection must be [0 - 1] \n", channel_number + 1);
+    if (config->scene_change_detection > 2) {
+        SVT_LOG("Error Instance %u: The scene change detection must be [0 - 2] \n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
     }
     if (config->max_qp_allowed > MAX_QP_VALUE) {
@@ -2575,6 +2714,11 @@ static EbErrorType verify_settings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (scs_ptr->static_config.enable_roi_map && scs_ptr->static_config.enable_adaptive_quantization == 1) {
+        SVT_LOG("Error instance %u : The region of interest map is not supported with the segmentation based adaptive quantization\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if ((config->encoder_bit_depth != 8) &&
         (config->encoder_bit_depth != 10)
         ) {
@@ -2701,8 +2845,8 @@ static EbErrorType verify_settings(
     }
 
     // CDEF
-    if (config->cdef_mode > 5 || config->cdef_mode < -1) {
-        SVT_LOG("Error instance %u: Invalid CDEF mode [0 - 5, -1 for auto], your input: %d\n", channel_number + 1, config->cdef_mode);
+    if (config->cdef_mode > 6 || config->cdef_mode < -1) {
+        SVT_LOG("Error instance %u: Invalid CDEF mode [0 - 6, -1 for auto], your input: %d\n", channel_number + 1, config->cdef_mode);
         return_error = EB_ErrorBadParameter;
     }
 
@@ -2712,8 +2856,8 @@ static EbErrorType verify_settings(
       return_error = EB_ErrorBadParameter;
     }
 
-    if (config->sg_filter_mode > 4 || config->sg_filter_mode < -1) {
-        SVT_LOG("Error instance %u: Invalid self-guided filter mode [0 - 4, -1 for auto], your input: %d\n", channel_number + 1, config->sg_filter_mode);
+    if (config->sg_filter_mode > 5 || config->sg_filter_mode < -1) {
+        SVT_LOG("Error instance %u: Invalid self-guided filter mode [0 - 5, -1 for auto], your input: %d\n", channel_number + 1, config->sg_filter_mode);
         return_error = EB_ErrorBadParameter;
     }
 
@@ -2869,13 +3013,19 @@ static EbErrorType verify_settings(
         }
     }
 
-    if (config->superres_mode > 2) {
+    if (config->superres_mode >= SUPERRES_MODES || config->superres_mode == SUPERRES_QTHRESH) {
         SVT_LOG("Error instance %u: invalid superres-mode %d, should be in the range [%d - %d], "
-                "only SUPERRES_NONE (0), SUPERRES_FIXED (1) and SUPERRES_RANDOM (2) are currently implemented \n", channel_number + 1, config->superres_mode, 0, 2);
+                "only SUPERRES_NONE (0), SUPERRES_FIXED (1), SUPERRES_RANDOM (2) and SUPERRES_AUTO (4) are currently implemented \n", channel_number + 1, config->superres_mode, 0, 4);
         return_error = EB_ErrorBadParameter;
     }
 
-    if (config->superres_mode > 0 && (config->input_stat_file || config->output_stat_file)){
+    if (config->superres_mode == SUPERRES_AUTO && !config->speed_control_flag) {
+        SVT_LOG("Error instance %u: superres-mode 4 (SUPERRES_AUTO) requires speed control to be enabled \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->superres_mode > 0 && (config->input_stat_file || config->output_stat_file ||
+        config->input_stat_buffer || config->output_stat_callback)){
         SVT_LOG("Error instance %u: superres cannot be enabled in 2-pass mode yet \n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
     }
@@ -2924,11 +3074,26 @@ EbErrorType eb_svt_enc_init_parameter(
     config_ptr->tile_columns = 0;
 
     config_ptr->qp = 50;
+    config_ptr->crf = -1;
     config_ptr->use_qp_file = EB_FALSE;
+    config_ptr->enable_roi_map = EB_FALSE;
+    config_ptr->input_stat_file = NULL;
+    config_ptr->output_stat_file = NULL;
+    config_ptr->input_stat_buffer = NULL;
+    config_ptr->input_stat_buffer_size = 0;
+    config_ptr->output_stat_callback = NULL;
+    config_ptr->output_stat_private_data = NULL;
+    config_ptr->shared_rc = NULL;
+    config_ptr->enable_lookahead_pass = EB_FALSE;
     config_ptr->scene_change_detection = 0;
     config_ptr->rate_control_mode = 0;
     config_ptr->look_ahead_distance = (uint32_t)~0;
+    config_ptr->enable_tpl_la = EB_FALSE;
     config_ptr->target_bit_rate = 7000000;
+    config_ptr->vbv_mode = 0;
+    config_ptr->vbv_maxrate = 0;
+    config_ptr->vbv_init = 90;
+    config_ptr->max_frame_size = 0;
     config_ptr->max_qp_allowed = 63;
     config_ptr->min_qp_allowed = 10;
     config_ptr->enc_mode = MAX_ENC_PRESET;
@@ -2937,6 +3102,8 @@ EbErrorType eb_svt_enc_init_parameter(
     config_ptr->intra_refresh_type = 1;
     config_ptr->hierarchical_levels = 4;
     config_ptr->pred_structure = EB_PRED_RANDOM_ACCESS;
+    config_ptr->real_time_mode = EB_FALSE;
+    config_ptr->adaptive_mini_gop = EB_FALSE;
     config_ptr->disable_dlf_flag = EB_FALSE;
     config_ptr->enable_warped_motion = DEFAULT;
     config_ptr->enable_global_motion = EB_TRUE;
@@ -3021,6 +3188,7 @@ EbErrorType eb_svt_enc_init_parameter(
     //config_ptr->latency_mode = 0;
     config_ptr->speed_control_flag = 0;
     config_ptr->film_grain_denoise_strength = 0;
+    config_ptr->fast_film_grain = EB_FALSE;
 
     // CPU Flags
     config_ptr->use_cpu_flags = CPU_FLAGS_ALL;
@@ -3038,6 +3206,7 @@ EbErrorType eb_svt_enc_init_parameter(
     // Alt-Ref default values
     config_ptr->enable_altrefs = EB_TRUE;
     config_ptr->altref_nframes = 7;
+    config_ptr->adaptive_altref = EB_FALSE;
     config_ptr->altref_strength = 5;
     config_ptr->enable_overlays = EB_FALSE;
 
@@ -3099,6 +3268,8 @@ static void print_lib_params(
         SVT_LOG("\nSVT [config]: RCMode / TargetBitrate (kbps)/ LookaheadDistance / SceneChange\t\t: VBR / %d / %d / %d ", (int)config->target_bit_rate/1000, config->look_ahead_distance, config->scene_change_detection);
     else if (config->rate_control_mode == 2)
         SVT_LOG("\nSVT [config]: RCMode / TargetBitrate (kbps)/ LookaheadDistance / SceneChange\t\t: Constraint VBR / %d / %d / %d ", (int)config->target_bit_rate/1000, config->look_ahead_distance, config->scene_change_detection);
+    else if (config->crf >= 0)
+        SVT_LOG("\nSVT [config]: BRC Mode / CRF  / LookaheadDistance / SceneChange\t\t\t: CRF / %d / %d / %d ", config->crf, config->look_ahead_distance, config->scene_change_detection);
     else
         SVT_LOG("\nSVT [config]: BRC Mode / QP  / LookaheadDistance / SceneChange\t\t\t: CQP / %d / %d / %d ", scs->static_config.qp, config->look_ahead_distance, config->scene_change_detection);
 #ifdef DEBUG_BUFFERS
@@ -3464,6 +3635,19 @@ static void copy_input_buffer(
     // Copy the picture buffer
     if (src->p_buffer != NULL)
         copy_frame_buffer(sequenceControlSet, dst->p_buffer, src->p_buffer);
+
+    // Copy the region of interest map, a picture without map gets a neutral one
+    if (sequenceControlSet->static_config.enable_roi_map) {
+        const size_t roi_map_size = roi_map_block_count(sequenceControlSet);
+        if (src->roi_delta_qp != NULL)
+            EB_MEMCPY(dst->roi_delta_qp, src->roi_delta_qp, roi_map_size);
+        else
+            EB_MEMSET(dst->roi_delta_qp, 0, roi_map_size);
+        if (src->roi_static_hint != NULL)
+            EB_MEMCPY(dst->roi_static_hint, src->roi_static_hint, roi_map_size);
+        else
+            EB_MEMSET(dst->roi_static_hint, 0, roi_map_size);
+    }
 }
 
 /**********************************
@@ -3749,6 +3933,11 @@ EbErrorType eb_input_buffer_header_creator(
         scs_ptr,
         input_buffer);
 
+    if (scs_ptr->static_config.enable_roi_map) {
+        EB_MALLOC_ARRAY(input_buffer->roi_delta_qp, roi_map_block_count(scs_ptr));
+        EB_MALLOC_ARRAY(input_buffer->roi_static_hint, roi_map_block_count(scs_ptr));
+    }
+
     input_buffer->p_app_private = NULL;
 
     return EB_ErrorNone;
@@ -3762,6 +3951,8 @@ void eb_input_buffer_header_destroyer(    EbPtr p)
     EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_cb);
     EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_cr);
 
+    EB_FREE_ARRAY(obj->roi_delta_qp);
+    EB_FREE_ARRAY(obj->roi_static_hint);
     EB_DELETE(buf);
     EB_FREE(obj);
 }
@@ -11,6 +11,7 @@
  * * eb_cdef_filter_block_avx2
  * * compute_cdef_dist_avx2
  * * copy_rect8_8bit_to_16bit_avx2
+ * * copy_rect16_16bit_to_8bit_avx2
  * * search_one_dual_avx2
  *
  * @author Cidana-Wenyao
@@ -503,13 +504,65 @@ TEST(CdefToolTest, CopyRectMatchTest) {
             for (int i = 0; i < vsize; ++i) {
                 for (int j = 0; j < hsize; ++j)
                     ASSERT_EQ(dst_ref_[i * CDEF_BSTRIDE + j],
-                              dst_ref_[i * CDEF_BSTRIDE + j])
+                              dst_tst_[i * CDEF_BSTRIDE + j])
                         << "copy_rect8_8bit_to_16bit failed with pos(" << i
                         << " " << j << ")";
             }
         }
 }
 
+/**
+ * @brief Unit test for copy_rect16_16bit_to_8bit_avx2
+ *
+ * Test strategy:
+ * Feed src data generated randomly on 16 bits (the low bytes are kept),
+ * and check the dst data, and that the samples around the rectangle are
+ * not written
+ *
+ * Expect result:
+ * The dst data from targeted function should be identical
+ * with the date from reference function.
+ *
+ * Test coverage:
+ * Test cases:
+ * hsize: [1, 72]
+ * vsize: [1, 16]
+ *
+ */
+TEST(CdefToolTest, CopyRect16To8MatchTest) {
+    SVTRandom rnd_(16, false);
+
+    DECLARE_ALIGNED(16, uint16_t, src_data_[CDEF_INBUF_SIZE]);
+    DECLARE_ALIGNED(16, uint8_t, dst_data_tst_[CDEF_INBUF_SIZE]);
+    DECLARE_ALIGNED(16, uint8_t, dst_data_ref_[CDEF_INBUF_SIZE]);
+
+    // prepare src data
+    for (int i = 0; i < CDEF_INBUF_SIZE; ++i)
+        src_data_[i] = rnd_.random();
+
+    for (int hsize = 1; hsize <= 72; ++hsize)
+        for (int vsize = 1; vsize <= 16; ++vsize) {
+            memset(dst_data_tst_, 0, sizeof(dst_data_tst_));
+            memset(dst_data_ref_, 0, sizeof(dst_data_ref_));
+            uint16_t *src_ =
+                src_data_ + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+            uint8_t *dst_tst_ =
+                dst_data_tst_ + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+            uint8_t *dst_ref_ =
+                dst_data_ref_ + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+
+            eb_copy_rect16_16bit_to_8bit_c(
+                dst_ref_, CDEF_BSTRIDE, src_, CDEF_BSTRIDE, vsize, hsize);
+            eb_copy_rect16_16bit_to_8bit_avx2(
+                dst_tst_, CDEF_BSTRIDE, src_, CDEF_BSTRIDE, vsize, hsize);
+
+            for (int i = 0; i < CDEF_INBUF_SIZE; ++i)
+                ASSERT_EQ(dst_data_ref_[i], dst_data_tst_[i])
+                    << "copy_rect16_16bit_to_8bit failed with hsize " << hsize
+                    << " vsize " << vsize << " pos " << i;
+        }
+}
+
 /**
  * @brief Unit test for compute_cdef_dist_avx2
  *
@@ -690,7 +743,6 @@ TEST(CdefToolTest, SearchOneDualMatchTest) {
     const int sb_count = 100;
     const int fast = 0;  // unused
     const int start_gi = 0;
-    const int end_gi = TOTAL_STRENGTHS;
     int lvl_luma_ref[CDEF_MAX_STRENGTHS], lvl_chroma_ref[CDEF_MAX_STRENGTHS];
     int lvl_luma_tst[CDEF_MAX_STRENGTHS], lvl_chroma_tst[CDEF_MAX_STRENGTHS];
     uint64_t(*mse[2])[TOTAL_STRENGTHS];
@@ -704,6 +756,9 @@ TEST(CdefToolTest, SearchOneDualMatchTest) {
             for (int n = 0; n < sb_count; ++n)
                 for (int j = 0; j < 64; ++j)
                     mse[i][n][j] = rnd_.random();
+        // all the strengths, or the packed strengths of a pruned search
+        const int end_gi =
+            (k & 1) ? 1 + (int)(rnd_.random() % TOTAL_STRENGTHS) : TOTAL_STRENGTHS;
 
         // try different nb_strengths
         for (int i = 0; i <= 3; ++i) {
@@ -757,6 +812,41 @@ TEST(CdefToolTest, SearchOneDualMatchTest) {
     eb_aom_free(mse[1]);
 }
 
+TEST(CdefToolTest, SubsampleListTest) {
+    CdefList dlist[MI_SIZE_128X128 * MI_SIZE_128X128];
+    CdefList sub_dlist[MI_SIZE_128X128 * MI_SIZE_128X128];
+    SVTRandom skip_rnd_(0, 1);
+
+    for (int k = 0; k < 100; ++k) {
+        int cdef_count = 0;
+        // generate the cdef list randomly, sparse lists in the odd loops
+        for (int r = 0; r < MI_SIZE_64X64 >> 1; ++r) {
+            for (int c = 0; c < MI_SIZE_64X64 >> 1; ++c) {
+                if (!skip_rnd_.random() && (!(k & 1) || !(r & 3))) {
+                    dlist[cdef_count].by = (uint8_t)r;
+                    dlist[cdef_count].bx = (uint8_t)c;
+                    ++cdef_count;
+                }
+            }
+        }
+
+        const int sub_count = cdef_subsample_list(sub_dlist, dlist, cdef_count);
+        int expected = 0;
+        for (int i = 0; i < cdef_count; ++i)
+            expected += !((dlist[i].by + dlist[i].bx) & 1);
+        if (cdef_count < 8 || !expected)
+            expected = cdef_count;
+        ASSERT_EQ(sub_count, expected) << "loop: " << k;
+        // the blocks kept are in the order of the list
+        for (int i = 0, j = 0; i < sub_count; ++i, ++j) {
+            while (j < cdef_count && (dlist[j].by != sub_dlist[i].by ||
+                                      dlist[j].bx != sub_dlist[i].bx))
+                ++j;
+            ASSERT_LT(j, cdef_count) << "loop: " << k << " block " << i;
+        }
+    }
+}
+
 TEST(CdefToolTest, DISABLED_SearchOneDualSpeedTest) {
     // setup enviroment
     const int sb_count = 100;
@@ -6,7 +6,8 @@
 /******************************************************************************
  * @file EncodeTxbAsmTest.cc
  *
- * @brief Unit test for eb_av1_txb_init_levels_avx2:
+ * @brief Unit test for eb_av1_txb_init_levels_avx2,
+ * eb_av1_get_nz_map_contexts and eb_av1_update_coeff_eob_fast:
  *
  * @author Cidana-Wenyao
  *
@@ -54,6 +55,9 @@ static INLINE int get_padded_idx(const int idx, const int bwl) {
 extern "C" void eb_av1_get_nz_map_contexts_sse2(
     const uint8_t *const levels, const int16_t *const scan, const uint16_t eob,
     TxSize tx_size, const TxClass tx_class, int8_t *const coeff_contexts);
+extern "C" void eb_av1_get_nz_map_contexts_avx2(
+    const uint8_t *const levels, const int16_t *const scan, const uint16_t eob,
+    TxSize tx_size, const TxClass tx_class, int8_t *const coeff_contexts);
 using GetNzMapContextsFunc = void (*)(const uint8_t *const levels,
                                       const int16_t *const scan,
                                       const uint16_t eob, const TxSize tx_size,
@@ -161,6 +165,12 @@ INSTANTIATE_TEST_CASE_P(
                        ::testing::Range(0, static_cast<int>(TX_TYPES), 1),
                        ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
 
+INSTANTIATE_TEST_CASE_P(
+    AVX2, EncodeTxbTest,
+    ::testing::Combine(::testing::Values(&eb_av1_get_nz_map_contexts_avx2),
+                       ::testing::Range(0, static_cast<int>(TX_TYPES), 1),
+                       ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
+
 // test assembly code of eb_av1_txb_init_levels
 using TxbInitLevelsFunc = void (*)(const TranLow *const coeff, const int width,
                                    const int height, uint8_t *const levels);
@@ -305,4 +315,127 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(::testing::Values(&eb_av1_txb_init_levels_avx512),
                        ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
 #endif
+
+// test assembly code of eb_av1_update_coeff_eob_fast
+using UpdateCoeffEobFastFunc = void (*)(uint16_t *eob, int shift,
+                                        const int16_t *dequant_ptr,
+                                        const int16_t *scan,
+                                        const TranLow *coeff_ptr,
+                                        TranLow *qcoeff_ptr,
+                                        TranLow *dqcoeff_ptr);
+using UpdateCoeffEobFastParam =
+    std::tuple<UpdateCoeffEobFastFunc, int, int>;
+/**
+ * @brief Unit test for eb_av1_update_coeff_eob_fast (fast RDOQ stage):
+ *
+ * Test strategy:
+ * Verify this assembly code by comparing with reference c implementation.
+ * Feed the same coefficients and check the eob and the quantized and
+ * dequantized coefficients.
+ *
+ * Expect result:
+ * Output from assemble function should be exactly same as output from c.
+ *
+ * Test coverage:
+ * coeff: random, with a random ratio of coefficients below the zero bin
+ * qcoeff: random, with random zeros
+ * eob: all values up to the number of coefficients of the tx_size
+ * tx_size, tx_type: all
+ *
+ */
+class UpdateCoeffEobFastTest
+    : public ::testing::TestWithParam<UpdateCoeffEobFastParam> {
+  public:
+    UpdateCoeffEobFastTest()
+        : rnd_(0, INT16_MAX), ref_func_(&eb_av1_update_coeff_eob_fast_c) {
+    }
+
+    virtual ~UpdateCoeffEobFastTest() {
+        aom_clear_system_state();
+    }
+
+    void run_test(const UpdateCoeffEobFastFunc test_func, const int tx_type,
+                  const int tx_size) {
+        const int width = get_txb_wide((TxSize)tx_size);
+        const int height = get_txb_high((TxSize)tx_size);
+        const int shift = av1_get_tx_scale((TxSize)tx_size);
+        const int16_t *const scan = av1_scan_orders[tx_size][tx_type].scan;
+
+        for (int eob = 1; eob <= width * height; ++eob) {
+            prepare_data(width * height);
+            uint16_t eob_ref = eob, eob_test = eob;
+
+            ref_func_(&eob_ref,
+                      shift,
+                      dequant_,
+                      scan,
+                      coeff_,
+                      qcoeff_ref_,
+                      dqcoeff_ref_);
+            test_func(&eob_test,
+                      shift,
+                      dequant_,
+                      scan,
+                      coeff_,
+                      qcoeff_test_,
+                      dqcoeff_test_);
+
+            ASSERT_EQ(eob_ref, eob_test)
+                << "tx_size " << tx_size << " tx_type " << tx_type << " eob "
+                << eob;
+            for (int i = 0; i < width * height; ++i) {
+                ASSERT_EQ(qcoeff_ref_[i], qcoeff_test_[i])
+                    << "tx_size " << tx_size << " eob " << eob << " i " << i;
+                ASSERT_EQ(dqcoeff_ref_[i], dqcoeff_test_[i])
+                    << "tx_size " << tx_size << " eob " << eob << " i " << i;
+            }
+        }
+    }
+
+  private:
+    void prepare_data(const int n_coeffs) {
+        dequant_[0] = 4 + rnd_.random() % 1024;
+        dequant_[1] = 4 + rnd_.random() % 1024;
+        // ratio of the coefficients forced in the zero bin
+        const int small_ratio = rnd_.random() % 5;
+        for (int i = 0; i < n_coeffs; ++i) {
+            const int16_t dq = dequant_[i != 0];
+            int32_t c = rnd_.random() % (4 * dq);
+            if (static_cast<int>(rnd_.random() % 4) < small_ratio)
+                c = rnd_.random() % (dq / 2 + 1);
+            coeff_[i] = (rnd_.random() & 1) ? -c : c;
+            qcoeff_ref_[i] = (rnd_.random() % 8) ? coeff_[i] / dq : 0;
+            dqcoeff_ref_[i] = qcoeff_ref_[i] * dq;
+        }
+        memcpy(qcoeff_test_, qcoeff_ref_, sizeof(qcoeff_ref_));
+        memcpy(dqcoeff_test_, dqcoeff_ref_, sizeof(dqcoeff_ref_));
+    }
+
+    SVTRandom rnd_;
+    int16_t dequant_[2];
+    TranLow coeff_[MAX_TX_SQUARE];
+    TranLow qcoeff_ref_[MAX_TX_SQUARE];
+    TranLow qcoeff_test_[MAX_TX_SQUARE];
+    TranLow dqcoeff_ref_[MAX_TX_SQUARE];
+    TranLow dqcoeff_test_[MAX_TX_SQUARE];
+    const UpdateCoeffEobFastFunc ref_func_;
+};
+
+TEST_P(UpdateCoeffEobFastTest, update_coeff_eob_fast_match) {
+    run_test(TEST_GET_PARAM(0), TEST_GET_PARAM(1), TEST_GET_PARAM(2));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, UpdateCoeffEobFastTest,
+    ::testing::Combine(::testing::Values(&eb_av1_update_coeff_eob_fast_avx2),
+                       ::testing::Range(0, static_cast<int>(TX_TYPES), 1),
+                       ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
+
+#ifndef NON_AVX512_SUPPORT
+INSTANTIATE_TEST_CASE_P(
+    AVX512, UpdateCoeffEobFastTest,
+    ::testing::Combine(::testing::Values(&eb_av1_update_coeff_eob_fast_avx512),
+                       ::testing::Range(0, static_cast<int>(TX_TYPES), 1),
+                       ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
+#endif
 }  // namespace
@@ -14,6 +14,7 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 #include <stdlib.h>
+#include <vector>
 
 // workaround to eliminate the compiling warning on linux
 // The macro will conflict with definition in gtest.h
@@ -27,6 +28,7 @@
 #include "grainSynthesis.h"
 #include "gtest/gtest.h"
 #include "EbUtility.h"
+#include "EbTime.h"
 #include "FilmGrainExpectedResult.h"
 #include "acm_random.h"
 #include "noise_model.h"
@@ -388,6 +390,7 @@ class DenoiseModelRunTest : public ::testing::Test {
         DenoiseAndModelInitData fg_init_data;
         fg_init_data.encoder_bit_depth = EB_8BIT;
         fg_init_data.encoder_color_format = EB_YUV420;
+        fg_init_data.fast_film_grain = 1;
         fg_init_data.noise_level = 4;  // TODO: check the range;
         fg_init_data.width = width_;
         fg_init_data.height = height_;
@@ -457,6 +460,42 @@ class DenoiseModelRunTest : public ::testing::Test {
             &noise_model, &in_pic_, &output_film_grain, 0);
     }
 
+    // fast film grain path: denoise the picture in bands of band_height rows,
+    // then model the noise
+    void run_fast_test(int band_height) {
+        init_data();
+
+        EXPECT_EQ(eb_aom_denoise_and_model_snapshot(&noise_model, &in_pic_, 0),
+                  1);
+        for (int row = 0; row < height_; row += band_height) {
+            EXPECT_EQ(eb_aom_denoise_rows(
+                          &noise_model, &in_pic_, row, row + band_height, 0),
+                      1);
+        }
+        EXPECT_EQ(eb_aom_denoise_and_model_estimate(
+                      &noise_model, &in_pic_, &output_film_grain, 0),
+                  1);
+    }
+
+    void save_output() {
+        for (int c = 0; c < 3; ++c) {
+            const int size = c ? (width_ >> 1) * (height_ >> 1)
+                               : width_ * height_;
+            ref_output_[c].assign(data_ptr_[c], data_ptr_[c] + size);
+        }
+    }
+
+    int max_output_diff() {
+        int max_diff = 0;
+        for (int c = 0; c < 3; ++c) {
+            for (size_t i = 0; i < ref_output_[c].size(); ++i) {
+                max_diff = AOMMAX(max_diff,
+                                  abs(ref_output_[c][i] - data_ptr_[c][i]));
+            }
+        }
+        return max_diff;
+    }
+
   protected:
     int subsampling_x_;
     int subsampling_y_;
@@ -466,6 +505,7 @@ class DenoiseModelRunTest : public ::testing::Test {
     libaom_test::ACMRandom random_;
     uint8_t *data_ptr_[3];
     uint8_t *denoised_ptr_[3];
+    std::vector<uint8_t> ref_output_[3];
 };
 
 TEST_F(DenoiseModelRunTest, OutputFilmGrainCheck) {
@@ -473,3 +513,82 @@ TEST_F(DenoiseModelRunTest, OutputFilmGrainCheck) {
     check_filmgrain();
     EXPECT_FALSE(HasFailure());
 }
+
+// The fast path on a single band must match the full denoise and model run
+TEST_F(DenoiseModelRunTest, FastSingleBandMatchRun) {
+    run_test();
+    save_output();
+
+    random_.Reset(100171);
+    memset(&output_film_grain, 0, sizeof(output_film_grain));
+    run_fast_test(height_);
+    check_filmgrain();
+    EXPECT_EQ(max_output_diff(), 0);
+}
+
+// Only the error diffusion of the dithering stops at the band edges
+TEST_F(DenoiseModelRunTest, FastMultiBandCheck) {
+    run_test();
+    save_output();
+
+    random_.Reset(100171);
+    run_fast_test(32);
+    EXPECT_LE(max_output_diff(), 1);
+    EXPECT_EQ(output_film_grain.apply_grain, 1);
+}
+
+TEST_F(DenoiseModelRunTest, DISABLED_FastSpeedTest) {
+    const int num_loop = 100;
+    double time_run, time_denoise, time_model;
+    uint64_t start_time_seconds, start_time_useconds;
+    uint64_t middle_time_seconds, middle_time_useconds;
+    uint64_t finish_time_seconds, finish_time_useconds;
+
+    time_run = time_denoise = time_model = 0;
+    for (int i = 0; i < num_loop; i++) {
+        init_data();
+        eb_start_time(&start_time_seconds, &start_time_useconds);
+        eb_aom_denoise_and_model_run(
+            &noise_model, &in_pic_, &output_film_grain, 0);
+        eb_start_time(&finish_time_seconds, &finish_time_useconds);
+        double time;
+        eb_compute_overall_elapsed_time_ms(start_time_seconds,
+                                           start_time_useconds,
+                                           finish_time_seconds,
+                                           finish_time_useconds,
+                                           &time);
+        time_run += time;
+
+        init_data();
+        eb_start_time(&start_time_seconds, &start_time_useconds);
+        eb_aom_denoise_and_model_snapshot(&noise_model, &in_pic_, 0);
+        for (int row = 0; row < height_; row += 64)
+            eb_aom_denoise_rows(&noise_model, &in_pic_, row, row + 64, 0);
+        eb_start_time(&middle_time_seconds, &middle_time_useconds);
+        eb_aom_denoise_and_model_estimate(
+            &noise_model, &in_pic_, &output_film_grain, 0);
+        eb_start_time(&finish_time_seconds, &finish_time_useconds);
+        eb_compute_overall_elapsed_time_ms(start_time_seconds,
+                                           start_time_useconds,
+                                           middle_time_seconds,
+                                           middle_time_useconds,
+                                           &time);
+        time_denoise += time;
+        eb_compute_overall_elapsed_time_ms(middle_time_seconds,
+                                           middle_time_useconds,
+                                           finish_time_seconds,
+                                           finish_time_useconds,
+                                           &time);
+        time_model += time;
+    }
+
+    printf("Average Milliseconds per Picture (%dx%d)\n", width_, height_);
+    printf("    eb_aom_denoise_and_model_run()      : %6.3f\n",
+           time_run / num_loop);
+    printf("    fast path, denoise (64 rows bands)  : %6.3f\n",
+           time_denoise / num_loop);
+    printf("    fast path, noise modeling           : %6.3f\n",
+           time_model / num_loop);
+    printf("    speedup when the grain is reused     : %6.2fx\n",
+           time_run / time_denoise);
+}
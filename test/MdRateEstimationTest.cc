@@ -0,0 +1,246 @@
+/*
+ * Copyright(c) 2019 Intel Corporation
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file MdRateEstimationTest.cc
+ *
+ * @brief Unit test for the incremental update of the MD rate tables:
+ * - av1_update_syntax_rate
+ * - av1_update_mv_rate
+ * - av1_update_coefficients_rate
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "gtest/gtest.h"
+// workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+#include "EbDefinitions.h"
+#include "EbMdRateEstimation.h"
+#include "EbTime.h"
+#include "random.h"
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace {
+
+/**
+ * @brief Unit test for the incremental rate table update
+ *
+ * Test strategy:
+ * Derive the rate tables of a base FRAME_CONTEXT, adapt a random subset of
+ * its CDFs (symbols coded with update_cdf, coefficient CDFs averaged with the
+ * ones of another qindex), then update the tables incrementally and compare
+ * them with a full rebuild from the adapted FRAME_CONTEXT.
+ *
+ * Expected result:
+ * The incrementally updated tables are identical to the rebuilt ones.
+ *
+ * Test coverage:
+ * I and non I slices, with and without high precision mv and intrabc.
+ */
+class MdRateEstimationTest : public ::testing::TestWithParam<int> {
+  public:
+    MdRateEstimationTest() : rnd_(0, 1 << 16) {
+    }
+
+    void SetUp() override {
+        base_fc_ = (FRAME_CONTEXT *)calloc(1, sizeof(*base_fc_));
+        fc_ = (FRAME_CONTEXT *)calloc(1, sizeof(*fc_));
+        qp_fc_ = (FRAME_CONTEXT *)calloc(1, sizeof(*qp_fc_));
+        rates_ref_ = (MdRateEstimationContext *)calloc(1, sizeof(*rates_ref_));
+        rates_tst_ = (MdRateEstimationContext *)calloc(1, sizeof(*rates_tst_));
+        pcs_ = (PictureControlSet *)calloc(1, sizeof(*pcs_));
+        ppcs_ = (PictureParentControlSet *)calloc(1, sizeof(*ppcs_));
+        ASSERT_NE(base_fc_, nullptr);
+        ASSERT_NE(fc_, nullptr);
+        ASSERT_NE(qp_fc_, nullptr);
+        ASSERT_NE(rates_ref_, nullptr);
+        ASSERT_NE(rates_tst_, nullptr);
+        ASSERT_NE(pcs_, nullptr);
+        ASSERT_NE(ppcs_, nullptr);
+        pcs_->parent_pcs_ptr = ppcs_;
+    }
+
+    void TearDown() override {
+        free(base_fc_);
+        free(fc_);
+        free(qp_fc_);
+        free(rates_ref_);
+        free(rates_tst_);
+        free(pcs_);
+        free(ppcs_);
+    }
+
+  protected:
+    void init_frame(const int cfg) {
+        const int base_q_idx = 20 + rnd_.random() % 200;
+        is_i_slice_ = (cfg & 1) ? EB_TRUE : EB_FALSE;
+        ppcs_->frm_hdr.allow_high_precision_mv = (cfg >> 1) & 1;
+        ppcs_->frm_hdr.allow_intrabc = (cfg >> 2) & 1;
+        eb_av1_default_coef_probs(base_fc_, base_q_idx);
+        init_mode_probs(base_fc_);
+        eb_av1_default_coef_probs(qp_fc_, 255 - base_q_idx);
+        init_mode_probs(qp_fc_);
+    }
+
+    // adapt a random subset of the CDFs of base_fc_ into fc_
+    void adapt_cdfs(const int num_symbols) {
+        *fc_ = *base_fc_;
+        for (int i = 0; i < num_symbols; i++) {
+            const int ctx = rnd_.random();
+            switch (rnd_.random() % 8) {
+            case 0:
+                update_cdf(fc_->partition_cdf[ctx % PARTITION_CONTEXTS],
+                           rnd_.random() % 4,
+                           4);
+                break;
+            case 1:
+                update_cdf(fc_->skip_cdfs[ctx % SKIP_CONTEXTS],
+                           rnd_.random() % 2,
+                           2);
+                break;
+            case 2:
+                update_cdf(fc_->y_mode_cdf[ctx % BlockSize_GROUPS],
+                           rnd_.random() % INTRA_MODES,
+                           INTRA_MODES);
+                break;
+            case 3:
+                update_cdf(fc_->cfl_sign_cdf,
+                           rnd_.random() % CFL_JOINT_SIGNS,
+                           CFL_JOINT_SIGNS);
+                break;
+            case 4:
+                update_cdf(fc_->nmvc.joints_cdf,
+                           rnd_.random() % MV_JOINTS,
+                           MV_JOINTS);
+                break;
+            case 5:
+                update_cdf(fc_->ndvc.comps[ctx % 2].classes_cdf,
+                           rnd_.random() % MV_CLASSES,
+                           MV_CLASSES);
+                break;
+            case 6:
+                update_cdf(fc_->coeff_base_cdf[ctx % TX_SIZES][ctx % PLANE_TYPES]
+                                              [ctx % SIG_COEF_CONTEXTS],
+                           rnd_.random() % 4,
+                           4);
+                break;
+            default:
+                update_cdf(fc_->coeff_br_cdf[ctx % TX_SIZES][ctx % PLANE_TYPES]
+                                            [ctx % LEVEL_CONTEXTS],
+                           rnd_.random() % BR_CDF_SIZE,
+                           BR_CDF_SIZE);
+                break;
+            }
+        }
+        // sb level averaging of the coefficient CDFs, as done in enc dec
+        if (rnd_.random() & 1)
+            avg_cdf_symbols(fc_, qp_fc_, AVG_CDF_WEIGHT_LEFT, AVG_CDF_WEIGHT_TOP);
+    }
+
+    void estimate_full(MdRateEstimationContext *rates, FRAME_CONTEXT *fc) {
+        av1_estimate_syntax_rate(rates, is_i_slice_, fc);
+        av1_estimate_mv_rate(pcs_, rates, fc);
+        av1_estimate_coefficients_rate(rates, fc);
+    }
+
+    void estimate_incremental(MdRateEstimationContext *rates, FRAME_CONTEXT *fc,
+                              const FRAME_CONTEXT *base_fc) {
+        av1_update_syntax_rate(rates, is_i_slice_, fc, base_fc);
+        av1_update_mv_rate(pcs_, rates, fc, base_fc);
+        av1_update_coefficients_rate(rates, fc, base_fc);
+    }
+
+    void run_match_test(const int cfg) {
+        for (int iter = 0; iter < 20; iter++) {
+            init_frame(cfg);
+            adapt_cdfs(1 << (iter % 8));
+
+            memset(rates_ref_, 0, sizeof(*rates_ref_));
+            memset(rates_tst_, 0, sizeof(*rates_tst_));
+            estimate_full(rates_ref_, fc_);
+            estimate_full(rates_tst_, base_fc_);
+            estimate_incremental(rates_tst_, fc_, base_fc_);
+
+            // the mv cost stacks point to the tables of their own context
+            ASSERT_EQ(rates_ref_->nmvcoststack[0] - rates_ref_->nmv_costs[0],
+                      rates_tst_->nmvcoststack[0] - rates_tst_->nmv_costs[0]);
+            ASSERT_EQ(rates_ref_->nmvcoststack[1] - rates_ref_->nmv_costs[1],
+                      rates_tst_->nmvcoststack[1] - rates_tst_->nmv_costs[1]);
+            rates_ref_->nmvcoststack[0] = rates_ref_->nmvcoststack[1] = NULL;
+            rates_tst_->nmvcoststack[0] = rates_tst_->nmvcoststack[1] = NULL;
+            ASSERT_EQ(0, memcmp(rates_ref_, rates_tst_, sizeof(*rates_ref_)))
+                << "cfg " << cfg << " iter " << iter;
+        }
+    }
+
+    void run_speed_test(const int cfg) {
+        const int num_loop = 2000;
+        double time_full, time_inc;
+        uint64_t start_time_seconds, start_time_useconds;
+        uint64_t middle_time_seconds, middle_time_useconds;
+        uint64_t finish_time_seconds, finish_time_useconds;
+
+        init_frame(cfg);
+        // a SB worth of coded symbols
+        adapt_cdfs(64);
+        estimate_full(rates_tst_, base_fc_);
+
+        eb_start_time(&start_time_seconds, &start_time_useconds);
+        for (int i = 0; i < num_loop; i++) estimate_full(rates_ref_, fc_);
+        eb_start_time(&middle_time_seconds, &middle_time_useconds);
+        for (int i = 0; i < num_loop; i++)
+            estimate_incremental(rates_tst_, fc_, base_fc_);
+        eb_start_time(&finish_time_seconds, &finish_time_useconds);
+
+        eb_compute_overall_elapsed_time_ms(start_time_seconds,
+                                           start_time_useconds,
+                                           middle_time_seconds,
+                                           middle_time_useconds,
+                                           &time_full);
+        eb_compute_overall_elapsed_time_ms(middle_time_seconds,
+                                           middle_time_useconds,
+                                           finish_time_seconds,
+                                           finish_time_useconds,
+                                           &time_inc);
+        printf("rate tables cfg %d: full rebuild %6.2f ms, incremental %6.2f ms "
+               "(x%5.2f)\n",
+               cfg,
+               time_full,
+               time_inc,
+               time_full / time_inc);
+    }
+
+    SVTRandom rnd_;
+    EbBool is_i_slice_;
+    FRAME_CONTEXT *base_fc_;
+    FRAME_CONTEXT *fc_;
+    FRAME_CONTEXT *qp_fc_;
+    MdRateEstimationContext *rates_ref_;
+    MdRateEstimationContext *rates_tst_;
+    PictureControlSet *pcs_;
+    PictureParentControlSet *ppcs_;
+};
+
+TEST_P(MdRateEstimationTest, IncrementalMatchFullRebuild) {
+    run_match_test(GetParam());
+}
+
+TEST_P(MdRateEstimationTest, DISABLED_Speed) {
+    run_speed_test(GetParam());
+}
+
+// bit 0: I slice, bit 1: high precision mv, bit 2: intrabc
+INSTANTIATE_TEST_CASE_P(RateEstimation, MdRateEstimationTest,
+                        ::testing::Range(0, 8));
+
+}  // namespace
@@ -19,6 +19,7 @@
  * - Ext_eigth_sad_calculation_nsq_func
  * - Extsad_Calculation_8x8_16x16_func
  * - Extsad_Calculation_32x32_64x64_func
+ * - eb_hist_abs_diff
  *
  * @author Cidana-Ryan, Cidana-Wenyao, Cidana-Ivy
  *
@@ -39,6 +40,8 @@
 #include "gtest/gtest.h"
 #include "aom_dsp_rtcd.h"
 #include "EbComputeSAD.h"
+#include "EbComputeSAD_AVX2.h"
+#include "EbComputeSAD_C.h"
 #include "EbMeSadCalculation.h"
 #include "EbMotionEstimation.h"
 #include "EbMotionEstimationContext.h"
@@ -2497,4 +2500,48 @@ TEST_P(SADTestSubSample16bit, DISABLED_Speed) {
     RunSpeedTest();
 }
 
+/**
+ * @brief Unit test for the histogram absolute difference:
+ * - eb_hist_abs_diff_avx2
+ *
+ * Test strategy:
+ * Compare the AVX2 and the C versions on random histograms (bins up to the
+ * samples of a 4K picture), of sizes with and
+ * without a tail of bins under 8.
+ *
+ * Expected result:
+ * The results are the same.
+ */
+class HistAbsDiffTest : public ::testing::TestWithParam<uint32_t> {
+  public:
+    HistAbsDiffTest() : rnd_(0, 1 << 23) {
+    }
+
+    void check_hist_abs_diff() {
+        const uint32_t n = GetParam();
+        for (int i = 0; i < 100; i++) {
+            for (uint32_t bin = 0; bin < n; bin++) {
+                hist_a_[bin] = i ? rnd_.random() : (1 << 23);
+                hist_b_[bin] = i ? rnd_.random() : 0;
+            }
+            EXPECT_EQ(eb_hist_abs_diff_c(hist_a_, hist_b_, n),
+                      eb_hist_abs_diff_avx2(hist_a_, hist_b_, n))
+                << "n " << n << " iteration " << i;
+        }
+    }
+
+  protected:
+    SVTRandom rnd_;
+    uint32_t hist_a_[HISTOGRAM_NUMBER_OF_BINS];
+    uint32_t hist_b_[HISTOGRAM_NUMBER_OF_BINS];
+};
+
+TEST_P(HistAbsDiffTest, MatchesC) {
+    if (get_cpu_flags_to_use() & CPU_FLAGS_AVX2)
+        check_hist_abs_diff();
+}
+
+INSTANTIATE_TEST_CASE_P(SAD, HistAbsDiffTest,
+                        ::testing::Values(8, 13, 64, HISTOGRAM_NUMBER_OF_BINS));
+
 }  // namespace
@@ -0,0 +1,467 @@
+/*
+ * Copyright(c) 2019 Intel Corporation
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file SuperResTest.cc
+ *
+ * @brief Unit test for the superres and scaled reference kernels:
+ * - av1_convolve_horiz_rs_sse4_1
+ * - av1_highbd_convolve_horiz_rs_sse4_1
+ * - eb_av1_convolve_2d_scale_sse4_1
+ * - eb_av1_highbd_convolve_2d_scale_sse4_1
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "common_dsp_rtcd.h"
+#include "EbDefinitions.h"
+#include "EbInterPrediction.h"
+#include "EbSuperRes.h"
+#include "EbTime.h"
+#include "convolve.h"
+#include "filter.h"
+#include "random.h"
+
+extern "C" int32_t av1_get_upscale_convolve_step(int in_length,
+                                                 int out_length);
+extern "C" int32_t get_upscale_convolve_x0(int in_length, int out_length,
+                                           int32_t x_step_qn);
+extern "C" EbErrorType av1_resize_plane(const uint8_t *const input, int height,
+                                        int width, int in_stride,
+                                        uint8_t *output, int height2,
+                                        int width2, int out_stride);
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace {
+
+// Columns of border on each side of the superres source rows, enough for the
+// normative 8-tap filter at the picture edges.
+const int kRsBorder = 16;
+
+static int downscaled_width(int width, int denom) {
+    return (width * SCALE_NUMERATOR + denom / 2) / denom;
+}
+
+// Replicate the first and last pixel of each row into the border, like
+// upscale_normative_rect() does at the picture edges.
+template <typename Sample>
+static void extend_rows(Sample *buf, int stride, int width, int height) {
+    for (int i = 0; i < height; i++) {
+        Sample *row = buf + i * stride;
+        for (int j = 1; j <= kRsBorder; j++) {
+            row[-j] = row[0];
+            row[width - 1 + j] = row[width - 1];
+        }
+    }
+}
+
+TEST(SuperResConvolveTest, HorizRsMatchC) {
+    if (!(get_cpu_flags_to_use() & CPU_FLAGS_SSE4_1))
+        return;
+    SVTRandom rnd(0, 255);
+    SVTRandom rnd_w(1, 200);
+    const int height = 8;
+
+    for (int denom = SCALE_NUMERATOR + 1; denom <= MAX_SUPERRES_DENOM;
+         denom++) {
+        for (int iter = 0; iter < 20; iter++) {
+            const int width2 = rnd_w.random();
+            const int width = AOMMAX(downscaled_width(width2, denom), 1);
+            const int src_stride = width + 2 * kRsBorder;
+            std::vector<uint8_t> src(src_stride * height);
+            std::vector<uint8_t> dst_ref(width2 * height);
+            std::vector<uint8_t> dst_tst(width2 * height);
+            for (size_t i = 0; i < src.size(); i++)
+                src[i] = (uint8_t)rnd.random();
+            uint8_t *const input = src.data() + kRsBorder;
+            extend_rows(input, src_stride, width, height);
+
+            const int32_t x_step_qn =
+                av1_get_upscale_convolve_step(width, width2);
+            const int32_t x0_qn =
+                get_upscale_convolve_x0(width, width2, x_step_qn);
+            av1_convolve_horiz_rs_c(input - 1,
+                                    src_stride,
+                                    dst_ref.data(),
+                                    width2,
+                                    width2,
+                                    height,
+                                    &av1_resize_filter_normative[0][0],
+                                    x0_qn,
+                                    x_step_qn);
+            av1_convolve_horiz_rs_sse4_1(input - 1,
+                                         src_stride,
+                                         dst_tst.data(),
+                                         width2,
+                                         width2,
+                                         height,
+                                         &av1_resize_filter_normative[0][0],
+                                         x0_qn,
+                                         x_step_qn);
+            ASSERT_EQ(dst_ref, dst_tst)
+                << "denom " << denom << " width " << width << " -> "
+                << width2;
+        }
+    }
+}
+
+TEST(SuperResConvolveTest, HighbdHorizRsMatchC) {
+    if (!(get_cpu_flags_to_use() & CPU_FLAGS_SSE4_1))
+        return;
+    SVTRandom rnd_w(1, 200);
+    const int height = 8;
+
+    for (int bd = 10; bd <= 12; bd += 2) {
+        SVTRandom rnd(0, (1 << bd) - 1);
+        for (int denom = SCALE_NUMERATOR + 1; denom <= MAX_SUPERRES_DENOM;
+             denom++) {
+            for (int iter = 0; iter < 20; iter++) {
+                const int width2 = rnd_w.random();
+                const int width = AOMMAX(downscaled_width(width2, denom), 1);
+                const int src_stride = width + 2 * kRsBorder;
+                std::vector<uint16_t> src(src_stride * height);
+                std::vector<uint16_t> dst_ref(width2 * height);
+                std::vector<uint16_t> dst_tst(width2 * height);
+                for (size_t i = 0; i < src.size(); i++)
+                    src[i] = (uint16_t)rnd.random();
+                uint16_t *const input = src.data() + kRsBorder;
+                extend_rows(input, src_stride, width, height);
+
+                const int32_t x_step_qn =
+                    av1_get_upscale_convolve_step(width, width2);
+                const int32_t x0_qn =
+                    get_upscale_convolve_x0(width, width2, x_step_qn);
+                av1_highbd_convolve_horiz_rs_c(
+                    input - 1,
+                    src_stride,
+                    dst_ref.data(),
+                    width2,
+                    width2,
+                    height,
+                    &av1_resize_filter_normative[0][0],
+                    x0_qn,
+                    x_step_qn,
+                    bd);
+                av1_highbd_convolve_horiz_rs_sse4_1(
+                    input - 1,
+                    src_stride,
+                    dst_tst.data(),
+                    width2,
+                    width2,
+                    height,
+                    &av1_resize_filter_normative[0][0],
+                    x0_qn,
+                    x_step_qn,
+                    bd);
+                ASSERT_EQ(dst_ref, dst_tst)
+                    << "bd " << bd << " denom " << denom << " width "
+                    << width << " -> " << width2;
+            }
+        }
+    }
+}
+
+// The scaled prediction reads up to twice the block size plus the filter
+// taps from the reference.
+const int kScaleSrcBorder = 8;
+const int kScaleSrcSize = 2 * MAX_SB_SIZE + 2 * kScaleSrcBorder + 16;
+
+typedef enum {
+    SCALE_SINGLE,
+    SCALE_COMPOUND_FIRST,
+    SCALE_COMPOUND_AVG,
+    SCALE_COMPOUND_DIST_WTD,
+    SCALE_PRED_TYPES
+} ScalePredType;
+
+static ConvolveParams get_scale_conv_params(ScalePredType type,
+                                            ConvBufType *conv_buf, int bd) {
+    const int is_compound = type != SCALE_SINGLE;
+    const int do_average = type >= SCALE_COMPOUND_AVG;
+    ConvolveParams conv_params = get_conv_params_no_round(
+        0, do_average, 0, conv_buf, MAX_SB_SIZE, is_compound, bd);
+    conv_params.use_dist_wtd_comp_avg = type == SCALE_COMPOUND_DIST_WTD;
+    conv_params.fwd_offset = 9;
+    conv_params.bck_offset = 7;
+    return conv_params;
+}
+
+template <typename Sample>
+class ConvolveScaleTest : public ::testing::Test {
+  protected:
+    void run_test(int bd) {
+        SVTRandom rnd(0, (1 << bd) - 1);
+        SVTRandom rnd12(12, false);
+        SVTRandom rnd_step(SCALE_SUBPEL_SHIFTS / 2, 2 * SCALE_SUBPEL_SHIFTS);
+        SVTRandom rnd_subpel(0, SCALE_SUBPEL_SHIFTS - 1);
+        static const int sizes[] = {2, 4, 8, 16, 32, 64, 128};
+        std::vector<Sample> src(kScaleSrcSize * kScaleSrcSize);
+        std::vector<Sample> dst_ref(MAX_SB_SQUARE), dst_tst(MAX_SB_SQUARE);
+        std::vector<ConvBufType> conv_ref(MAX_SB_SQUARE),
+            conv_tst(MAX_SB_SQUARE);
+
+        for (size_t i = 0; i < src.size(); i++) src[i] = (Sample)rnd.random();
+        const Sample *const src_ptr =
+            src.data() + kScaleSrcBorder * kScaleSrcSize + kScaleSrcBorder;
+
+        for (int wi = 0; wi < 7; wi++) {
+            for (int hi = 0; hi < 7; hi++) {
+                const int w = sizes[wi], h = sizes[hi];
+                for (int filter = EIGHTTAP_REGULAR; filter < INTERP_FILTERS_ALL;
+                     filter++) {
+                    const InterpFilterParams filter_params_x =
+                        av1_get_interp_filter_params_with_block_size(
+                            (InterpFilter)filter, w);
+                    const InterpFilterParams filter_params_y =
+                        av1_get_interp_filter_params_with_block_size(
+                            (InterpFilter)filter, h);
+                    for (int type = SCALE_SINGLE; type < SCALE_PRED_TYPES;
+                         type++) {
+                        const int x_step_qn = rnd_step.random();
+                        const int y_step_qn = rnd_step.random();
+                        const int subpel_x_qn = rnd_subpel.random();
+                        const int subpel_y_qn = rnd_subpel.random();
+                        for (int i = 0; i < MAX_SB_SQUARE; i++) {
+                            conv_ref[i] = conv_tst[i] = rnd12.random();
+                            dst_ref[i] = dst_tst[i] = (Sample)rnd.random();
+                        }
+                        ConvolveParams conv_params_ref = get_scale_conv_params(
+                            (ScalePredType)type, conv_ref.data(), bd);
+                        ConvolveParams conv_params_tst = get_scale_conv_params(
+                            (ScalePredType)type, conv_tst.data(), bd);
+                        run_convolve(src_ptr,
+                                     w,
+                                     h,
+                                     &filter_params_x,
+                                     &filter_params_y,
+                                     subpel_x_qn,
+                                     x_step_qn,
+                                     subpel_y_qn,
+                                     y_step_qn,
+                                     &conv_params_ref,
+                                     &conv_params_tst,
+                                     dst_ref.data(),
+                                     dst_tst.data(),
+                                     bd);
+                        ASSERT_EQ(dst_ref, dst_tst)
+                            << "bd " << bd << " " << w << "x" << h
+                            << " filter " << filter << " type " << type
+                            << " step (" << x_step_qn << ", " << y_step_qn
+                            << ")";
+                        ASSERT_EQ(conv_ref, conv_tst)
+                            << "bd " << bd << " " << w << "x" << h
+                            << " filter " << filter << " type " << type
+                            << " step (" << x_step_qn << ", " << y_step_qn
+                            << ")";
+                    }
+                }
+            }
+        }
+    }
+
+    void run_convolve(const Sample *src, int w, int h,
+                      const InterpFilterParams *filter_params_x,
+                      const InterpFilterParams *filter_params_y,
+                      int subpel_x_qn, int x_step_qn, int subpel_y_qn,
+                      int y_step_qn, ConvolveParams *conv_params_ref,
+                      ConvolveParams *conv_params_tst, Sample *dst_ref,
+                      Sample *dst_tst, int bd);
+};
+
+template <>
+void ConvolveScaleTest<uint8_t>::run_convolve(
+    const uint8_t *src, int w, int h, const InterpFilterParams *filter_params_x,
+    const InterpFilterParams *filter_params_y, int subpel_x_qn, int x_step_qn,
+    int subpel_y_qn, int y_step_qn, ConvolveParams *conv_params_ref,
+    ConvolveParams *conv_params_tst, uint8_t *dst_ref, uint8_t *dst_tst,
+    int bd) {
+    (void)bd;
+    eb_av1_convolve_2d_scale_c(src,
+                               kScaleSrcSize,
+                               dst_ref,
+                               MAX_SB_SIZE,
+                               w,
+                               h,
+                               filter_params_x,
+                               filter_params_y,
+                               subpel_x_qn,
+                               x_step_qn,
+                               subpel_y_qn,
+                               y_step_qn,
+                               conv_params_ref);
+    eb_av1_convolve_2d_scale_sse4_1(src,
+                                    kScaleSrcSize,
+                                    dst_tst,
+                                    MAX_SB_SIZE,
+                                    w,
+                                    h,
+                                    filter_params_x,
+                                    filter_params_y,
+                                    subpel_x_qn,
+                                    x_step_qn,
+                                    subpel_y_qn,
+                                    y_step_qn,
+                                    conv_params_tst);
+}
+
+template <>
+void ConvolveScaleTest<uint16_t>::run_convolve(
+    const uint16_t *src, int w, int h,
+    const InterpFilterParams *filter_params_x,
+    const InterpFilterParams *filter_params_y, int subpel_x_qn, int x_step_qn,
+    int subpel_y_qn, int y_step_qn, ConvolveParams *conv_params_ref,
+    ConvolveParams *conv_params_tst, uint16_t *dst_ref, uint16_t *dst_tst,
+    int bd) {
+    eb_av1_highbd_convolve_2d_scale_c(src,
+                                      kScaleSrcSize,
+                                      dst_ref,
+                                      MAX_SB_SIZE,
+                                      w,
+                                      h,
+                                      filter_params_x,
+                                      filter_params_y,
+                                      subpel_x_qn,
+                                      x_step_qn,
+                                      subpel_y_qn,
+                                      y_step_qn,
+                                      conv_params_ref,
+                                      bd);
+    eb_av1_highbd_convolve_2d_scale_sse4_1(src,
+                                           kScaleSrcSize,
+                                           dst_tst,
+                                           MAX_SB_SIZE,
+                                           w,
+                                           h,
+                                           filter_params_x,
+                                           filter_params_y,
+                                           subpel_x_qn,
+                                           x_step_qn,
+                                           subpel_y_qn,
+                                           y_step_qn,
+                                           conv_params_tst,
+                                           bd);
+}
+
+typedef ConvolveScaleTest<uint8_t> LowbdConvolveScaleTest;
+typedef ConvolveScaleTest<uint16_t> HighbdConvolveScaleTest;
+
+TEST_F(LowbdConvolveScaleTest, MatchC) {
+    if (get_cpu_flags_to_use() & CPU_FLAGS_SSE4_1)
+        run_test(8);
+}
+
+TEST_F(HighbdConvolveScaleTest, MatchC) {
+    if (get_cpu_flags_to_use() & CPU_FLAGS_SSE4_1) {
+        run_test(10);
+        run_test(12);
+    }
+}
+
+// Compares the superres round trip (downscale then normative upscale) of a
+// 1080p luma plane across the denominators: the share of pixels left to code,
+// the upscale throughput of the C and SIMD kernels, and the PSNR of the
+// upscaled plane against the source.
+TEST(SuperResConvolveTest, DISABLED_SpeedAndQualityAcrossDenominators) {
+    if (!(get_cpu_flags_to_use() & CPU_FLAGS_SSE4_1))
+        return;
+    const int width = 1920, height = 1080;
+    const int stride = width + 2 * kRsBorder;
+    const int num_loop = 20;
+    SVTRandom rnd(-8, 8);
+    std::vector<uint8_t> source(width * height);
+    std::vector<uint8_t> down(stride * height);
+    std::vector<uint8_t> up(width * height);
+
+    // Smooth gradients with some texture on top
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            const double v = 128 + 60 * sin(j / 37.0) * cos(i / 23.0) +
+                             30 * sin((i + j) / 7.0) + rnd.random();
+            source[i * width + j] = (uint8_t)AOMMAX(0, AOMMIN(255, (int)v));
+        }
+    }
+
+    printf("denom  coded width  coded pixels  C fps  SIMD fps  PSNR (dB)\n");
+    for (int denom = SCALE_NUMERATOR + 1; denom <= MAX_SUPERRES_DENOM;
+         denom++) {
+        const int coded_width = downscaled_width(width, denom);
+        uint8_t *const input = down.data() + kRsBorder;
+        av1_resize_plane(source.data(),
+                         height,
+                         width,
+                         width,
+                         input,
+                         height,
+                         coded_width,
+                         stride);
+        extend_rows(input, stride, coded_width, height);
+
+        const int32_t x_step_qn =
+            av1_get_upscale_convolve_step(coded_width, width);
+        const int32_t x0_qn =
+            get_upscale_convolve_x0(coded_width, width, x_step_qn);
+        double time_c, time_simd;
+        uint64_t start_seconds, start_useconds;
+        uint64_t finish_seconds, finish_useconds;
+
+        eb_start_time(&start_seconds, &start_useconds);
+        for (int i = 0; i < num_loop; i++)
+            av1_convolve_horiz_rs_c(input - 1,
+                                    stride,
+                                    up.data(),
+                                    width,
+                                    width,
+                                    height,
+                                    &av1_resize_filter_normative[0][0],
+                                    x0_qn,
+                                    x_step_qn);
+        eb_start_time(&finish_seconds, &finish_useconds);
+        eb_compute_overall_elapsed_time_ms(start_seconds,
+                                           start_useconds,
+                                           finish_seconds,
+                                           finish_useconds,
+                                           &time_c);
+
+        eb_start_time(&start_seconds, &start_useconds);
+        for (int i = 0; i < num_loop; i++)
+            av1_convolve_horiz_rs_sse4_1(input - 1,
+                                         stride,
+                                         up.data(),
+                                         width,
+                                         width,
+                                         height,
+                                         &av1_resize_filter_normative[0][0],
+                                         x0_qn,
+                                         x_step_qn);
+        eb_start_time(&finish_seconds, &finish_useconds);
+        eb_compute_overall_elapsed_time_ms(start_seconds,
+                                           start_useconds,
+                                           finish_seconds,
+                                           finish_useconds,
+                                           &time_simd);
+
+        double sse = 0;
+        for (int i = 0; i < width * height; i++) {
+            const double diff = (double)source[i] - up[i];
+            sse += diff * diff;
+        }
+        const double psnr =
+            sse ? 10 * log10(255.0 * 255.0 * width * height / sse) : 99.0;
+
+        printf("%5d  %11d  %11.1f%%  %5.0f  %8.0f  %9.2f\n",
+               denom,
+               coded_width,
+               100.0 * coded_width / width,
+               1000.0 * num_loop / time_c,
+               1000.0 * num_loop / time_simd,
+               psnr);
+    }
+}
+
+}  // namespace
@@ -9,6 +9,8 @@
  * @brief Unit test for Temporal Filter functions:
  * - svt_av1_apply_temporal_filter_sse4_1
  * - svt_av1_highbd_apply_temporal_filter_sse4_1
+ * - svt_av1_apply_temporal_filter_avx512
+ * - svt_av1_highbd_apply_temporal_filter_avx512
  *
  * @author Cidana-Ivy
  *
@@ -18,6 +20,7 @@
 #include <stdlib.h>
 #include <limits.h>
 
+#include "aom_dsp_rtcd.h"
 #include "EbPictureOperators.h"
 #include "EbEncIntraPrediction.h"
 #include "EbTemporalFiltering.h"
@@ -438,4 +441,196 @@ INSTANTIATE_TEST_CASE_P(
                        ::testing::ValuesIn(FW_PATTERNS),
                        ::testing::ValuesIn(ALTREF_STRENGTH)));
 
+#ifndef NON_AVX512_SUPPORT
+
+typedef void (*TemporalFilterFunc)(
+    const uint8_t *y_src, int y_src_stride, const uint8_t *y_pre,
+    int y_pre_stride, const uint8_t *u_src, const uint8_t *v_src,
+    int uv_src_stride, const uint8_t *u_pre, const uint8_t *v_pre,
+    int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, int use_whole_blk,
+    uint32_t *y_accum, uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count,
+    uint32_t *v_accum, uint16_t *v_count);
+typedef void (*TemporalFilterHbdFunc)(
+    const uint16_t *y_src, int y_src_stride, const uint16_t *y_pre,
+    int y_pre_stride, const uint16_t *u_src, const uint16_t *v_src,
+    int uv_src_stride, const uint16_t *u_pre, const uint16_t *v_pre,
+    int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, int use_whole_blk,
+    uint32_t *y_accum, uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count,
+    uint32_t *v_accum, uint16_t *v_count);
+
+typedef std::tuple<int, int> ChromaSubsampling;
+ChromaSubsampling TEST_SUBSAMPLING[] = {ChromaSubsampling(1, 1),
+                                        ChromaSubsampling(1, 0),
+                                        ChromaSubsampling(0, 0)};
+// 32x32 blocks are filtered by the encoder, 64x64 and 16x16 blocks take the
+// 16 sub-block weights path (the AVX-512 kernels fall back to C on 64x64)
+const uint32_t TEST_BLOCK_SIZE[] = {16, 32, 64};
+
+typedef std::tuple<ChromaSubsampling, uint32_t, int> TemporalFilterParam;
+
+/**
+ * @brief Unit test for the AVX-512 Temporal Filter functions:
+ *  - svt_av1_apply_temporal_filter_avx512
+ *  - svt_av1_highbd_apply_temporal_filter_avx512
+ *
+ * Test strategy:
+ * Random source and predicted blocks, random sub-block filter weights and
+ * random initial accumulators and counters are filtered by the C and the
+ * AVX-512 functions, for 8, 10 and 12 bit pixels.
+ *
+ * Expected result:
+ * The accumulators and counters of the C and AVX-512 functions are equal.
+ *
+ * Test coverage:
+ *  chroma sub-sampling {420, 422, 444}
+ *  block size {16x16, 32x32, 64x64}
+ *  alt-ref strength {0,1,2,3,4,5,6}
+ */
+class TemporalFilterAvx512Test
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<TemporalFilterParam> {
+  public:
+    TemporalFilterAvx512Test()
+        : ss_x_(std::get<0>(TEST_GET_PARAM(0))),
+          ss_y_(std::get<1>(TEST_GET_PARAM(0))),
+          block_size_(TEST_GET_PARAM(1)),
+          altref_strength_(TEST_GET_PARAM(2)) {
+    }
+
+  protected:
+    void prepare_data(SVTRandom &rnd_pel) {
+        SVTRandom rnd_weight(0, 2);
+        SVTRandom rnd_accum(0, 1 << 20);
+        SVTRandom rnd_count(0, UINT16_MAX);
+
+        for (int i = 0; i < BLK_PELS * COLOR_CHANNELS; i++) {
+            src_[i] = (uint16_t)rnd_pel.random();
+            // flat areas of the prediction give large weights
+            pred_[i] = (i & 64) ? src_[i] : (uint16_t)rnd_pel.random();
+            src8_[i] = (uint8_t)src_[i];
+            pred8_[i] = (uint8_t)pred_[i];
+            accum_ref_[i] = accum_tst_[i] = rnd_accum.random();
+            count_ref_[i] = count_tst_[i] = (uint16_t)rnd_count.random();
+        }
+        for (int i = 0; i < N_16X16_BLOCKS; i++)
+            blk_fw_[i] = rnd_weight.random();
+    }
+
+    void check_output() {
+        EXPECT_EQ(0,
+                  memcmp(accum_ref_,
+                         accum_tst_,
+                         sizeof(accum_ref_[0]) * BLK_PELS * COLOR_CHANNELS))
+            << "accumulators differ, block " << block_size_ << " strength "
+            << altref_strength_;
+        EXPECT_EQ(0,
+                  memcmp(count_ref_,
+                         count_tst_,
+                         sizeof(count_ref_[0]) * BLK_PELS * COLOR_CHANNELS))
+            << "counters differ, block " << block_size_ << " strength "
+            << altref_strength_;
+    }
+
+    template <typename Pel, typename Func>
+    void run_filter(Func func, const Pel *src, const Pel *pred, uint32_t *accum,
+                    uint16_t *count) {
+        func(src,
+             BW,
+             pred,
+             BW,
+             src + BLK_PELS,
+             src + 2 * BLK_PELS,
+             BW,
+             pred + BLK_PELS,
+             pred + 2 * BLK_PELS,
+             BW,
+             block_size_,
+             block_size_,
+             ss_x_,
+             ss_y_,
+             altref_strength_,
+             blk_fw_,
+             0,  // use_32x32
+             accum,
+             count,
+             accum + BLK_PELS,
+             count + BLK_PELS,
+             accum + 2 * BLK_PELS,
+             count + 2 * BLK_PELS);
+    }
+
+    void run_test() {
+        SVTRandom rnd_pel(0, UINT8_MAX);
+
+        for (int loop = 0; loop < 20; loop++) {
+            prepare_data(rnd_pel);
+            run_filter<uint8_t, TemporalFilterFunc>(
+                svt_av1_apply_filtering_c, src8_, pred8_, accum_ref_, count_ref_);
+            run_filter<uint8_t, TemporalFilterFunc>(
+                svt_av1_apply_temporal_filter_avx512,
+                src8_,
+                pred8_,
+                accum_tst_,
+                count_tst_);
+            check_output();
+        }
+    }
+
+    void run_test_highbd() {
+        for (int bd = 10; bd <= 12; bd += 2) {
+            SVTRandom rnd_pel(0, (1 << bd) - 1);
+
+            for (int loop = 0; loop < 20; loop++) {
+                prepare_data(rnd_pel);
+                run_filter<uint16_t, TemporalFilterHbdFunc>(
+                    svt_av1_apply_filtering_highbd_c,
+                    src_,
+                    pred_,
+                    accum_ref_,
+                    count_ref_);
+                run_filter<uint16_t, TemporalFilterHbdFunc>(
+                    svt_av1_highbd_apply_temporal_filter_avx512,
+                    src_,
+                    pred_,
+                    accum_tst_,
+                    count_tst_);
+                check_output();
+            }
+        }
+    }
+
+    int ss_x_, ss_y_;
+    uint32_t block_size_;
+    int altref_strength_;
+    int blk_fw_[N_16X16_BLOCKS];
+    uint8_t src8_[BLK_PELS * COLOR_CHANNELS];
+    uint8_t pred8_[BLK_PELS * COLOR_CHANNELS];
+    uint16_t src_[BLK_PELS * COLOR_CHANNELS];
+    uint16_t pred_[BLK_PELS * COLOR_CHANNELS];
+    uint32_t accum_ref_[BLK_PELS * COLOR_CHANNELS];
+    uint32_t accum_tst_[BLK_PELS * COLOR_CHANNELS];
+    uint16_t count_ref_[BLK_PELS * COLOR_CHANNELS];
+    uint16_t count_tst_[BLK_PELS * COLOR_CHANNELS];
+};
+
+TEST_P(TemporalFilterAvx512Test, MatchTest) {
+    if (get_cpu_flags_to_use() & CPU_FLAGS_AVX512F)
+        run_test();
+};
+
+TEST_P(TemporalFilterAvx512Test, MatchTestHbd) {
+    if (get_cpu_flags_to_use() & CPU_FLAGS_AVX512F)
+        run_test_highbd();
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TemporalFilter, TemporalFilterAvx512Test,
+    ::testing::Combine(::testing::ValuesIn(TEST_SUBSAMPLING),
+                       ::testing::ValuesIn(TEST_BLOCK_SIZE),
+                       ::testing::ValuesIn(ALTREF_STRENGTH)));
+
+#endif  // !NON_AVX512_SUPPORT
+
 }  // namespace
@@ -0,0 +1,161 @@
+/*
+ * Copyright(c) 2019 Intel Corporation
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file VbvModelTest.cc
+ *
+ * @brief Unit test for the VBV (leaky bucket) decoder buffer model:
+ * - vbv_model_update
+ * - vbv_model_max_tu_bits
+ * - vbv_model_padding_bytes
+ *
+ ******************************************************************************/
+#include "gtest/gtest.h"
+// workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+#include "EbDefinitions.h"
+#include "EbRateControlVbv.h"
+#include "random.h"
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace {
+
+// 1 Mbps @ 25 fps (Q16), 1 s buffer: 40000 bits per TU
+static const uint32_t kMaxRate = 1000000;
+static const uint32_t kFrameRate = 25 << 16;
+static const uint32_t kBufferSize = 1000000;
+static const uint32_t kFillPerTu = kMaxRate / 25;
+
+/**
+ * @brief Unit test for the VBV buffer model
+ *
+ * Test strategy:
+ * Replay sequences of TU sizes through the model, the TU sizes being either
+ * fixed, or random and limited by the model (as the rate control does), and
+ * padded in CBR (as the packetization does).
+ *
+ * Expected result:
+ * The model reports the buffer underflows, overflows and oversized TUs of the
+ * sequence, and none when the TUs are limited and padded.
+ *
+ * Test coverage:
+ * VBR and CBR, with and without a max frame size.
+ */
+class VbvModelTest : public ::testing::TestWithParam<int> {
+  public:
+    VbvModelTest() : rnd_(0, 1 << 16) {
+    }
+
+  protected:
+    void init_model(const int cfg, uint32_t initial_fullness) {
+        cbr_ = (cfg & 1) ? EB_TRUE : EB_FALSE;
+        max_tu_size_ = (cfg & 2) ? kFillPerTu * 4 : 0;
+        vbv_model_init(&vbv_,
+                       kBufferSize,
+                       kMaxRate,
+                       kFrameRate,
+                       initial_fullness,
+                       max_tu_size_,
+                       cbr_);
+    }
+
+    // removes a TU, padded as in the packetization
+    EbBool remove_tu(uint64_t tu_bits) {
+        const uint32_t padding_bytes = vbv_model_padding_bytes(&vbv_, tu_bits);
+        return vbv_model_update(&vbv_, tu_bits + ((uint64_t)padding_bytes << 3));
+    }
+
+    void run_constant_rate_test(const int cfg) {
+        init_model(cfg, 90);
+        for (int i = 0; i < 1000; i++)
+            ASSERT_EQ(remove_tu(kFillPerTu), EB_TRUE) << "cfg " << cfg << " tu " << i;
+        EXPECT_EQ(vbv_.tu_count, 1000u);
+        EXPECT_EQ(vbv_.underflow_count, 0u);
+        EXPECT_EQ(vbv_.overflow_count, 0u);
+        EXPECT_EQ(vbv_.oversize_count, 0u);
+    }
+
+    void run_underflow_test(const int cfg) {
+        init_model(cfg, 50);
+        // a TU above the initial fullness, then the buffer refills
+        EXPECT_EQ(vbv_model_update(&vbv_, kBufferSize), EB_FALSE);
+        EXPECT_EQ(vbv_.underflow_count, 1u);
+        EXPECT_EQ(vbv_.oversize_count, max_tu_size_ ? 1u : 0u);
+        EXPECT_DOUBLE_EQ(vbv_.fullness, kFillPerTu);
+        for (int i = 0; i < 100; i++) remove_tu(kFillPerTu / 2);
+        EXPECT_EQ(vbv_.underflow_count, 1u);
+    }
+
+    void run_small_tu_test(const int cfg) {
+        init_model(cfg, 90);
+        // TUs well below the rate: VBR stops the input, CBR pads them
+        for (int i = 0; i < 200; i++) {
+            const uint64_t tu_bits = kFillPerTu / 10;
+            const uint32_t padding_bytes = vbv_model_padding_bytes(&vbv_, tu_bits);
+            if (!cbr_) {
+                ASSERT_EQ(padding_bytes, 0u);
+            }
+            ASSERT_EQ(remove_tu(tu_bits), EB_TRUE) << "cfg " << cfg << " tu " << i;
+        }
+        EXPECT_EQ(vbv_.overflow_count, 0u);
+        EXPECT_LE(vbv_.fullness, (double)kBufferSize);
+        // unpadded in CBR, the buffer overflows
+        if (cbr_) {
+            EXPECT_EQ(vbv_model_update(&vbv_, 0), EB_FALSE);
+            EXPECT_EQ(vbv_.overflow_count, 1u);
+        }
+    }
+
+    void run_limited_random_test(const int cfg) {
+        init_model(cfg, 90);
+        for (int i = 0; i < 5000; i++) {
+            // random sizes up to 8 TUs worth of bits, I frames every 64 TUs
+            uint64_t tu_bits = (uint64_t)kFillPerTu * (rnd_.random() % 1024) / 128;
+            if (i % 64 == 0) tu_bits *= 4;
+            const double max_bits = vbv_model_max_tu_bits(&vbv_, vbv_.fullness);
+            if (tu_bits > (uint64_t)max_bits)
+                tu_bits = (uint64_t)max_bits;
+            ASSERT_EQ(remove_tu(tu_bits), EB_TRUE) << "cfg " << cfg << " tu " << i;
+            // the buffer stays above its low mark
+            ASSERT_GE(vbv_.fullness, kBufferSize * VBV_MIN_FULLNESS_PERCENT / 100.0);
+        }
+        EXPECT_EQ(vbv_.underflow_count, 0u);
+        EXPECT_EQ(vbv_.overflow_count, 0u);
+        EXPECT_EQ(vbv_.oversize_count, 0u);
+    }
+
+    SVTRandom rnd_;
+    EbBool cbr_;
+    uint32_t max_tu_size_;
+    VbvModel vbv_;
+};
+
+TEST_P(VbvModelTest, ConstantRateIsCompliant) {
+    run_constant_rate_test(GetParam());
+}
+
+TEST_P(VbvModelTest, LargeTuUnderflows) {
+    run_underflow_test(GetParam());
+}
+
+TEST_P(VbvModelTest, SmallTusDoNotOverflow) {
+    run_small_tu_test(GetParam());
+}
+
+TEST_P(VbvModelTest, LimitedRandomTusAreCompliant) {
+    run_limited_random_test(GetParam());
+}
+
+// bit 0: CBR, bit 1: max frame size
+INSTANTIATE_TEST_CASE_P(RateControl, VbvModelTest, ::testing::Range(0, 4));
+
+}  // namespace
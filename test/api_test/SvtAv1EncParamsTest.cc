@@ -125,8 +125,11 @@ class EncParamTestBase : public ::testing::Test {
             ctxt_.enc_params.rate_control_mode = 1;
         } else if (!param_name_str_.compare("injector_frame_rate")) {
             ctxt_.enc_params.speed_control_flag = 1;
+        } else if (!param_name_str_.compare("fast_film_grain")) {
+            ctxt_.enc_params.film_grain_denoise_strength = 1;
         } else if (!param_name_str_.compare("altref_strength") ||
-                   !param_name_str_.compare("altref_nframes")) {
+                   !param_name_str_.compare("altref_nframes") ||
+                   !param_name_str_.compare("adaptive_altref")) {
             ctxt_.enc_params.enable_altrefs = EB_TRUE;
         }
     }
@@ -284,6 +287,10 @@ DEFINE_PARAM_TEST_CLASS(EncParamFilmGrainDenoiseStrTest,
                         film_grain_denoise_strength);
 PARAM_TEST(EncParamFilmGrainDenoiseStrTest);
 
+/** Test case for fast_film_grain*/
+DEFINE_PARAM_TEST_CLASS(EncParamFastFilmGrainTest, fast_film_grain);
+PARAM_TEST(EncParamFastFilmGrainTest);
+
 /** Test case for enable_warped_motion*/
 DEFINE_PARAM_TEST_CLASS(EncParamEnableWarpedMotionTest, enable_warped_motion);
 PARAM_TEST(EncParamEnableWarpedMotionTest);
@@ -419,6 +426,10 @@ PARAM_TEST(EncParamAltRefsStrengthTest);
 DEFINE_PARAM_TEST_CLASS(EncParamAltRefsFramesNumTest, altref_nframes);
 PARAM_TEST(EncParamAltRefsFramesNumTest);
 
+/** Test case for adaptive_altref*/
+DEFINE_PARAM_TEST_CLASS(EncParamAdaptiveAltRefTest, adaptive_altref);
+PARAM_TEST(EncParamAdaptiveAltRefTest);
+
 /** Test case for enable_overlays*/
 DEFINE_PARAM_TEST_CLASS(EncParamEnableOverlaysTest, enable_overlays);
 PARAM_TEST(EncParamEnableOverlaysTest);
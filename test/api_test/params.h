@@ -484,6 +484,21 @@ static const vector<uint32_t> invalid_film_grain_denoise_strength = {
     // none
 };
 
+/* Fast film grain: the grain parameters are only estimated on key frames and
+ * scene cuts, the other pictures reuse them.
+ *
+ * Default is 0. */
+static const vector<EbBool> default_fast_film_grain = {
+    EB_FALSE,
+};
+static const vector<EbBool> valid_fast_film_grain = {
+    EB_FALSE,
+    EB_TRUE,
+};
+static const vector<EbBool> invalid_fast_film_grain = {
+    // none
+};
+
 /* Warped motion
  *
  * Default is 0. */
@@ -1046,8 +1061,13 @@ static const vector<uint8_t> valid_altref_strength = {0, 1, 2, 3, 4, 5, 6};
 static const vector<uint8_t> invalid_altref_strength = {7};
 
 static const vector<uint8_t> default_altref_nframes = {7};
-static const vector<uint8_t> valid_altref_nframes = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
-static const vector<uint8_t> invalid_altref_nframes = {11};
+static const vector<uint8_t> valid_altref_nframes = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+static const vector<uint8_t> invalid_altref_nframes = {16};
+
+static const vector<EbBool> default_adaptive_altref = {EB_FALSE};
+static const vector<EbBool> valid_adaptive_altref = {EB_FALSE, EB_TRUE};
+static const vector<EbBool> invalid_adaptive_altref = {/*none*/};
 
 static const vector<EbBool> default_enable_overlays = {EB_FALSE};
 static const vector<EbBool> valid_enable_overlays = {EB_FALSE, EB_TRUE};
@@ -1057,7 +1077,7 @@ static const vector<EbBool> invalid_enable_overlays = {/*none*/};
  */
 static const vector<EbBool> default_superres_mode = {0};
 static const vector<EbBool> valid_superres_mode = {0, 1, 2};
-static const vector<EbBool> invalid_superres_mode = {3};
+static const vector<EbBool> invalid_superres_mode = {3, 5};
 
 static const vector<uint8_t> default_superres_denom = {8};
 static const vector<uint8_t> valid_superres_denom = {8, 9, 10, 11, 12, 13, 14, 15, 16};
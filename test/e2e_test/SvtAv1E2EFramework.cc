@@ -180,7 +180,8 @@ void SvtAv1E2ETestFramework::init_test(TestVideoVector &test_vector) {
     // Prepare input and output buffer
     //
     // Input Buffer
-    av1enc_ctx_.input_picture_buffer = new EbBufferHeaderType;
+    // zero-initialized, the encoder reads the optional input fields
+    av1enc_ctx_.input_picture_buffer = new EbBufferHeaderType();
     ASSERT_NE(av1enc_ctx_.input_picture_buffer, nullptr)
         << "Malloc memory for inputPictureBuffer failed.";
     av1enc_ctx_.input_picture_buffer->p_buffer = nullptr;
@@ -400,6 +401,10 @@ void SvtAv1E2ETestFramework::run_encode_process() {
                         EB_AV1_INVALID_PICTURE;
                     av1enc_ctx_.input_picture_buffer->qp =
                         video_src_->get_frame_qp(video_src_->get_frame_index());
+                    av1enc_ctx_.input_picture_buffer->roi_delta_qp = nullptr;
+                    av1enc_ctx_.input_picture_buffer->roi_static_hint = nullptr;
+                    update_input_picture(av1enc_ctx_.input_picture_buffer,
+                                         video_src_->get_frame_index());
                     // Send the picture
                     EXPECT_EQ(EB_ErrorNone,
                               return_error = eb_svt_enc_send_picture(
@@ -413,6 +418,7 @@ void SvtAv1E2ETestFramework::run_encode_process() {
                 if (frame_count == 0 || frame == nullptr) {
                     src_file_eos = true;  // send eos only once
                     EbBufferHeaderType headerPtrLast;
+                    memset(&headerPtrLast, 0, sizeof(headerPtrLast));
                     headerPtrLast.n_alloc_len = 0;
                     headerPtrLast.n_filled_len = 0;
                     headerPtrLast.n_tick_count = 0;
@@ -91,6 +91,17 @@ class SvtAv1E2ETestFramework : public ::testing::TestWithParam<EncTestSetting> {
     /* change the encoder settings */
     virtual void update_enc_setting();
 
+    /** change the input picture before it is sent to the encoder, like the
+     picture type or the per picture settings
+     @param input  input buffer header of the picture
+     @param index  index of the picture in the video source
+    */
+    virtual void update_input_picture(EbBufferHeaderType *input,
+                                      uint32_t index) {
+        (void)input;
+        (void)index;
+    }
+
     /** Add custom process here, which will be invoked after
      encoding loop is finished, like output stats,
      analyse the Bitstream generated.
@@ -265,3 +265,78 @@ static const std::vector<EncTestSetting> tile_settings = {
 INSTANTIATE_TEST_CASE_P(TILETEST, TileIndependenceTest,
                         ::testing::ValuesIn(tile_settings),
                         EncTestSetting::GetSettingName);
+
+/**
+ * @brief SVT-AV1 encoder E2E test with a region of interest map sent with the
+ * input pictures
+ *
+ * Test strategy:
+ * Setup SVT-AV1 encoder with enable_roi_map, and send a map with lower and
+ * higher qp regions and static blocks with every other picture, the other
+ * pictures have no map. Collect the reconstructed frames and compare them
+ * with reference decoder output.
+ *
+ * Expected result:
+ * The pictures with a map are accepted, no error is reported in encoding
+ * progress. The reconstructed frame data is same as the output frame from
+ * reference decoder.
+ *
+ * Test coverage:
+ * All test vectors of 640*480 */
+class RoiMapTest : public SvtAv1E2ETestFramework {
+  protected:
+    void config_test() override {
+        enable_decoder = true;
+        enable_recon = true;
+        enable_stat = true;
+        enable_config = true;
+        SvtAv1E2ETestFramework::config_test();
+    }
+
+    void update_enc_setting() override {
+        SvtAv1E2ETestFramework::update_enc_setting();
+        av1enc_ctx_.enc_params.enable_roi_map = EB_TRUE;
+
+        // one entry per 64x64 block in raster order
+        const uint32_t cols = (av1enc_ctx_.enc_params.source_width + 63) / 64;
+        const uint32_t rows = (av1enc_ctx_.enc_params.source_height + 63) / 64;
+        roi_delta_qp_.resize(cols * rows);
+        roi_static_hint_.resize(cols * rows);
+        for (uint32_t i = 0; i < rows; i++) {
+            for (uint32_t j = 0; j < cols; j++) {
+                // better quality in the center, static border
+                const bool center = j >= cols / 4 && j < cols * 3 / 4 &&
+                                    i >= rows / 4 && i < rows * 3 / 4;
+                roi_delta_qp_[i * cols + j] = center ? -12 : 8;
+                roi_static_hint_[i * cols + j] = (i == 0 || j == 0) ? 1 : 0;
+            }
+        }
+    }
+
+    void update_input_picture(EbBufferHeaderType *input,
+                              uint32_t index) override {
+        if (index % 2 == 0) {
+            input->roi_delta_qp = roi_delta_qp_.data();
+            input->roi_static_hint = roi_static_hint_.data();
+        }
+    }
+
+    std::vector<int8_t> roi_delta_qp_;
+    std::vector<uint8_t> roi_static_hint_;
+};
+
+TEST_P(RoiMapTest, RoiMapTest) {
+    run_death_test();
+}
+
+static const std::vector<EncTestSetting> roi_map_settings = {
+    {"RoiMapTest1", {{"EncoderMode", "5"}}, default_test_vectors},
+    {"RoiMapTest2",
+     {{"EncoderMode", "5"},
+      {"RateControlMode", "2"},
+      {"TargetBitRate", "1000000"}},
+     default_test_vectors}};
+
+INSTANTIATE_TEST_CASE_P(ROIMAP, RoiMapTest,
+                        ::testing::ValuesIn(roi_map_settings),
+                        EncTestSetting::GetSettingName);
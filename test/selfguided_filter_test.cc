@@ -482,6 +482,154 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(::testing::Values(eb_apply_selfguided_restoration_avx2),
                        ::testing::ValuesIn(highbd_params_avx2)));
 
+typedef void (*SgrIntegralImagesFunc)(const uint8_t *dgd8, int32_t width,
+                                      int32_t height, int32_t dgd_stride,
+                                      int32_t *sgr_buf, int32_t highbd);
+typedef void (*SgrIiFunc)(const uint8_t *dgd8, int32_t width, int32_t height,
+                          int32_t dgd_stride, int32_t *sgr_buf, int32_t *flt0,
+                          int32_t *flt1, int32_t flt_stride,
+                          int32_t sgr_params_idx, int32_t bit_depth,
+                          int32_t highbd);
+
+// Test parameter list:
+//  <integral images function, filter function>
+typedef tuple<SgrIntegralImagesFunc, SgrIiFunc> IiFilterTestParam;
+
+/**
+ * @brief Unit test for the self-guided filter of a whole restoration unit
+ * from its integral images, as used by the search:
+ * - eb_av1_selfguided_integral_images
+ * - eb_av1_selfguided_restoration_ii
+ *
+ * Test strategy:
+ * Filter random and flat units of random sizes (up to the max unit size) once
+ * from their integral images, computed once per unit, and once per processing
+ * unit with eb_av1_selfguided_restoration_c, for all the parameter sets.
+ *
+ * Expected result:
+ * Both outputs are identical.
+ *
+ * Test coverage:
+ * 8, 10 and 12 bit, processing units of 64x64, 32x64, 64x32 and 32x32.
+ */
+class AV1SelfguidedIiFilterTest
+    : public ::testing::TestWithParam<IiFilterTestParam> {
+  public:
+    virtual void TearDown() {
+        aom_clear_system_state();
+    }
+
+  protected:
+    void RunCorrectnessTest(int32_t bit_depth) {
+        const SgrIntegralImagesFunc ii_fun = TEST_GET_PARAM(0);
+        const SgrIiFunc tst_fun = TEST_GET_PARAM(1);
+        const int32_t highbd = bit_depth > 8;
+        const int32_t max_size = RESTORATION_UNITSIZE_MAX * 3 / 2;
+        const int32_t stride = max_size + 32;
+        const int32_t flt_stride = ((max_size + 7) & ~7) + 8;
+        uint8_t *input8 = (uint8_t *)eb_aom_memalign(
+            32, stride * (max_size + 32) * sizeof(uint8_t));
+        uint16_t *input16 = (uint16_t *)eb_aom_memalign(
+            32, stride * (max_size + 32) * sizeof(uint16_t));
+        int32_t *sgr_buf = (int32_t *)eb_aom_memalign(32, SGRPROJ_II_BUF_SIZE);
+        int32_t *ref_buf = (int32_t *)eb_aom_memalign(32, SGRPROJ_TMPBUF_SIZE);
+        int32_t *tst_buf = (int32_t *)eb_aom_memalign(32, SGRPROJ_TMPBUF_SIZE);
+        int32_t *ref_flt[2] = {ref_buf, ref_buf + RESTORATION_UNITPELS_MAX};
+        int32_t *tst_flt[2] = {tst_buf, tst_buf + RESTORATION_UNITPELS_MAX};
+        const uint8_t *input = highbd
+                                   ? CONVERT_TO_BYTEPTR(input16) + stride * 16 + 16
+                                   : input8 + stride * 16 + 16;
+        ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+        for (int iter = 0; iter < 12; ++iter) {
+            const int32_t pu_width = RESTORATION_PROC_UNIT_SIZE >> (iter & 1);
+            const int32_t pu_height =
+                RESTORATION_PROC_UNIT_SIZE >> ((iter >> 1) & 1);
+            const int32_t width =
+                iter < 4 ? max_size : 1 + rnd.PseudoUniform(max_size);
+            const int32_t height =
+                iter < 4 ? max_size : 1 + rnd.PseudoUniform(max_size);
+            const bool flat = iter == 5;
+
+            for (int i = 0; i < stride * (max_size + 32); ++i) {
+                input8[i] = flat ? 255 : rnd.Rand8();
+                input16[i] = flat ? (1 << bit_depth) - 1
+                                  : rnd.Rand16() & ((1 << bit_depth) - 1);
+            }
+            ii_fun(input, width, height, stride, sgr_buf, highbd);
+
+            for (int32_t ep = 0; ep < SGRPROJ_PARAMS; ++ep) {
+                const SgrParamsType *const params = &eb_sgr_params[ep];
+
+                for (int32_t i = 0; i < height; i += pu_height) {
+                    for (int32_t j = 0; j < width; j += pu_width) {
+                        eb_av1_selfguided_restoration_c(
+                            input + i * stride + j,
+                            AOMMIN(pu_width, width - j),
+                            AOMMIN(pu_height, height - i),
+                            stride,
+                            ref_flt[0] + i * flt_stride + j,
+                            ref_flt[1] + i * flt_stride + j,
+                            flt_stride,
+                            ep,
+                            bit_depth,
+                            highbd);
+                    }
+                }
+                tst_fun(input,
+                        width,
+                        height,
+                        stride,
+                        sgr_buf,
+                        tst_flt[0],
+                        tst_flt[1],
+                        flt_stride,
+                        ep,
+                        bit_depth,
+                        highbd);
+
+                for (int32_t r = 0; r < 2; ++r) {
+                    if (!params->r[r])
+                        continue;
+                    for (int32_t i = 0; i < height; ++i) {
+                        for (int32_t j = 0; j < width; ++j) {
+                            ASSERT_EQ(ref_flt[r][i * flt_stride + j],
+                                      tst_flt[r][i * flt_stride + j])
+                                << "iter " << iter << " ep " << ep
+                                << " radius " << r << " (" << j << ", " << i
+                                << ") of " << width << "x" << height;
+                        }
+                    }
+                }
+            }
+        }
+
+        eb_aom_free(input8);
+        eb_aom_free(input16);
+        eb_aom_free(sgr_buf);
+        eb_aom_free(ref_buf);
+        eb_aom_free(tst_buf);
+    }
+};
+
+TEST_P(AV1SelfguidedIiFilterTest, CorrectnessTest) {
+    RunCorrectnessTest(8);
+}
+TEST_P(AV1SelfguidedIiFilterTest, HighbdCorrectnessTest) {
+    RunCorrectnessTest(10);
+    RunCorrectnessTest(12);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    C, AV1SelfguidedIiFilterTest,
+    ::testing::Values(make_tuple(eb_av1_selfguided_integral_images_c,
+                                 eb_av1_selfguided_restoration_ii_c)));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1SelfguidedIiFilterTest,
+    ::testing::Values(make_tuple(eb_av1_selfguided_integral_images_avx2,
+                                 eb_av1_selfguided_restoration_ii_avx2)));
+
 #if 0
 // To test integral_images() and integral_images_highbd(), make them not static,
 // and add declarations to header file.